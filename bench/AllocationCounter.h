@@ -0,0 +1,14 @@
+#ifndef ALLOCATION_COUNTER_H
+#define ALLOCATION_COUNTER_H
+#include <cstdint>
+
+// Counts every global operator new made by the benchmark process. The counters
+// are defined together with the replacement operators in AllocationCounter.cpp.
+struct AllocationSnapshot {
+    uint64_t allocations;
+    uint64_t bytes;
+};
+
+AllocationSnapshot currentAllocations();
+
+#endif
@@ -0,0 +1,193 @@
+#ifndef BENCH_HARNESS_H
+#define BENCH_HARNESS_H
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "AllocationCounter.h"
+#include "CacheCounters.h"
+
+struct BenchResult {
+    std::string name;
+    uint64_t iterations;
+    double nsPerOp;
+    double allocationsPerOp;
+    double bytesPerOp;
+    // Negative when the platform has no cache miss counter
+    double cacheMissesPerOp;
+};
+
+// Keeps the compiler from discarding a value that is computed only for timing.
+template <typename T>
+inline void doNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+// The simulation logs every action to std::cout; benchmarks measure the
+// primitives, not the terminal, so output is discarded while one is alive.
+class CoutSilencer {
+private:
+    std::streambuf* saved;
+
+public:
+    explicit CoutSilencer(bool active = true) : saved(nullptr) {
+        if (active) {
+            saved = std::cout.rdbuf(nullptr);
+        }
+    }
+    ~CoutSilencer() {
+        if (saved) {
+            std::cout.rdbuf(saved);
+            std::cout.clear();
+        }
+    }
+    CoutSilencer(const CoutSilencer&) = delete;
+    CoutSilencer& operator=(const CoutSilencer&) = delete;
+};
+
+class BenchRunner {
+private:
+    std::vector<BenchResult> results;
+    std::vector<std::pair<std::string, std::string>> reports;
+    std::string filter;
+    double minTimeSeconds;
+    int warmupIterations;
+    CacheMissCounter cacheMisses;
+
+    bool selected(const std::string& name) const {
+        return filter.empty() || name.find(filter) != std::string::npos;
+    }
+
+    template <typename Fn>
+    void measure(const std::string& name, uint64_t iterations, Fn& fn) {
+        AllocationSnapshot before = currentAllocations();
+        uint64_t missesBefore = cacheMisses.read();
+        auto start = std::chrono::steady_clock::now();
+        for (uint64_t i = 0; i < iterations; ++i) {
+            fn();
+        }
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        uint64_t missesAfter = cacheMisses.read();
+        AllocationSnapshot after = currentAllocations();
+
+        double ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+        results.push_back({name,
+                           iterations,
+                           ns / iterations,
+                           static_cast<double>(after.allocations - before.allocations) / iterations,
+                           static_cast<double>(after.bytes - before.bytes) / iterations,
+                           cacheMisses.isAvailable()
+                               ? static_cast<double>(missesAfter - missesBefore) / iterations
+                               : -1.0});
+    }
+
+public:
+    BenchRunner(const std::string& filter, double minTimeSeconds, int warmupIterations)
+        : filter(filter), minTimeSeconds(minTimeSeconds), warmupIterations(warmupIterations) {}
+
+    // Warms up, then doubles the batch size until one batch runs for at least
+    // the minimum time and reports that batch.
+    template <typename Fn>
+    void run(const std::string& name, Fn fn) {
+        if (!selected(name)) return;
+
+        for (int i = 0; i < warmupIterations; ++i) {
+            fn();
+        }
+
+        uint64_t iterations = 1;
+        while (true) {
+            auto start = std::chrono::steady_clock::now();
+            for (uint64_t i = 0; i < iterations; ++i) {
+                fn();
+            }
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            if (seconds >= minTimeSeconds / 4 || iterations >= (uint64_t(1) << 30)) {
+                double scale = seconds > 0 ? minTimeSeconds / seconds : 2.0;
+                iterations = std::max<uint64_t>(1, static_cast<uint64_t>(iterations * std::min(scale, 4.0)));
+                break;
+            }
+            iterations *= 2;
+        }
+        measure(name, iterations, fn);
+    }
+
+    // For stateful benchmarks such as whole ticks, where every run must cover
+    // the same number of operations to be comparable between builds.
+    template <typename Fn>
+    void runFixed(const std::string& name, int warmup, uint64_t iterations, Fn fn) {
+        if (!selected(name)) return;
+
+        for (int i = 0; i < warmup; ++i) {
+            fn();
+        }
+        measure(name, iterations, fn);
+    }
+
+    bool wants(const std::string& name) const { return selected(name); }
+
+    // Attaches a pre-rendered JSON object (e.g. memory accounting) to the output.
+    void addReport(const std::string& name, const std::string& json) {
+        reports.emplace_back(name, json);
+    }
+
+    const std::vector<BenchResult>& getResults() const { return results; }
+
+    void writeTable(std::ostream& out) const {
+        out << std::left << std::setw(44) << "benchmark" << std::right
+            << std::setw(12) << "iterations"
+            << std::setw(14) << "ns/op"
+            << std::setw(12) << "allocs/op"
+            << std::setw(12) << "bytes/op"
+            << std::setw(12) << "misses/op" << '\n';
+        for (const BenchResult& r : results) {
+            out << std::left << std::setw(44) << r.name << std::right
+                << std::setw(12) << r.iterations
+                << std::setw(14) << std::fixed << std::setprecision(1) << r.nsPerOp
+                << std::setw(12) << std::setprecision(2) << r.allocationsPerOp
+                << std::setw(12) << std::setprecision(1) << r.bytesPerOp;
+            if (r.cacheMissesPerOp < 0) {
+                out << std::setw(12) << "-" << '\n';
+            } else {
+                out << std::setw(12) << r.cacheMissesPerOp << '\n';
+            }
+        }
+    }
+
+    void writeJson(std::ostream& out, const std::vector<std::pair<std::string, std::string>>& context) const {
+        out << "{\n  \"context\": {";
+        for (size_t i = 0; i < context.size(); ++i) {
+            out << (i ? ", " : "") << '"' << context[i].first << "\": \"" << context[i].second << '"';
+        }
+        out << "},\n  \"benchmarks\": [\n";
+        for (size_t i = 0; i < results.size(); ++i) {
+            const BenchResult& r = results[i];
+            out << "    {\"name\": \"" << r.name << "\""
+                << ", \"iterations\": " << r.iterations
+                << ", \"ns_per_op\": " << std::fixed << std::setprecision(3) << r.nsPerOp
+                << ", \"allocs_per_op\": " << std::setprecision(4) << r.allocationsPerOp
+                << ", \"bytes_per_op\": " << std::setprecision(2) << r.bytesPerOp;
+            if (r.cacheMissesPerOp >= 0) {
+                out << ", \"cache_misses_per_op\": " << r.cacheMissesPerOp;
+            }
+            out << '}' << (i + 1 < results.size() ? ",\n" : "\n");
+        }
+        out << "  ],\n  \"reports\": {";
+        for (size_t i = 0; i < reports.size(); ++i) {
+            out << (i ? ",\n" : "\n") << "    \"" << reports[i].first << "\": " << reports[i].second;
+        }
+        out << (reports.empty() ? "}\n}\n" : "\n  }\n}\n");
+    }
+};
+
+#endif
@@ -0,0 +1,53 @@
+#ifndef CACHE_COUNTERS_H
+#define CACHE_COUNTERS_H
+#include <cstdint>
+#include <cstring>
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Last-level cache misses of the calling thread, counted by the kernel's
+// perf events. Unavailable (and reading zero) on other platforms, in many
+// VMs, and when perf_event_paranoid forbids user-space counting.
+class CacheMissCounter {
+private:
+    int fd;
+
+public:
+    CacheMissCounter() : fd(-1) {
+#if defined(__linux__)
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+    }
+    ~CacheMissCounter() {
+#if defined(__linux__)
+        if (fd >= 0) close(fd);
+#endif
+    }
+    CacheMissCounter(const CacheMissCounter&) = delete;
+    CacheMissCounter& operator=(const CacheMissCounter&) = delete;
+
+    bool isAvailable() const { return fd >= 0; }
+
+    // Running total; take differences around the code being measured
+    uint64_t read() const {
+        uint64_t value = 0;
+#if defined(__linux__)
+        if (fd >= 0 && ::read(fd, &value, sizeof(value)) != static_cast<ssize_t>(sizeof(value))) {
+            value = 0;
+        }
+#endif
+        return value;
+    }
+};
+
+#endif
@@ -0,0 +1,550 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include "BenchHarness.h"
+#include "FoodSearch.h"
+#include "FrameDumper.h"
+#include "OccupancyBitboards.h"
+#include "OccupancyPyramid.h"
+#include "Scenario.h"
+#include "Animal.h"
+#include "Grid.h"
+#include "Plant.h"
+#include "Position.h"
+#include "SoilField.h"
+#include "StatisticsRecorder.h"
+#include "TileLayout.h"
+#include "TimingWheel.h"
+#include "Viewport.h"
+#include "WorldManager.h"
+
+using namespace std;
+
+namespace {
+
+struct Options {
+    string jsonPath;
+    string filter;
+    double minTime = 0.25;
+    int warmup = 100;
+    unsigned seed = 12345;
+    bool verbose = false;
+};
+
+Options parseOptions(int argc, char* argv[]) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--json" && i + 1 < argc) {
+            options.jsonPath = argv[++i];
+        } else if (arg == "--filter" && i + 1 < argc) {
+            options.filter = argv[++i];
+        } else if (arg == "--min-time" && i + 1 < argc) {
+            options.minTime = stod(argv[++i]);
+        } else if (arg == "--warmup" && i + 1 < argc) {
+            options.warmup = stoi(argv[++i]);
+        } else if (arg == "--seed" && i + 1 < argc) {
+            options.seed = static_cast<unsigned>(stoul(argv[++i]));
+        } else if (arg == "--verbose") {
+            options.verbose = true;
+        } else {
+            cerr << "Usage: microbench [--json PATH] [--filter TEXT] [--min-time SECONDS]"
+                 << " [--warmup N] [--seed N] [--verbose]" << endl;
+            exit(arg == "--help" ? 0 : 1);
+        }
+    }
+    return options;
+}
+
+// Fills roughly `density` of the grid with plants, skipping the reserved tile.
+// The plants are owned by the returned vector, the grid only points at them.
+vector<unique_ptr<Plant>> scatterPlants(Grid& grid, double density, mt19937& gen, int reservedX, int reservedY) {
+    vector<unique_ptr<Plant>> plants;
+    uniform_real_distribution<double> coin(0.0, 1.0);
+    for (int y = 0; y < grid.getHeight(); ++y) {
+        for (int x = 0; x < grid.getWidth(); ++x) {
+            if ((x == reservedX && y == reservedY) || coin(gen) >= density) continue;
+            plants.push_back(unique_ptr<Plant>(new Plant(5.0f, 100, 0.5f, 0.3f)));
+            plants.back()->setPosition(Position(x, y));
+            grid.getTile(x, y).setOccupant(*plants.back());
+        }
+    }
+    return plants;
+}
+
+void benchPosition(BenchRunner& runner) {
+    Position center(50, 50);
+    Position corner(0, 0);
+    Position target(57, 41);
+
+    runner.run("position/adjacent_interior", [&]() {
+        doNotOptimize(center.getAdjacentPositions());
+    });
+    runner.run("position/adjacent_corner", [&]() {
+        doNotOptimize(corner.getAdjacentPositions());
+    });
+    runner.run("position/distance", [&]() {
+        doNotOptimize(center.distanceToPoint(target));
+    });
+}
+
+void benchGrid(BenchRunner& runner) {
+    Grid grid(256, 256);
+    int x = 0;
+
+    runner.run("grid/get_tile_in_bounds", [&]() {
+        x = (x + 37) & 255;
+        doNotOptimize(&grid.getTile(x, 255 - x));
+    });
+    runner.run("grid/get_tile_out_of_range", [&]() {
+        try {
+            doNotOptimize(&grid.getTile(256, 0));
+        } catch (const out_of_range&) {
+        }
+    });
+}
+
+void benchAnimal(BenchRunner& runner, unsigned seed) {
+    const int size = 64;
+    const int visions[] = {1, 5, 20};
+
+    for (int vision : visions) {
+        string name = "animal/find_nearest_food/vision_" + to_string(vision);
+        if (!runner.wants(name)) continue;
+
+        mt19937 gen(seed);
+        Grid grid(size, size);
+        vector<unique_ptr<Plant>> plants = scatterPlants(grid, 0.05, gen, size / 2, size / 2);
+        Animal animal(20.0f, 80, 2, vision, AnimalType::HERBIVORE, 1.0f, 30.0f, 5);
+        animal.setPosition(Position(size / 2, size / 2));
+        grid.getTile(size / 2, size / 2).setOccupant(animal);
+
+        runner.run(name, [&]() {
+            doNotOptimize(animal.findNearestFood(grid));
+        });
+        grid.getTile(size / 2, size / 2).clearOccupant();
+    }
+
+    if (runner.wants("animal/find_best_move_position")) {
+        mt19937 gen(seed);
+        Grid grid(size, size);
+        vector<unique_ptr<Plant>> plants = scatterPlants(grid, 0.05, gen, size / 2, size / 2);
+        Animal animal(20.0f, 80, 2, 5, AnimalType::HERBIVORE, 1.0f, 30.0f, 5);
+        animal.setPosition(Position(size / 2, size / 2));
+        grid.getTile(size / 2, size / 2).setOccupant(animal);
+
+        runner.run("animal/find_best_move_position", [&]() {
+            doNotOptimize(animal.findBestMovePosition(grid));
+        });
+        grid.getTile(size / 2, size / 2).clearOccupant();
+    }
+}
+
+void benchClosestEmptyTile(BenchRunner& runner, unsigned seed) {
+    const int size = 64;
+    const int densities[] = {10, 50, 90};
+
+    for (int percent : densities) {
+        string name = "grid/find_closest_empty_tile/density_" + to_string(percent);
+        if (!runner.wants(name)) continue;
+
+        mt19937 gen(seed);
+        Grid grid(size, size);
+        vector<unique_ptr<Plant>> plants = scatterPlants(grid, percent / 100.0, gen, -1, -1);
+        Position from(size / 2, size / 2);
+
+        runner.run(name, [&]() {
+            doNotOptimize(&grid.findClosestEmptyTile(from));
+        });
+    }
+}
+
+void benchWorldUpdate(BenchRunner& runner, unsigned seed) {
+    const int sizes[] = {32, 64, 128};
+
+    for (int size : sizes) {
+        string name = "world/update/" + to_string(size) + "x" + to_string(size);
+        if (!runner.wants(name)) continue;
+
+        WorldManager& world = buildScenarioWorld(size, size, 0.30, 0.03, 0.01, seed);
+        runner.runFixed(name, 10, 100, [&]() {
+            world.update();
+        });
+
+        ostringstream memory;
+        world.getMemoryAccounting().writeJson(memory);
+        runner.addReport(name + "/memory", memory.str());
+        WorldManager::resetInstance();
+    }
+}
+
+// Whole ticks of an aged world: organisms were allocated in one random order
+// and inserted in another, as births and deaths leave them after a while.
+// Insertion order jumps across the grid and the heap alike; spatial order
+// walks the tiles forward. The misses/op column shows the difference where
+// the platform exposes a cache miss counter.
+void benchUpdateOrder(BenchRunner& runner, unsigned seed) {
+    const int size = 384;
+    const int intervals[] = {0, 64};
+
+    for (int interval : intervals) {
+        string name = string("world/update_order/") + (interval == 0 ? "insertion" : "spatial") + "/" +
+                      to_string(size) + "x" + to_string(size);
+        if (!runner.wants(name)) continue;
+
+        WorldManager::resetInstance();
+        WorldManager& world = WorldManager::getInstance(size, size, 1.0f);
+        world.setSpatialSortInterval(interval);
+        srand(seed);
+        mt19937 gen(seed);
+        vector<int> tiles(size * size);
+        for (int i = 0; i < size * size; ++i) {
+            tiles[i] = i;
+        }
+        shuffle(tiles.begin(), tiles.end(), gen);
+        tiles.resize(tiles.size() * 3 / 10);
+
+        vector<pair<int, Organism*>> placed;
+        uniform_real_distribution<double> coin(0.0, 1.0);
+        for (int tile : tiles) {
+            double roll = coin(gen);
+            Organism* organism;
+            if (roll < 0.85) {
+                organism = new Plant(5.0f, 100, 0.5f, 0.3f);
+            } else if (roll < 0.97) {
+                organism = new Animal(15.0f, 80, 2, 5, AnimalType::HERBIVORE, 1.0f, 25.0f, 5);
+            } else {
+                organism = new Animal(20.0f, 90, 2, 6, AnimalType::CARNIVORE, 1.2f, 30.0f, 8);
+            }
+            placed.emplace_back(tile, organism);
+        }
+        shuffle(placed.begin(), placed.end(), gen);
+        for (const auto& entry : placed) {
+            world.addOrganism(entry.second, entry.first % size, entry.first / size);
+        }
+
+        runner.runFixed(name, 5, 20, [&]() {
+            world.update();
+        });
+        WorldManager::resetInstance();
+    }
+}
+
+// One tick of the scheduler with every organism rescheduled after it acts.
+// Cost follows the number due per tick, so the slow population is cheaper.
+void benchScheduler(BenchRunner& runner) {
+    const int population = 100000;
+    const int intervals[] = {1, 8};
+
+    for (int interval : intervals) {
+        string name = "scheduler/tick/" + to_string(population) + "/every_" + to_string(interval);
+        if (!runner.wants(name)) continue;
+
+        vector<unique_ptr<Plant>> plants;
+        TimingWheel wheel;
+        for (int i = 0; i < population; ++i) {
+            plants.push_back(unique_ptr<Plant>(new Plant(5.0f, 100, 0.5f, 0.3f)));
+            wheel.schedule(plants.back().get(), static_cast<uint64_t>(i % interval));
+        }
+        vector<Organism*> due;
+        runner.run(name, [&]() {
+            due.clear();
+            wheel.advance(due);
+            for (Organism* organism : due) {
+                wheel.schedule(organism, static_cast<uint64_t>(interval - 1));
+            }
+        });
+        doNotOptimize(due.size());
+    }
+}
+
+// Per-tick cost of recording statistics for a large population. Every-Nth
+// sampling only pays for the event counts on the skipped ticks; windows build
+// a full sample every tick.
+void benchStatistics(BenchRunner& runner) {
+    const int population = 100000;
+    struct Mode {
+        const char* name;
+        StatisticsDownsampling downsampling;
+        int interval;
+    };
+    const Mode modes[] = {
+        {"every_1", StatisticsDownsampling::EVERY_NTH, 1},
+        {"every_100", StatisticsDownsampling::EVERY_NTH, 100},
+        {"window_100", StatisticsDownsampling::WINDOW, 100},
+    };
+
+    for (const Mode& mode : modes) {
+        string name = "statistics/collect/" + to_string(population) + "/" + mode.name;
+        if (!runner.wants(name)) continue;
+
+        vector<unique_ptr<Plant>> plants;
+        vector<Organism*> organisms;
+        for (int i = 0; i < population; ++i) {
+            plants.push_back(unique_ptr<Plant>(new Plant(static_cast<float>(i % 97), 100, 0.5f, 0.3f)));
+            plants.back()->incrementAge(i % 89);
+            organisms.push_back(plants.back().get());
+        }
+        SimulationMetrics metrics;
+        string path = (filesystem::temp_directory_path() / "microbench_statistics.bin").string();
+        StatisticsOptions options;
+        options.downsampling = mode.downsampling;
+        options.intervalTicks = mode.interval;
+
+        StatisticsRecorder recorder;
+        recorder.open(path, options);
+        runner.run(name, [&]() {
+            metrics.increment(MetricCounter::BIRTHS);
+            metrics.endTick();
+            recorder.collect(metrics.getTick(), organisms, metrics);
+        });
+        recorder.close();
+        doNotOptimize(recorder.getRowsRecorded());
+        remove(path.c_str());
+    }
+}
+
+// Encoding cost of one 1024x1024 frame per format on a single thread; the
+// dumper's frame rate is roughly workers / (ns/op).
+void benchFrameEncode(BenchRunner& runner, unsigned seed) {
+    const int size = 1024;
+    struct Format {
+        const char* name;
+        FrameFormat format;
+    };
+    const Format formats[] = {{"ppm", FrameFormat::PPM}, {"png", FrameFormat::PNG}};
+
+    vector<FoodClass> occupancy(static_cast<size_t>(size) * size);
+    mt19937 gen(seed);
+    uniform_int_distribution<int> classDist(0, FOOD_CLASS_COUNT - 1);
+    for (FoodClass& foodClass : occupancy) {
+        foodClass = static_cast<FoodClass>(classDist(gen));
+    }
+
+    for (const Format& format : formats) {
+        string name = "frames/encode/" + to_string(size) + "x" + to_string(size) + "/" + format.name;
+        if (!runner.wants(name)) continue;
+
+        vector<uint8_t> encoded;
+        runner.run(name, [&]() {
+            FrameDumper::encode(format.format, size, size, 1, occupancy.data(), encoded);
+        });
+        doNotOptimize(encoded.size());
+
+        ostringstream report;
+        report << "{\"frames_per_s_per_worker\":" << 1e9 / runner.getResults().back().nsPerOp << '}';
+        runner.addReport(name + "/throughput", report.str());
+    }
+}
+
+// Whole-grid "has an empty neighbor" and "food next to me" boards against the
+// per-tile neighbor scans they replace, over a random half-full grid.
+void benchNeighborhood(BenchRunner& runner, unsigned seed) {
+    const int sizes[] = {256, 1024, 4096};
+
+    for (int size : sizes) {
+        string boardName = "neighborhood/bitboards/" + to_string(size) + "x" + to_string(size);
+        string scanName = "neighborhood/scan/" + to_string(size) + "x" + to_string(size);
+        if (!runner.wants(boardName) && !runner.wants(scanName)) continue;
+
+        vector<FoodClass> occupancy(static_cast<size_t>(size) * size, FOOD_CLASS_EMPTY);
+        OccupancyBitboards bitboards(size, size);
+        mt19937 gen(seed);
+        uniform_int_distribution<int> classDist(0, 2 * FOOD_CLASS_COUNT - 1);
+        for (size_t i = 0; i < occupancy.size(); ++i) {
+            int drawn = classDist(gen);
+            FoodClass foodClass = drawn < FOOD_CLASS_COUNT ? static_cast<FoodClass>(drawn) : FOOD_CLASS_EMPTY;
+            bitboards.set(static_cast<int>(i % size), static_cast<int>(i / size), occupancy[i], foodClass);
+            occupancy[i] = foodClass;
+        }
+
+        if (runner.wants(boardName)) {
+            // Flipping one tile each time forces a full rebuild
+            bool flip = false;
+            runner.run(boardName, [&]() {
+                bitboards.set(0, 0, flip ? FOOD_CLASS_PLANT : FOOD_CLASS_EMPTY, flip ? FOOD_CLASS_EMPTY : FOOD_CLASS_PLANT);
+                flip = !flip;
+                bitboards.refreshNeighborhood();
+            });
+            doNotOptimize(bitboards.hasEmptyNeighbor(size / 2, size / 2));
+        }
+
+        // The scan takes seconds at 4096x4096, so it stops at 1024x1024
+        if (size <= 1024 && runner.wants(scanName)) {
+            runner.run(scanName, [&]() {
+                size_t ready = 0;
+                for (int y = 0; y < size; ++y) {
+                    for (int x = 0; x < size; ++x) {
+                        ready += FoodSearch::emptyNeighborMask(occupancy.data(), size, size, x, y) != 0;
+                        ready += FoodSearch::adjacentFood<DIET_TABLE[0]>(occupancy.data(), size, size, x, y) >= 0;
+                        ready += FoodSearch::adjacentFood<DIET_TABLE[1]>(occupancy.data(), size, size, x, y) >= 0;
+                        ready += FoodSearch::adjacentFood<DIET_TABLE[2]>(occupancy.data(), size, size, x, y) >= 0;
+                    }
+                }
+                doNotOptimize(ready);
+            });
+        }
+    }
+}
+
+// Carnivore vision scans over an 8192x8192 world (well past L2) with sparse
+// prey, row-major against the blocked layout from the same random spots.
+void benchLayoutSearch(BenchRunner& runner, unsigned seed) {
+    const int size = 8192;
+    const int visions[] = {8, 24, 48};
+    const size_t SPOTS = 4096;
+    const DietMask carnivore = DIET_TABLE[static_cast<int>(AnimalType::CARNIVORE)];
+
+    bool wanted = false;
+    for (int vision : visions) {
+        for (const char* layoutName : {"row", "blocked"}) {
+            wanted = wanted || runner.wants("search/nearest/" + string(layoutName) + "/vision" + to_string(vision));
+        }
+    }
+    if (!wanted) return;
+
+    vector<FoodClass> rowMajor(static_cast<size_t>(size) * size, FOOD_CLASS_EMPTY);
+    mt19937 gen(seed);
+    uniform_int_distribution<int> roll(0, 999);
+    for (FoodClass& tile : rowMajor) {
+        int value = roll(gen);
+        if (value < 2) tile = animalFoodClass(AnimalType::HERBIVORE);
+        else if (value < 40) tile = FOOD_CLASS_PLANT;
+    }
+    TileLayout layout(GridLayout::BLOCKED, size, size);
+    vector<FoodClass> blocked(layout.getStorageSize(), FOOD_CLASS_EMPTY);
+    layout.scatter(rowMajor.data(), blocked.data());
+
+    uniform_int_distribution<int> coordinate(0, size - 1);
+    vector<pair<int, int>> spots(SPOTS);
+    for (auto& spot : spots) {
+        spot = {coordinate(gen), coordinate(gen)};
+    }
+
+    for (int vision : visions) {
+        string rowName = "search/nearest/row/vision" + to_string(vision);
+        string blockedName = "search/nearest/blocked/vision" + to_string(vision);
+        size_t next = 0;
+        long long found = 0;
+        if (runner.wants(rowName)) {
+            runner.run(rowName, [&]() {
+                const auto& spot = spots[next++ % SPOTS];
+                found += FoodSearch::nearestFood<carnivore>(rowMajor.data(), size, size, spot.first, spot.second, vision);
+            });
+        }
+        if (runner.wants(blockedName)) {
+            runner.run(blockedName, [&]() {
+                const auto& spot = spots[next++ % SPOTS];
+                found += FoodSearch::nearestFoodBlocked<carnivore>(blocked.data(), layout, spot.first, spot.second, vision);
+            });
+        }
+        doNotOptimize(found);
+    }
+}
+
+// A fitted 1280x800 view of growing worlds; the raster should cost about the
+// same at every size since it reads one pyramid cell per window pixel.
+void benchViewport(BenchRunner& runner, unsigned seed) {
+    const int sizes[] = {256, 1024, 4096};
+
+    for (int size : sizes) {
+        string name = "viewport/rasterize/" + to_string(size) + "x" + to_string(size);
+        if (!runner.wants(name)) continue;
+
+        vector<FoodClass> occupancy(static_cast<size_t>(size) * size);
+        mt19937 gen(seed);
+        uniform_int_distribution<int> classDist(0, FOOD_CLASS_COUNT - 1);
+        for (FoodClass& foodClass : occupancy) {
+            foodClass = static_cast<FoodClass>(classDist(gen));
+        }
+        OccupancyPyramid pyramid(size, size, occupancy.data());
+        Viewport viewport(size, size, 1280, 800, 1.0);
+        viewport.fitWorld();
+        ViewportRaster raster;
+        runner.run(name, [&]() {
+            viewport.rasterize(pyramid, raster);
+        });
+        doNotOptimize(raster.rgba.data());
+
+        ostringstream report;
+        report << "{\"level\":" << raster.level << ",\"cells\":" << raster.columns * raster.rows << '}';
+        runner.addReport(name + "/cells", report.str());
+    }
+}
+
+// Reports cell throughput next to ns/op so the stencil can be compared
+// against the Gcell/s target across grid sizes and thread counts.
+void benchSoilStep(BenchRunner& runner) {
+    const int sizes[] = {256, 1024, 4096};
+
+    for (int size : sizes) {
+        string name = "soil/step/" + to_string(size) + "x" + to_string(size);
+        if (!runner.wants(name)) continue;
+
+        SoilField soil(size, size, 5.0f, 10.0f);
+        soil.deposit(size / 2, size / 2, 1000.0f);
+        runner.run(name, [&]() {
+            soil.step(0.5f);
+        });
+        doNotOptimize(soil.getNutrients(0, 0));
+
+        double cellsPerSecond = static_cast<double>(size) * size / (runner.getResults().back().nsPerOp * 1e-9);
+        ostringstream report;
+        report << "{\"threads\":" << soil.getThreadCount() << ",\"gcells_per_s\":" << cellsPerSecond / 1e9 << '}';
+        runner.addReport(name + "/throughput", report.str());
+    }
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    Options options = parseOptions(argc, argv);
+    BenchRunner runner(options.filter, options.minTime, options.warmup);
+
+    {
+        CoutSilencer silencer(!options.verbose);
+        benchPosition(runner);
+        benchGrid(runner);
+        benchAnimal(runner, options.seed);
+        benchClosestEmptyTile(runner, options.seed);
+        benchWorldUpdate(runner, options.seed);
+        benchUpdateOrder(runner, options.seed);
+        benchSoilStep(runner);
+        benchScheduler(runner);
+        benchStatistics(runner);
+        benchFrameEncode(runner, options.seed);
+        benchViewport(runner, options.seed);
+        benchNeighborhood(runner, options.seed);
+        benchLayoutSearch(runner, options.seed);
+    }
+
+    runner.writeTable(cout);
+
+    if (!options.jsonPath.empty()) {
+        ofstream out(options.jsonPath);
+        if (!out) {
+            cerr << "Cannot write " << options.jsonPath << endl;
+            return 1;
+        }
+        runner.writeJson(out, {{"seed", to_string(options.seed)},
+                               {"min_time_s", to_string(options.minTime)},
+                               {"warmup", to_string(options.warmup)},
+#ifdef NDEBUG
+                               {"build", "release"},
+#else
+                               {"build", "debug"},
+#endif
+                               {"compiler", __VERSION__}});
+    }
+    return 0;
+}
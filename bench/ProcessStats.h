@@ -0,0 +1,52 @@
+#ifndef PROCESS_STATS_H
+#define PROCESS_STATS_H
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <unistd.h>
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+// Resident set size and glibc allocator counters of the current process, read
+// from /proc and mallinfo2. Fields are zero where the platform lacks them.
+struct ProcessStats {
+    uint64_t rssBytes;
+    uint64_t peakRssBytes;
+    uint64_t heapInUseBytes;
+    uint64_t heapFreeBytes;
+    uint64_t mmapBytes;
+};
+
+inline uint64_t readStatusKilobytes(const std::string& key) {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, key.size(), key) == 0) {
+            return std::stoull(line.substr(key.size())) * 1024;
+        }
+    }
+    return 0;
+}
+
+inline ProcessStats sampleProcessStats() {
+    ProcessStats stats = {0, 0, 0, 0, 0};
+
+    std::ifstream statm("/proc/self/statm");
+    uint64_t totalPages = 0;
+    uint64_t residentPages = 0;
+    if (statm >> totalPages >> residentPages) {
+        stats.rssBytes = residentPages * static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+    }
+    stats.peakRssBytes = readStatusKilobytes("VmHWM:");
+
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    struct mallinfo2 info = mallinfo2();
+    stats.heapInUseBytes = info.uordblks + info.hblkhd;
+    stats.heapFreeBytes = info.fordblks;
+    stats.mmapBytes = info.hblkhd;
+#endif
+    return stats;
+}
+
+#endif
@@ -0,0 +1,66 @@
+#ifndef SCENARIO_H
+#define SCENARIO_H
+#include <cstdlib>
+#include <random>
+#include "Animal.h"
+#include "Plant.h"
+#include "WorldManager.h"
+
+// Scatters plants, herbivores and carnivores over rows [firstRow, lastRow) of
+// a world whose grid starts at row originRow. Rolls are drawn for every tile
+// from row 0 on, so a band gets the same organisms it would as part of the
+// whole world, whatever the split. Organism decisions still draw from their
+// own randomness, so runs are comparable between builds but not bit-identical.
+inline void populateScenarioRows(WorldManager& world,
+                                 int firstRow,
+                                 int lastRow,
+                                 int originRow,
+                                 double plantDensity,
+                                 double herbivoreDensity,
+                                 double carnivoreDensity,
+                                 unsigned seed) {
+    srand(seed);
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<double> coin(0.0, 1.0);
+    int width = world.getGrid().getWidth();
+
+    for (int row = 0; row < lastRow; ++row) {
+        for (int x = 0; x < width; ++x) {
+            double roll = coin(gen);
+            if (row < firstRow) continue;
+            int y = row - originRow;
+            if (roll < plantDensity) {
+                world.addOrganism(new Plant(5.0f, 100, 0.5f, 0.3f), x, y);
+            } else if (roll < plantDensity + herbivoreDensity) {
+                world.addOrganism(new Animal(15.0f, 80, 2, 5, AnimalType::HERBIVORE, 1.0f, 25.0f, 5), x, y);
+            } else if (roll < plantDensity + herbivoreDensity + carnivoreDensity) {
+                world.addOrganism(new Animal(20.0f, 90, 2, 6, AnimalType::CARNIVORE, 1.2f, 30.0f, 8), x, y);
+            }
+        }
+    }
+}
+
+// Scatters plants, herbivores and carnivores over the whole world with the
+// given per-tile probabilities.
+inline void populateScenario(WorldManager& world,
+                             double plantDensity,
+                             double herbivoreDensity,
+                             double carnivoreDensity,
+                             unsigned seed) {
+    populateScenarioRows(world, 0, world.getGrid().getHeight(), 0,
+                         plantDensity, herbivoreDensity, carnivoreDensity, seed);
+}
+
+// Replaces the current world with a freshly populated one.
+inline WorldManager& buildScenarioWorld(int width, int height,
+                                        double plantDensity,
+                                        double herbivoreDensity,
+                                        double carnivoreDensity,
+                                        unsigned seed) {
+    WorldManager::resetInstance();
+    WorldManager& world = WorldManager::getInstance(width, height, 1.0f);
+    populateScenario(world, plantDensity, herbivoreDensity, carnivoreDensity, seed);
+    return world;
+}
+
+#endif
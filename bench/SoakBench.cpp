@@ -0,0 +1,319 @@
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "AllocationCounter.h"
+#include "BenchHarness.h"
+#include "ProcessStats.h"
+#include "Scenario.h"
+#include "ShardedRunner.h"
+#include "TickProfiler.h"
+#include "WorldManager.h"
+
+using namespace std;
+
+namespace {
+
+struct Options {
+    string mode;
+    string csvPath;
+    int size = 256;
+    double density = 0.3;
+    long long ticks = 1000000;
+    long long sampleEvery = 1000;
+    vector<int> sizes = {256, 512, 1024, 2048, 4096, 8192};
+    vector<double> densities = {0.1, 0.3, 0.6};
+    long long sweepTicks = 50;
+    unsigned seed = 12345;
+    // Above 1, organisms update on a shared TaskPool of threads - 1 workers
+    int threads = 1;
+    // Processes, and halo rows each shares with its neighbors, in shard mode
+    int shards = 2;
+    int haloRows = ShardedRunner::DEFAULT_HALO_ROWS;
+};
+
+void usage() {
+    cerr << "Usage:\n"
+         << "  soakbench soak  [--size N] [--density D] [--ticks N] [--sample-every N] [--seed N] [--threads N] [--csv PATH]\n"
+         << "  soakbench sweep [--sizes 256,512,...] [--densities 0.1,0.3,...] [--ticks N] [--seed N] [--threads N] [--csv PATH]\n"
+         << "  soakbench shard [--size N] [--density D] [--shards N] [--halo N] [--ticks N] [--seed N] [--csv PATH]\n";
+}
+
+template <typename T>
+vector<T> parseList(const string& text) {
+    vector<T> values;
+    stringstream stream(text);
+    string item;
+    while (getline(stream, item, ',')) {
+        if (item.empty()) continue;
+        stringstream itemStream(item);
+        T value;
+        itemStream >> value;
+        values.push_back(value);
+    }
+    return values;
+}
+
+Options parseOptions(int argc, char* argv[]) {
+    Options options;
+    if (argc < 2) {
+        usage();
+        exit(1);
+    }
+    options.mode = argv[1];
+    bool ticksGiven = false;
+    long long ticks = 0;
+
+    for (int i = 2; i < argc; ++i) {
+        string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--csv" && hasValue) {
+            options.csvPath = argv[++i];
+        } else if (arg == "--size" && hasValue) {
+            options.size = stoi(argv[++i]);
+        } else if (arg == "--density" && hasValue) {
+            options.density = stod(argv[++i]);
+        } else if (arg == "--ticks" && hasValue) {
+            ticks = stoll(argv[++i]);
+            ticksGiven = true;
+        } else if (arg == "--sample-every" && hasValue) {
+            options.sampleEvery = stoll(argv[++i]);
+        } else if (arg == "--sizes" && hasValue) {
+            options.sizes = parseList<int>(argv[++i]);
+        } else if (arg == "--densities" && hasValue) {
+            options.densities = parseList<double>(argv[++i]);
+        } else if (arg == "--seed" && hasValue) {
+            options.seed = static_cast<unsigned>(stoul(argv[++i]));
+        } else if (arg == "--threads" && hasValue) {
+            options.threads = stoi(argv[++i]);
+        } else if (arg == "--shards" && hasValue) {
+            options.shards = stoi(argv[++i]);
+        } else if (arg == "--halo" && hasValue) {
+            options.haloRows = stoi(argv[++i]);
+        } else {
+            usage();
+            exit(1);
+        }
+    }
+
+    if (ticksGiven) {
+        options.ticks = ticks;
+        options.sweepTicks = ticks;
+    }
+    if (options.sampleEvery <= 0) options.sampleEvery = 1;
+    if (options.threads > 1) {
+        TaskPool::configureShared(options.threads - 1, false);
+    }
+    return options;
+}
+
+// Opens the CSV destination, falling back to stdout when no path is given.
+// The fallback keeps its own handle on stdout because std::cout is silenced
+// while the simulation runs.
+ostream& openCsv(const string& path, ofstream& file, ostream& stdoutStream) {
+    if (path.empty()) return stdoutStream;
+    file.open(path);
+    if (!file) {
+        cerr << "Cannot write " << path << endl;
+        exit(1);
+    }
+    return file;
+}
+
+// Runs one world for up to millions of ticks and writes one row per sample
+// interval with tick latency, population, RSS and allocator counters.
+int runSoak(const Options& options) {
+    ofstream file;
+    ostream stdoutStream(cout.rdbuf());
+    ostream& csv = openCsv(options.csvPath, file, stdoutStream);
+    csv << "tick,elapsed_s,organisms,tick_mean_ns,tick_p50_ns,tick_p99_ns,tick_max_ns,"
+        << "rss_bytes,peak_rss_bytes,heap_in_use_bytes,heap_free_bytes,mmap_bytes,"
+        << "allocs,alloc_bytes,grid_live_bytes,organism_live_bytes,organism_store_live_bytes,"
+        << "scratch_peak_bytes\n";
+
+    CoutSilencer silencer;
+    WorldManager& world = buildScenarioWorld(options.size, options.size, options.density,
+                                             options.density / 10, options.density / 30, options.seed);
+    world.setParallelUpdates(options.threads > 1);
+
+    LatencyHistogram tickLatency;
+    AllocationSnapshot allocationsAtSample = currentAllocations();
+    auto start = chrono::steady_clock::now();
+
+    for (long long tick = 1; tick <= options.ticks; ++tick) {
+        auto tickStart = chrono::steady_clock::now();
+        world.update();
+        tickLatency.record(static_cast<uint64_t>(
+            chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - tickStart).count()));
+
+        if (tick % options.sampleEvery == 0 || tick == options.ticks) {
+            ProcessStats stats = sampleProcessStats();
+            AllocationSnapshot allocations = currentAllocations();
+            double elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+            csv << tick << ',' << elapsed << ',' << world.getOrganismCount() << ','
+                << tickLatency.getMean() << ',' << tickLatency.getPercentile(50.0) << ','
+                << tickLatency.getPercentile(99.0) << ',' << tickLatency.getMax() << ','
+                << stats.rssBytes << ',' << stats.peakRssBytes << ',' << stats.heapInUseBytes << ','
+                << stats.heapFreeBytes << ',' << stats.mmapBytes << ','
+                << (allocations.allocations - allocationsAtSample.allocations) << ','
+                << (allocations.bytes - allocationsAtSample.bytes) << ','
+                << world.getMemoryAccounting().getUsage(MemorySubsystem::GRID).liveBytes << ','
+                << world.getMemoryAccounting().getUsage(MemorySubsystem::ORGANISMS).liveBytes << ','
+                << world.getMemoryAccounting().getUsage(MemorySubsystem::ORGANISM_STORE).liveBytes << ','
+                << world.getMemoryAccounting().getUsage(MemorySubsystem::SCRATCH).peakBytes << '\n';
+            csv.flush();
+
+            tickLatency.reset();
+            allocationsAtSample = allocations;
+        }
+    }
+
+    WorldManager::resetInstance();
+    return 0;
+}
+
+// Builds one world per size and density and reports throughput and the live
+// heap attributable to tiles and to organisms, plus the dead-organism removal
+// cost per organism so superlinear growth shows up across sizes. The compact
+// columns show what the same population costs as packed records.
+int runSweep(const Options& options) {
+    ofstream file;
+    ostream stdoutStream(cout.rdbuf());
+    ostream& csv = openCsv(options.csvPath, file, stdoutStream);
+    csv << "width,height,density,initial_organisms,final_organisms,build_s,ticks,ticks_per_s,"
+        << "organism_updates_per_s,tick_mean_ns,remove_dead_mean_ns,remove_dead_ns_per_organism,"
+        << "grid_heap_bytes,organism_heap_bytes,bytes_per_tile,bytes_per_organism,rss_bytes,"
+        << "accounted_grid_bytes,accounted_organism_bytes,accounted_bytes_per_organism,scratch_peak_bytes,"
+        << "compact_organism_bytes,compact_bytes_per_organism\n";
+
+    CoutSilencer silencer;
+    for (int size : options.sizes) {
+        for (double density : options.densities) {
+            WorldManager::resetInstance();
+            uint64_t heapBefore = sampleProcessStats().heapInUseBytes;
+
+            auto buildStart = chrono::steady_clock::now();
+            WorldManager& world = WorldManager::getInstance(size, size, 1.0f);
+            uint64_t heapEmptyWorld = sampleProcessStats().heapInUseBytes;
+            populateScenario(world, density, density / 10, density / 30, options.seed);
+            world.setParallelUpdates(options.threads > 1);
+            double buildSeconds = chrono::duration<double>(chrono::steady_clock::now() - buildStart).count();
+
+            ProcessStats populated = sampleProcessStats();
+            int initialOrganisms = world.getOrganismCount();
+            uint64_t gridBytes = heapEmptyWorld - heapBefore;
+            uint64_t organismBytes = populated.heapInUseBytes > heapEmptyWorld ? populated.heapInUseBytes - heapEmptyWorld : 0;
+
+            const MemoryAccounting& accounting = world.getMemoryAccounting();
+            uint64_t accountedOrganismBytes = accounting.getUsage(MemorySubsystem::ORGANISMS).liveBytes
+                                              + accounting.getUsage(MemorySubsystem::ORGANISM_STORE).liveBytes;
+
+            CompactOrganismStore compact;
+            world.packOrganisms(compact);
+            uint64_t compactBytes = compact.getMemoryFootprint().bytes;
+
+            TickProfiler& profiler = world.getProfiler();
+            profiler.reset();
+            profiler.setEnabled(true);
+
+            long long organismUpdates = 0;
+            auto tickStart = chrono::steady_clock::now();
+            for (long long tick = 0; tick < options.sweepTicks; ++tick) {
+                organismUpdates += world.getOrganismCount();
+                world.update();
+            }
+            double tickSeconds = chrono::duration<double>(chrono::steady_clock::now() - tickStart).count();
+            profiler.setEnabled(false);
+
+            const LatencyHistogram& removeDead = profiler.getHistogram(TickPhase::REMOVE_DEAD);
+            double meanPopulation = options.sweepTicks > 0 ? static_cast<double>(organismUpdates) / options.sweepTicks : 0.0;
+
+            csv << size << ',' << size << ',' << density << ',' << initialOrganisms << ','
+                << world.getOrganismCount() << ',' << buildSeconds << ',' << options.sweepTicks << ','
+                << (tickSeconds > 0 ? options.sweepTicks / tickSeconds : 0.0) << ','
+                << (tickSeconds > 0 ? organismUpdates / tickSeconds : 0.0) << ','
+                << profiler.getHistogram(TickPhase::TICK_TOTAL).getMean() << ','
+                << removeDead.getMean() << ','
+                << (meanPopulation > 0 ? removeDead.getMean() / meanPopulation : 0.0) << ','
+                << gridBytes << ',' << organismBytes << ','
+                << static_cast<double>(gridBytes) / (static_cast<double>(size) * size) << ','
+                << (initialOrganisms > 0 ? static_cast<double>(organismBytes) / initialOrganisms : 0.0) << ','
+                << populated.rssBytes << ','
+                << accounting.getUsage(MemorySubsystem::GRID).liveBytes << ','
+                << accountedOrganismBytes << ','
+                << (initialOrganisms > 0 ? static_cast<double>(accountedOrganismBytes) / initialOrganisms : 0.0) << ','
+                << accounting.getUsage(MemorySubsystem::SCRATCH).peakBytes << ','
+                << compactBytes << ','
+                << (initialOrganisms > 0 ? static_cast<double>(compactBytes) / initialOrganisms : 0.0) << '\n';
+            csv.flush();
+        }
+    }
+
+    WorldManager::resetInstance();
+    return 0;
+}
+
+// Runs one scenario world split into bands over forked processes and reports
+// throughput plus how much crossed the band boundaries. The time includes
+// forking and populating the shards.
+int runShard(const Options& options) {
+    ofstream file;
+    ostream stdoutStream(cout.rdbuf());
+    ostream& csv = openCsv(options.csvPath, file, stdoutStream);
+    csv << "width,height,density,shards,halo_rows,ticks,elapsed_s,ticks_per_s,initial_organisms,"
+        << "final_organisms,emigrants,immigrants,displaced,lost,halo_updates\n";
+
+    CoutSilencer silencer;
+    ShardedRunner runner(options.size, options.size, options.shards, options.haloRows);
+    double density = options.density;
+    unsigned seed = options.seed;
+    auto start = chrono::steady_clock::now();
+    bool finished = runner.run(static_cast<uint64_t>(options.sweepTicks), [=](WorldManager& world, const ShardBand& band) {
+        populateScenarioRows(world, band.firstRow, band.lastRow, band.originRow,
+                             density, density / 10, density / 30, seed);
+    });
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    if (!finished) {
+        cerr << "Sharded run failed" << endl;
+        return 1;
+    }
+
+    ShardSummary total = ShardSummary();
+    for (int shard = 0; shard < runner.getShardCount(); ++shard) {
+        const ShardSummary& summary = runner.getSummary(shard);
+        total.emigrants += summary.emigrants;
+        total.immigrants += summary.immigrants;
+        total.displaced += summary.displaced;
+        total.lost += summary.lost;
+        total.haloUpdates += summary.haloUpdates;
+    }
+    const vector<uint64_t>& organisms = runner.getOrganismsPerTick();
+    csv << options.size << ',' << options.size << ',' << density << ',' << options.shards << ','
+        << options.haloRows << ',' << options.sweepTicks << ',' << seconds << ','
+        << (seconds > 0 ? options.sweepTicks / seconds : 0.0) << ','
+        << organisms.front() << ',' << organisms.back() << ','
+        << total.emigrants << ',' << total.immigrants << ',' << total.displaced << ','
+        << total.lost << ',' << total.haloUpdates << '\n';
+    return 0;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    Options options = parseOptions(argc, argv);
+    if (options.mode == "soak") {
+        return runSoak(options);
+    }
+    if (options.mode == "sweep") {
+        return runSweep(options);
+    }
+    if (options.mode == "shard") {
+        return runShard(options);
+    }
+    usage();
+    return 1;
+}
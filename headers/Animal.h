@@ -2,23 +2,29 @@
 #define ANIMAL_H
 
 #include "Organism.h"
+#include "Perception.h"
 
 class Grid;
 
-enum class AnimalType {
-    HERBIVORE,
-    CARNIVORE,
-    OMNIVORE
-};
-
 class Animal : public Organism {
 private:
-    int movementSpeed;
-    int visionDistance;
-    AnimalType animalType;
-    float nutrientRequirement;
-    float reproductionNutrientThreshold;
-    int mass;
+    // Only the traits that vary between siblings are stored per animal; the
+    // rest live in the shared species descriptor.
+    int16_t nutrientRequirementDelta;
+    int8_t movementSpeedDelta;
+
+    Animal(float nutrients, uint16_t speciesId, int movementSpeed, float nutrientRequirement);
+
+    void setTraits(int movementSpeed, float nutrientRequirement);
+    void rebindSpecies(const Species& species, int movementSpeed, float nutrientRequirement);
+
+    // Decision steps, all reading the perception taken at the start of update
+    void move(Grid& grid, const Perception& perception);
+    void hunt(WorldManager& worldManager, const Perception& perception);
+    void tryReproduce(WorldManager& worldManager, const Perception& perception);
+    Position findBestMovePosition(const Perception& perception) const;
+
+    friend class CompactOrganism;
 
 public:
     Animal(float nutrients, 
@@ -47,19 +53,26 @@ public:
     void setMass(int newMass);
 
     void update(Grid& grid, WorldManager& worldManager) override;
+    // Faster animals act more often
+    int getActionInterval() const override;
     bool isReadyToReproduce() const override;
     void consumeResources() override;
     
     Organism* reproduce() override;
+    MemoryFootprint getMemoryFootprint() const override;
+    FoodClass getFoodClass() const override;
 
     bool canEat(const Organism* food) const;
     void eat(Organism* food);
     
+    // Moves immediately; Animal::update queues a MOVE intent instead
     void move(Grid& grid);
+    // Queue EAT and SPAWN intents that the world applies when the tick resolves
     void hunt(Grid& grid, WorldManager& worldManager);
     void tryReproduce(Grid& grid, WorldManager& worldManager);
 
-private:
+    // Perception queries, read-only on the grid
+    Perception perceive(const Grid& grid) const;
     Position findBestMovePosition(Grid& grid);
     Organism* findNearestFood(Grid& grid);
     Organism* findAdjacentFood(Grid& grid);
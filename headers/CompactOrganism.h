@@ -0,0 +1,114 @@
+#ifndef COMPACT_ORGANISM_H
+#define COMPACT_ORGANISM_H
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Organism.h"
+#include "Position.h"
+#include "MemoryAccounting.h"
+
+// 16-byte packed organism for very large populations. It mirrors the state of
+// an Animal or Plant without the vtable, the heap Position and the per-object
+// allocation: behaviour comes from the species descriptor and the position is
+// a row-major tile index into a grid of known width.
+//
+// Nutrient accuracy contract (Q19.12 fixed point):
+//  - Range is [0, 524287.999]; values outside saturate to the bounds.
+//  - Resolution is 1/4096. Every float -> fixed conversion rounds to nearest,
+//    so packing and each add/consume operand are off by at most 1/8192.
+//  - Adds and consumes are exact on the fixed value, so after n operations the
+//    total drift from the same sequence done in float is at most (n + 1)/8192
+//    plus float's own rounding.
+//  - consumeNutrients clamps at zero, and isDead tests the fixed value, so a
+//    compact organism dies on exactly the tick its fixed nutrients reach zero.
+//
+// Age is 16 bits and saturates at 65535. The major trait keeps Animal/Plant's
+// 1/1024-step delta exactly; the minor trait (animal speed delta, plant
+// absorption delta) is one byte, in 1/64 steps for plants, covering 0.02x-3x.
+class CompactOrganism {
+private:
+    static const uint8_t TYPE_ANIMAL_BIT = 0x01;
+    static const uint8_t REMOVED_BIT = 0x02;
+
+    uint8_t tag;
+    int8_t minorTrait;
+    uint16_t species;
+    uint16_t age;
+    int16_t majorTrait;
+    int32_t nutrients;
+    uint32_t tile;
+
+public:
+    static constexpr int NUTRIENT_FRACTION_BITS = 12;
+    static constexpr int32_t NUTRIENT_MAX = INT32_MAX;
+    static const float MINOR_TRAIT_STEPS;
+
+    static int32_t toFixed(float value);
+    static float fromFixed(int32_t value);
+
+    CompactOrganism();
+    // Captures an organism that sits on a grid of the given width
+    static CompactOrganism pack(const Organism& organism, int gridWidth);
+    // Rebuilds a heap Animal or Plant; the caller owns the result
+    Organism* unpack(int gridWidth) const;
+
+    // Organism-compatible accessors
+    OrganismType getType() const { return (tag & TYPE_ANIMAL_BIT) ? OrganismType::ANIMAL : OrganismType::PLANT; }
+    float getNutrients() const { return fromFixed(nutrients); }
+    void addNutrients(float amount);
+    void consumeNutrients(float amount);
+    int getAge() const { return age; }
+    int getMaxLifespan() const { return getSpecies().maxLifespan; }
+    void incrementAge() { if (age != UINT16_MAX) ++age; }
+    bool isDead() const { return age >= getSpecies().maxLifespan || nutrients <= 0; }
+    Position getPosition(int gridWidth) const;
+    void setPosition(const Position& position, int gridWidth);
+    uint16_t getSpeciesId() const { return species; }
+    // Ids are process-local; a record carried to another process is rebound
+    // to the id its descriptor interns to there
+    void setSpeciesId(uint16_t id) { species = id; }
+    const Species& getSpecies() const { return SpeciesRegistry::get(species); }
+    FoodClass getFoodClass() const;
+
+    // Animal-compatible accessors
+    int getMovementSpeed() const { return getSpecies().movementSpeed + minorTrait; }
+    float getNutrientRequirement() const { return decodeTraitDelta(getSpecies().nutrientRequirement, majorTrait); }
+    void consumeResources();
+
+    // Plant-compatible accessors
+    float getGrowthRate() const { return decodeTraitDelta(getSpecies().growthRate, majorTrait); }
+    float getNutrientAbsorptionRate() const;
+
+    uint32_t getTileIndex() const { return tile; }
+    int32_t getFixedNutrients() const { return nutrients; }
+    bool isRemoved() const { return (tag & REMOVED_BIT) != 0; }
+    void markRemoved() { tag |= REMOVED_BIT; }
+};
+
+static_assert(sizeof(CompactOrganism) == 16, "CompactOrganism must stay 16 bytes");
+
+// Flat array of compact organisms with O(1) swap-removal.
+class CompactOrganismStore {
+private:
+    std::vector<CompactOrganism> records;
+
+public:
+    void reserve(size_t count) { records.reserve(count); }
+    void clear() { records.clear(); }
+    size_t size() const { return records.size(); }
+    bool empty() const { return records.empty(); }
+
+    CompactOrganism& operator[](size_t index) { return records[index]; }
+    const CompactOrganism& operator[](size_t index) const { return records[index]; }
+
+    void add(const CompactOrganism& organism) { records.push_back(organism); }
+    void add(const Organism& organism, int gridWidth) { records.push_back(CompactOrganism::pack(organism, gridWidth)); }
+    // Order is not preserved
+    void removeAt(size_t index);
+    // Drops dead and removed records in one pass; returns how many went
+    size_t removeDead();
+
+    MemoryFootprint getMemoryFootprint() const;
+};
+
+#endif
@@ -0,0 +1,70 @@
+#ifndef DIET_H
+#define DIET_H
+#include <cstdint>
+
+enum class AnimalType {
+    HERBIVORE,
+    CARNIVORE,
+    OMNIVORE
+};
+
+const int ANIMAL_TYPE_COUNT = 3;
+
+// What a tile looks like to a hungry animal. The grid keeps one byte per tile
+// so the food searches never have to dereference the occupant. Animal classes
+// follow AnimalType order, so a new animal type gets its class automatically.
+using FoodClass = uint8_t;
+
+const FoodClass FOOD_CLASS_EMPTY = 0;
+const FoodClass FOOD_CLASS_PLANT = 1;
+const FoodClass FOOD_CLASS_FIRST_ANIMAL = 2;
+const FoodClass FOOD_CLASS_COUNT = FOOD_CLASS_FIRST_ANIMAL + ANIMAL_TYPE_COUNT;
+
+constexpr FoodClass animalFoodClass(AnimalType type) {
+    return static_cast<FoodClass>(FOOD_CLASS_FIRST_ANIMAL + static_cast<int>(type));
+}
+
+// One bit per food class. Bit 0 (empty) is never part of a diet, so testing a
+// tile against a diet also rejects empty tiles.
+using DietMask = uint32_t;
+
+constexpr DietMask foodClassBit(FoodClass foodClass) {
+    return foodClass == FOOD_CLASS_EMPTY ? 0u : (1u << foodClass);
+}
+
+constexpr DietMask anyAnimalMask() {
+    DietMask mask = 0;
+    for (int type = 0; type < ANIMAL_TYPE_COUNT; ++type) {
+        mask |= foodClassBit(animalFoodClass(static_cast<AnimalType>(type)));
+    }
+    return mask;
+}
+
+// Predator/prey matrix: row = eater, bits = food classes it accepts.
+// Adding an animal type means adding its enum value and one row here.
+constexpr DietMask DIET_TABLE[ANIMAL_TYPE_COUNT] = {
+    foodClassBit(FOOD_CLASS_PLANT),                    // HERBIVORE
+    anyAnimalMask(),                                   // CARNIVORE
+    foodClassBit(FOOD_CLASS_PLANT) | anyAnimalMask()   // OMNIVORE
+};
+
+constexpr DietMask dietMask(AnimalType type) {
+    return DIET_TABLE[static_cast<int>(type)];
+}
+
+constexpr bool dietAllows(DietMask diet, FoodClass foodClass) {
+    return ((diet >> foodClass) & 1u) != 0;
+}
+
+// Fills the border of halo-padded class arrays. It is not empty and no diet
+// accepts it, so neighbor kernels can read one tile past the edge untested.
+const FoodClass FOOD_CLASS_BORDER = FOOD_CLASS_COUNT;
+
+static_assert(FOOD_CLASS_BORDER < 32, "Food classes and the border must fit in a DietMask");
+static_assert(dietAllows(dietMask(AnimalType::HERBIVORE), FOOD_CLASS_PLANT), "Herbivores eat plants");
+static_assert(!dietAllows(dietMask(AnimalType::HERBIVORE), animalFoodClass(AnimalType::HERBIVORE)), "Herbivores eat no animals");
+static_assert(!dietAllows(dietMask(AnimalType::CARNIVORE), FOOD_CLASS_PLANT), "Carnivores eat no plants");
+static_assert(!dietAllows(dietMask(AnimalType::OMNIVORE), FOOD_CLASS_EMPTY), "Empty tiles are never food");
+static_assert(!dietAllows(dietMask(AnimalType::OMNIVORE), FOOD_CLASS_BORDER), "The border is never food");
+
+#endif
@@ -0,0 +1,240 @@
+#ifndef FOOD_SEARCH_H
+#define FOOD_SEARCH_H
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include "Diet.h"
+#include "TileLayout.h"
+
+class Grid;
+
+// Neighborhood food searches over the grid's per-tile food class bytes. The
+// kernels are instantiated once per diet row, so each animal type gets a loop
+// that tests a compile-time bitmask and never branches on the animal type.
+// Results are row-major tile indices, or -1 when nothing edible is in range.
+class FoodSearch {
+private:
+    static ptrdiff_t haloOffset(int neighbor, size_t stride) {
+        return NEIGHBOR_OFFSET_Y[neighbor] * static_cast<ptrdiff_t>(stride) + NEIGHBOR_OFFSET_X[neighbor];
+    }
+
+    static int lowestBit(unsigned bits) {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_ctz(bits);
+#else
+        int bit = 0;
+        while (!(bits & 1u)) {
+            bits >>= 1;
+            ++bit;
+        }
+        return bit;
+#endif
+    }
+
+public:
+    // The 8 neighbors in Position::getAdjacentPositions() order
+    static constexpr int NEIGHBOR_COUNT = 8;
+    static constexpr int NEIGHBOR_OFFSET_X[NEIGHBOR_COUNT] = {-1, -1, -1, 0, 0, 1, 1, 1};
+    static constexpr int NEIGHBOR_OFFSET_Y[NEIGHBOR_COUNT] = {-1, 0, 1, -1, 1, -1, 0, 1};
+
+    using NearestFoodKernel = int (*)(const FoodClass* classes, int width, int height, int x, int y, int vision);
+    using AdjacentFoodKernel = int (*)(const FoodClass* classes, int width, int height, int x, int y);
+    using BlockedNearestFoodKernel = int (*)(const FoodClass* classes, const TileLayout& layout, int x, int y, int vision);
+    using BlockedAdjacentFoodKernel = int (*)(const FoodClass* classes, const TileLayout& layout, int x, int y);
+    using HaloAdjacentFoodKernel = int (*)(const FoodClass* classes, size_t stride, int width, int x, int y);
+
+    // Same result as scanning the vision square row by row and keeping the
+    // first tile with the smallest truncated Euclidean distance. The searcher's
+    // own tile is never food.
+    template <DietMask Diet>
+    static int nearestFood(const FoodClass* classes, int width, int height, int x, int y, int vision) {
+        int minX = std::max(x - vision, 0);
+        int maxX = std::min(x + vision, width - 1);
+        int minY = std::max(y - vision, 0);
+        int maxY = std::min(y + vision, height - 1);
+
+        // trunc(sqrt(d2)) < shortest  <=>  d2 < shortest * shortest
+        int shortest = vision + 1;
+        int shortestSq = shortest * shortest;
+        int nearest = -1;
+
+        for (int cy = minY; cy <= maxY; ++cy) {
+            const FoodClass* row = classes + static_cast<size_t>(cy) * width;
+            int dySq = (cy - y) * (cy - y);
+            for (int cx = minX; cx <= maxX; ++cx) {
+                if (!dietAllows(Diet, row[cx])) continue;
+                int distanceSq = (cx - x) * (cx - x) + dySq;
+                if (distanceSq != 0 && distanceSq < shortestSq) {
+                    shortest = static_cast<int>(std::sqrt(static_cast<double>(distanceSq)));
+                    shortestSq = shortest * shortest;
+                    nearest = cy * width + cx;
+                }
+            }
+        }
+        return nearest;
+    }
+
+    // First edible neighbor in neighbor order.
+    template <DietMask Diet>
+    static int adjacentFood(const FoodClass* classes, int width, int height, int x, int y) {
+        for (int i = 0; i < NEIGHBOR_COUNT; ++i) {
+            int cx = x + NEIGHBOR_OFFSET_X[i];
+            int cy = y + NEIGHBOR_OFFSET_Y[i];
+            if (cx < 0 || cy < 0 || cx >= width || cy >= height) continue;
+            int index = cy * width + cx;
+            if (dietAllows(Diet, classes[index])) {
+                return index;
+            }
+        }
+        return -1;
+    }
+
+    // Bit i is set when neighbor i is on the grid and unoccupied.
+    static uint8_t emptyNeighborMask(const FoodClass* classes, int width, int height, int x, int y) {
+        uint8_t mask = 0;
+        for (int i = 0; i < NEIGHBOR_COUNT; ++i) {
+            int cx = x + NEIGHBOR_OFFSET_X[i];
+            int cy = y + NEIGHBOR_OFFSET_Y[i];
+            if (cx < 0 || cy < 0 || cx >= width || cy >= height) continue;
+            if (classes[cy * width + cx] == FOOD_CLASS_EMPTY) {
+                mask |= static_cast<uint8_t>(1u << i);
+            }
+        }
+        return mask;
+    }
+
+    // adjacentFood and emptyNeighborMask over a halo-padded array such as
+    // Grid::getHaloFoodClasses(), whose border reads as a class that is
+    // neither empty nor food. All 8 neighbors are read without a bounds test
+    // and folded into a bit mask; the first set bit is the first neighbor.
+    template <DietMask Diet>
+    static int adjacentFoodHalo(const FoodClass* classes, size_t stride, int width, int x, int y) {
+        const FoodClass* center = classes + static_cast<ptrdiff_t>(y) * static_cast<ptrdiff_t>(stride) + x;
+        unsigned hits = 0;
+        for (int i = 0; i < NEIGHBOR_COUNT; ++i) {
+            FoodClass neighbor = center[haloOffset(i, stride)];
+            hits |= static_cast<unsigned>(dietAllows(Diet, neighbor)) << i;
+        }
+        if (hits == 0) return -1;
+        int first = lowestBit(hits);
+        return (y + NEIGHBOR_OFFSET_Y[first]) * width + x + NEIGHBOR_OFFSET_X[first];
+    }
+
+    static uint8_t emptyNeighborMaskHalo(const FoodClass* classes, size_t stride, int x, int y) {
+        const FoodClass* center = classes + static_cast<ptrdiff_t>(y) * static_cast<ptrdiff_t>(stride) + x;
+        unsigned mask = 0;
+        for (int i = 0; i < NEIGHBOR_COUNT; ++i) {
+            mask |= static_cast<unsigned>(center[haloOffset(i, stride)] == FOOD_CLASS_EMPTY) << i;
+        }
+        return static_cast<uint8_t>(mask);
+    }
+
+    // Whether any of the 8 food class bytes packed in `bytes` is in the diet,
+    // using the "has a zero byte" trick once per accepted class
+    template <DietMask Diet>
+    static bool anyInDiet(uint64_t bytes) {
+        const uint64_t ones = 0x0101010101010101ull;
+        const uint64_t highs = 0x8080808080808080ull;
+        uint64_t hits = 0;
+        for (int foodClass = 0; foodClass < FOOD_CLASS_COUNT; ++foodClass) {
+            if (!dietAllows(Diet, static_cast<FoodClass>(foodClass))) continue;
+            uint64_t matches = bytes ^ (ones * static_cast<uint64_t>(foodClass));
+            hits |= (matches - ones) & ~matches & highs;
+        }
+        return hits != 0;
+    }
+
+    // nearestFood over a blocked layout, with the same result. The blocks
+    // overlapping the window are visited in memory order, one cache line
+    // each, and a block row with nothing edible is skipped with one 8-byte
+    // test. The row scan's "first found" becomes an explicit tie-break on the
+    // row-major index.
+    template <DietMask Diet>
+    static int nearestFoodBlocked(const FoodClass* classes, const TileLayout& layout, int x, int y, int vision) {
+        const int width = layout.getWidth();
+        const int mask = TileLayout::BLOCK_SIZE - 1;
+        int minX = std::max(x - vision, 0);
+        int maxX = std::min(x + vision, width - 1);
+        int minY = std::max(y - vision, 0);
+        int maxY = std::min(y + vision, layout.getHeight() - 1);
+
+        int shortest = vision + 1;
+        int limitSq = shortest * shortest;
+        int nearest = -1;
+
+        auto scanBlock = [&](size_t base, int blockX, int blockY) {
+            int x0 = std::max(minX, blockX);
+            int x1 = std::min(maxX, blockX + mask);
+            int y0 = std::max(minY, blockY);
+            int y1 = std::min(maxY, blockY + mask);
+            // Columns outside the window read as 0xFF, which is no class
+            uint8_t outside[TileLayout::BLOCK_SIZE];
+            for (int column = 0; column < TileLayout::BLOCK_SIZE; ++column) {
+                outside[column] = blockX + column < x0 || blockX + column > x1 ? 0xFF : 0;
+            }
+            uint64_t outsideBytes;
+            std::memcpy(&outsideBytes, outside, sizeof(outsideBytes));
+            for (int cy = y0; cy <= y1; ++cy) {
+                const FoodClass* row = classes + base + static_cast<size_t>(cy & mask) * TileLayout::BLOCK_SIZE;
+                uint64_t rowBytes;
+                std::memcpy(&rowBytes, row, sizeof(rowBytes));
+                if (!anyInDiet<Diet>(rowBytes | outsideBytes)) continue;
+                int dySq = (cy - y) * (cy - y);
+                for (int cx = x0; cx <= x1; ++cx) {
+                    if (!dietAllows(Diet, row[cx & mask])) continue;
+                    int distanceSq = (cx - x) * (cx - x) + dySq;
+                    if (distanceSq == 0 || distanceSq >= limitSq) continue;
+                    int distance = static_cast<int>(std::sqrt(static_cast<double>(distanceSq)));
+                    int index = cy * width + cx;
+                    if (distance < shortest || index < nearest) {
+                        shortest = distance;
+                        nearest = index;
+                        limitSq = (shortest + 1) * (shortest + 1);
+                    }
+                }
+            }
+        };
+
+        layout.forEachBlock(minX, minY, maxX, maxY, [&](int blockX, int blockY) {
+            scanBlock(layout.blockBase(blockX, blockY), blockX, blockY);
+        });
+        return nearest;
+    }
+
+    // adjacentFood and emptyNeighborMask through a layout's index translation;
+    // results are still row-major indices and neighbor bits
+    template <DietMask Diet>
+    static int adjacentFoodBlocked(const FoodClass* classes, const TileLayout& layout, int x, int y) {
+        for (int i = 0; i < NEIGHBOR_COUNT; ++i) {
+            int cx = x + NEIGHBOR_OFFSET_X[i];
+            int cy = y + NEIGHBOR_OFFSET_Y[i];
+            if (cx < 0 || cy < 0 || cx >= layout.getWidth() || cy >= layout.getHeight()) continue;
+            if (dietAllows(Diet, classes[layout.index(cx, cy)])) {
+                return cy * layout.getWidth() + cx;
+            }
+        }
+        return -1;
+    }
+
+    static uint8_t emptyNeighborMaskBlocked(const FoodClass* classes, const TileLayout& layout, int x, int y) {
+        uint8_t mask = 0;
+        for (int i = 0; i < NEIGHBOR_COUNT; ++i) {
+            int cx = x + NEIGHBOR_OFFSET_X[i];
+            int cy = y + NEIGHBOR_OFFSET_Y[i];
+            if (cx < 0 || cy < 0 || cx >= layout.getWidth() || cy >= layout.getHeight()) continue;
+            if (classes[layout.index(cx, cy)] == FOOD_CLASS_EMPTY) {
+                mask |= static_cast<uint8_t>(1u << i);
+            }
+        }
+        return mask;
+    }
+
+    // Runtime entry points: one table lookup picks the specialized kernel,
+    // and the grid's layout picks the row-major or blocked family.
+    static int nearestFood(AnimalType type, const Grid& grid, int x, int y, int vision);
+    static int adjacentFood(AnimalType type, const Grid& grid, int x, int y);
+    static uint8_t emptyNeighborMask(const Grid& grid, int x, int y);
+};
+
+#endif
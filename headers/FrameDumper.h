@@ -0,0 +1,92 @@
+#ifndef FRAME_DUMPER_H
+#define FRAME_DUMPER_H
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "Diet.h"
+
+enum class FrameFormat {
+    // Binary P6
+    PPM,
+    // 8-bit RGB with stored (uncompressed) deflate blocks, so no zlib needed
+    PNG
+};
+
+struct FrameDumpOptions {
+    std::string directory;
+    FrameFormat format = FrameFormat::PPM;
+    int intervalTicks = 1;
+    // Pixels per tile along each axis
+    int scale = 1;
+    // Frames encoded at once on the shared TaskPool
+    int workers = 2;
+    // Frames waiting for a worker before new ones are dropped
+    size_t maxQueuedFrames = 8;
+};
+
+// Renders grid occupancy straight to numbered image files, one pixel block
+// per tile in the viewer's colours. The tick only copies the occupancy bytes
+// into a recycled buffer; colouring, scaling, encoding and writing happen in
+// drain jobs on the shared TaskPool, at most `workers` at a time. When every
+// drain is busy and the queue is full the frame is dropped and counted rather
+// than slowing the simulation down.
+class FrameDumper {
+private:
+    struct Job {
+        uint64_t tick;
+        int width;
+        int height;
+        std::vector<FoodClass> occupancy;
+    };
+
+    FrameDumpOptions options;
+    bool enabled;
+
+    std::mutex queueMutex;
+    std::condition_variable drainsFinished;
+    std::deque<Job> queue;
+    std::vector<std::vector<FoodClass>> spareBuffers;
+    // Drain jobs submitted and not yet finished
+    int activeDrains;
+
+    std::atomic<uint64_t> framesWritten;
+    std::atomic<uint64_t> framesDropped;
+    std::atomic<uint64_t> writeFailures;
+
+    void drainQueue();
+    void writeFrame(const Job& job, std::vector<uint8_t>& encoded);
+
+public:
+    FrameDumper();
+    ~FrameDumper();
+
+    FrameDumper(const FrameDumper&) = delete;
+    FrameDumper& operator=(const FrameDumper&) = delete;
+
+    // Creates the directory if needed. Bad intervals, scales or worker
+    // counts throw; a directory that cannot be created warns and returns false.
+    bool open(const FrameDumpOptions& options);
+    // Waits for the queued frames to be written
+    void close();
+    bool isEnabled() const { return enabled; }
+
+    bool wantsTick(uint64_t tick) const;
+    // Queues the frame if the tick is one to keep; returns whether it was queued
+    bool capture(uint64_t tick, int width, int height, const FoodClass* occupancy);
+
+    uint64_t getFramesWritten() const { return framesWritten.load(std::memory_order_relaxed); }
+    uint64_t getFramesDropped() const { return framesDropped.load(std::memory_order_relaxed); }
+
+    std::string framePath(uint64_t tick) const;
+
+    // Renders and encodes one frame into `out`, replacing its contents
+    static void encode(FrameFormat format, int width, int height, int scale,
+                       const FoodClass* occupancy, std::vector<uint8_t>& out);
+};
+
+#endif
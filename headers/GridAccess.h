@@ -0,0 +1,28 @@
+#ifndef GRID_ACCESS_H
+#define GRID_ACCESS_H
+#include <stdexcept>
+
+// Bounds policies for the grid's tile accessors. The public getTile always
+// uses CheckedAccess and throws on bad coordinates; code that already knows
+// its coordinates are on the grid (found by a kernel, validated when an
+// intent was queued) goes through tileAt with GridAccess, which keeps the
+// check in debug builds and compiles it away in release.
+struct CheckedAccess {
+    static void verify(bool inBounds) {
+        if (!inBounds) {
+            throw std::out_of_range("Coordinates are out of bounds.");
+        }
+    }
+};
+
+struct UncheckedAccess {
+    static void verify(bool) {}
+};
+
+#ifdef NDEBUG
+using GridAccess = UncheckedAccess;
+#else
+using GridAccess = CheckedAccess;
+#endif
+
+#endif
@@ -1,26 +1,108 @@
 #ifndef GRID_IMPL_H
 #define GRID_IMPL_H
+#include <atomic>
+#include <cstdint>
 #include <vector>
 #include "Tile.h"
 #include "Organism.h"
+#include "MemoryAccounting.h"
+#include "OccupancyBitboards.h"
+#include "TileLayout.h"
+#include "GridAccess.h"
+
+class OccupancyPyramid;
 
 class GridImpl {
 private:
     int width;
     int height;
     std::vector<std::vector<Tile>> tiles;
+    std::vector<FoodClass> foodClasses;
+    OccupancyBitboards bitboards;
+    TileLayout layout;
+    // foodClasses again inside a one-tile FOOD_CLASS_BORDER frame, for the
+    // neighbor kernels
+    std::vector<FoodClass> haloClasses;
+    // Copy of foodClasses in the blocked layout; empty while row-major
+    std::vector<FoodClass> layoutClasses;
+    // Built on first request, then kept current by setFoodClass
+    OccupancyPyramid* pyramid;
+    // Per-tile claims: the round in the high half, the claimant's handle in
+    // the low half. Claims from older rounds read as free, so starting a new
+    // round never touches the array. Round 0 is never current.
+    std::vector<std::atomic<uint64_t>> claims;
+    uint32_t claimRound;
+    // Occupants of rows outside [foodFirstRow, foodLastRow) are never food
+    int foodFirstRow;
+    int foodLastRow;
+
+    void onFoodClassChanged(size_t index, FoodClass before, FoodClass after);
+    // What the food searches see of a tile: the occupant's class on the food
+    // rows, FOOD_CLASS_BORDER (occupied, but no diet's) outside them
+    FoodClass searchClass(int y, FoodClass foodClass) const {
+        return foodClass == FOOD_CLASS_EMPTY || (y >= foodFirstRow && y < foodLastRow) ? foodClass : FOOD_CLASS_BORDER;
+    }
+    void updateSearchCopies(int x, int y, FoodClass before, FoodClass after);
 
 public:
     GridImpl(int width, int height);
     ~GridImpl();
 
     Tile& getTile(int x, int y);
+    template <typename Access>
+    Tile& tileAt(int x, int y) {
+        Access::verify(isInBounds(x, y));
+        return tiles[y][x];
+    }
     void setTile(int x, int y, const Tile& tile);
     Tile& findClosestEmptyTile(const Position& pos);
     Organism& findClosestOrganism(const Position& pos, OrganismType targetType) const;
-    bool isInBounds(int x, int y) const;
+    bool isInBounds(int x, int y) const {
+        return x >= 0 && x < width && y >= 0 && y < height;
+    }
+    MemoryFootprint getMemoryFootprint() const;
     int getWidth() const { return width; }
     int getHeight() const { return height; }
+    // Row-major food class per tile, kept in sync by the tiles themselves
+    const FoodClass* getFoodClasses() const { return foodClasses.data(); }
+    // Tile (0, 0) of the halo copy; rows are getHaloStride() apart and the
+    // row and column on each side of the grid read as FOOD_CLASS_BORDER
+    const FoodClass* getHaloFoodClasses() const { return haloClasses.data() + getHaloStride() + 1; }
+    size_t getHaloStride() const { return static_cast<size_t>(width) + 2; }
+    // Called by the tiles whenever their occupant changes
+    void setFoodClass(size_t index, FoodClass foodClass) {
+        FoodClass previous = foodClasses[index];
+        if (previous != foodClass) {
+            foodClasses[index] = foodClass;
+            onFoodClassChanged(index, previous, foodClass);
+        }
+    }
+    // Lock-free reservation of an empty tile for the current round. Fails
+    // when the tile is occupied or another handle got it first; claiming
+    // again with the same handle succeeds.
+    bool tryClaim(size_t index, uint32_t handle);
+    // Gives back a claim the handle holds; false when it holds none
+    bool release(size_t index, uint32_t handle);
+    bool isClaimed(size_t index) const {
+        return (claims[index].load(std::memory_order_acquire) >> 32) == claimRound;
+    }
+    // Drops every claim; only call while nobody is claiming
+    void beginClaimRound();
+    const OccupancyPyramid& enableOccupancyPyramid();
+    // Null until enabled
+    const OccupancyPyramid* getOccupancyPyramid() const { return pyramid; }
+    const OccupancyBitboards& getBitboards() const { return bitboards; }
+    void setLayout(GridLayout kind);
+    const TileLayout& getLayout() const { return layout; }
+    const FoodClass* getLayoutFoodClasses() const {
+        return layout.getKind() == GridLayout::ROW_MAJOR ? foodClasses.data() : layoutClasses.data();
+    }
+    // Restricts food to rows [firstRow, lastRow). Occupants elsewhere still
+    // fill their tiles, but the halo and blocked copies and the bitboards
+    // hold FOOD_CLASS_BORDER for them; getFoodClasses() keeps their class.
+    void setFoodRows(int firstRow, int lastRow);
+    int getFoodFirstRow() const { return foodFirstRow; }
+    int getFoodLastRow() const { return foodLastRow; }
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,94 @@
+#ifndef INTENT_H
+#define INTENT_H
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "MemoryAccounting.h"
+
+class Organism;
+
+// Organisms only read the world while they update. Every change they want to
+// make is queued as an intent, and the world applies all intents together
+// once every organism has had its turn.
+enum class IntentKind : uint8_t {
+    EAT,    // eat the occupant of the target tile
+    DIE,    // remove the actor and decompose it on its own tile
+    MOVE,   // move the actor onto the empty target tile
+    SPAWN   // place the actor's offspring on the empty target tile
+};
+
+struct Intent {
+    Organism* actor;
+    // y * width + x of the tile the intent acts on
+    uint32_t tile;
+    // The actor's place in the update order; the lowest one wins a conflict
+    uint32_t sequence;
+    IntentKind kind;
+
+    // Eats resolve first, then deaths, then moves and spawns compete for
+    // tiles in the same pass
+    int phase() const {
+        return kind == IntentKind::SPAWN ? static_cast<int>(IntentKind::MOVE) : static_cast<int>(kind);
+    }
+
+    bool operator<(const Intent& other) const {
+        if (phase() != other.phase()) return phase() < other.phase();
+        if (tile != other.tile) return tile < other.tile;
+        return sequence < other.sequence;
+    }
+};
+
+// Intents emitted by one thread. The thread driving an organism sets its
+// sequence number before calling update, so every intent carries it.
+class IntentBuffer {
+private:
+    std::vector<Intent> intents;
+    uint32_t sequence;
+
+    friend class IntentQueue;
+
+public:
+    IntentBuffer() : sequence(0) {}
+
+    void setSequence(uint32_t value) { sequence = value; }
+    uint32_t getSequence() const { return sequence; }
+    void push(IntentKind kind, Organism& actor, uint32_t tile) {
+        intents.push_back({&actor, tile, sequence, kind});
+    }
+    size_t size() const { return intents.size(); }
+};
+
+// One command buffer per worker thread so emitting never takes a lock. The
+// tick thread is worker 0 unless it binds itself to another slot.
+class IntentQueue {
+private:
+    // Padded so neighboring workers never share the line holding a vector
+    struct alignas(64) Slot {
+        IntentBuffer buffer;
+    };
+
+    std::vector<Slot> slots;
+
+public:
+    explicit IntentQueue(int workers = 1);
+
+    // Drops pending intents; only call between ticks
+    void setWorkerCount(int workers);
+    int getWorkerCount() const { return static_cast<int>(slots.size()); }
+
+    // Every later local() call on this thread uses the given slot
+    static void bindWorker(int worker);
+    static int boundWorker();
+
+    IntentBuffer& local();
+    IntentBuffer& buffer(int worker) { return slots[worker].buffer; }
+    size_t pending() const;
+
+    // Moves every pending intent into out (replacing its contents) in
+    // resolve order and leaves the worker buffers empty but allocated
+    void drain(std::vector<Intent>& out);
+
+    MemoryFootprint getMemoryFootprint() const;
+};
+
+#endif
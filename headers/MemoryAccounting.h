@@ -0,0 +1,82 @@
+#ifndef MEMORY_ACCOUNTING_H
+#define MEMORY_ACCOUNTING_H
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+enum class MemorySubsystem {
+    GRID,
+    ORGANISMS,
+    ORGANISM_STORE,
+    SCRATCH,
+    SOIL,
+    SCHEDULER,
+    COUNT
+};
+
+// Heap bytes and allocations owned by one object, excluding allocator overhead.
+struct MemoryFootprint {
+    uint64_t bytes;
+    uint64_t allocations;
+};
+
+struct MemoryUsage {
+    uint64_t liveBytes;
+    uint64_t peakBytes;
+    uint64_t allocations;
+    uint64_t deallocations;
+};
+
+// Live/peak byte counter for one subsystem. Owners report what they allocate
+// and free; the counters are atomics so they can be read while a tick runs.
+class MemoryAccount {
+private:
+    std::atomic<uint64_t> liveBytes;
+    std::atomic<uint64_t> peakBytes;
+    std::atomic<uint64_t> allocations;
+    std::atomic<uint64_t> deallocations;
+
+public:
+    MemoryAccount();
+
+    void charge(const MemoryFootprint& footprint);
+    void release(const MemoryFootprint& footprint);
+    MemoryUsage getUsage() const;
+    void reset();
+};
+
+class MemoryAccounting {
+private:
+    std::array<MemoryAccount, static_cast<size_t>(MemorySubsystem::COUNT)> accounts;
+
+public:
+    MemoryAccount& getAccount(MemorySubsystem subsystem);
+    MemoryUsage getUsage(MemorySubsystem subsystem) const;
+    uint64_t getTotalLiveBytes() const;
+
+    void writeTable(std::ostream& out) const;
+    void writeJson(std::ostream& out) const;
+
+    static const char* subsystemName(MemorySubsystem subsystem);
+};
+
+// Charges a scratch buffer for the lifetime of the enclosing scope.
+class ScopedMemoryCharge {
+private:
+    MemoryAccount& account;
+    MemoryFootprint footprint;
+
+public:
+    ScopedMemoryCharge(MemoryAccount& account, const MemoryFootprint& footprint)
+        : account(account), footprint(footprint) {
+        account.charge(footprint);
+    }
+    ~ScopedMemoryCharge() { account.release(footprint); }
+
+    ScopedMemoryCharge(const ScopedMemoryCharge&) = delete;
+    ScopedMemoryCharge& operator=(const ScopedMemoryCharge&) = delete;
+};
+
+#endif
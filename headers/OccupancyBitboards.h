@@ -0,0 +1,98 @@
+#ifndef OCCUPANCY_BITBOARDS_H
+#define OCCUPANCY_BITBOARDS_H
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Diet.h"
+#include "MemoryAccounting.h"
+
+// Bit-sliced neighbor counts: tile (x, y) has
+// sum(plane[i] bit << i) of its 8 neighbors set, 0..8.
+struct NeighborCounts {
+    static const int PLANES = 4;
+    size_t wordsPerRow = 0;
+    std::vector<uint64_t> planes[PLANES];
+
+    int at(int x, int y) const;
+};
+
+// One bit per tile for every food class, plus an "any occupant" layer. Rows
+// are padded to whole 64-bit words (bit x % 64 of word x / 64 is column x)
+// and the padding bits are always clear. The grid updates the layers on every
+// occupant change, which lets neighborhood questions be answered for the whole
+// world with shifts and ORs over a few words per row instead of per-tile scans.
+class OccupancyBitboards {
+public:
+    // Layer index of the occupied-tile board; classes use their own value
+    static const int LAYER_ANY = FOOD_CLASS_COUNT;
+    static const int LAYER_COUNT = FOOD_CLASS_COUNT + 1;
+
+private:
+    int width;
+    int height;
+    size_t wordsPerRow;
+    // Valid column bits of each row's last word
+    uint64_t lastWordMask;
+    std::vector<uint64_t> layers[LAYER_COUNT];
+    std::vector<uint64_t> zeroRow;
+    // Bumped on every change
+    uint64_t version;
+    // Rows changed since the derived boards were last refreshed, each listed
+    // once; a derived row reads the layer rows above and below it as well
+    mutable std::vector<uint8_t> rowChanged;
+    mutable std::vector<int> changedRows;
+
+    // Derived boards, refreshed row by row on first use after a change
+    mutable std::vector<uint64_t> emptyNeighborBoard;
+    mutable std::vector<uint64_t> adjacentFoodBoards[ANIMAL_TYPE_COUNT];
+    // Three rows of a diet's union, centered on the row being refreshed
+    mutable std::vector<uint64_t> scratch;
+    mutable uint64_t refreshedRows;
+
+    const uint64_t* rowOf(const uint64_t* board, int y) const;
+    bool testBoard(const std::vector<uint64_t>& board, int x, int y) const;
+    void markRowChanged(int y);
+    void unionRow(DietMask classes, int y, uint64_t* out) const;
+    void refreshRow(int y) const;
+
+public:
+    OccupancyBitboards(int width, int height);
+
+    // Moves tile (x, y) from one class to another. FOOD_CLASS_BORDER stands
+    // for an occupant no diet accepts: it is only on the "any occupant" layer.
+    void set(int x, int y, FoodClass before, FoodClass after);
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    size_t getWordsPerRow() const { return wordsPerRow; }
+    size_t getWordCount() const { return wordsPerRow * static_cast<size_t>(height); }
+    uint64_t getVersion() const { return version; }
+    const uint64_t* layer(int layerIndex) const { return layers[layerIndex].data(); }
+    bool test(int layerIndex, int x, int y) const;
+
+    // Whole-grid operations on boards in this layout; `out` is resized to fit
+    // OR of the class layers the diet accepts
+    void unionOf(DietMask classes, std::vector<uint64_t>& out) const;
+    // Tiles with at least one of their 8 neighbors set in `board`
+    void neighborsOf(const uint64_t* board, std::vector<uint64_t>& out) const;
+    // How many of each tile's 8 neighbors are set in `board`
+    void countNeighbors(const uint64_t* board, NeighborCounts& out) const;
+    // Set tiles in the board
+    uint64_t population(const uint64_t* board) const;
+
+    // Rebuilds the rows of the derived boards around the tiles that changed
+    // since the last call. The world calls it once per tick before the
+    // organisms update; the queries below call it too, so they are exact
+    // outside a tick as well.
+    void refreshNeighborhood() const;
+    // Derived-board rows rebuilt so far
+    uint64_t getRefreshedRows() const { return refreshedRows; }
+    // Whether a plant here could spread / an animal could move or give birth
+    bool hasEmptyNeighbor(int x, int y) const;
+    // Whether an animal of this type standing here has something to eat next to it
+    bool hasAdjacentFood(AnimalType type, int x, int y) const;
+
+    MemoryFootprint getMemoryFootprint() const;
+};
+
+#endif
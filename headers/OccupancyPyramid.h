@@ -0,0 +1,66 @@
+#ifndef OCCUPANCY_PYRAMID_H
+#define OCCUPANCY_PYRAMID_H
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Diet.h"
+#include "MemoryAccounting.h"
+
+// Mip pyramid over the grid's per-tile food classes. Level 0 is the grid
+// itself; a cell of level L covers 2^L x 2^L tiles and counts the occupants
+// of every class inside it. The grid reports each tile change, which touches
+// one cell per level, so the pyramid never has to be rebuilt and a zoomed-out
+// view reads a few cells instead of every tile.
+class OccupancyPyramid {
+public:
+    // Counted classes, i.e. every class except empty
+    static const int CLASS_SLOTS = FOOD_CLASS_COUNT - 1;
+
+private:
+    struct Level {
+        int width;
+        int height;
+        // CLASS_SLOTS counts per cell, row-major
+        std::vector<uint32_t> counts;
+    };
+
+    int width;
+    int height;
+    const FoodClass* tiles;
+    // levels[0] stays empty; level 0 reads the tiles directly
+    std::vector<Level> levels;
+
+public:
+    // occupancy is the grid's row-major food class array, which must outlive
+    // the pyramid; it is read to build the levels and for level 0 queries
+    OccupancyPyramid(int width, int height, const FoodClass* occupancy);
+
+    // Called by the grid after a tile's class changed
+    void update(int x, int y, FoodClass before, FoodClass after);
+    void rebuild();
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    // Including level 0; the last level is a single cell
+    int getLevelCount() const { return static_cast<int>(levels.size()); }
+    int getLevelWidth(int level) const;
+    int getLevelHeight(int level) const;
+
+    uint32_t getCount(int level, int x, int y, FoodClass foodClass) const;
+    uint32_t getOccupied(int level, int x, int y) const;
+    // Tiles of the world inside the cell; smaller along the far edges
+    uint32_t getCellArea(int level, int x, int y) const;
+    // Most common class among the occupants (lowest class on ties), or
+    // FOOD_CLASS_EMPTY for an empty cell
+    FoodClass getMajority(int level, int x, int y) const;
+
+    // Direct reads for renderers walking many cells. Level 0 is the tile
+    // array itself; above it every cell has CLASS_SLOTS counts, class c at
+    // slot c - 1, and cells of a row are adjacent.
+    const FoodClass* getTiles() const { return tiles; }
+    const uint32_t* cellCounts(int level, int x, int y) const;
+
+    MemoryFootprint getMemoryFootprint() const;
+};
+
+#endif
@@ -2,25 +2,31 @@
 #define ORGANISM_H
 
 #include "Position.h"
+#include "MemoryAccounting.h"
+#include "Diet.h"
+#include "Species.h"
 
 class Grid;
 class WorldManager;
 
-enum class OrganismType {
-    PLANT,
-    ANIMAL
-};
-
 class Organism {
 protected:
-    OrganismType type;
+    // Widest first so subclasses can pack their inline traits into the tail
+    Position* position;
     float nutrients;
     int age;
-    int maxLifespan;
-    Position* position;
+    uint16_t speciesId;
+    OrganismType type;
+    // Set when the world retires this organism while resolving a tick; it is
+    // deleted once the tick's intents are all applied
+    bool removed;
+
+    MemoryFootprint withPositionFootprint(uint64_t objectBytes) const;
+
+    friend class WorldManagerImpl;
 
 public:
-    Organism(OrganismType type, float nutrients, int maxLifespan);
+    Organism(OrganismType type, float nutrients, uint16_t speciesId);
     virtual ~Organism();
 
     // Non-virtual methods 
@@ -29,17 +35,28 @@ public:
     void addNutrients(float amount);
     void consumeNutrients(float amount);
     int getAge() const;
-    void incrementAge();
+    int getMaxLifespan() const;
+    uint16_t getSpeciesId() const { return speciesId; }
+    const Species& getSpecies() const { return SpeciesRegistry::get(speciesId); }
+    void incrementAge(int ticks = 1);
     bool isDead() const;
+    bool isRemoved() const { return removed; }
     
     const Position& getPosition() const;
     void setPosition(const Position& newPos);
     
     virtual void update(Grid& grid, WorldManager& worldManager) = 0;
+    // Ticks between two updates. Each update covers that many ticks of aging
+    // and metabolism, so acting less often does not slow the organism's clock.
+    virtual int getActionInterval() const { return 1; }
     virtual bool isReadyToReproduce() const = 0;
     virtual void consumeResources() = 0;
     
     virtual Organism* reproduce();
+    // Heap owned by this organism: the object itself and its position
+    virtual MemoryFootprint getMemoryFootprint() const;
+    // Class recorded on the tile this organism occupies
+    virtual FoodClass getFoodClass() const = 0;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,27 @@
+#ifndef PERCEPTION_H
+#define PERCEPTION_H
+#include <cstdint>
+#include "Position.h"
+
+class Organism;
+
+// Everything an animal looks at during one update, gathered once at the start
+// of Animal::update. Nothing on the grid changes between the perception scan
+// and the single action the animal takes, so every decision step can read it.
+struct Perception {
+    int x;
+    int y;
+    // Bit i set when FoodSearch neighbor i is on the grid and empty
+    uint8_t emptyNeighbors;
+    Organism* adjacentFood;
+    Organism* nearestFood;
+
+    bool hasEmptyNeighbor() const { return emptyNeighbors != 0; }
+    int emptyNeighborCount() const;
+    // The nth empty neighbor in neighbor order, 0 <= nth < emptyNeighborCount()
+    Position emptyNeighbor(int nth) const;
+    // The nth for which emptyNeighbor(nth) is (x, y); 0 when it is none
+    int emptyNeighborRank(int x, int y) const;
+};
+
+#endif
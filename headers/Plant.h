@@ -7,9 +7,15 @@ class Grid;
 
 class Plant : public Organism {
 private:
-    float growthRate;
-    float nutrientAbsorptionRate;
-    float spreadingThreshold;
+    // Per-plant variation on top of the shared species descriptor
+    int16_t growthRateDelta;
+    int16_t nutrientAbsorptionRateDelta;
+
+    Plant(float nutrients, uint16_t speciesId, float growthRate, float nutrientAbsorptionRate);
+
+    void setTraits(float growthRate, float nutrientAbsorptionRate);
+
+    friend class CompactOrganism;
 
 public:
     Plant(float nutrients, int maxLifespan, float growthRate, float nutrientAbsorptionRate);
@@ -23,12 +29,21 @@ public:
     void setNutrientAbsorptionRate(float rate);
     
     void update(Grid& grid, WorldManager& worldManager) override;
+    // Slow growers act rarely
+    int getActionInterval() const override;
     bool isReadyToReproduce() const override;
     void consumeResources() override;
     
     Organism* reproduce() override;
+    MemoryFootprint getMemoryFootprint() const override;
+    FoodClass getFoodClass() const override;
 
+    // Nutrients this plant tries to take from the soil each tick
+    float getAbsorptionDemand() const;
+    // Absorbs the full demand without a soil (standalone plants)
     void absorbNutrients();
+    void absorbNutrients(float amount);
+    // Queues a SPAWN intent for a random empty neighbor
     void trySpread(Grid& grid, WorldManager& worldManager);
 };
 
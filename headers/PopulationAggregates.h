@@ -0,0 +1,72 @@
+#ifndef POPULATION_AGGREGATES_H
+#define POPULATION_AGGREGATES_H
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include "Diet.h"
+#include "Species.h"
+
+class Organism;
+
+// Population totals kept up to date as organisms are added, removed and
+// changed, so every query is O(1) instead of a walk over the organisms.
+// Fields are relaxed atomics: another thread may read them while a tick runs
+// and sees each value as it was at some point during the tick; between ticks
+// all of them agree.
+//
+// Nutrients are summed in fixed point, so adding and later removing the same
+// organism cancels exactly and the totals never drift.
+class PopulationAggregates {
+public:
+    static const int NUTRIENT_BUCKETS = 16;
+    static constexpr float NUTRIENT_BUCKET_WIDTH = 2.0f;
+    static const int AGE_BUCKETS = 16;
+    static const int AGE_BUCKET_WIDTH = 10;
+    static constexpr float NUTRIENT_SCALE = 1024.0f;
+
+    // What one organism adds to the totals
+    struct Contribution {
+        FoodClass foodClass;
+        uint8_t nutrientBucket;
+        uint8_t ageBucket;
+        int64_t nutrients;
+        int64_t age;
+    };
+
+private:
+    std::array<std::atomic<int64_t>, FOOD_CLASS_COUNT> classCounts;
+    std::atomic<int64_t> nutrientTotal;
+    std::atomic<int64_t> ageTotal;
+    std::array<std::atomic<int64_t>, NUTRIENT_BUCKETS> nutrientHistogram;
+    std::array<std::atomic<int64_t>, AGE_BUCKETS> ageHistogram;
+
+    void apply(const Contribution& contribution, int64_t sign);
+
+public:
+    PopulationAggregates();
+
+    static Contribution contributionOf(const Organism& organism);
+
+    void add(const Organism& organism);
+    void remove(const Organism& organism);
+    // Moves an organism from the totals it had when `before` was taken to its
+    // current state
+    void update(const Contribution& before, const Organism& organism);
+    void clear();
+
+    int64_t getTotalCount() const;
+    int64_t getCount(OrganismType type) const;
+    int64_t getCount(AnimalType type) const;
+    double getTotalNutrients() const;
+    double getMeanNutrients() const;
+    double getMeanAge() const;
+
+    // The last bucket of each histogram is open-ended
+    int64_t getNutrientBucket(int bucket) const;
+    int64_t getAgeBucket(int bucket) const;
+    static int nutrientBucketOf(float nutrients);
+    static int ageBucketOf(int age);
+};
+
+#endif
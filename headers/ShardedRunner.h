@@ -0,0 +1,104 @@
+#ifndef SHARDED_RUNNER_H
+#define SHARDED_RUNNER_H
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "WorldManager.h"
+
+// One shard's horizontal band of a sharded world. Rows here are global; the
+// shard's own grid starts at originRow and holds its owned rows plus up to
+// haloAbove and haloBelow rows mirrored from the neighboring bands.
+struct ShardBand {
+    int shard;
+    // Owned rows are [firstRow, lastRow)
+    int firstRow;
+    int lastRow;
+    int originRow;
+    int haloAbove;
+    int haloBelow;
+
+    int getOwnedRows() const { return lastRow - firstRow; }
+    int getLocalHeight() const { return getOwnedRows() + haloAbove + haloBelow; }
+    int toLocalRow(int row) const { return row - originRow; }
+    int toGlobalRow(int localRow) const { return localRow + originRow; }
+    bool owns(int row) const { return row >= firstRow && row < lastRow; }
+};
+
+// What one shard's process did over a run
+struct ShardSummary {
+    // Living organisms when the run ended
+    uint64_t organisms;
+    // Organisms handed to a neighbor, and taken in from one
+    uint64_t emigrants;
+    uint64_t immigrants;
+    // Immigrants whose tile was taken, placed on the closest free owned tile
+    uint64_t displaced;
+    // Immigrants dropped because the band had no free tile left
+    uint64_t lost;
+    // Occupied halo tiles when the run ended, and ghost changes over the run
+    uint64_t ghosts;
+    uint64_t haloUpdates;
+    // Set by the shard's process once it has finished every tick
+    uint64_t completed;
+};
+
+// Runs one world as shardCount forked processes on the local machine, each
+// owning a horizontal band of rows. All shards advance in lockstep with one
+// process-shared barrier per tick. After its tick, each shard:
+//  - hands every organism that ended up in its halo rows to the neighbor
+//    owning that row, as a CompactOrganism plus its species descriptor;
+//  - publishes its top and bottom haloRows owned rows of food classes;
+//  - waits at the barrier, then places the neighbors' migrants in its own
+//    rows and rebuilds the ghosts in its halo rows where a class changed.
+// Halo rows show organisms near a boundary the neighbor's occupancy as of the
+// end of its update. Ghosts block moves and births onto their tiles but are
+// never food, so animals neither eat across a boundary nor stall next to prey
+// they cannot take; they hunt within their own band like anywhere else, which
+// makes a sharded world differ from an unsharded one only along the
+// boundaries. Each shard's soil only diffuses within its own grid.
+//
+// Messages for a tick go to slots picked by its parity. A shard writes tick
+// t + 2's slot only after passing tick t + 1's barrier, which its neighbors
+// reach after they are done reading tick t's, so one barrier is enough.
+class ShardedRunner {
+public:
+    // Fills a freshly built shard world. Organisms go on owned rows only, at
+    // local coordinates (see ShardBand::toLocalRow).
+    using Populate = std::function<void(WorldManager& world, const ShardBand& band)>;
+
+    static const int DEFAULT_HALO_ROWS = 8;
+
+private:
+    int width;
+    int height;
+    int shardCount;
+    int haloRows;
+    float baseNutrients;
+    std::vector<ShardSummary> summaries;
+    std::vector<uint64_t> organismsPerTick;
+
+public:
+    // Every band must be at least haloRows tall
+    ShardedRunner(int width, int height, int shardCount, int haloRows = DEFAULT_HALO_ROWS,
+                  float baseNutrients = 1.0f);
+
+    // Bands split the rows as evenly as possible, the first ones taller
+    ShardBand bandFor(int shard) const;
+    int getShardCount() const { return shardCount; }
+    int getHaloRows() const { return haloRows; }
+
+    // Forks one process per shard, runs ticks ticks and waits for all of
+    // them. Returns false if a shard failed, in which case the others are
+    // killed, or if the platform cannot share a barrier between processes.
+    // The shared TaskPool is stopped first; a world recording statistics
+    // must close them, as their writer thread cannot be paused for the fork.
+    bool run(uint64_t ticks, const Populate& populate);
+
+    // Results of the last run
+    const ShardSummary& getSummary(int shard) const { return summaries.at(shard); }
+    // Organisms over all shards after setup (index 0) and after every tick
+    const std::vector<uint64_t>& getOrganismsPerTick() const { return organismsPerTick; }
+};
+
+#endif
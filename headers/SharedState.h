@@ -0,0 +1,136 @@
+#ifndef SHARED_STATE_H
+#define SHARED_STATE_H
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Diet.h"
+
+// World state published into a POSIX shared-memory segment so viewers and
+// analyzers in other processes can map it instead of parsing console output.
+//
+// The segment starts with a SharedStateHeader, followed by a ring of
+// frameCount frames, each a SharedFrameHeader and the layers: one FoodClass
+// byte per tile (row-major) and, optionally, one float of soil nutrients per
+// tile. Every frame is guarded by its own seqlock: the writer makes the
+// sequence odd, copies the layers in and makes it even again, and a reader
+// accepts what it read only if the sequence was even and unchanged across the
+// read. The writer never waits for readers; a reader that falls a whole ring
+// behind simply fails validation and retries on the latest frame.
+
+const uint32_t SHARED_STATE_VERSION = 1;
+const uint32_t SHARED_LAYER_OCCUPANCY = 1u << 0;
+const uint32_t SHARED_LAYER_NUTRIENTS = 1u << 1;
+
+struct alignas(64) SharedStateHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t width;
+    uint32_t height;
+    uint32_t frameCount;
+    uint32_t layers;
+    uint32_t reserved;
+    uint64_t frameStride;
+    uint64_t occupancyOffset;
+    // 0 when the segment has no nutrient layer
+    uint64_t nutrientOffset;
+    // Frames published so far; the latest is (published - 1) % frameCount
+    std::atomic<uint64_t> published;
+};
+
+struct alignas(64) SharedFrameHeader {
+    std::atomic<uint64_t> sequence;
+    uint64_t tick;
+    uint64_t organisms;
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+              "Shared-memory seqlocks need lock-free 64-bit atomics");
+
+// Owns the segment: creates it on open and unlinks it on close
+class SharedStateExporter {
+private:
+    std::string name;
+    int fd;
+    unsigned char* base;
+    size_t mappedBytes;
+    SharedStateHeader* header;
+
+public:
+    SharedStateExporter();
+    ~SharedStateExporter();
+
+    SharedStateExporter(const SharedStateExporter&) = delete;
+    SharedStateExporter& operator=(const SharedStateExporter&) = delete;
+
+    // The name follows shm_open rules ("/name"). Invalid sizes throw; a
+    // segment that cannot be created warns and leaves the exporter closed.
+    bool open(const std::string& name, int width, int height, int frameCount, bool withNutrients);
+    void close();
+    bool isOpen() const { return header != nullptr; }
+
+    // Copies the layers into the next frame of the ring. nutrients is
+    // ignored when the segment has no nutrient layer.
+    void publish(uint64_t tick, uint64_t organisms, const FoodClass* occupancy, const float* nutrients);
+    uint64_t getPublishedCount() const;
+
+    static size_t segmentBytes(int width, int height, int frameCount, bool withNutrients);
+};
+
+// Points into the mapped segment; only trust the contents after validate()
+struct SharedFrameView {
+    uint64_t sequence = 0;
+    uint64_t tick = 0;
+    uint64_t organisms = 0;
+    const FoodClass* occupancy = nullptr;
+    // nullptr when the segment has no nutrient layer
+    const float* nutrients = nullptr;
+    const SharedFrameHeader* frame = nullptr;
+};
+
+struct SharedFrameCopy {
+    uint64_t tick = 0;
+    uint64_t organisms = 0;
+    std::vector<FoodClass> occupancy;
+    std::vector<float> nutrients;
+};
+
+// Maps an exporter's segment read-only
+class SharedStateReader {
+private:
+    int fd;
+    const unsigned char* base;
+    size_t mappedBytes;
+    const SharedStateHeader* header;
+
+public:
+    SharedStateReader();
+    ~SharedStateReader();
+
+    SharedStateReader(const SharedStateReader&) = delete;
+    SharedStateReader& operator=(const SharedStateReader&) = delete;
+
+    // Fails without a message if the segment does not exist yet or is not
+    // an export of this version
+    bool open(const std::string& name);
+    void close();
+    bool isOpen() const { return header != nullptr; }
+
+    int getWidth() const;
+    int getHeight() const;
+    int getFrameCount() const;
+    bool hasNutrients() const;
+    uint64_t getPublishedCount() const;
+
+    // Zero-copy access to the latest frame: fails if nothing is published or
+    // the frame is being written right now. Read through the view, then call
+    // validate(); if it fails, the data may be torn and must be discarded.
+    bool acquireLatest(SharedFrameView& view) const;
+    bool validate(const SharedFrameView& view) const;
+
+    // Copies the latest consistent frame, retrying up to `attempts` times
+    bool copyLatest(SharedFrameCopy& copy, int attempts = 16) const;
+};
+
+#endif
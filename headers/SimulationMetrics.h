@@ -0,0 +1,106 @@
+#ifndef SIMULATION_METRICS_H
+#define SIMULATION_METRICS_H
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+enum class MetricCounter {
+    BIRTHS,
+    DEATHS_STARVATION,
+    DEATHS_OLD_AGE,
+    DEATHS_PREDATION,
+    MOVES,
+    EATS,
+    FAILED_SPREADS,
+    DECOMPOSITION_SPAWNS,
+    // Intents dropped because another actor got to the tile first
+    INTENT_CONFLICTS,
+    COUNT
+};
+
+enum class MetricGauge {
+    ORGANISMS,
+    PLANTS,
+    HERBIVORES,
+    CARNIVORES,
+    OMNIVORES,
+    COUNT
+};
+
+// Event counters are split into cache-line sized shards and every thread
+// increments only the shard it was assigned on first use, so parallel ticks
+// never contend on a counter. Totals are summed over the shards on read.
+class SimulationMetrics {
+public:
+    static const size_t SHARD_COUNT = 16;
+    static const size_t COUNTER_COUNT = static_cast<size_t>(MetricCounter::COUNT);
+    static const size_t GAUGE_COUNT = static_cast<size_t>(MetricGauge::COUNT);
+
+private:
+    struct alignas(64) Shard {
+        std::array<std::atomic<uint64_t>, COUNTER_COUNT> counters;
+    };
+
+    std::array<Shard, SHARD_COUNT> shards;
+    std::array<std::atomic<int64_t>, GAUGE_COUNT> gauges;
+
+    // Written only by the thread driving the tick, read between ticks
+    uint64_t tick;
+    std::array<uint64_t, COUNTER_COUNT> totalsAtLastTick;
+    std::array<uint64_t, COUNTER_COUNT> lastTickDeltas;
+
+    static size_t shardIndex();
+
+public:
+    SimulationMetrics();
+
+    void increment(MetricCounter counter, uint64_t amount = 1) {
+        shards[shardIndex()].counters[static_cast<size_t>(counter)]
+            .fetch_add(amount, std::memory_order_relaxed);
+    }
+
+    void setGauge(MetricGauge gauge, int64_t value) {
+        gauges[static_cast<size_t>(gauge)].store(value, std::memory_order_relaxed);
+    }
+
+    uint64_t getTotal(MetricCounter counter) const;
+    int64_t getGauge(MetricGauge gauge) const;
+
+    // Closes the current tick: the events counted since the previous call
+    // become the per-tick values returned by getLastTickDelta.
+    void endTick();
+    uint64_t getTick() const { return tick; }
+    uint64_t getLastTickDelta(MetricCounter counter) const;
+    void reset();
+
+    static const char* counterName(MetricCounter counter);
+    static const char* gaugeName(MetricGauge gauge);
+};
+
+// Writes the metrics every N ticks to a Prometheus textfile (for the
+// node-exporter textfile collector) and/or appends a row to a CSV time series.
+class MetricsExporter {
+private:
+    std::string prometheusPath;
+    std::string csvPath;
+    int intervalTicks;
+    std::ofstream csvFile;
+    std::array<uint64_t, SimulationMetrics::COUNTER_COUNT> totalsAtLastRow;
+
+    void writePrometheus(const SimulationMetrics& metrics) const;
+    void appendCsvRow(const SimulationMetrics& metrics);
+
+public:
+    MetricsExporter();
+
+    void configure(const std::string& prometheusPath, const std::string& csvPath, int intervalTicks);
+    bool isEnabled() const { return intervalTicks > 0; }
+
+    void onTick(const SimulationMetrics& metrics);
+    void flush(const SimulationMetrics& metrics);
+};
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef SOIL_FIELD_H
+#define SOIL_FIELD_H
+#include <cstddef>
+#include <vector>
+#include "MemoryAccounting.h"
+
+// Per-tile soil nutrients. Every tick the field regenerates toward its
+// capacity and diffuses to the four direct neighbors (no flux across the
+// border, so diffusion alone conserves the total). Plants draw from it and
+// decomposition deposits into it. Capacity only bounds regeneration: a
+// deposit can lift the soil above it, and that surplus spreads out and stays
+// until plants draw it down.
+//
+// The step is a double-buffered 5-point stencil: rows are split into bands
+// run on the shared TaskPool for large grids, each band is walked in column
+// tiles so the three live rows stay in L1, and the interior of each row is
+// computed four floats at a time with SSE when available.
+class SoilField {
+private:
+    int width;
+    int height;
+    float capacity;
+    float diffusionRate;
+    std::vector<float> current;
+    std::vector<float> next;
+    int threadCount;
+
+    void stepRows(int firstRow, int lastRow, float regeneration);
+
+public:
+    // Columns per cache tile and the least work worth a thread of its own
+    static const int TILE_WIDTH = 2048;
+    static const size_t MIN_CELLS_PER_THREAD = size_t(1) << 16;
+
+    // diffusionRate is the fraction exchanged with each neighbor per tick and
+    // must stay at or below 0.25 for the stencil to be stable
+    SoilField(int width, int height, float initialLevel, float capacity, float diffusionRate = 0.1f);
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    float getCapacity() const { return capacity; }
+    float getDiffusionRate() const { return diffusionRate; }
+
+    float getNutrients(int x, int y) const;
+    void setNutrients(int x, int y, float amount);
+    // Removes up to amount from the tile and returns what was actually taken
+    float draw(int x, int y, float amount);
+    // Adds to the tile, beyond capacity if need be
+    void deposit(int x, int y, float amount);
+    double getTotal() const;
+    const float* data() const { return current.data(); }
+
+    // Most bands a step is split into; 0 picks std::thread::hardware_concurrency()
+    void setThreadCount(int threads);
+    int getThreadCount() const { return threadCount; }
+
+    // One tick: regenerate by up to `regeneration` without passing capacity,
+    // diffuse, and keep every tile at or above 0
+    void step(float regeneration);
+
+    MemoryFootprint getMemoryFootprint() const;
+};
+
+#endif
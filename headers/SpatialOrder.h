@@ -0,0 +1,45 @@
+#ifndef SPATIAL_ORDER_H
+#define SPATIAL_ORDER_H
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "MemoryAccounting.h"
+#include "TileLayout.h"
+
+class Organism;
+
+// Puts organism lists in the storage order of their tiles under a grid
+// layout (row-major or Z order), so walking a list walks the grid forward
+// instead of jumping across it. Sorting is a stable LSD radix sort over the
+// tile keys: a fixed number of linear passes, so its cost is bounded by the
+// list length whatever the current order.
+class SpatialOrder {
+public:
+    static const int DIGIT_BITS = 11;
+
+private:
+    struct Entry {
+        // Index of the organism's tile in the layout's storage
+        uint32_t key;
+        Organism* organism;
+    };
+
+    std::vector<Entry> entries;
+    std::vector<Entry> scratch;
+    std::vector<uint32_t> counts;
+    size_t sortCount;
+    size_t sortedOrganisms;
+
+public:
+    SpatialOrder();
+
+    void sort(std::vector<Organism*>& organisms, const TileLayout& layout);
+
+    // Lists sorted so far, and the organisms in them
+    size_t getSortCount() const { return sortCount; }
+    size_t getSortedOrganisms() const { return sortedOrganisms; }
+
+    MemoryFootprint getMemoryFootprint() const;
+};
+
+#endif
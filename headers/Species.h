@@ -0,0 +1,76 @@
+#ifndef SPECIES_H
+#define SPECIES_H
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include "Diet.h"
+
+enum class OrganismType : uint8_t {
+    PLANT,
+    ANIMAL
+};
+
+// Immutable traits shared by every organism of one species. Fields that do
+// not apply to the organism type stay zero.
+struct Species {
+    OrganismType type;
+    int maxLifespan;
+
+    AnimalType animalType;
+    int movementSpeed;
+    int visionDistance;
+    float nutrientRequirement;
+    float reproductionNutrientThreshold;
+    int mass;
+
+    float growthRate;
+    float nutrientAbsorptionRate;
+    float spreadingThreshold;
+
+    static Species animal(int maxLifespan, int movementSpeed, int visionDistance, AnimalType animalType,
+                          float nutrientRequirement, float reproductionNutrientThreshold, int mass);
+    static Species plant(int maxLifespan, float growthRate, float nutrientAbsorptionRate, float spreadingThreshold);
+
+    bool operator==(const Species& other) const;
+};
+
+// Per-individual deviation from a species value, stored inline as a signed
+// count of 1/1024 steps of that value. The range covers 0.001x to 33x the
+// species value; anything beyond saturates.
+const float TRAIT_DELTA_STEPS = 1024.0f;
+
+int16_t encodeTraitDelta(float speciesValue, float value);
+
+inline float decodeTraitDelta(float speciesValue, int16_t delta) {
+    return delta == 0 ? speciesValue : speciesValue + speciesValue * (delta / TRAIT_DELTA_STEPS);
+}
+
+// Process-wide flyweight store. Identical descriptors are interned to the
+// same 16-bit id, and descriptors never move once created, so lookups are a
+// lock-free two-level array read. Only interning takes the lock.
+class SpeciesRegistry {
+private:
+    static const int CHUNK_BITS = 8;
+    static const size_t CHUNK_SIZE = size_t(1) << CHUNK_BITS;
+    static const size_t MAX_SPECIES = size_t(1) << 16;
+
+    struct SpeciesHash {
+        size_t operator()(const Species& species) const;
+    };
+
+    static Species* chunks[MAX_SPECIES / CHUNK_SIZE];
+    static size_t count;
+    static std::mutex mutex;
+
+    static std::unordered_map<Species, uint16_t, SpeciesHash>& index();
+
+public:
+    static uint16_t intern(const Species& species);
+    static const Species& get(uint16_t id) {
+        return chunks[id >> CHUNK_BITS][id & (CHUNK_SIZE - 1)];
+    }
+    static size_t size();
+};
+
+#endif
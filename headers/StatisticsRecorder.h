@@ -0,0 +1,166 @@
+#ifndef STATISTICS_RECORDER_H
+#define STATISTICS_RECORDER_H
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "TaskPool.h"
+
+class Organism;
+class SimulationMetrics;
+
+// Per-tick population statistics, one column each
+enum class StatColumn {
+    PLANTS,
+    HERBIVORES,
+    CARNIVORES,
+    OMNIVORES,
+    NUTRIENTS_MEAN,
+    NUTRIENTS_P50,
+    NUTRIENTS_P90,
+    AGE_MEAN,
+    AGE_P50,
+    AGE_P90,
+    AGE_MAX,
+    BIRTHS,
+    DEATHS,
+    COUNT
+};
+
+enum class StatisticsFormat {
+    // Chunks of little-endian columns, see StatisticsRecorder
+    BINARY,
+    CSV
+};
+
+enum class StatisticsDownsampling {
+    // Keep one tick in every N. Births and deaths hold the sum since the
+    // previous kept row, so no event is lost.
+    EVERY_NTH,
+    // Reduce every window of N ticks to the min, max and mean of each column
+    WINDOW
+};
+
+struct StatisticsOptions {
+    StatisticsFormat format = StatisticsFormat::BINARY;
+    StatisticsDownsampling downsampling = StatisticsDownsampling::EVERY_NTH;
+    int intervalTicks = 1;
+    // Rows buffered before a chunk is handed to the writer thread
+    size_t chunkRows = 4096;
+};
+
+// A whole statistics file read back into memory
+struct StatisticsTable {
+    std::vector<std::string> names;
+    std::vector<uint64_t> ticks;
+    std::vector<std::vector<float>> columns;
+
+    // Index of the named column, or -1
+    int find(const std::string& name) const;
+};
+
+// Accumulates the statistics of every tick into column buffers and writes
+// them out a chunk at a time from a background thread, so the tick only pays
+// for filling the buffers.
+//
+// Binary layout: the magic "ECOSTATS", a uint32 version and a uint32 column
+// count, then every column name as a uint16 length and its bytes. Each chunk
+// follows as a uint32 row count, that many uint64 ticks and then that many
+// float32 values for each column in turn. Every number is little-endian,
+// whatever the host's byte order.
+class StatisticsRecorder {
+public:
+    static const size_t COLUMN_COUNT = static_cast<size_t>(StatColumn::COUNT);
+    static const uint32_t FORMAT_VERSION = 1;
+    // Filled chunks allowed to wait for the writer before record() blocks
+    static const size_t MAX_PENDING_CHUNKS = 4;
+
+    struct Sample {
+        float values[COLUMN_COUNT];
+    };
+
+private:
+    struct Chunk {
+        std::vector<uint64_t> ticks;
+        std::vector<std::vector<float>> columns;
+    };
+
+    StatisticsOptions options;
+    std::string path;
+    std::vector<std::string> columnNames;
+    bool enabled;
+
+    // Only touched by the thread driving the tick
+    Chunk filling;
+    uint64_t birthsSinceRow;
+    uint64_t deathsSinceRow;
+    uint64_t ticksInWindow;
+    uint64_t windowLastTick;
+    Sample windowMin;
+    Sample windowMax;
+    double windowSum[COLUMN_COUNT];
+    std::vector<float> nutrientScratch;
+    std::vector<float> ageScratch;
+    std::vector<uint8_t> columnScratch;
+    GrainTuner gatherGrain;
+    uint64_t rowsRecorded;
+
+    // Shared with the writer thread
+    std::mutex queueMutex;
+    std::condition_variable wakeWriter;
+    std::condition_variable wakeRecorder;
+    std::deque<Chunk> pending;
+    std::vector<Chunk> spare;
+    bool stopping;
+    std::ofstream file;
+    std::thread writer;
+
+    void buildColumnNames();
+    void writeHeader();
+    void writeChunk(const Chunk& chunk);
+    void writerLoop();
+    void appendRow(uint64_t tick, const float* values);
+    void handOff();
+    void resetWindow();
+    void emitWindow();
+
+public:
+    StatisticsRecorder();
+    ~StatisticsRecorder();
+
+    StatisticsRecorder(const StatisticsRecorder&) = delete;
+    StatisticsRecorder& operator=(const StatisticsRecorder&) = delete;
+
+    // Starts a new file, closing any previous one first. An interval below 1
+    // or an empty chunk size throws; a file that cannot be created only warns.
+    void open(const std::string& path, const StatisticsOptions& options);
+    // Writes what is buffered, including a partial window, and stops the
+    // writer thread
+    void close();
+    bool isEnabled() const { return enabled; }
+
+    // Whether the downsampling keeps anything of this tick's sample. The
+    // sample's BIRTHS and DEATHS are the events of that one tick.
+    bool needsSample(uint64_t tick) const;
+    void record(uint64_t tick, const Sample& sample);
+    // Events of a tick that was not sampled, carried into the next kept row
+    void countEvents(uint64_t births, uint64_t deaths);
+
+    // Counts events every tick and builds a full sample only on the ticks
+    // the downsampling keeps
+    void collect(uint64_t tick, const std::vector<Organism*>& organisms, const SimulationMetrics& metrics);
+    void buildSample(const std::vector<Organism*>& organisms, Sample& sample);
+
+    const std::vector<std::string>& getColumnNames() const { return columnNames; }
+    uint64_t getRowsRecorded() const { return rowsRecorded; }
+
+    static const char* columnName(StatColumn column);
+    static bool readBinary(const std::string& path, StatisticsTable& table);
+};
+
+#endif
@@ -0,0 +1,160 @@
+#ifndef TASK_POOL_H
+#define TASK_POOL_H
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Picks the chunk size of one parallel loop from how long its items took the
+// last few times. Chunks aim at TARGET_CHUNK_NANOS of work, so cheap loops
+// are not cut finer than scheduling is worth (a loop under one chunk's worth
+// runs inline), but never fewer than CHUNKS_PER_PARTICIPANT per participant
+// so the stealing has something to balance with.
+class GrainTuner {
+private:
+    // Moving average; 0 until the first measurement
+    double nanosPerItem;
+
+public:
+    static const uint64_t TARGET_CHUNK_NANOS = 50000;
+    static const size_t CHUNKS_PER_PARTICIPANT = 4;
+
+    GrainTuner() : nanosPerItem(0.0) {}
+
+    size_t grainFor(size_t count, int participants) const;
+    void record(size_t items, uint64_t nanos);
+    double getNanosPerItem() const { return nanosPerItem; }
+};
+
+// Persistent worker threads shared by everything in the simulation that runs
+// in parallel. Parallel loops are cut into chunks dealt round-robin onto one
+// deque per participant; each participant works through its own deque from
+// the front and, once it is empty, steals from the back of the others. The
+// thread that starts a loop takes part in it (as participant 0 when it is not
+// a worker) until every chunk is done, so loops can nest. Detached jobs go to
+// a separate queue that only the workers serve, behind any loop chunks.
+//
+// Idle workers spin briefly, then yield, then sleep until work arrives, so a
+// paused simulation costs no CPU. At most one thread outside the pool should
+// drive loops at a time, since all such threads share participant 0.
+class TaskPool {
+public:
+    // Runs items [begin, end) of a loop on the given participant
+    using RangeFunction = void (*)(void* body, size_t begin, size_t end, int participant);
+
+    static const int SPIN_ROUNDS = 64;
+    static const int YIELD_ROUNDS = 256;
+
+private:
+    struct RangeJob {
+        RangeFunction run;
+        void* body;
+        bool timed;
+        std::atomic<size_t> unfinished;
+        std::atomic<uint64_t> nanos;
+        // The first exception a chunk threw; the chunks after it are skipped
+        std::atomic<bool> failed;
+        std::exception_ptr error;
+    };
+
+    struct Chunk {
+        RangeJob* job;
+        size_t begin;
+        size_t end;
+    };
+
+    // Padded so neighboring participants never share the line holding a lock
+    struct alignas(64) ChunkQueue {
+        std::mutex lock;
+        std::deque<Chunk> chunks;
+    };
+
+    int workerCount;
+    std::vector<std::unique_ptr<ChunkQueue>> queues;
+    std::mutex detachedLock;
+    std::deque<std::function<void()>> detached;
+    std::vector<std::thread> workers;
+
+    // Chunks plus detached jobs waiting anywhere; sleepers wait for it to rise
+    std::atomic<size_t> queued;
+    std::mutex sleepLock;
+    std::condition_variable wake;
+    std::atomic<int> sleepers;
+    std::atomic<bool> stopping;
+    std::atomic<int> pinnedWorkers;
+    std::atomic<uint64_t> steals;
+
+    void workerLoop(int participant, bool pin);
+    bool popChunk(int participant, Chunk& chunk);
+    bool popDetached(std::function<void()>& job);
+    void runChunk(const Chunk& chunk, int participant);
+    void wakeSleepers();
+    void runRange(size_t count, size_t grain, RangeFunction run, void* body, GrainTuner* tuner);
+
+    template <typename Body>
+    static void invokeRange(void* body, size_t begin, size_t end, int participant) {
+        (*static_cast<Body*>(body))(begin, end, participant);
+    }
+
+public:
+    // 0 workers picks one less than the hardware threads, and at least one.
+    // Pinning binds the workers to cores 1, 2, ... where the platform allows
+    // it, leaving core 0 to the thread driving the tick.
+    explicit TaskPool(int workers = 0, bool pinWorkers = false);
+    // Finishes the queued detached jobs, then stops the workers
+    ~TaskPool();
+
+    TaskPool(const TaskPool&) = delete;
+    TaskPool& operator=(const TaskPool&) = delete;
+
+    // The pool used by the tick, the statistics and the frame dumper. It is
+    // never destroyed, so objects torn down at exit can still use it.
+    static TaskPool& shared();
+    // Replaces the shared pool; only call while nothing is using it
+    static void configureShared(int workers, bool pinWorkers);
+    // Finishes the shared pool's queued detached jobs and joins its workers;
+    // the next shared() starts a fresh one with the same configuration. Call
+    // this before fork(), so no worker holds a lock the child would inherit.
+    static void stopShared();
+
+    int getWorkerCount() const { return workerCount; }
+    // The workers plus the thread outside the pool that starts a loop
+    int getParticipantCount() const { return workerCount + 1; }
+    // This thread's participant number in this pool; 0 outside its workers
+    int currentParticipant() const;
+    bool isPinned() const { return pinnedWorkers.load(std::memory_order_relaxed) == workerCount; }
+    int getSleepingWorkers() const { return sleepers.load(std::memory_order_relaxed); }
+    // Chunks run by a participant other than the one they were dealt to
+    uint64_t getStealCount() const { return steals.load(std::memory_order_relaxed); }
+
+    // Runs job on some worker later; the caller tracks its completion
+    void submit(std::function<void()> job);
+
+    // Calls body(begin, end, participant) over [0, count) in chunks of grain
+    // items and returns when all of them are done. If a body throws, the
+    // chunks not yet started are skipped and the first exception is rethrown
+    // here, on the calling thread, once the running ones have finished.
+    template <typename Body>
+    void parallelFor(size_t count, size_t grain, Body&& body) {
+        using Decayed = typename std::remove_reference<Body>::type;
+        runRange(count, grain, &invokeRange<Decayed>, const_cast<void*>(static_cast<const void*>(&body)), nullptr);
+    }
+
+    // Same, with the grain picked and then refined by tuner
+    template <typename Body>
+    void parallelFor(size_t count, GrainTuner& tuner, Body&& body) {
+        using Decayed = typename std::remove_reference<Body>::type;
+        runRange(count, tuner.grainFor(count, getParticipantCount()), &invokeRange<Decayed>,
+                 const_cast<void*>(static_cast<const void*>(&body)), &tuner);
+    }
+};
+
+#endif
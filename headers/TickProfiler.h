@@ -0,0 +1,124 @@
+#ifndef TICK_PROFILER_H
+#define TICK_PROFILER_H
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+// Stages of WorldManagerImpl::update that get their own timer. The per organism
+// type entries hold the summed update time of that type within one tick.
+enum class TickPhase {
+    TICK_TOTAL,
+    ORGANISM_UPDATE,
+    RESOLVE_INTENTS,
+    REMOVE_DEAD,
+    DECOMPOSITION_SPAWN,
+    SOIL_UPDATE,
+    STATISTICS,
+    SHARED_EXPORT,
+    FRAME_DUMP,
+    NEIGHBORHOOD,
+    SPATIAL_SORT,
+    PLANT_UPDATE,
+    HERBIVORE_UPDATE,
+    CARNIVORE_UPDATE,
+    OMNIVORE_UPDATE,
+    COUNT
+};
+
+// HDR-style log-linear histogram of nanosecond samples. Every power of two is
+// split into 16 linear sub-buckets, so any recorded value is reported with a
+// relative error below ~3% while the whole range up to ~18 minutes fits in a
+// fixed array of counters.
+class LatencyHistogram {
+private:
+    static const int SUB_BUCKET_BITS = 5;
+    static const int SUB_BUCKET_HALF = 1 << (SUB_BUCKET_BITS - 1);
+    static const int MAX_MAGNITUDE = 36;
+
+    std::vector<uint64_t> buckets;
+    uint64_t totalCount;
+    uint64_t minValue;
+    uint64_t maxValue;
+    long double sum;
+
+    static size_t bucketIndex(uint64_t value);
+    static uint64_t bucketMidpoint(size_t index);
+
+public:
+    LatencyHistogram();
+
+    void record(uint64_t nanoseconds);
+    void reset();
+
+    uint64_t getCount() const { return totalCount; }
+    uint64_t getMin() const { return totalCount ? minValue : 0; }
+    uint64_t getMax() const { return maxValue; }
+    double getMean() const;
+    uint64_t getPercentile(double percentile) const;
+};
+
+class TickProfiler {
+private:
+    bool enabled;
+    std::array<LatencyHistogram, static_cast<size_t>(TickPhase::COUNT)> histograms;
+
+public:
+    TickProfiler();
+
+    void setEnabled(bool value) { enabled = value; }
+    bool isEnabled() const { return enabled; }
+
+    void record(TickPhase phase, uint64_t nanoseconds);
+    const LatencyHistogram& getHistogram(TickPhase phase) const;
+    void reset();
+
+    void writeTable(std::ostream& out) const;
+    void writeJson(std::ostream& out) const;
+
+    static const char* phaseName(TickPhase phase);
+};
+
+// Records the lifetime of the enclosing scope into one profiler phase. The
+// enabled flag is sampled once on construction so toggling mid-scope is safe.
+class ScopedPhaseTimer {
+private:
+    TickProfiler* profiler;
+    TickPhase phase;
+    std::chrono::steady_clock::time_point start;
+
+public:
+    ScopedPhaseTimer(TickProfiler& profiler, TickPhase phase)
+        : profiler(profiler.isEnabled() ? &profiler : nullptr), phase(phase) {
+        if (this->profiler) {
+            start = std::chrono::steady_clock::now();
+        }
+    }
+
+    ~ScopedPhaseTimer() {
+        if (profiler) {
+            auto elapsed = std::chrono::steady_clock::now() - start;
+            profiler->record(phase, static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+        }
+    }
+
+    ScopedPhaseTimer(const ScopedPhaseTimer&) = delete;
+    ScopedPhaseTimer& operator=(const ScopedPhaseTimer&) = delete;
+};
+
+// Building with ECOSYSTEM_PROFILING=OFF compiles every timer out of the tick.
+#ifdef ECOSYSTEM_DISABLE_PROFILING
+#define PROFILE_TICK_PHASE(profiler, phase)
+#define PROFILING_COMPILED_IN false
+#else
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_TICK_PHASE(profiler, phase) \
+    ScopedPhaseTimer PROFILE_CONCAT(phaseTimer_, __LINE__)(profiler, phase)
+#define PROFILING_COMPILED_IN true
+#endif
+
+#endif
@@ -3,10 +3,14 @@
 #include "Position.h"
 #include "Organism.h"
 
+class GridImpl;
+
 class TileImpl {
 private:
     Position position;
     Organism* organism;
+    GridImpl* grid;
+    size_t gridIndex;
 public:
     TileImpl(const Position& pos);
     ~TileImpl();
@@ -16,6 +20,9 @@ public:
     void setOccupant(const Organism& organism);
     void clearOccupant();
     Position& getPosition();
+    // Reports occupant changes to the owning grid's food class array at
+    // `index`; loose tiles are never bound
+    void bindGrid(GridImpl* owner, size_t index);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,105 @@
+#ifndef TILE_LAYOUT_H
+#define TILE_LAYOUT_H
+#include <cstddef>
+#include <vector>
+#include "MemoryAccounting.h"
+
+enum class GridLayout {
+    // Plain y * width + x
+    ROW_MAJOR,
+    // 8x8 blocks of one cache line each, the blocks in Z (Morton) order
+    BLOCKED
+};
+
+// Maps tile coordinates to positions in a per-tile array. Both layouts reduce
+// to index(x, y) = columnOffset[x] + rowOffset[y]: row-major uses x and
+// y * width; blocked splits each coordinate into its in-block part and its
+// Morton-spread block bits, which never overlap, so the same add works. When
+// the block counts differ, the shorter axis runs out of bits first and the
+// rest of the longer one goes on top, so padding stays under 2x per axis.
+class TileLayout {
+public:
+    static const int BLOCK_SHIFT = 3;
+    static const int BLOCK_SIZE = 1 << BLOCK_SHIFT;
+    static const int BLOCK_TILES = BLOCK_SIZE * BLOCK_SIZE;
+
+private:
+    GridLayout kind;
+    int width;
+    int height;
+    size_t storageSize;
+    std::vector<size_t> columnOffsets;
+    std::vector<size_t> rowOffsets;
+    // For each bit of a block's position, lowest first: whether it comes from
+    // the block's y (else x) and which bit of that coordinate it is
+    std::vector<bool> splitIsY;
+    std::vector<int> splitBit;
+
+    template <typename Visit>
+    void visitBlocks(int split, int blockX, int blockY,
+                     int firstX, int firstY, int lastX, int lastY, Visit& visit) const {
+        if (split < 0) {
+            visit(blockX << BLOCK_SHIFT, blockY << BLOCK_SHIFT);
+            return;
+        }
+        int half = 1 << splitBit[split];
+        if (splitIsY[split]) {
+            if (firstY < blockY + half) visitBlocks(split - 1, blockX, blockY, firstX, firstY, lastX, lastY, visit);
+            if (lastY >= blockY + half) visitBlocks(split - 1, blockX, blockY + half, firstX, firstY, lastX, lastY, visit);
+        } else {
+            if (firstX < blockX + half) visitBlocks(split - 1, blockX, blockY, firstX, firstY, lastX, lastY, visit);
+            if (lastX >= blockX + half) visitBlocks(split - 1, blockX + half, blockY, firstX, firstY, lastX, lastY, visit);
+        }
+    }
+
+public:
+    TileLayout(GridLayout kind, int width, int height);
+
+    GridLayout getKind() const { return kind; }
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    // Array length needed, including the padding blocks of the blocked layout
+    size_t getStorageSize() const { return storageSize; }
+
+    size_t index(int x, int y) const { return columnOffsets[x] + rowOffsets[y]; }
+    // Start of the block holding (x, y); its rows are BLOCK_SIZE apart. Only
+    // meaningful for the blocked layout.
+    size_t blockBase(int x, int y) const {
+        return index(x & ~(BLOCK_SIZE - 1), y & ~(BLOCK_SIZE - 1));
+    }
+
+    // Calls visit(x, y) with the first tile of every block overlapping the
+    // tile rectangle [x0, x1] x [y0, y1], in storage order. The blocked layout
+    // descends its Z curve and skips halves outside the rectangle, so no
+    // sorting is needed.
+    template <typename Visit>
+    void forEachBlock(int x0, int y0, int x1, int y1, Visit visit) const {
+        int firstX = x0 >> BLOCK_SHIFT;
+        int firstY = y0 >> BLOCK_SHIFT;
+        int lastX = x1 >> BLOCK_SHIFT;
+        int lastY = y1 >> BLOCK_SHIFT;
+        if (kind == GridLayout::ROW_MAJOR) {
+            for (int blockY = firstY; blockY <= lastY; ++blockY) {
+                for (int blockX = firstX; blockX <= lastX; ++blockX) {
+                    visit(blockX << BLOCK_SHIFT, blockY << BLOCK_SHIFT);
+                }
+            }
+            return;
+        }
+        visitBlocks(static_cast<int>(splitBit.size()) - 1, 0, 0, firstX, firstY, lastX, lastY, visit);
+    }
+
+    MemoryFootprint getMemoryFootprint() const;
+
+    // Copies a row-major array into this layout
+    template <typename T>
+    void scatter(const T* rowMajor, T* out) const {
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                out[index(x, y)] = rowMajor[static_cast<size_t>(y) * width + x];
+            }
+        }
+    }
+};
+
+#endif
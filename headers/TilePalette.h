@@ -0,0 +1,19 @@
+#ifndef TILE_PALETTE_H
+#define TILE_PALETTE_H
+#include <cstdint>
+#include "Diet.h"
+
+// RGB colour of each food class, shared by the viewer and the frame dumper
+inline const uint8_t TILE_PALETTE[FOOD_CLASS_COUNT][3] = {
+    {200, 200, 200},  // empty
+    {0, 255, 0},      // plant
+    {0, 0, 255},      // herbivore
+    {255, 0, 0},      // carnivore
+    {255, 0, 255},    // omnivore
+};
+
+inline const uint8_t* tileColour(FoodClass foodClass) {
+    return TILE_PALETTE[foodClass < FOOD_CLASS_COUNT ? foodClass : FOOD_CLASS_EMPTY];
+}
+
+#endif
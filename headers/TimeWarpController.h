@@ -0,0 +1,95 @@
+#ifndef TIME_WARP_CONTROLLER_H
+#define TIME_WARP_CONTROLLER_H
+#include <cstdint>
+#include <string>
+
+// Decides how many simulation ticks the viewer runs per loop, and whether the
+// loop renders.
+//
+// At a fixed multiplier the simulation runs at BASE_TICKS_PER_SECOND times
+// the multiplier; in max mode it runs as many ticks as fit in the frame.
+// The tick budget of a rendering loop is the frame interval minus the
+// measured render cost, divided by the measured cost of one tick. When more
+// ticks are owed than fit beside a render, the loop skips rendering and
+// spends the whole frame on ticks, and the rest of the debt carries forward:
+// frames are dropped, not ticks. Rendering still happens at least
+// MIN_FRAMES_PER_SECOND so the window stays live, and the debt is capped at
+// MAX_BACKLOG_SECONDS of ticks, so a world that can never keep up runs flat
+// out instead of owing an ever-growing backlog.
+class TimeWarpController {
+private:
+    double frameSeconds;
+    double multiplier;
+    bool maxSpeed;
+
+    // Exponential moving averages of measured costs, 0 until first measured
+    double tickSeconds;
+    double renderSeconds;
+
+    // Ticks owed at a fixed multiplier, carried between loops
+    double tickDebt;
+    // Wall time since the last loop that rendered
+    double sinceRender;
+    bool renderDue;
+    uint64_t skippedFrames;
+
+    // Achieved rate, refreshed every RATE_WINDOW_SECONDS of wall time
+    double windowSeconds;
+    uint64_t windowTicks;
+    double achievedTicksPerSecond;
+
+    uint64_t totalTicks;
+    uint64_t droppedTicks;
+
+    static double smooth(double average, double sample);
+
+public:
+    // The viewer's historic pace: two ticks per second at 1x
+    static constexpr double BASE_TICKS_PER_SECOND = 2.0;
+    static constexpr double MIN_MULTIPLIER = 0.25;
+    static constexpr double MAX_MULTIPLIER = 65536.0;
+    // Share of the frame the simulation may always use, even when rendering
+    // alone overruns the frame
+    static constexpr double MIN_TICK_SHARE = 0.25;
+    static constexpr double RATE_WINDOW_SECONDS = 0.5;
+    static constexpr double MIN_FRAMES_PER_SECOND = 4.0;
+    static constexpr double MAX_BACKLOG_SECONDS = 1.0;
+
+    explicit TimeWarpController(double framesPerSecond = 60.0);
+
+    double getMultiplier() const { return multiplier; }
+    // Clamped to [MIN_MULTIPLIER, MAX_MULTIPLIER]
+    void setMultiplier(double value);
+    void faster() { setMultiplier(multiplier * 2.0); }
+    void slower() { setMultiplier(multiplier / 2.0); }
+
+    bool isMaxSpeed() const { return maxSpeed; }
+    void setMaxSpeed(bool enabled);
+    void toggleMaxSpeed() { setMaxSpeed(!maxSpeed); }
+
+    // Ticks to run this loop, given the wall time since the previous call
+    int planTicks(double elapsedSeconds);
+    // Whether the loop just planned should draw a frame after its ticks
+    bool shouldRender() const { return renderDue; }
+    // Feed back what running them actually cost
+    void recordTicks(int ticks, double seconds);
+    void recordRender(double seconds);
+
+    // Wall time the simulation may use in one frame
+    double getTickBudgetSeconds() const;
+    double getTickCostSeconds() const { return tickSeconds; }
+    double getAchievedTicksPerSecond() const { return achievedTicksPerSecond; }
+    // The pace the multiplier asks for; 0 in max mode
+    double getRequestedTicksPerSecond() const;
+    double getTickDebt() const { return tickDebt; }
+    uint64_t getTotalTicks() const { return totalTicks; }
+    // Loops that ran ticks without rendering to catch up
+    uint64_t getSkippedFrames() const { return skippedFrames; }
+    // Ticks beyond the MAX_BACKLOG_SECONDS cap that were given up
+    uint64_t getDroppedTicks() const { return droppedTicks; }
+
+    // One line for the viewer's overlay, e.g. "x8  15.9/16.0 ticks/s"
+    std::string describe() const;
+};
+
+#endif
@@ -0,0 +1,95 @@
+#ifndef TIMING_WHEEL_H
+#define TIMING_WHEEL_H
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "MemoryAccounting.h"
+
+class Organism;
+
+// Hierarchical timing wheel of organisms waiting for their next action.
+// Level L has SLOTS slots of SLOTS^L ticks each; an organism sits on the
+// lowest level whose span still covers its due tick. Advancing one tick
+// empties a single level 0 slot and, when a level wraps, redistributes one
+// slot of the level above, so a tick costs O(organisms due) rather than
+// O(organisms scheduled).
+//
+// Cancelling or moving an organism leaves a null in its old slot, found
+// through the index kept with its due tick, so neither scans a slot; the
+// nulls are skipped when the slot is delivered or cascaded.
+class TimingWheel {
+public:
+    static const int SLOT_BITS = 6;
+    static const int SLOTS = 1 << SLOT_BITS;
+    static const int LEVELS = 4;
+
+private:
+    // Where an organism waits: its due tick and its index in that slot
+    struct Entry {
+        uint64_t due;
+        size_t index;
+    };
+
+    std::vector<Organism*> slots[LEVELS][SLOTS];
+    // Due further out than the top level reaches (over 16M ticks)
+    std::vector<Organism*> overflow;
+    // Due tick of every organism the wheel has seen, so it can be cancelled.
+    // Delivered organisms keep their entry as NOT_SCHEDULED, which lets the
+    // usual deliver-then-reschedule cycle run without touching the allocator.
+    std::unordered_map<const Organism*, Entry> dueTicks;
+    uint64_t now;
+    size_t scheduledCount;
+    // Reused while a slot is redistributed so cascades do not allocate
+    std::vector<Organism*> cascading;
+
+    std::vector<Organism*>* slotFor(uint64_t due);
+    void place(Organism* organism, Entry& entry);
+    void vacate(const Entry& entry);
+    void cascade(int level);
+    void reindex();
+
+public:
+    TimingWheel();
+
+    // The tick the next advance() will deliver
+    uint64_t getCurrentTick() const { return now; }
+    size_t size() const { return scheduledCount; }
+    bool isScheduled(const Organism* organism) const;
+
+    // Due `delay` ticks after the current one; 0 means the next advance().
+    // Rescheduling an organism that is already waiting moves it.
+    void schedule(Organism* organism, uint64_t delay);
+    // Also forgets the organism, so call it before the organism is deleted
+    bool cancel(const Organism* organism);
+    void clear();
+
+    // Appends the organisms due at the current tick and moves on to the next
+    // one. The order only depends on the sequence of schedule calls.
+    void advance(std::vector<Organism*>& due);
+
+    // Hands every waiting list, cleared of cancelled entries, to
+    // reorder(std::vector<Organism*>&), which may permute it but not add or
+    // remove organisms. Later deliveries follow
+    // the new order, and the due-tick index is rebuilt in that order so its
+    // lookups walk memory forward too.
+    template <typename Reorder>
+    void reorderSlots(Reorder reorder) {
+        auto visit = [&reorder](std::vector<Organism*>& slot) {
+            slot.erase(std::remove(slot.begin(), slot.end(), nullptr), slot.end());
+            if (slot.size() > 1) reorder(slot);
+        };
+        for (auto& level : slots) {
+            for (auto& slot : level) {
+                visit(slot);
+            }
+        }
+        visit(overflow);
+        reindex();
+    }
+
+    MemoryFootprint getMemoryFootprint() const;
+};
+
+#endif
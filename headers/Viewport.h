@@ -0,0 +1,74 @@
+#ifndef VIEWPORT_H
+#define VIEWPORT_H
+#include <cstdint>
+#include <vector>
+#include "OccupancyPyramid.h"
+
+// One RGBA pixel per visible cell of the chosen pyramid level, plus where the
+// block lands in the window. The viewer uploads it as a texture and stretches
+// it by cellPixels.
+struct ViewportRaster {
+    int level = 0;
+    int firstCellX = 0;
+    int firstCellY = 0;
+    int columns = 0;
+    int rows = 0;
+    // Window position of the first cell's top-left corner
+    double screenX = 0.0;
+    double screenY = 0.0;
+    // On-screen size of one cell
+    double cellPixels = 1.0;
+    std::vector<uint8_t> rgba;
+};
+
+// Pan/zoom state of the viewer window over the world. Zoomed in, only the
+// tiles inside the window are drawn; zoomed out past one tile per pixel it
+// samples the coarsest pyramid level whose cells still cover a pixel, so the
+// work per frame follows the window size rather than the world size.
+class Viewport {
+private:
+    int worldWidth;
+    int worldHeight;
+    int windowWidth;
+    int windowHeight;
+    // World coordinate (in tiles) at the window centre
+    double centerX;
+    double centerY;
+    double pixelsPerTile;
+
+    double minPixelsPerTile() const;
+    void clamp();
+
+public:
+    static constexpr double MAX_PIXELS_PER_TILE = 64.0;
+
+    Viewport(int worldWidth, int worldHeight, int windowWidth, int windowHeight, double pixelsPerTile);
+
+    void resize(int windowWidth, int windowHeight);
+    // Centres the world and zooms until all of it fits the window
+    void fitWorld();
+    // Moves the view by a distance in window pixels
+    void pan(double dx, double dy);
+    // Scales the zoom by factor while keeping the world point under the
+    // window pixel (px, py) in place
+    void zoom(double factor, double px, double py);
+
+    double getPixelsPerTile() const { return pixelsPerTile; }
+    double getCenterX() const { return centerX; }
+    double getCenterY() const { return centerY; }
+    int getWindowWidth() const { return windowWidth; }
+    int getWindowHeight() const { return windowHeight; }
+
+    double worldToScreenX(double x) const;
+    double worldToScreenY(double y) const;
+    double screenToWorldX(double px) const;
+    double screenToWorldY(double py) const;
+
+    // Finest level whose cells are at least a pixel wide
+    int selectLevel(int levelCount) const;
+    // Colours the visible cells of the selected level: the majority class
+    // faded towards the empty colour by the share of occupied tiles
+    void rasterize(const OccupancyPyramid& pyramid, ViewportRaster& raster) const;
+};
+
+#endif
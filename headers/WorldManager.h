@@ -1,11 +1,24 @@
 #ifndef WORLD_MANAGER_H
 #define WORLD_MANAGER_H
+#include <string>
 #include <vector>
 #include "Grid.h"
 #include "Organism.h"
 #include "Animal.h"
 #include "Plant.h"
 #include "Position.h"
+#include "TickProfiler.h"
+#include "SimulationMetrics.h"
+#include "CompactOrganism.h"
+#include "SoilField.h"
+#include "Intent.h"
+#include "Perception.h"
+#include "StatisticsRecorder.h"
+#include "PopulationAggregates.h"
+#include "FrameDumper.h"
+#include "OccupancyPyramid.h"
+#include "SpatialOrder.h"
+#include "TaskPool.h"
 
 class WorldManagerImpl;
 
@@ -19,6 +32,15 @@ private:
 public:
     
     static WorldManager& getInstance(int width, int height, float nutrient);
+    // Destroys the current world so the next getInstance call builds a new one
+    static void resetInstance();
+    // Forgets the current world without destroying it. A forked child calls
+    // this before building its own, so it never tears down (or unlinks) what
+    // belongs to the parent.
+    static void forgetInstanceAfterFork();
+    // Whether the current world, if there is one, has a statistics writer
+    // thread running
+    static bool isRecordingStatistics();
     
     void update();
 
@@ -27,8 +49,75 @@ public:
     void removeOrganism(Organism* organism);
     void removeOrganism(Position position);
     void spawnPlantFromDeadOrganism(Position position, float nutrients);
+    // Queues a change for the end of the tick; organisms call this from
+    // update instead of mutating the grid or the organism list directly
+    void emitIntent(IntentKind kind, Organism& actor, int x, int y);
+    // Reserves the empty tile at (x, y) for the calling organism's move or
+    // spawn this tick, so racing updates never pick the same target. A claim
+    // lost to another organism counts as an intent conflict.
+    bool claimTile(int x, int y);
+    // Claims the first free one of the empty neighbors, starting at the nth
+    // and wrapping around; the claimed tile is stored in claimed. Counts one
+    // intent conflict if every one of them was lost to another organism.
+    bool claimEmptyNeighbor(const Perception& neighborhood, int nth, Position& claimed);
     const Grid& getGrid() const;
     int getOrganismCount() const;
+    // Ticks completed so far
+    uint64_t getCurrentTick() const;
+    TickProfiler& getProfiler();
+    SimulationMetrics& getMetrics();
+    // Counts, nutrient and age totals of the living organisms, kept current by
+    // the world and safe to read from other threads
+    const PopulationAggregates& getAggregates() const;
+    const MemoryAccounting& getMemoryAccounting() const;
+    // Replaces the store's contents with a compact copy of every organism
+    void packOrganisms(CompactOrganismStore& store) const;
+    const SoilField& getSoil() const;
+    // Takes up to amount from the soil under (x, y); returns what was taken
+    float drawSoilNutrients(int x, int y, float amount);
+    void configureMetricsExport(const std::string& prometheusPath, const std::string& csvPath, int intervalTicks);
+    // Records per-tick population statistics to a file; see StatisticsRecorder
+    void configureStatistics(const std::string& path, const StatisticsOptions& options);
+    // Writes out the buffered statistics and closes the file
+    void closeStatistics();
+    // Publishes occupancy (and soil nutrients) every tick into a shared-memory
+    // ring that other processes read with SharedStateReader
+    bool configureSharedExport(const std::string& name, int frameCount, bool withNutrients);
+    // Writes an image of the grid every N ticks; see FrameDumper
+    bool configureFrameDump(const FrameDumpOptions& options);
+    // Waits for the queued frames to be written
+    void closeFrameDump();
+    const FrameDumper& getFrameDumper() const;
+    // Starts maintaining the grid's occupancy pyramid for zoomed-out views
+    const OccupancyPyramid& enableOccupancyPyramid();
+    // Switches the storage the food searches scan; see TileLayout
+    void setGridLayout(GridLayout kind);
+    // Ticks between passes that put the organism list and the update order
+    // in tile order; 0, the default, keeps insertion order
+    void setSpatialSortInterval(int ticks);
+    const SpatialOrder& getSpatialOrder() const;
+    // Updates the due organisms on the shared TaskPool. Off by default: with
+    // several threads, which of two organisms gets a contested tile depends
+    // on timing. Call between ticks, after any TaskPool::configureShared.
+    void setParallelUpdates(bool enabled);
+    bool hasParallelUpdates() const;
+    // Organisms only log their actions while updates run serially; on the
+    // pool the lines would interleave and hold the workers up on the stream
+    bool logsOrganismUpdates() const;
+
+    // Sharding support; see ShardedRunner. Rows outside [firstRow, lastRow)
+    // mirror a neighboring shard: their tiles hold ghosts, which are never
+    // updated and occupy their tiles but are never food, and organisms that
+    // end a tick there are handed over by takeEmigrants.
+    void setOwnedRows(int firstRow, int lastRow);
+    // Puts a ghost the caller keeps owning on an empty tile outside the
+    // owned rows
+    void placeGhost(Organism* ghost, int x, int y);
+    // Takes the ghost off (x, y) and returns it; nullptr if there is none
+    Organism* removeGhost(int x, int y);
+    // Detaches every organism outside the owned rows and appends it to
+    // emigrants; the caller owns them afterwards
+    void takeEmigrants(std::vector<Organism*>& emigrants);
 
     WorldManager(const WorldManager&) = delete;
     WorldManager& operator=(const WorldManager&) = delete;
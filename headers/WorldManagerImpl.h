@@ -3,17 +3,74 @@
 #include <unordered_map>
 #include <vector>
 #include <random>
+#include <string>
 #include "Grid.h"
 #include "Organism.h"
 #include "Animal.h"
 #include "Plant.h"
 #include "Position.h"
+#include "TickProfiler.h"
+#include "SimulationMetrics.h"
+#include "MemoryAccounting.h"
+#include "CompactOrganism.h"
+#include "SoilField.h"
+#include "Intent.h"
+#include "Perception.h"
+#include "TimingWheel.h"
+#include "StatisticsRecorder.h"
+#include "PopulationAggregates.h"
+#include "SharedState.h"
+#include "FrameDumper.h"
+#include "SpatialOrder.h"
+#include "TaskPool.h"
 
 class WorldManagerImpl {
 private:
     Grid* grid;
     std::vector<Organism*> organisms;
     float baseNutrientGenerationRate;
+    SoilField soil;
+    TickProfiler profiler;
+    SimulationMetrics metrics;
+    MetricsExporter metricsExporter;
+    StatisticsRecorder statistics;
+    PopulationAggregates aggregates;
+    SharedStateExporter sharedState;
+    FrameDumper frameDumper;
+    MemoryAccounting memory;
+    size_t accountedStoreCapacity;
+    IntentQueue intents;
+    // Organisms wake up at their own cadence instead of every tick
+    TimingWheel schedule;
+    std::vector<Organism*> dueOrganisms;
+    MemoryFootprint accountedSchedulerFootprint;
+    // Re-sorts the organism list and the wheel's slots by tile every
+    // spatialSortInterval ticks, so updates sweep the grid in storage order
+    SpatialOrder spatialOrder;
+    int spatialSortInterval;
+    // Organism updates run as chunks on the shared TaskPool when set
+    bool parallelUpdates;
+    GrainTuner updateGrain;
+    std::vector<PopulationAggregates::Contribution> dueContributions;
+    // Rows [ownedFirstRow, ownedLastRow) belong to this world; the rest hold
+    // ghosts mirroring a neighboring shard. The whole grid when not sharded.
+    int ownedFirstRow;
+    int ownedLastRow;
+
+    void orderSpatially();
+    void prefetchDue(size_t index) const;
+    void updateOrganisms(WorldManager& worldManager);
+    void updateOrganismsProfiled(WorldManager& worldManager);
+    void updateOrganismsParallel(WorldManager& worldManager);
+    void updatePopulationGauges();
+    void accountOrganismStore();
+    void accountScheduler();
+    void reschedule(Organism* organism);
+    // Sets lost when the tile was free but another handle claimed it first
+    bool tryClaimTile(int x, int y, bool& lost);
+    void resolveIntents();
+    void retireOrganism(Organism* organism);
+    void compactOrganisms();
 public:
     WorldManagerImpl(int width, int height, float nutrients);
     ~WorldManagerImpl();
@@ -24,9 +81,39 @@ public:
     void removeOrganism(Organism* organism);
     void removeOrganism(int x, int y);
     void spawnPlantFromDeadOrganism(int x, int y, float nutrients);
+    void emitIntent(IntentKind kind, Organism& actor, int x, int y);
+    bool claimTile(int x, int y);
+    bool claimEmptyNeighbor(const Perception& neighborhood, int nth, Position& claimed);
     const Grid& getGrid() const;
     int getOrganismCount() const;
+    uint64_t getCurrentTick() const;
+    TickProfiler& getProfiler();
+    SimulationMetrics& getMetrics();
+    const PopulationAggregates& getAggregates() const;
+    const MemoryAccounting& getMemoryAccounting() const;
+    void packOrganisms(CompactOrganismStore& store) const;
+    const SoilField& getSoil() const;
+    float drawSoilNutrients(int x, int y, float amount);
+    void configureMetricsExport(const std::string& prometheusPath, const std::string& csvPath, int intervalTicks);
+    void configureStatistics(const std::string& path, const StatisticsOptions& options);
+    void closeStatistics();
+    bool isRecordingStatistics() const;
+    bool configureSharedExport(const std::string& name, int frameCount, bool withNutrients);
+    bool configureFrameDump(const FrameDumpOptions& options);
+    void closeFrameDump();
+    const FrameDumper& getFrameDumper() const;
+    const OccupancyPyramid& enableOccupancyPyramid();
+    void setGridLayout(GridLayout kind);
+    void setSpatialSortInterval(int ticks);
+    const SpatialOrder& getSpatialOrder() const;
+    void setParallelUpdates(bool enabled);
+    bool hasParallelUpdates() const;
     void removeDeadOrganisms();
+    void setOwnedRows(int firstRow, int lastRow);
+    bool ownsRow(int y) const { return y >= ownedFirstRow && y < ownedLastRow; }
+    void placeGhost(Organism* ghost, int x, int y);
+    Organism* removeGhost(int x, int y);
+    void takeEmigrants(std::vector<Organism*>& emigrants);
 };
 
 #endif
\ No newline at end of file
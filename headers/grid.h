@@ -11,12 +11,41 @@ public:
     ~Grid();
 
     Tile& getTile(int x, int y) const;
+    // For coordinates already known to be on the grid; checked in debug
+    // builds only, see GridAccess
+    Tile& tileAt(int x, int y) const { return pImpl->tileAt<GridAccess>(x, y); }
     void setTile(int x, int y, const Tile& tile);
     Tile& findClosestEmptyTile(const Position& pos) const;
     Organism& findClosestOrganism(const Position& pos, OrganismType targetType) const;
-    bool isInBounds(int x, int y) const;
+    bool isInBounds(int x, int y) const { return pImpl->isInBounds(x, y); }
+    MemoryFootprint getMemoryFootprint() const;
     int getWidth() const { return pImpl->getWidth(); }
     int getHeight() const { return pImpl->getHeight(); }
+    const FoodClass* getFoodClasses() const { return pImpl->getFoodClasses(); }
+    // Builds the occupancy pyramid on first use; tile changes keep it current
+    const OccupancyPyramid& enableOccupancyPyramid() { return pImpl->enableOccupancyPyramid(); }
+    const OccupancyPyramid* getOccupancyPyramid() const { return pImpl->getOccupancyPyramid(); }
+    // Per-class occupancy bits with whole-grid neighborhood operations
+    const OccupancyBitboards& getBitboards() const { return pImpl->getBitboards(); }
+    // Storage order of getLayoutFoodClasses(), which the food searches read;
+    // getFoodClasses() stays row-major for exporters either way
+    void setLayout(GridLayout kind) { pImpl->setLayout(kind); }
+    const TileLayout& getLayout() const { return pImpl->getLayout(); }
+    const FoodClass* getLayoutFoodClasses() const { return pImpl->getLayoutFoodClasses(); }
+    // Occupants outside rows [firstRow, lastRow) are never found as food;
+    // see GridImpl
+    void setFoodRows(int firstRow, int lastRow) { pImpl->setFoodRows(firstRow, lastRow); }
+    int getFoodFirstRow() const { return pImpl->getFoodFirstRow(); }
+    int getFoodLastRow() const { return pImpl->getFoodLastRow(); }
+    // Row-major classes framed by FOOD_CLASS_BORDER; see GridImpl
+    const FoodClass* getHaloFoodClasses() const { return pImpl->getHaloFoodClasses(); }
+    size_t getHaloStride() const { return pImpl->getHaloStride(); }
+    // Atomic reservations of empty tiles by row-major index, for organisms
+    // racing for the same target while they update; see GridImpl
+    bool tryClaim(size_t tile, uint32_t handle) { return pImpl->tryClaim(tile, handle); }
+    bool release(size_t tile, uint32_t handle) { return pImpl->release(tile, handle); }
+    bool isClaimed(size_t tile) const { return pImpl->isClaimed(tile); }
+    void beginClaimRound() { pImpl->beginClaimRound(); }
 };
 
 #endif
\ No newline at end of file
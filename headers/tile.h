@@ -8,6 +8,7 @@ class TileImpl;
 class Tile {
 private:
     TileImpl* pImpl;
+    friend class GridImpl;
 public:
     Tile(const Position& position);
     ~Tile();
@@ -1,7 +1,10 @@
 #include "Animal.h"
 #include "Grid.h"
 #include "Plant.h"
-#include "WorldManager.h"  // ADD THIS LINE
+#include "FoodSearch.h"
+#include "WorldManager.h"
+#include <cmath>
+#include <cstdint>
 #include <cstdlib>
 #include <ctime>
 #include <vector>
@@ -9,6 +12,11 @@
 #include <random>
 #include <iostream>
 
+// An animal of speed s acts every ACTION_CADENCE_TICKS / s ticks, rounded up,
+// so the usual speed of 2 acts every tick and slower animals fall behind
+static const int ACTION_CADENCE_TICKS = 2;
+static const int MAX_ACTION_INTERVAL = 8;
+
 Animal::Animal(float nutrients, 
                int maxLifespan, 
                int movementSpeed, 
@@ -17,68 +25,123 @@ Animal::Animal(float nutrients,
                float nutrientRequirement,
                float reproductionNutrientThreshold,
                int mass)
-    : Organism(OrganismType::ANIMAL, nutrients, maxLifespan),
-      movementSpeed(movementSpeed),
-      visionDistance(visionDistance),
-      animalType(animalType),
-      nutrientRequirement(nutrientRequirement),
-      reproductionNutrientThreshold(reproductionNutrientThreshold),
-      mass(mass) {}
-
-// Getters and Setters remain the same...
-int Animal::getMovementSpeed() const { return movementSpeed; }
-int Animal::getVisionDistance() const { return visionDistance; }
-AnimalType Animal::getAnimalType() const { return animalType; }
-float Animal::getNutrientRequirement() const { return nutrientRequirement; }
-float Animal::getReproductionNutrientThreshold() const { return reproductionNutrientThreshold; }
-int Animal::getMass() const { return mass; }
-
-void Animal::setMovementSpeed(int speed) { movementSpeed = speed; }
-void Animal::setVisionDistance(int distance) { visionDistance = distance; }
-void Animal::setAnimalType(AnimalType type) { animalType = type; }
-void Animal::setNutrientRequirement(float requirement) { nutrientRequirement = requirement; }
-void Animal::setReproductionNutrientThreshold(float threshold) { reproductionNutrientThreshold = threshold; }
-void Animal::setMass(int newMass) { mass = newMass; }
+    : Organism(OrganismType::ANIMAL, nutrients,
+               SpeciesRegistry::intern(Species::animal(maxLifespan, movementSpeed, visionDistance, animalType,
+                                                       nutrientRequirement, reproductionNutrientThreshold, mass))),
+      nutrientRequirementDelta(0),
+      movementSpeedDelta(0) {}
+
+// Offspring share the parent's species and only store their own variation.
+Animal::Animal(float nutrients, uint16_t speciesId, int movementSpeed, float nutrientRequirement)
+    : Organism(OrganismType::ANIMAL, nutrients, speciesId),
+      nutrientRequirementDelta(0),
+      movementSpeedDelta(0) {
+    setTraits(movementSpeed, nutrientRequirement);
+}
+
+void Animal::setTraits(int movementSpeed, float nutrientRequirement) {
+    const Species& species = getSpecies();
+    int speedDelta = std::clamp(movementSpeed - species.movementSpeed, static_cast<int>(INT8_MIN), static_cast<int>(INT8_MAX));
+    movementSpeedDelta = static_cast<int8_t>(speedDelta);
+    nutrientRequirementDelta = encodeTraitDelta(species.nutrientRequirement, nutrientRequirement);
+}
+
+// Setters move this animal to the species with the changed trait.
+void Animal::rebindSpecies(const Species& species, int movementSpeed, float nutrientRequirement) {
+    speciesId = SpeciesRegistry::intern(species);
+    setTraits(movementSpeed, nutrientRequirement);
+}
+
+int Animal::getMovementSpeed() const { return getSpecies().movementSpeed + movementSpeedDelta; }
+int Animal::getVisionDistance() const { return getSpecies().visionDistance; }
+AnimalType Animal::getAnimalType() const { return getSpecies().animalType; }
+float Animal::getNutrientRequirement() const { return decodeTraitDelta(getSpecies().nutrientRequirement, nutrientRequirementDelta); }
+float Animal::getReproductionNutrientThreshold() const { return getSpecies().reproductionNutrientThreshold; }
+int Animal::getMass() const { return getSpecies().mass; }
+
+void Animal::setMovementSpeed(int speed) {
+    Species species = getSpecies();
+    species.movementSpeed = speed;
+    rebindSpecies(species, speed, getNutrientRequirement());
+}
+
+void Animal::setVisionDistance(int distance) {
+    Species species = getSpecies();
+    species.visionDistance = distance;
+    rebindSpecies(species, getMovementSpeed(), getNutrientRequirement());
+}
+
+void Animal::setAnimalType(AnimalType type) {
+    Species species = getSpecies();
+    species.animalType = type;
+    rebindSpecies(species, getMovementSpeed(), getNutrientRequirement());
+}
+
+void Animal::setNutrientRequirement(float requirement) {
+    Species species = getSpecies();
+    species.nutrientRequirement = requirement;
+    rebindSpecies(species, getMovementSpeed(), requirement);
+}
+
+void Animal::setReproductionNutrientThreshold(float threshold) {
+    Species species = getSpecies();
+    species.reproductionNutrientThreshold = threshold;
+    rebindSpecies(species, getMovementSpeed(), getNutrientRequirement());
+}
+
+void Animal::setMass(int newMass) {
+    Species species = getSpecies();
+    species.mass = newMass;
+    rebindSpecies(species, getMovementSpeed(), getNutrientRequirement());
+}
+
+int Animal::getActionInterval() const {
+    int speed = getMovementSpeed();
+    if (speed <= 0) return MAX_ACTION_INTERVAL;
+    return std::clamp((ACTION_CADENCE_TICKS + speed - 1) / speed, 1, MAX_ACTION_INTERVAL);
+}
 
 void Animal::update(Grid& grid, WorldManager& worldManager) {
-    consumeResources();
-    incrementAge();
+    int elapsed = getActionInterval();
+    consumeNutrients(getNutrientRequirement() * elapsed);
+    incrementAge(elapsed);
     
-    if (isReadyToReproduce()) {
-        std::vector<Position> adjacentPositions = position->getAdjacentPositions();
-        bool canReproduce = false;
-        
-        for (const auto& pos : adjacentPositions) {
-            if (grid.isInBounds(pos.getX(), pos.getY())) {
-                Tile& tile = grid.getTile(pos.getX(), pos.getY());
-                if (tile.isEmpty()) {
-                    canReproduce = true;
-                    break;
-                }
-            }
-        }
-        
-        if (canReproduce) {
-            tryReproduce(grid, worldManager);
-            return; 
-        }
+    if (isDead()) {
+        worldManager.emitIntent(IntentKind::DIE, *this, position->getX(), position->getY());
+        return;
+    }
+    
+    // One neighbor scan and one vision scan serve every step below
+    Perception perception = perceive(grid);
+    
+    if (isReadyToReproduce() && perception.hasEmptyNeighbor()) {
+        tryReproduce(worldManager, perception);
+        return; 
     }
     
-    Organism* adjacentFood = findAdjacentFood(grid);
-    if (adjacentFood) {
-        hunt(grid, worldManager); 
+    if (perception.adjacentFood) {
+        hunt(worldManager, perception); 
         return; 
     }
     
-    move(grid);
+    Position next = findBestMovePosition(perception);
+    if (next.getX() == perception.x && next.getY() == perception.y) {
+        return;
+    }
+    // Losing the best tile to another mover falls back to the empty
+    // neighbors after it
+    Position target = next;
+    if (worldManager.claimEmptyNeighbor(perception, perception.emptyNeighborRank(next.getX(), next.getY()), target)) {
+        worldManager.emitIntent(IntentKind::MOVE, *this, target.getX(), target.getY());
+    }
 }
 
 bool Animal::isReadyToReproduce() const {
-    return nutrients > reproductionNutrientThreshold;
+    return nutrients > getSpecies().reproductionNutrientThreshold;
 }
 
 void Animal::consumeResources() {
-    consumeNutrients(nutrientRequirement);
+    consumeNutrients(getNutrientRequirement());
 }
 
 Organism* Animal::reproduce() {
@@ -86,35 +149,32 @@ Organism* Animal::reproduce() {
         return nullptr;
     }
 
+    float reproductionNutrientThreshold = getReproductionNutrientThreshold();
     consumeNutrients(reproductionNutrientThreshold / 2);
 
     float nutrientVariation = 0.9f + static_cast<float>(rand()) / RAND_MAX * 0.2f;
-    int speedVariation = static_cast<int>(0.9f + static_cast<float>(rand()) / RAND_MAX * 0.2f);
+    float speedVariation = 0.9f + static_cast<float>(rand()) / RAND_MAX * 0.2f;
     
     return new Animal(
-        reproductionNutrientThreshold / 2, 
-        maxLifespan,                       
-        static_cast<int>(movementSpeed * speedVariation),
-        visionDistance,
-        animalType,
-        nutrientRequirement * nutrientVariation,
-        reproductionNutrientThreshold,
-        mass
+        reproductionNutrientThreshold / 2,
+        speciesId,
+        static_cast<int>(std::lround(getMovementSpeed() * speedVariation)),
+        getNutrientRequirement() * nutrientVariation
     );
 }
 
+MemoryFootprint Animal::getMemoryFootprint() const {
+    return withPositionFootprint(sizeof(Animal));
+}
+
+FoodClass Animal::getFoodClass() const {
+    return animalFoodClass(getSpecies().animalType);
+}
+
 bool Animal::canEat(const Organism* food) const {
     if (food == nullptr) return false;
     
-    if (animalType == AnimalType::HERBIVORE && food->getType() == OrganismType::PLANT) {
-        return true;
-    } else if (animalType == AnimalType::CARNIVORE && food->getType() == OrganismType::ANIMAL) {
-        return true;
-    } else if (animalType == AnimalType::OMNIVORE) {
-        return true;
-    }
-    
-    return false;
+    return dietAllows(dietMask(getSpecies().animalType), food->getFoodClass());
 }
 
 void Animal::eat(Organism* food) {
@@ -125,158 +185,141 @@ void Animal::eat(Organism* food) {
 }
 
 void Animal::move(Grid& grid) {
-    Position newPos = findBestMovePosition(grid);
+    move(grid, perceive(grid));
+}
+
+void Animal::move(Grid& grid, const Perception& perception) {
+    Position newPos = findBestMovePosition(perception);
     
     // Clear current tile
-    Tile& currentTile = grid.getTile(position->getX(), position->getY());
+    Tile& currentTile = grid.tileAt(position->getX(), position->getY());
     currentTile.clearOccupant();
     
     // Move to new position
     setPosition(newPos);
     
     // Occupy new tile
-    Tile& newTile = grid.getTile(newPos.getX(), newPos.getY());
+    Tile& newTile = grid.tileAt(newPos.getX(), newPos.getY());
     newTile.setOccupant(*this);
 }
 
 void Animal::hunt(Grid& grid, WorldManager& worldManager) {
-    Organism* nearestFood = findNearestFood(grid);
+    hunt(worldManager, perceive(grid));
+}
+
+void Animal::hunt(WorldManager& worldManager, const Perception& perception) {
+    Organism* nearestFood = perception.nearestFood;
     
     if (nearestFood) {
         int distance = position->distanceToPoint(nearestFood->getPosition());
         
-        // If food is adjacent, eat it
+        // If food is adjacent, eat it once the tick resolves
         if (distance <= 1) {
-            eat(nearestFood);
-            
-            // Remove eaten organism from grid and world manager
-            Position foodPos = nearestFood->getPosition();
-            worldManager.removeOrganism(foodPos);
+            const Position& foodPos = nearestFood->getPosition();
+            worldManager.emitIntent(IntentKind::EAT, *this, foodPos.getX(), foodPos.getY());
         }
     }
 }
 
-Position Animal::findBestMovePosition(Grid& grid) {
-    std::vector<Position> adjacentPositions = position->getAdjacentPositions();
-    std::vector<Position> validPositions;
+Perception Animal::perceive(const Grid& grid) const {
+    const Species& species = getSpecies();
+    Perception perception;
+    perception.x = position->getX();
+    perception.y = position->getY();
+    // The tick's neighborhood boards rule most tiles out before any scan
+    const OccupancyBitboards& bitboards = grid.getBitboards();
+    perception.emptyNeighbors = bitboards.hasEmptyNeighbor(perception.x, perception.y)
+        ? FoodSearch::emptyNeighborMask(grid, perception.x, perception.y) : 0;
     
-    // Filter for positions that are within bounds AND empty
-    for (const auto& pos : adjacentPositions) {
-        if (grid.isInBounds(pos.getX(), pos.getY())) {
-            Tile& tile = grid.getTile(pos.getX(), pos.getY());
-            if (tile.isEmpty()) {
-                validPositions.push_back(pos);
-            }
-        }
-    }
-    
-    if (validPositions.empty()) {
+    int width = grid.getWidth();
+    int adjacent = bitboards.hasAdjacentFood(species.animalType, perception.x, perception.y)
+        ? FoodSearch::adjacentFood(species.animalType, grid, perception.x, perception.y) : -1;
+    perception.adjacentFood = adjacent < 0 ? nullptr : grid.tileAt(adjacent % width, adjacent / width).getOccupant();
+    int nearest = FoodSearch::nearestFood(species.animalType, grid, perception.x, perception.y, species.visionDistance);
+    perception.nearestFood = nearest < 0 ? nullptr : grid.tileAt(nearest % width, nearest / width).getOccupant();
+    return perception;
+}
+
+Position Animal::findBestMovePosition(Grid& grid) {
+    return findBestMovePosition(perceive(grid));
+}
+
+Position Animal::findBestMovePosition(const Perception& perception) const {
+    int validCount = perception.emptyNeighborCount();
+    if (validCount == 0) {
         return *position; // Stay in place if no valid moves
     }
     
     // Try to move towards food
-    Organism* nearestFood = findNearestFood(grid);
-    if (nearestFood) {
-        Position foodPos = nearestFood->getPosition();
+    if (perception.nearestFood) {
+        const Position& foodPos = perception.nearestFood->getPosition();
         
-        // Find the position that gets us closest to food
-        Position bestPos = validPositions[0];
-        int shortestDistance = bestPos.distanceToPoint(foodPos);
-        
-        for (const auto& pos : validPositions) {
-            int distance = pos.distanceToPoint(foodPos);
-            if (distance < shortestDistance) {
+        // First empty neighbor that gets us closest to food
+        int bestIndex = -1;
+        int shortestDistance = 0;
+        for (int i = 0; i < FoodSearch::NEIGHBOR_COUNT; ++i) {
+            if (!(perception.emptyNeighbors & (1u << i))) continue;
+            int dx = foodPos.getX() - (perception.x + FoodSearch::NEIGHBOR_OFFSET_X[i]);
+            int dy = foodPos.getY() - (perception.y + FoodSearch::NEIGHBOR_OFFSET_Y[i]);
+            int distance = static_cast<int>(std::sqrt(static_cast<double>(dx * dx + dy * dy)));
+            if (bestIndex < 0 || distance < shortestDistance) {
                 shortestDistance = distance;
-                bestPos = pos;
+                bestIndex = i;
             }
         }
         
-        return bestPos;
+        return Position(perception.x + FoodSearch::NEIGHBOR_OFFSET_X[bestIndex],
+                        perception.y + FoodSearch::NEIGHBOR_OFFSET_Y[bestIndex]);
     }
     
     // Random movement if no food found
     std::random_device rd;
     std::mt19937 gen(rd());
-    std::uniform_int_distribution<> dis(0, validPositions.size() - 1);
+    std::uniform_int_distribution<> dis(0, validCount - 1);
     
-    return validPositions[dis(gen)];
+    return perception.emptyNeighbor(dis(gen));
 }
 
 void Animal::tryReproduce(Grid& grid, WorldManager& worldManager) {
+    tryReproduce(worldManager, perceive(grid));
+}
+
+void Animal::tryReproduce(WorldManager& worldManager, const Perception& perception) {
     if (!isReadyToReproduce()) {
         return; // Early exit if not ready
     }
     
-    std::vector<Position> adjacentPositions = position->getAdjacentPositions();
-    std::vector<Position> validPositions;
-    
-    for (const auto& pos : adjacentPositions) {
-        if (grid.isInBounds(pos.getX(), pos.getY())) {
-            Tile& tile = grid.getTile(pos.getX(), pos.getY());
-            if (tile.isEmpty()) {
-                validPositions.push_back(pos);
-            }
-        }
-    }
-    
-    if (!validPositions.empty()) {
+    int validCount = perception.emptyNeighborCount();
+    if (validCount > 0) {
         std::random_device rd;
         std::mt19937 gen(rd());
-        std::uniform_int_distribution<> dis(0, validPositions.size() - 1);
-        
-        Position birthPos = validPositions[dis(gen)];
-        Animal* offspring = dynamic_cast<Animal*>(reproduce());
+        std::uniform_int_distribution<> dis(0, validCount - 1);
         
-        if (offspring) {
-            worldManager.addOrganism(offspring, birthPos);
-            std::cout << "Animal reproduced at (" << birthPos.getX() << ", " << birthPos.getY() << ")" << std::endl;
+        // The offspring is only created once the spawn resolves
+        Position birthPos = perception.emptyNeighbor(0);
+        if (!worldManager.claimEmptyNeighbor(perception, dis(gen), birthPos)) {
+            return;
+        }
+        worldManager.emitIntent(IntentKind::SPAWN, *this, birthPos.getX(), birthPos.getY());
+        if (worldManager.logsOrganismUpdates()) {
+            std::cout << "Animal wants to reproduce at (" << birthPos.getX() << ", " << birthPos.getY() << ")" << std::endl;
         }
     }
 }
 
 Organism* Animal::findNearestFood(Grid& grid) {
-    Organism* nearestFood = nullptr;
-    int shortestDistance = visionDistance + 1;
-    
-    // Search within vision distance
-    for (int dy = -visionDistance; dy <= visionDistance; ++dy) {
-        for (int dx = -visionDistance; dx <= visionDistance; ++dx) {
-            int checkX = position->getX() + dx;
-            int checkY = position->getY() + dy;
-            
-            if (grid.isInBounds(checkX, checkY)) {
-                Tile& tile = grid.getTile(checkX, checkY);
-                if (!tile.isEmpty()) {
-                    Organism* organism = tile.getOccupant();
-                    if (canEat(organism)) {
-                        int distance = position->distanceToPoint(organism->getPosition());
-                        if (distance < shortestDistance) {
-                            shortestDistance = distance;
-                            nearestFood = organism;
-                        }
-                    }
-                }
-            }
-        }
+    const Species& species = getSpecies();
+    int index = FoodSearch::nearestFood(species.animalType, grid, position->getX(), position->getY(), species.visionDistance);
+    if (index < 0) {
+        return nullptr;
     }
-    
-    return nearestFood;
+    return grid.tileAt(index % grid.getWidth(), index / grid.getWidth()).getOccupant();
 }
 
 Organism* Animal::findAdjacentFood(Grid& grid) {
-    std::vector<Position> adjacentPositions = position->getAdjacentPositions();
-    
-    for (const auto& pos : adjacentPositions) {
-        if (grid.isInBounds(pos.getX(), pos.getY())) {
-            Tile& tile = grid.getTile(pos.getX(), pos.getY());
-            if (!tile.isEmpty()) {
-                Organism* organism = tile.getOccupant();
-                if (canEat(organism)) {
-                    return organism;
-                }
-            }
-        }
+    int index = FoodSearch::adjacentFood(getSpecies().animalType, grid, position->getX(), position->getY());
+    if (index < 0) {
+        return nullptr;
     }
-    
-    return nullptr;
+    return grid.tileAt(index % grid.getWidth(), index / grid.getWidth()).getOccupant();
 }
\ No newline at end of file
@@ -0,0 +1,117 @@
+#include "CompactOrganism.h"
+#include "Animal.h"
+#include "Plant.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+const float CompactOrganism::MINOR_TRAIT_STEPS = 64.0f;
+
+int32_t CompactOrganism::toFixed(float value) {
+    double scaled = std::round(static_cast<double>(value) * (1 << NUTRIENT_FRACTION_BITS));
+    if (scaled <= 0.0) return 0;
+    if (scaled >= static_cast<double>(NUTRIENT_MAX)) return NUTRIENT_MAX;
+    return static_cast<int32_t>(scaled);
+}
+
+float CompactOrganism::fromFixed(int32_t value) {
+    return static_cast<float>(static_cast<double>(value) / (1 << NUTRIENT_FRACTION_BITS));
+}
+
+CompactOrganism::CompactOrganism()
+    : tag(0), minorTrait(0), species(0), age(0), majorTrait(0), nutrients(0), tile(0) {}
+
+CompactOrganism CompactOrganism::pack(const Organism& organism, int gridWidth) {
+    CompactOrganism compact;
+    const Species& species = organism.getSpecies();
+    compact.species = organism.getSpeciesId();
+    compact.age = static_cast<uint16_t>(min(max(organism.getAge(), 0), static_cast<int>(UINT16_MAX)));
+    compact.nutrients = toFixed(organism.getNutrients());
+
+    if (organism.getType() == OrganismType::ANIMAL) {
+        const Animal& animal = static_cast<const Animal&>(organism);
+        compact.tag = TYPE_ANIMAL_BIT;
+        compact.majorTrait = encodeTraitDelta(species.nutrientRequirement, animal.getNutrientRequirement());
+        compact.minorTrait = static_cast<int8_t>(clamp(animal.getMovementSpeed() - species.movementSpeed,
+                                                       static_cast<int>(INT8_MIN), static_cast<int>(INT8_MAX)));
+    } else {
+        const Plant& plant = static_cast<const Plant&>(organism);
+        compact.majorTrait = encodeTraitDelta(species.growthRate, plant.getGrowthRate());
+        if (species.nutrientAbsorptionRate != 0.0f) {
+            long steps = lround((plant.getNutrientAbsorptionRate() / species.nutrientAbsorptionRate - 1.0f) * MINOR_TRAIT_STEPS);
+            compact.minorTrait = static_cast<int8_t>(clamp(steps, -static_cast<long>(MINOR_TRAIT_STEPS) + 1, static_cast<long>(INT8_MAX)));
+        }
+    }
+
+    if (gridWidth > 0) {
+        compact.setPosition(organism.getPosition(), gridWidth);
+    }
+    return compact;
+}
+
+Organism* CompactOrganism::unpack(int gridWidth) const {
+    Organism* organism;
+    if (getType() == OrganismType::ANIMAL) {
+        Animal* animal = new Animal(getNutrients(), species, getMovementSpeed(), getNutrientRequirement());
+        animal->age = age;
+        organism = animal;
+    } else {
+        Plant* plant = new Plant(getNutrients(), species, getGrowthRate(), getNutrientAbsorptionRate());
+        plant->age = age;
+        organism = plant;
+    }
+    organism->setPosition(getPosition(gridWidth));
+    return organism;
+}
+
+void CompactOrganism::addNutrients(float amount) {
+    int64_t sum = static_cast<int64_t>(nutrients) + (amount >= 0 ? toFixed(amount) : -toFixed(-amount));
+    nutrients = static_cast<int32_t>(clamp<int64_t>(sum, 0, NUTRIENT_MAX));
+}
+
+void CompactOrganism::consumeNutrients(float amount) {
+    addNutrients(-amount);
+}
+
+Position CompactOrganism::getPosition(int gridWidth) const {
+    return Position(static_cast<int>(tile % static_cast<uint32_t>(gridWidth)),
+                    static_cast<int>(tile / static_cast<uint32_t>(gridWidth)));
+}
+
+void CompactOrganism::setPosition(const Position& position, int gridWidth) {
+    tile = static_cast<uint32_t>(position.getY()) * static_cast<uint32_t>(gridWidth)
+         + static_cast<uint32_t>(position.getX());
+}
+
+FoodClass CompactOrganism::getFoodClass() const {
+    return getType() == OrganismType::ANIMAL ? animalFoodClass(getSpecies().animalType) : FOOD_CLASS_PLANT;
+}
+
+void CompactOrganism::consumeResources() {
+    if (getType() == OrganismType::ANIMAL) {
+        consumeNutrients(getNutrientRequirement());
+    }
+}
+
+float CompactOrganism::getNutrientAbsorptionRate() const {
+    float base = getSpecies().nutrientAbsorptionRate;
+    return minorTrait == 0 ? base : base + base * (minorTrait / MINOR_TRAIT_STEPS);
+}
+
+void CompactOrganismStore::removeAt(size_t index) {
+    records[index] = records.back();
+    records.pop_back();
+}
+
+size_t CompactOrganismStore::removeDead() {
+    size_t before = records.size();
+    records.erase(remove_if(records.begin(), records.end(),
+                            [](const CompactOrganism& organism) { return organism.isRemoved() || organism.isDead(); }),
+                  records.end());
+    return before - records.size();
+}
+
+MemoryFootprint CompactOrganismStore::getMemoryFootprint() const {
+    return {records.capacity() * sizeof(CompactOrganism), records.capacity() > 0 ? 1u : 0u};
+}
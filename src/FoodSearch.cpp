@@ -0,0 +1,67 @@
+#include "FoodSearch.h"
+#include "Grid.h"
+#include <array>
+#include <utility>
+
+using namespace std;
+
+namespace {
+
+// One kernel per DIET_TABLE row, built at compile time, so a new animal type
+// only needs its diet row.
+template <size_t... Types>
+constexpr array<FoodSearch::NearestFoodKernel, sizeof...(Types)> makeNearestKernels(index_sequence<Types...>) {
+    return {{&FoodSearch::nearestFood<DIET_TABLE[Types]>...}};
+}
+
+template <size_t... Types>
+constexpr array<FoodSearch::HaloAdjacentFoodKernel, sizeof...(Types)> makeHaloAdjacentKernels(index_sequence<Types...>) {
+    return {{&FoodSearch::adjacentFoodHalo<DIET_TABLE[Types]>...}};
+}
+
+template <size_t... Types>
+constexpr array<FoodSearch::BlockedNearestFoodKernel, sizeof...(Types)> makeBlockedNearestKernels(index_sequence<Types...>) {
+    return {{&FoodSearch::nearestFoodBlocked<DIET_TABLE[Types]>...}};
+}
+
+template <size_t... Types>
+constexpr array<FoodSearch::BlockedAdjacentFoodKernel, sizeof...(Types)> makeBlockedAdjacentKernels(index_sequence<Types...>) {
+    return {{&FoodSearch::adjacentFoodBlocked<DIET_TABLE[Types]>...}};
+}
+
+constexpr auto nearestKernels = makeNearestKernels(make_index_sequence<ANIMAL_TYPE_COUNT>());
+constexpr auto haloAdjacentKernels = makeHaloAdjacentKernels(make_index_sequence<ANIMAL_TYPE_COUNT>());
+constexpr auto blockedNearestKernels = makeBlockedNearestKernels(make_index_sequence<ANIMAL_TYPE_COUNT>());
+constexpr auto blockedAdjacentKernels = makeBlockedAdjacentKernels(make_index_sequence<ANIMAL_TYPE_COUNT>());
+
+}
+
+int FoodSearch::nearestFood(AnimalType type, const Grid& grid, int x, int y, int vision) {
+    const TileLayout& layout = grid.getLayout();
+    if (layout.getKind() == GridLayout::BLOCKED) {
+        return blockedNearestKernels[static_cast<size_t>(type)](grid.getLayoutFoodClasses(), layout, x, y, vision);
+    }
+    // getFoodClasses() keeps the classes of the rows that are not food, so
+    // the scan only covers the food rows
+    int firstRow = grid.getFoodFirstRow();
+    size_t offset = static_cast<size_t>(firstRow) * grid.getWidth();
+    int nearest = nearestKernels[static_cast<size_t>(type)](grid.getFoodClasses() + offset, grid.getWidth(),
+                                                            grid.getFoodLastRow() - firstRow, x, y - firstRow, vision);
+    return nearest < 0 ? -1 : nearest + static_cast<int>(offset);
+}
+
+int FoodSearch::adjacentFood(AnimalType type, const Grid& grid, int x, int y) {
+    const TileLayout& layout = grid.getLayout();
+    if (layout.getKind() == GridLayout::BLOCKED) {
+        return blockedAdjacentKernels[static_cast<size_t>(type)](grid.getLayoutFoodClasses(), layout, x, y);
+    }
+    return haloAdjacentKernels[static_cast<size_t>(type)](grid.getHaloFoodClasses(), grid.getHaloStride(), grid.getWidth(), x, y);
+}
+
+uint8_t FoodSearch::emptyNeighborMask(const Grid& grid, int x, int y) {
+    const TileLayout& layout = grid.getLayout();
+    if (layout.getKind() == GridLayout::BLOCKED) {
+        return emptyNeighborMaskBlocked(grid.getLayoutFoodClasses(), layout, x, y);
+    }
+    return emptyNeighborMaskHalo(grid.getHaloFoodClasses(), grid.getHaloStride(), x, y);
+}
@@ -0,0 +1,315 @@
+#include "FrameDumper.h"
+#include "TilePalette.h"
+#include "TaskPool.h"
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+using namespace std;
+
+// Largest payload of one stored deflate block
+static const size_t STORED_BLOCK_BYTES = 65535;
+
+// Slicing-by-8 tables: table[k][b] is the CRC of byte b followed by k zero
+// bytes, so eight input bytes are folded per step instead of one
+using CrcTables = array<array<uint32_t, 256>, 8>;
+
+static const CrcTables& crcTables() {
+    static const CrcTables tables = []() {
+        CrcTables entries{};
+        for (uint32_t n = 0; n < 256; ++n) {
+            uint32_t c = n;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1u) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            entries[0][n] = c;
+        }
+        for (uint32_t n = 0; n < 256; ++n) {
+            for (int k = 1; k < 8; ++k) {
+                entries[k][n] = entries[0][entries[k - 1][n] & 0xFFu] ^ (entries[k - 1][n] >> 8);
+            }
+        }
+        return entries;
+    }();
+    return tables;
+}
+
+static uint32_t crc32Update(uint32_t crc, const uint8_t* data, size_t length) {
+    const CrcTables& t = crcTables();
+    while (length >= 8) {
+        uint32_t low = crc ^ (uint32_t(data[0]) | uint32_t(data[1]) << 8 |
+                              uint32_t(data[2]) << 16 | uint32_t(data[3]) << 24);
+        crc = t[7][low & 0xFFu] ^ t[6][(low >> 8) & 0xFFu] ^
+              t[5][(low >> 16) & 0xFFu] ^ t[4][low >> 24] ^
+              t[3][data[4]] ^ t[2][data[5]] ^ t[1][data[6]] ^ t[0][data[7]];
+        data += 8;
+        length -= 8;
+    }
+    for (size_t i = 0; i < length; ++i) {
+        crc = t[0][(crc ^ data[i]) & 0xFFu] ^ (crc >> 8);
+    }
+    return crc;
+}
+
+// Sums are reduced every 5552 bytes, the most that cannot overflow 32 bits
+static uint32_t adler32(const uint8_t* data, size_t length) {
+    uint32_t a = 1;
+    uint32_t b = 0;
+    while (length > 0) {
+        size_t run = min<size_t>(length, 5552);
+        for (size_t i = 0; i < run; ++i) {
+            a += data[i];
+            b += a;
+        }
+        a %= 65521u;
+        b %= 65521u;
+        data += run;
+        length -= run;
+    }
+    return (b << 16) | a;
+}
+
+static void appendBigEndian(vector<uint8_t>& out, uint32_t value) {
+    out.push_back(static_cast<uint8_t>(value >> 24));
+    out.push_back(static_cast<uint8_t>(value >> 16));
+    out.push_back(static_cast<uint8_t>(value >> 8));
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+// Length, type and data, then the CRC over type and data
+static void appendPngChunk(vector<uint8_t>& out, const char type[4], const uint8_t* data, size_t length) {
+    appendBigEndian(out, static_cast<uint32_t>(length));
+    size_t typeStart = out.size();
+    out.insert(out.end(), type, type + 4);
+    out.insert(out.end(), data, data + length);
+    uint32_t crc = crc32Update(0xFFFFFFFFu, out.data() + typeStart, length + 4) ^ 0xFFFFFFFFu;
+    appendBigEndian(out, crc);
+}
+
+// Writes every pixel row of the scaled image to `pixels`, each preceded by
+// `rowPrefix` bytes that are left for the caller (PNG's filter byte)
+static void renderRows(int width, int height, int scale, const FoodClass* occupancy,
+                       size_t rowPrefix, uint8_t* pixels) {
+    size_t rowBytes = static_cast<size_t>(width) * scale * 3;
+    size_t stride = rowPrefix + rowBytes;
+    for (int y = 0; y < height; ++y) {
+        uint8_t* first = pixels + static_cast<size_t>(y) * scale * stride;
+        uint8_t* out = first + rowPrefix;
+        const FoodClass* row = occupancy + static_cast<size_t>(y) * width;
+        for (int x = 0; x < width; ++x) {
+            const uint8_t* colour = tileColour(row[x]);
+            for (int s = 0; s < scale; ++s) {
+                out[0] = colour[0];
+                out[1] = colour[1];
+                out[2] = colour[2];
+                out += 3;
+            }
+        }
+        // The other rows of the tile block repeat the first
+        for (int s = 1; s < scale; ++s) {
+            memcpy(first + static_cast<size_t>(s) * stride, first, stride);
+        }
+    }
+}
+
+void FrameDumper::encode(FrameFormat format, int width, int height, int scale,
+                         const FoodClass* occupancy, vector<uint8_t>& out) {
+    out.clear();
+    size_t pixelWidth = static_cast<size_t>(width) * scale;
+    size_t pixelHeight = static_cast<size_t>(height) * scale;
+
+    if (format == FrameFormat::PPM) {
+        char header[64];
+        int headerLength = snprintf(header, sizeof(header), "P6\n%zu %zu\n255\n", pixelWidth, pixelHeight);
+        out.resize(static_cast<size_t>(headerLength) + pixelWidth * pixelHeight * 3);
+        memcpy(out.data(), header, static_cast<size_t>(headerLength));
+        renderRows(width, height, scale, occupancy, 0, out.data() + headerLength);
+        return;
+    }
+
+    // Filtered rows as PNG expects them: a 0 (no filter) byte, then RGB
+    thread_local vector<uint8_t> raw;
+    size_t stride = 1 + pixelWidth * 3;
+    raw.resize(stride * pixelHeight);
+    renderRows(width, height, scale, occupancy, 1, raw.data());
+    for (size_t row = 0; row < pixelHeight; ++row) {
+        raw[row * stride] = 0;
+    }
+
+    size_t blocks = max<size_t>(1, (raw.size() + STORED_BLOCK_BYTES - 1) / STORED_BLOCK_BYTES);
+    out.reserve(8 + 25 + 12 + 2 + raw.size() + blocks * 5 + 4 + 12);
+
+    static const uint8_t SIGNATURE[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    out.insert(out.end(), SIGNATURE, SIGNATURE + 8);
+
+    uint8_t ihdr[13];
+    for (int i = 0; i < 4; ++i) {
+        ihdr[i] = static_cast<uint8_t>(pixelWidth >> (24 - 8 * i));
+        ihdr[4 + i] = static_cast<uint8_t>(pixelHeight >> (24 - 8 * i));
+    }
+    ihdr[8] = 8;   // bits per channel
+    ihdr[9] = 2;   // truecolour
+    ihdr[10] = 0;  // deflate
+    ihdr[11] = 0;  // adaptive filtering
+    ihdr[12] = 0;  // no interlace
+    appendPngChunk(out, "IHDR", ihdr, sizeof(ihdr));
+
+    // IDAT is assembled in place: zlib header, stored blocks, Adler-32
+    size_t lengthAt = out.size();
+    appendBigEndian(out, 0);
+    size_t typeStart = out.size();
+    out.insert(out.end(), {'I', 'D', 'A', 'T', 0x78, 0x01});
+    for (size_t offset = 0, block = 0; block < blocks; ++block) {
+        size_t length = min(STORED_BLOCK_BYTES, raw.size() - offset);
+        bool last = block + 1 == blocks;
+        out.push_back(last ? 1 : 0);
+        out.push_back(static_cast<uint8_t>(length));
+        out.push_back(static_cast<uint8_t>(length >> 8));
+        out.push_back(static_cast<uint8_t>(~length));
+        out.push_back(static_cast<uint8_t>(~length >> 8));
+        out.insert(out.end(), raw.begin() + offset, raw.begin() + offset + length);
+        offset += length;
+    }
+    appendBigEndian(out, adler32(raw.data(), raw.size()));
+    uint32_t dataLength = static_cast<uint32_t>(out.size() - typeStart - 4);
+    for (int i = 0; i < 4; ++i) {
+        out[lengthAt + i] = static_cast<uint8_t>(dataLength >> (24 - 8 * i));
+    }
+    appendBigEndian(out, crc32Update(0xFFFFFFFFu, out.data() + typeStart, dataLength + 4) ^ 0xFFFFFFFFu);
+
+    appendPngChunk(out, "IEND", nullptr, 0);
+}
+
+FrameDumper::FrameDumper()
+    : enabled(false), activeDrains(0), framesWritten(0), framesDropped(0), writeFailures(0) { }
+
+FrameDumper::~FrameDumper() {
+    close();
+}
+
+bool FrameDumper::open(const FrameDumpOptions& newOptions) {
+    if (newOptions.intervalTicks < 1) {
+        throw invalid_argument("Frame dump interval must be at least one tick");
+    }
+    if (newOptions.scale < 1) {
+        throw invalid_argument("Frame dump scale must be at least 1");
+    }
+    if (newOptions.workers < 1) {
+        throw invalid_argument("Frame dump needs at least one worker");
+    }
+    close();
+
+    error_code error;
+    filesystem::create_directories(newOptions.directory, error);
+    if (error || !filesystem::is_directory(newOptions.directory)) {
+        cerr << "Warning: Cannot create frame directory " << newOptions.directory << endl;
+        return false;
+    }
+
+    options = newOptions;
+    options.maxQueuedFrames = max<size_t>(options.maxQueuedFrames, 1);
+    framesWritten.store(0, memory_order_relaxed);
+    framesDropped.store(0, memory_order_relaxed);
+    writeFailures.store(0, memory_order_relaxed);
+    enabled = true;
+    return true;
+}
+
+// A drain only finishes once it has found the queue empty, so no queued
+// frame is lost
+void FrameDumper::close() {
+    if (!enabled) return;
+    unique_lock<mutex> lock(queueMutex);
+    drainsFinished.wait(lock, [this]() { return activeDrains == 0; });
+    spareBuffers.clear();
+    enabled = false;
+}
+
+bool FrameDumper::wantsTick(uint64_t tick) const {
+    return enabled && tick % static_cast<uint64_t>(options.intervalTicks) == 0;
+}
+
+bool FrameDumper::capture(uint64_t tick, int width, int height, const FoodClass* occupancy) {
+    if (!wantsTick(tick)) return false;
+    size_t tiles = static_cast<size_t>(width) * static_cast<size_t>(height);
+
+    Job job;
+    {
+        lock_guard<mutex> lock(queueMutex);
+        if (queue.size() >= options.maxQueuedFrames) {
+            framesDropped.fetch_add(1, memory_order_relaxed);
+            return false;
+        }
+        if (!spareBuffers.empty()) {
+            job.occupancy = std::move(spareBuffers.back());
+            spareBuffers.pop_back();
+        }
+    }
+
+    // The copy happens outside the lock so drains are not held up by it
+    job.tick = tick;
+    job.width = width;
+    job.height = height;
+    job.occupancy.assign(occupancy, occupancy + tiles);
+    bool startDrain = false;
+    {
+        lock_guard<mutex> lock(queueMutex);
+        queue.push_back(std::move(job));
+        if (activeDrains < options.workers) {
+            ++activeDrains;
+            startDrain = true;
+        }
+    }
+    if (startDrain) {
+        TaskPool::shared().submit([this]() { drainQueue(); });
+    }
+    return true;
+}
+
+string FrameDumper::framePath(uint64_t tick) const {
+    char name[32];
+    snprintf(name, sizeof(name), "frame_%08llu.%s", static_cast<unsigned long long>(tick),
+             options.format == FrameFormat::PNG ? "png" : "ppm");
+    return (filesystem::path(options.directory) / name).string();
+}
+
+// Writes frames until the queue is empty. Busy drains pick up the frames
+// captured meanwhile, so capture only starts one when fewer are running than
+// the options allow.
+void FrameDumper::drainQueue() {
+    vector<uint8_t> encoded;
+    unique_lock<mutex> lock(queueMutex);
+    while (!queue.empty()) {
+        Job job = std::move(queue.front());
+        queue.pop_front();
+        lock.unlock();
+
+        writeFrame(job, encoded);
+
+        lock.lock();
+        spareBuffers.push_back(std::move(job.occupancy));
+    }
+    --activeDrains;
+    drainsFinished.notify_all();
+}
+
+void FrameDumper::writeFrame(const Job& job, vector<uint8_t>& encoded) {
+    encode(options.format, job.width, job.height, options.scale, job.occupancy.data(), encoded);
+
+    string path = framePath(job.tick);
+    ofstream out(path, ios::out | ios::binary | ios::trunc);
+    out.write(reinterpret_cast<const char*>(encoded.data()), static_cast<streamsize>(encoded.size()));
+    if (!out) {
+        // One warning per dump is enough to notice a full disk
+        if (writeFailures.fetch_add(1, memory_order_relaxed) == 0) {
+            cerr << "Warning: Cannot write frame " << path << endl;
+        }
+        return;
+    }
+    framesWritten.fetch_add(1, memory_order_relaxed);
+}
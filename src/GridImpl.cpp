@@ -1,4 +1,8 @@
 #include "GridImpl.h"
+#include "TileImpl.h"
+#include "PositionImpl.h"
+#include "OccupancyPyramid.h"
+#include <algorithm>
 #include <stdexcept>
 #include <cmath>
 #include <limits>
@@ -6,7 +10,10 @@
 
 using namespace std;
 
-GridImpl::GridImpl(int width, int height) : width(width), height(height) {
+GridImpl::GridImpl(int width, int height)
+    : width(width), height(height), bitboards(width, height),
+      layout(GridLayout::ROW_MAJOR, width, height), pyramid(nullptr), claimRound(1),
+      foodFirstRow(0), foodLastRow(height) {
     cout << "Initializing grid with dimensions: " << width << "x" << height << endl;
     
     if (width <= 0 || height <= 0) {
@@ -20,15 +27,118 @@ GridImpl::GridImpl(int width, int height) : width(width), height(height) {
             tiles[y].emplace_back(Position(x, y));
         }
     }
+    
+    foodClasses.assign(static_cast<size_t>(width) * height, FOOD_CLASS_EMPTY);
+    haloClasses.assign(getHaloStride() * (height + 2), FOOD_CLASS_BORDER);
+    for (int y = 0; y < height; ++y) {
+        FoodClass* row = haloClasses.data() + (y + 1) * getHaloStride() + 1;
+        fill(row, row + width, FOOD_CLASS_EMPTY);
+    }
+    claims = vector<atomic<uint64_t>>(static_cast<size_t>(width) * height);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            tiles[y][x].pImpl->bindGrid(this, static_cast<size_t>(y) * width + x);
+        }
+    }
 }
 
-GridImpl::~GridImpl() {}
+GridImpl::~GridImpl() {
+    delete pyramid;
+}
 
-Tile& GridImpl::getTile(int x, int y) {
-    if (!isInBounds(x, y)) {
-        throw out_of_range("Coordinates are out of bounds.");
+void GridImpl::setLayout(GridLayout kind) {
+    if (kind == layout.getKind()) return;
+    layout = TileLayout(kind, width, height);
+    if (kind == GridLayout::ROW_MAJOR) {
+        vector<FoodClass>().swap(layoutClasses);
+        return;
+    }
+    layoutClasses.assign(layout.getStorageSize(), FOOD_CLASS_EMPTY);
+    layout.scatter(foodClasses.data(), layoutClasses.data());
+    for (int y = 0; y < height; ++y) {
+        if (y >= foodFirstRow && y < foodLastRow) continue;
+        for (int x = 0; x < width; ++x) {
+            layoutClasses[layout.index(x, y)] = searchClass(y, foodClasses[static_cast<size_t>(y) * width + x]);
+        }
     }
-    return tiles[y][x];
+}
+
+void GridImpl::setFoodRows(int firstRow, int lastRow) {
+    if (firstRow < 0 || lastRow > height || firstRow >= lastRow) {
+        throw invalid_argument("Food rows must be a non-empty range inside the grid");
+    }
+    int previousFirst = foodFirstRow;
+    int previousLast = foodLastRow;
+    foodFirstRow = firstRow;
+    foodLastRow = lastRow;
+    for (int y = 0; y < height; ++y) {
+        bool wasFood = y >= previousFirst && y < previousLast;
+        bool isFood = y >= firstRow && y < lastRow;
+        if (wasFood == isFood) continue;
+        for (int x = 0; x < width; ++x) {
+            FoodClass foodClass = foodClasses[static_cast<size_t>(y) * width + x];
+            if (foodClass == FOOD_CLASS_EMPTY) continue;
+            updateSearchCopies(x, y, isFood ? FOOD_CLASS_BORDER : foodClass, searchClass(y, foodClass));
+        }
+    }
+}
+
+// A stale claim is overwritten with a compare-and-swap, so of several threads
+// racing for one free tile exactly one sees its swap succeed. Occupancy only
+// changes between rounds, so the food class test needs no synchronization.
+bool GridImpl::tryClaim(size_t index, uint32_t handle) {
+    if (foodClasses[index] != FOOD_CLASS_EMPTY) return false;
+    uint64_t mine = (static_cast<uint64_t>(claimRound) << 32) | handle;
+    atomic<uint64_t>& claim = claims[index];
+    uint64_t seen = claim.load(memory_order_acquire);
+    while ((seen >> 32) != claimRound) {
+        if (claim.compare_exchange_weak(seen, mine, memory_order_acq_rel, memory_order_acquire)) {
+            return true;
+        }
+    }
+    return seen == mine;
+}
+
+bool GridImpl::release(size_t index, uint32_t handle) {
+    uint64_t mine = (static_cast<uint64_t>(claimRound) << 32) | handle;
+    return claims[index].compare_exchange_strong(mine, 0, memory_order_acq_rel);
+}
+
+void GridImpl::beginClaimRound() {
+    if (++claimRound != 0) return;
+    // Once every 2^32 rounds the stamps wrap and old claims must really go
+    for (atomic<uint64_t>& claim : claims) {
+        claim.store(0, memory_order_relaxed);
+    }
+    claimRound = 1;
+}
+
+const OccupancyPyramid& GridImpl::enableOccupancyPyramid() {
+    if (pyramid == nullptr) {
+        pyramid = new OccupancyPyramid(width, height, foodClasses.data());
+    }
+    return *pyramid;
+}
+
+void GridImpl::onFoodClassChanged(size_t index, FoodClass before, FoodClass after) {
+    int y = static_cast<int>(index / width);
+    int x = static_cast<int>(index - static_cast<size_t>(y) * width);
+    updateSearchCopies(x, y, searchClass(y, before), searchClass(y, after));
+    if (pyramid != nullptr) {
+        pyramid->update(x, y, before, after);
+    }
+}
+
+void GridImpl::updateSearchCopies(int x, int y, FoodClass before, FoodClass after) {
+    bitboards.set(x, y, before, after);
+    haloClasses[(y + 1) * getHaloStride() + x + 1] = after;
+    if (layout.getKind() != GridLayout::ROW_MAJOR) {
+        layoutClasses[layout.index(x, y)] = after;
+    }
+}
+
+Tile& GridImpl::getTile(int x, int y) {
+    return tileAt<CheckedAccess>(x, y);
 }
 
 void GridImpl::setTile(int x, int y, const Tile& tile) {
@@ -44,7 +154,7 @@ Tile& GridImpl::findClosestEmptyTile(const Position& pos) {
     
     for (int y = 0; y < height; ++y) {
         for (int x = 0; x < width; ++x) {
-            Tile& currentTile = getTile(x, y);
+            Tile& currentTile = tiles[y][x];
             
             if (currentTile.isEmpty()) {
                 double dx = pos.getX() - x;
@@ -92,6 +202,29 @@ Organism& GridImpl::findClosestOrganism(const Position& pos, OrganismType target
     return *closestOrganism;
 }
 
-bool GridImpl::isInBounds(int x, int y) const {
-    return x >= 0 && x < width && y >= 0 && y < height;
+// Every tile owns a TileImpl, which owns the PositionImpl behind its Position.
+MemoryFootprint GridImpl::getMemoryFootprint() const {
+    MemoryFootprint footprint = {tiles.capacity() * sizeof(std::vector<Tile>), tiles.capacity() > 0 ? 1u : 0u};
+    footprint.bytes += (foodClasses.capacity() + haloClasses.capacity()) * sizeof(FoodClass);
+    footprint.allocations += (foodClasses.capacity() > 0 ? 1 : 0) + (haloClasses.capacity() > 0 ? 1 : 0);
+    footprint.bytes += claims.capacity() * sizeof(claims[0]);
+    footprint.allocations += claims.capacity() > 0 ? 1 : 0;
+    for (const auto& row : tiles) {
+        footprint.bytes += row.capacity() * sizeof(Tile);
+        footprint.allocations += row.capacity() > 0 ? 1 : 0;
+        footprint.bytes += row.size() * (sizeof(TileImpl) + sizeof(PositionImpl));
+        footprint.allocations += row.size() * 2;
+    }
+    MemoryFootprint layoutFootprint = layout.getMemoryFootprint();
+    footprint.bytes += layoutFootprint.bytes + layoutClasses.capacity() * sizeof(FoodClass);
+    footprint.allocations += layoutFootprint.allocations + (layoutClasses.capacity() > 0 ? 1 : 0);
+    MemoryFootprint bitboardFootprint = bitboards.getMemoryFootprint();
+    footprint.bytes += bitboardFootprint.bytes;
+    footprint.allocations += bitboardFootprint.allocations;
+    if (pyramid != nullptr) {
+        MemoryFootprint pyramidFootprint = pyramid->getMemoryFootprint();
+        footprint.bytes += sizeof(OccupancyPyramid) + pyramidFootprint.bytes;
+        footprint.allocations += 1 + pyramidFootprint.allocations;
+    }
+    return footprint;
 }
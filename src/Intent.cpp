@@ -0,0 +1,61 @@
+#include "Intent.h"
+#include <algorithm>
+
+using namespace std;
+
+namespace {
+thread_local int workerSlot = 0;
+}
+
+IntentQueue::IntentQueue(int workers) {
+    setWorkerCount(workers);
+}
+
+void IntentQueue::setWorkerCount(int workers) {
+    slots.clear();
+    slots.resize(static_cast<size_t>(max(workers, 1)));
+}
+
+void IntentQueue::bindWorker(int worker) {
+    workerSlot = worker;
+}
+
+int IntentQueue::boundWorker() {
+    return workerSlot;
+}
+
+IntentBuffer& IntentQueue::local() {
+    size_t slot = static_cast<size_t>(workerSlot);
+    return slots[slot < slots.size() ? slot : 0].buffer;
+}
+
+size_t IntentQueue::pending() const {
+    size_t total = 0;
+    for (const Slot& slot : slots) {
+        total += slot.buffer.intents.size();
+    }
+    return total;
+}
+
+void IntentQueue::drain(vector<Intent>& out) {
+    out.clear();
+    out.reserve(pending());
+    for (Slot& slot : slots) {
+        out.insert(out.end(), slot.buffer.intents.begin(), slot.buffer.intents.end());
+        slot.buffer.intents.clear();
+    }
+    // Keys are unique per actor and phase, so the result does not depend on
+    // which worker emitted what
+    sort(out.begin(), out.end());
+}
+
+MemoryFootprint IntentQueue::getMemoryFootprint() const {
+    MemoryFootprint footprint = {slots.capacity() * sizeof(Slot), slots.empty() ? 0u : 1u};
+    for (const Slot& slot : slots) {
+        if (slot.buffer.intents.capacity() > 0) {
+            footprint.bytes += slot.buffer.intents.capacity() * sizeof(Intent);
+            footprint.allocations += 1;
+        }
+    }
+    return footprint;
+}
@@ -0,0 +1,94 @@
+#include "MemoryAccounting.h"
+#include <iomanip>
+
+using namespace std;
+
+MemoryAccount::MemoryAccount() {
+    reset();
+}
+
+void MemoryAccount::charge(const MemoryFootprint& footprint) {
+    uint64_t live = liveBytes.fetch_add(footprint.bytes, memory_order_relaxed) + footprint.bytes;
+    allocations.fetch_add(footprint.allocations, memory_order_relaxed);
+
+    uint64_t peak = peakBytes.load(memory_order_relaxed);
+    while (live > peak && !peakBytes.compare_exchange_weak(peak, live, memory_order_relaxed)) {
+    }
+}
+
+void MemoryAccount::release(const MemoryFootprint& footprint) {
+    liveBytes.fetch_sub(footprint.bytes, memory_order_relaxed);
+    deallocations.fetch_add(footprint.allocations, memory_order_relaxed);
+}
+
+MemoryUsage MemoryAccount::getUsage() const {
+    return {liveBytes.load(memory_order_relaxed),
+            peakBytes.load(memory_order_relaxed),
+            allocations.load(memory_order_relaxed),
+            deallocations.load(memory_order_relaxed)};
+}
+
+void MemoryAccount::reset() {
+    liveBytes.store(0, memory_order_relaxed);
+    peakBytes.store(0, memory_order_relaxed);
+    allocations.store(0, memory_order_relaxed);
+    deallocations.store(0, memory_order_relaxed);
+}
+
+MemoryAccount& MemoryAccounting::getAccount(MemorySubsystem subsystem) {
+    return accounts[static_cast<size_t>(subsystem)];
+}
+
+MemoryUsage MemoryAccounting::getUsage(MemorySubsystem subsystem) const {
+    return accounts[static_cast<size_t>(subsystem)].getUsage();
+}
+
+uint64_t MemoryAccounting::getTotalLiveBytes() const {
+    uint64_t total = 0;
+    for (const MemoryAccount& account : accounts) {
+        total += account.getUsage().liveBytes;
+    }
+    return total;
+}
+
+const char* MemoryAccounting::subsystemName(MemorySubsystem subsystem) {
+    switch (subsystem) {
+        case MemorySubsystem::GRID: return "grid";
+        case MemorySubsystem::ORGANISMS: return "organisms";
+        case MemorySubsystem::ORGANISM_STORE: return "organism_store";
+        case MemorySubsystem::SCRATCH: return "scratch";
+        case MemorySubsystem::SOIL: return "soil";
+        case MemorySubsystem::SCHEDULER: return "scheduler";
+        default: return "unknown";
+    }
+}
+
+void MemoryAccounting::writeTable(ostream& out) const {
+    out << left << setw(16) << "subsystem" << right
+        << setw(16) << "live_bytes"
+        << setw(16) << "peak_bytes"
+        << setw(14) << "allocations"
+        << setw(14) << "frees" << '\n';
+    for (size_t i = 0; i < accounts.size(); ++i) {
+        MemoryUsage usage = accounts[i].getUsage();
+        out << left << setw(16) << subsystemName(static_cast<MemorySubsystem>(i)) << right
+            << setw(16) << usage.liveBytes
+            << setw(16) << usage.peakBytes
+            << setw(14) << usage.allocations
+            << setw(14) << usage.deallocations << '\n';
+    }
+}
+
+void MemoryAccounting::writeJson(ostream& out) const {
+    out << '{';
+    for (size_t i = 0; i < accounts.size(); ++i) {
+        MemoryUsage usage = accounts[i].getUsage();
+        if (i > 0) out << ',';
+        out << '"' << subsystemName(static_cast<MemorySubsystem>(i)) << "\":{"
+            << "\"live_bytes\":" << usage.liveBytes
+            << ",\"peak_bytes\":" << usage.peakBytes
+            << ",\"allocations\":" << usage.allocations
+            << ",\"frees\":" << usage.deallocations << '}';
+    }
+    out << '}';
+}
@@ -0,0 +1,289 @@
+#include "OccupancyBitboards.h"
+#include <algorithm>
+#include <bitset>
+#include <stdexcept>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+using namespace std;
+
+namespace {
+
+// Column c of the result holds column c - 1 of the row
+inline uint64_t shiftEast(const uint64_t* row, size_t w) {
+    return (row[w] << 1) | (w > 0 ? row[w - 1] >> 63 : 0);
+}
+
+// Column c of the result holds column c + 1 of the row
+inline uint64_t shiftWest(const uint64_t* row, size_t w, size_t words) {
+    return (row[w] >> 1) | (w + 1 < words ? row[w + 1] << 63 : 0);
+}
+
+// One word of the Moore dilation: V = above | below covers the tiles straight
+// above and below, and shifting X = V | row one column either way covers the
+// six diagonal and side neighbors. The tile itself is never included.
+inline uint64_t dilateWord(const uint64_t* above, const uint64_t* row, const uint64_t* below,
+                           size_t w, size_t words) {
+    uint64_t vertical = above[w] | below[w];
+    uint64_t all = vertical | row[w];
+    uint64_t previous = w > 0 ? above[w - 1] | row[w - 1] | below[w - 1] : 0;
+    uint64_t next = w + 1 < words ? above[w + 1] | row[w + 1] | below[w + 1] : 0;
+    return vertical | (all << 1) | (previous >> 63) | (all >> 1) | (next << 63);
+}
+
+void dilateRow(const uint64_t* above, const uint64_t* row, const uint64_t* below, uint64_t* out, size_t words) {
+    size_t w = 0;
+    if (words > 0) {
+        out[0] = dilateWord(above, row, below, 0, words);
+        w = 1;
+    }
+#if defined(__SSE2__)
+    // Two words at a time; the unaligned loads one word back and ahead supply
+    // the bits that cross word boundaries
+    for (; w + 2 < words; w += 2) {
+        auto load = [](const uint64_t* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); };
+        __m128i vertical = _mm_or_si128(load(above + w), load(below + w));
+        __m128i all = _mm_or_si128(vertical, load(row + w));
+        __m128i previous = _mm_or_si128(_mm_or_si128(load(above + w - 1), load(row + w - 1)), load(below + w - 1));
+        __m128i next = _mm_or_si128(_mm_or_si128(load(above + w + 1), load(row + w + 1)), load(below + w + 1));
+        __m128i result = _mm_or_si128(vertical, _mm_or_si128(_mm_slli_epi64(all, 1), _mm_srli_epi64(previous, 63)));
+        result = _mm_or_si128(result, _mm_or_si128(_mm_srli_epi64(all, 1), _mm_slli_epi64(next, 63)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + w), result);
+    }
+#endif
+    for (; w < words; ++w) {
+        out[w] = dilateWord(above, row, below, w, words);
+    }
+}
+
+// Adds one bit per tile into the bit-sliced counter; at most 8 inputs arrive,
+// so the fourth plane never carries
+inline void addBits(uint64_t input, uint64_t& p0, uint64_t& p1, uint64_t& p2, uint64_t& p3) {
+    uint64_t carry0 = p0 & input;
+    p0 ^= input;
+    uint64_t carry1 = p1 & carry0;
+    p1 ^= carry0;
+    uint64_t carry2 = p2 & carry1;
+    p2 ^= carry1;
+    p3 |= carry2;
+}
+
+}
+
+int NeighborCounts::at(int x, int y) const {
+    size_t word = static_cast<size_t>(y) * wordsPerRow + static_cast<size_t>(x) / 64;
+    int bit = x % 64;
+    int count = 0;
+    for (int plane = 0; plane < PLANES; ++plane) {
+        count |= static_cast<int>((planes[plane][word] >> bit) & 1u) << plane;
+    }
+    return count;
+}
+
+OccupancyBitboards::OccupancyBitboards(int width, int height)
+    : width(width), height(height), version(0), refreshedRows(0) {
+    if (width <= 0 || height <= 0) {
+        throw invalid_argument("Bitboard dimensions must be positive");
+    }
+    wordsPerRow = (static_cast<size_t>(width) + 63) / 64;
+    int tailBits = width % 64;
+    lastWordMask = tailBits == 0 ? ~0ull : (1ull << tailBits) - 1;
+
+    size_t words = getWordCount();
+    for (auto& board : layers) {
+        board.assign(words, 0);
+    }
+    // Every tile starts empty
+    for (int y = 0; y < height; ++y) {
+        uint64_t* row = layers[FOOD_CLASS_EMPTY].data() + static_cast<size_t>(y) * wordsPerRow;
+        for (size_t w = 0; w < wordsPerRow; ++w) {
+            row[w] = ~0ull;
+        }
+        row[wordsPerRow - 1] = lastWordMask;
+    }
+    zeroRow.assign(wordsPerRow, 0);
+
+    // Sized up front so the grid's memory account sees them from the start
+    emptyNeighborBoard.assign(words, 0);
+    for (auto& board : adjacentFoodBoards) {
+        board.assign(words, 0);
+    }
+    scratch.assign(3 * wordsPerRow, 0);
+
+    // Every tile starting empty leaves all of the derived boards stale
+    rowChanged.assign(height, 0);
+    changedRows.reserve(height);
+    for (int y = 0; y < height; ++y) {
+        markRowChanged(y);
+    }
+}
+
+void OccupancyBitboards::set(int x, int y, FoodClass before, FoodClass after) {
+    if (before == after || before > FOOD_CLASS_BORDER || after > FOOD_CLASS_BORDER) return;
+    size_t word = static_cast<size_t>(y) * wordsPerRow + static_cast<size_t>(x) / 64;
+    uint64_t bit = 1ull << (x % 64);
+    // The border class has no layer of its own
+    if (before != FOOD_CLASS_BORDER) layers[before][word] &= ~bit;
+    if (after != FOOD_CLASS_BORDER) layers[after][word] |= bit;
+    if (after == FOOD_CLASS_EMPTY) {
+        layers[LAYER_ANY][word] &= ~bit;
+    } else {
+        layers[LAYER_ANY][word] |= bit;
+    }
+    markRowChanged(y);
+    ++version;
+}
+
+void OccupancyBitboards::markRowChanged(int y) {
+    if (rowChanged[y]) return;
+    rowChanged[y] = 1;
+    changedRows.push_back(y);
+}
+
+const uint64_t* OccupancyBitboards::rowOf(const uint64_t* board, int y) const {
+    if (y < 0 || y >= height) return zeroRow.data();
+    return board + static_cast<size_t>(y) * wordsPerRow;
+}
+
+bool OccupancyBitboards::testBoard(const vector<uint64_t>& board, int x, int y) const {
+    return (board[static_cast<size_t>(y) * wordsPerRow + static_cast<size_t>(x) / 64] >> (x % 64)) & 1u;
+}
+
+bool OccupancyBitboards::test(int layerIndex, int x, int y) const {
+    return testBoard(layers[layerIndex], x, y);
+}
+
+void OccupancyBitboards::unionOf(DietMask classes, vector<uint64_t>& out) const {
+    out.assign(getWordCount(), 0);
+    for (int foodClass = 0; foodClass < FOOD_CLASS_COUNT; ++foodClass) {
+        if (!dietAllows(classes, static_cast<FoodClass>(foodClass))) continue;
+        const uint64_t* source = layers[foodClass].data();
+        for (size_t w = 0; w < out.size(); ++w) {
+            out[w] |= source[w];
+        }
+    }
+}
+
+void OccupancyBitboards::neighborsOf(const uint64_t* board, vector<uint64_t>& out) const {
+    out.resize(getWordCount());
+    for (int y = 0; y < height; ++y) {
+        uint64_t* target = out.data() + static_cast<size_t>(y) * wordsPerRow;
+        dilateRow(rowOf(board, y - 1), rowOf(board, y), rowOf(board, y + 1), target, wordsPerRow);
+        target[wordsPerRow - 1] &= lastWordMask;
+    }
+}
+
+void OccupancyBitboards::countNeighbors(const uint64_t* board, NeighborCounts& out) const {
+    out.wordsPerRow = wordsPerRow;
+    for (auto& plane : out.planes) {
+        plane.resize(getWordCount());
+    }
+    for (int y = 0; y < height; ++y) {
+        const uint64_t* above = rowOf(board, y - 1);
+        const uint64_t* row = rowOf(board, y);
+        const uint64_t* below = rowOf(board, y + 1);
+        size_t offset = static_cast<size_t>(y) * wordsPerRow;
+        for (size_t w = 0; w < wordsPerRow; ++w) {
+            uint64_t p0 = 0, p1 = 0, p2 = 0, p3 = 0;
+            addBits(above[w], p0, p1, p2, p3);
+            addBits(shiftEast(above, w), p0, p1, p2, p3);
+            addBits(shiftWest(above, w, wordsPerRow), p0, p1, p2, p3);
+            addBits(below[w], p0, p1, p2, p3);
+            addBits(shiftEast(below, w), p0, p1, p2, p3);
+            addBits(shiftWest(below, w, wordsPerRow), p0, p1, p2, p3);
+            addBits(shiftEast(row, w), p0, p1, p2, p3);
+            addBits(shiftWest(row, w, wordsPerRow), p0, p1, p2, p3);
+            uint64_t mask = w + 1 == wordsPerRow ? lastWordMask : ~0ull;
+            out.planes[0][offset + w] = p0 & mask;
+            out.planes[1][offset + w] = p1 & mask;
+            out.planes[2][offset + w] = p2 & mask;
+            out.planes[3][offset + w] = p3 & mask;
+        }
+    }
+}
+
+uint64_t OccupancyBitboards::population(const uint64_t* board) const {
+    uint64_t count = 0;
+    size_t words = getWordCount();
+    for (size_t w = 0; w < words; ++w) {
+        count += bitset<64>(board[w]).count();
+    }
+    return count;
+}
+
+// Row y of the union, or a clear row outside the grid
+void OccupancyBitboards::unionRow(DietMask classes, int y, uint64_t* out) const {
+    fill(out, out + wordsPerRow, 0);
+    if (y < 0 || y >= height) return;
+    for (int foodClass = 0; foodClass < FOOD_CLASS_COUNT; ++foodClass) {
+        if (!dietAllows(classes, static_cast<FoodClass>(foodClass))) continue;
+        const uint64_t* source = rowOf(layers[foodClass].data(), y);
+        for (size_t w = 0; w < wordsPerRow; ++w) {
+            out[w] |= source[w];
+        }
+    }
+}
+
+void OccupancyBitboards::refreshRow(int y) const {
+    size_t offset = static_cast<size_t>(y) * wordsPerRow;
+    const uint64_t* empty = layers[FOOD_CLASS_EMPTY].data();
+    uint64_t* target = emptyNeighborBoard.data() + offset;
+    dilateRow(rowOf(empty, y - 1), rowOf(empty, y), rowOf(empty, y + 1), target, wordsPerRow);
+    target[wordsPerRow - 1] &= lastWordMask;
+
+    uint64_t* above = scratch.data();
+    uint64_t* row = above + wordsPerRow;
+    uint64_t* below = row + wordsPerRow;
+    for (int type = 0; type < ANIMAL_TYPE_COUNT; ++type) {
+        DietMask classes = dietMask(static_cast<AnimalType>(type));
+        unionRow(classes, y - 1, above);
+        unionRow(classes, y, row);
+        unionRow(classes, y + 1, below);
+        target = adjacentFoodBoards[type].data() + offset;
+        dilateRow(above, row, below, target, wordsPerRow);
+        target[wordsPerRow - 1] &= lastWordMask;
+    }
+    ++refreshedRows;
+}
+
+void OccupancyBitboards::refreshNeighborhood() const {
+    if (changedRows.empty()) return;
+    // In order, so rows next to two changed rows are rebuilt only once
+    sort(changedRows.begin(), changedRows.end());
+    int refreshedUpTo = -1;
+    for (int y : changedRows) {
+        for (int row = max(y - 1, refreshedUpTo + 1); row <= min(y + 1, height - 1); ++row) {
+            refreshRow(row);
+            refreshedUpTo = row;
+        }
+        rowChanged[y] = 0;
+    }
+    changedRows.clear();
+}
+
+bool OccupancyBitboards::hasEmptyNeighbor(int x, int y) const {
+    refreshNeighborhood();
+    return testBoard(emptyNeighborBoard, x, y);
+}
+
+bool OccupancyBitboards::hasAdjacentFood(AnimalType type, int x, int y) const {
+    refreshNeighborhood();
+    return testBoard(adjacentFoodBoards[static_cast<int>(type)], x, y);
+}
+
+MemoryFootprint OccupancyBitboards::getMemoryFootprint() const {
+    MemoryFootprint footprint = {0, 0};
+    auto add = [&footprint](const vector<uint64_t>& board) {
+        footprint.bytes += board.capacity() * sizeof(uint64_t);
+        footprint.allocations += board.capacity() > 0 ? 1 : 0;
+    };
+    for (const auto& board : layers) add(board);
+    for (const auto& board : adjacentFoodBoards) add(board);
+    add(emptyNeighborBoard);
+    add(scratch);
+    add(zeroRow);
+    footprint.bytes += rowChanged.capacity() + changedRows.capacity() * sizeof(int);
+    footprint.allocations += 2;
+    return footprint;
+}
@@ -0,0 +1,136 @@
+#include "OccupancyPyramid.h"
+#include <algorithm>
+#include <stdexcept>
+
+using namespace std;
+
+OccupancyPyramid::OccupancyPyramid(int width, int height, const FoodClass* occupancy)
+    : width(width), height(height), tiles(occupancy) {
+    if (width <= 0 || height <= 0) {
+        throw invalid_argument("Pyramid dimensions must be positive");
+    }
+
+    levels.push_back(Level{width, height, {}});
+    while (levels.back().width > 1 || levels.back().height > 1) {
+        const Level& below = levels.back();
+        Level level;
+        level.width = (below.width + 1) / 2;
+        level.height = (below.height + 1) / 2;
+        level.counts.assign(static_cast<size_t>(level.width) * level.height * CLASS_SLOTS, 0);
+        levels.push_back(std::move(level));
+    }
+    rebuild();
+}
+
+// Level 1 is counted from the tiles, every level above from the one below
+void OccupancyPyramid::rebuild() {
+    for (size_t level = 1; level < levels.size(); ++level) {
+        fill(levels[level].counts.begin(), levels[level].counts.end(), 0u);
+    }
+    if (levels.size() < 2) return;
+
+    Level& first = levels[1];
+    for (int y = 0; y < height; ++y) {
+        const FoodClass* row = tiles + static_cast<size_t>(y) * width;
+        uint32_t* cellRow = first.counts.data() + static_cast<size_t>(y / 2) * first.width * CLASS_SLOTS;
+        for (int x = 0; x < width; ++x) {
+            if (row[x] != FOOD_CLASS_EMPTY && row[x] < FOOD_CLASS_COUNT) {
+                ++cellRow[static_cast<size_t>(x / 2) * CLASS_SLOTS + row[x] - 1];
+            }
+        }
+    }
+
+    for (size_t level = 2; level < levels.size(); ++level) {
+        const Level& below = levels[level - 1];
+        Level& current = levels[level];
+        for (int y = 0; y < below.height; ++y) {
+            for (int x = 0; x < below.width; ++x) {
+                const uint32_t* source = below.counts.data() + (static_cast<size_t>(y) * below.width + x) * CLASS_SLOTS;
+                uint32_t* target = current.counts.data() + (static_cast<size_t>(y / 2) * current.width + x / 2) * CLASS_SLOTS;
+                for (int slot = 0; slot < CLASS_SLOTS; ++slot) {
+                    target[slot] += source[slot];
+                }
+            }
+        }
+    }
+}
+
+void OccupancyPyramid::update(int x, int y, FoodClass before, FoodClass after) {
+    if (before == after) return;
+    for (size_t level = 1; level < levels.size(); ++level) {
+        Level& current = levels[level];
+        uint32_t* cell = current.counts.data() +
+            (static_cast<size_t>(y >> level) * current.width + (x >> level)) * CLASS_SLOTS;
+        if (before != FOOD_CLASS_EMPTY && before < FOOD_CLASS_COUNT) --cell[before - 1];
+        if (after != FOOD_CLASS_EMPTY && after < FOOD_CLASS_COUNT) ++cell[after - 1];
+    }
+}
+
+int OccupancyPyramid::getLevelWidth(int level) const {
+    return level >= 0 && level < getLevelCount() ? levels[level].width : 0;
+}
+
+int OccupancyPyramid::getLevelHeight(int level) const {
+    return level >= 0 && level < getLevelCount() ? levels[level].height : 0;
+}
+
+const uint32_t* OccupancyPyramid::cellCounts(int level, int x, int y) const {
+    const Level& current = levels[level];
+    return current.counts.data() + (static_cast<size_t>(y) * current.width + x) * CLASS_SLOTS;
+}
+
+uint32_t OccupancyPyramid::getCount(int level, int x, int y, FoodClass foodClass) const {
+    if (foodClass == FOOD_CLASS_EMPTY || foodClass >= FOOD_CLASS_COUNT) return 0;
+    if (level == 0) {
+        return tiles[static_cast<size_t>(y) * width + x] == foodClass ? 1u : 0u;
+    }
+    return cellCounts(level, x, y)[foodClass - 1];
+}
+
+uint32_t OccupancyPyramid::getOccupied(int level, int x, int y) const {
+    if (level == 0) {
+        return tiles[static_cast<size_t>(y) * width + x] != FOOD_CLASS_EMPTY ? 1u : 0u;
+    }
+    const uint32_t* counts = cellCounts(level, x, y);
+    uint32_t occupied = 0;
+    for (int slot = 0; slot < CLASS_SLOTS; ++slot) {
+        occupied += counts[slot];
+    }
+    return occupied;
+}
+
+uint32_t OccupancyPyramid::getCellArea(int level, int x, int y) const {
+    int x0 = x << level;
+    int y0 = y << level;
+    int x1 = min(width, (x + 1) << level);
+    int y1 = min(height, (y + 1) << level);
+    return static_cast<uint32_t>(max(0, x1 - x0) * max(0, y1 - y0));
+}
+
+FoodClass OccupancyPyramid::getMajority(int level, int x, int y) const {
+    if (level == 0) {
+        FoodClass foodClass = tiles[static_cast<size_t>(y) * width + x];
+        return foodClass < FOOD_CLASS_COUNT ? foodClass : FOOD_CLASS_EMPTY;
+    }
+    const uint32_t* counts = cellCounts(level, x, y);
+    FoodClass majority = FOOD_CLASS_EMPTY;
+    uint32_t best = 0;
+    for (int slot = 0; slot < CLASS_SLOTS; ++slot) {
+        if (counts[slot] > best) {
+            best = counts[slot];
+            majority = static_cast<FoodClass>(slot + 1);
+        }
+    }
+    return majority;
+}
+
+MemoryFootprint OccupancyPyramid::getMemoryFootprint() const {
+    MemoryFootprint footprint = {levels.capacity() * sizeof(Level), 1};
+    for (const Level& level : levels) {
+        if (level.counts.capacity() > 0) {
+            footprint.bytes += level.counts.capacity() * sizeof(uint32_t);
+            footprint.allocations += 1;
+        }
+    }
+    return footprint;
+}
@@ -1,7 +1,8 @@
 #include "Organism.h"
+#include "PositionImpl.h"
 
-Organism::Organism(OrganismType type, float nutrients, int maxLifespan)
-    : type(type), nutrients(nutrients), age(0), maxLifespan(maxLifespan), position(nullptr) { }
+Organism::Organism(OrganismType type, float nutrients, uint16_t speciesId)
+    : position(nullptr), nutrients(nutrients), age(0), speciesId(speciesId), type(type), removed(false) { }
 
 Organism::~Organism() {
     delete position;
@@ -28,12 +29,16 @@ int Organism::getAge() const {
     return age;
 }
 
-void Organism::incrementAge() {
-    ++age;
+int Organism::getMaxLifespan() const {
+    return getSpecies().maxLifespan;
+}
+
+void Organism::incrementAge(int ticks) {
+    age += ticks;
 }
 
 bool Organism::isDead() const {
-    return age >= maxLifespan || nutrients <= 0;
+    return age >= getSpecies().maxLifespan || nutrients <= 0;
 }
 
 const Position& Organism::getPosition() const {
@@ -55,4 +60,15 @@ Organism* Organism::reproduce() {
     // Default implementation returns nullptr
     // Derived classes will override with specific reproduction logic
     return nullptr;
+}
+
+MemoryFootprint Organism::withPositionFootprint(uint64_t objectBytes) const {
+    if (position == nullptr) {
+        return {objectBytes, 1};
+    }
+    return {objectBytes + sizeof(Position) + sizeof(PositionImpl), 3};
+}
+
+MemoryFootprint Organism::getMemoryFootprint() const {
+    return withPositionFootprint(sizeof(Organism));
 }
\ No newline at end of file
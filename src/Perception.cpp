@@ -0,0 +1,28 @@
+#include "Perception.h"
+#include "FoodSearch.h"
+#include <bitset>
+
+int Perception::emptyNeighborCount() const {
+    return static_cast<int>(std::bitset<FoodSearch::NEIGHBOR_COUNT>(emptyNeighbors).count());
+}
+
+Position Perception::emptyNeighbor(int nth) const {
+    for (int i = 0; i < FoodSearch::NEIGHBOR_COUNT; ++i) {
+        if ((emptyNeighbors & (1u << i)) && nth-- == 0) {
+            return Position(x + FoodSearch::NEIGHBOR_OFFSET_X[i], y + FoodSearch::NEIGHBOR_OFFSET_Y[i]);
+        }
+    }
+    return Position(x, y);
+}
+
+int Perception::emptyNeighborRank(int cx, int cy) const {
+    int rank = 0;
+    for (int i = 0; i < FoodSearch::NEIGHBOR_COUNT; ++i) {
+        if (!(emptyNeighbors & (1u << i))) continue;
+        if (x + FoodSearch::NEIGHBOR_OFFSET_X[i] == cx && y + FoodSearch::NEIGHBOR_OFFSET_Y[i] == cy) {
+            return rank;
+        }
+        ++rank;
+    }
+    return 0;
+}
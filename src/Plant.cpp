@@ -1,63 +1,105 @@
 #include "Plant.h"
 #include "Grid.h"
+#include "FoodSearch.h"
+#include "Perception.h"
 #include "WorldManager.h"
+#include <algorithm>
+#include <cmath>
 #include <random>
 #include <vector>
 #include <iostream>
 
+// A plant acts every ACTION_CADENCE_GROWTH / growthRate ticks, rounded and
+// kept within [1, MAX_ACTION_INTERVAL], so the usual growth rate of 0.5 acts
+// every tick and slower growers fall behind
+static const float ACTION_CADENCE_GROWTH = 0.5f;
+static const int MAX_ACTION_INTERVAL = 8;
+
 Plant::Plant(float nutrients, int maxLifespan, float growthRate, float nutrientAbsorptionRate)
-    : Organism(OrganismType::PLANT, nutrients, maxLifespan),
-      growthRate(growthRate), 
-      nutrientAbsorptionRate(nutrientAbsorptionRate),
-      spreadingThreshold(8.0f) {}
+    : Organism(OrganismType::PLANT, nutrients,
+               SpeciesRegistry::intern(Species::plant(maxLifespan, growthRate, nutrientAbsorptionRate, 8.0f))),
+      growthRateDelta(0),
+      nutrientAbsorptionRateDelta(0) {}
+
+// Seedlings share the parent's species and only store their own variation.
+Plant::Plant(float nutrients, uint16_t speciesId, float growthRate, float nutrientAbsorptionRate)
+    : Organism(OrganismType::PLANT, nutrients, speciesId),
+      growthRateDelta(0),
+      nutrientAbsorptionRateDelta(0) {
+    setTraits(growthRate, nutrientAbsorptionRate);
+}
+
+void Plant::setTraits(float growthRate, float nutrientAbsorptionRate) {
+    const Species& species = getSpecies();
+    growthRateDelta = encodeTraitDelta(species.growthRate, growthRate);
+    nutrientAbsorptionRateDelta = encodeTraitDelta(species.nutrientAbsorptionRate, nutrientAbsorptionRate);
+}
 
 float Plant::getGrowthRate() const {
-    return growthRate;
+    return decodeTraitDelta(getSpecies().growthRate, growthRateDelta);
 }
 
 float Plant::getNutrientAbsorptionRate() const {
-    return nutrientAbsorptionRate;
+    return decodeTraitDelta(getSpecies().nutrientAbsorptionRate, nutrientAbsorptionRateDelta);
 }
 
 void Plant::setGrowthRate(float rate) {
-    growthRate = rate;
+    Species species = getSpecies();
+    species.growthRate = rate;
+    float absorptionRate = getNutrientAbsorptionRate();
+    speciesId = SpeciesRegistry::intern(species);
+    setTraits(rate, absorptionRate);
 }
 
 void Plant::setNutrientAbsorptionRate(float rate) {
-    nutrientAbsorptionRate = rate;
+    Species species = getSpecies();
+    species.nutrientAbsorptionRate = rate;
+    float growthRate = getGrowthRate();
+    speciesId = SpeciesRegistry::intern(species);
+    setTraits(growthRate, rate);
+}
+
+int Plant::getActionInterval() const {
+    float growthRate = getGrowthRate();
+    if (growthRate <= 0.0f) return MAX_ACTION_INTERVAL;
+    return std::clamp(static_cast<int>(std::lround(ACTION_CADENCE_GROWTH / growthRate)), 1, MAX_ACTION_INTERVAL);
 }
 
 void Plant::update(Grid& grid, WorldManager& worldManager) {
-    incrementAge();
+    int elapsed = getActionInterval();
+    incrementAge(elapsed);
+    
+    if (isDead()) {
+        worldManager.emitIntent(IntentKind::DIE, *this, position->getX(), position->getY());
+        return;
+    }
     
-    std::cout << "Plant at (" << position->getX() << ", " << position->getY() 
-              << ") has " << nutrients << " nutrients (threshold: " << spreadingThreshold << ")" << std::endl;
+    bool logging = worldManager.logsOrganismUpdates();
+    if (logging) {
+        std::cout << "Plant at (" << position->getX() << ", " << position->getY() 
+                  << ") has " << nutrients << " nutrients (threshold: " << getSpecies().spreadingThreshold << ")" << std::endl;
+    }
     
     if (isReadyToReproduce()) {
-        std::vector<Position> adjacentPositions = position->getAdjacentPositions();
-        bool canSpread = false;
-        
-        for (const auto& pos : adjacentPositions) {
-            if (grid.isInBounds(pos.getX(), pos.getY())) {
-                Tile& tile = grid.getTile(pos.getX(), pos.getY());
-                if (tile.isEmpty()) {
-                    canSpread = true;
-                    break;
-                }
+        if (grid.getBitboards().hasEmptyNeighbor(position->getX(), position->getY())) {
+            if (logging) {
+                std::cout << "Plant is ready to reproduce!" << std::endl;
             }
-        }
-        
-        if (canSpread) {
-            std::cout << "Plant is ready to reproduce!" << std::endl;
             trySpread(grid, worldManager);
             return; 
         }
+        worldManager.getMetrics().increment(MetricCounter::FAILED_SPREADS);
+    }
+    float demand = getAbsorptionDemand() * elapsed;
+    float absorbed = worldManager.drawSoilNutrients(position->getX(), position->getY(), demand);
+    absorbNutrients(absorbed);
+    if (logging) {
+        std::cout << "Plant absorbed " << absorbed << " nutrients, total: " << nutrients << std::endl;
     }
-    absorbNutrients();
 }
 
 bool Plant::isReadyToReproduce() const {
-    return nutrients > spreadingThreshold;
+    return nutrients > getSpecies().spreadingThreshold;
 }
 
 void Plant::consumeResources() { 
@@ -70,6 +112,7 @@ Organism* Plant::reproduce() {
         return nullptr;
     }
     
+    float spreadingThreshold = getSpecies().spreadingThreshold;
     consumeNutrients(spreadingThreshold / 2);
     
     float nutrientVariation = 0.8f + static_cast<float>(rand()) / RAND_MAX * 0.4f; // 0.8 to 1.2
@@ -77,22 +120,36 @@ Organism* Plant::reproduce() {
     
     return new Plant(
         spreadingThreshold / 3,  
-        maxLifespan,
-        growthRate * growthVariation,
-        nutrientAbsorptionRate * nutrientVariation
+        speciesId,
+        getGrowthRate() * growthVariation,
+        getNutrientAbsorptionRate() * nutrientVariation
     );
 }
 
+MemoryFootprint Plant::getMemoryFootprint() const {
+    return withPositionFootprint(sizeof(Plant));
+}
+
+FoodClass Plant::getFoodClass() const {
+    return FOOD_CLASS_PLANT;
+}
+
+float Plant::getAbsorptionDemand() const {
+    return getNutrientAbsorptionRate() * getGrowthRate() * 2.0f;
+}
+
 void Plant::absorbNutrients() {
-    float absorbed = nutrientAbsorptionRate * growthRate * 2.0f;
+    absorbNutrients(getAbsorptionDemand());
+}
+
+void Plant::absorbNutrients(float absorbed) {
     addNutrients(absorbed);
-    
-    std::cout << "Plant absorbed " << absorbed << " nutrients, total: " << nutrients << std::endl;
 }
 
 void Plant::trySpread(Grid& grid, WorldManager& worldManager) {
+    bool logging = worldManager.logsOrganismUpdates();
     if (!isReadyToReproduce()) {
-        std::cout << "Plant not ready to reproduce (nutrients: " << nutrients << "/" << spreadingThreshold << ")" << std::endl;
+        std::cout << "Plant not ready to reproduce (nutrients: " << nutrients << "/" << getSpecies().spreadingThreshold << ")" << std::endl;
         return;
     }
     
@@ -101,40 +158,38 @@ void Plant::trySpread(Grid& grid, WorldManager& worldManager) {
         return;
     }
     
-    std::vector<Position> adjacentPositions = position->getAdjacentPositions();
-    std::vector<Position> validPositions;
-    
-    std::cout << "Checking " << adjacentPositions.size() << " adjacent positions for spreading..." << std::endl;
-    
-    for (const auto& pos : adjacentPositions) {
-        if (grid.isInBounds(pos.getX(), pos.getY())) {
-            Tile& tile = grid.getTile(pos.getX(), pos.getY());
-            if (tile.isEmpty()) {
-                validPositions.push_back(pos);
-                std::cout << "Found valid position: (" << pos.getX() << ", " << pos.getY() << ")" << std::endl;
-            } else {
-                std::cout << "Position (" << pos.getX() << ", " << pos.getY() << ") is occupied" << std::endl;
-            }
-        } else {
-            std::cout << "Position (" << pos.getX() << ", " << pos.getY() << ") is out of bounds" << std::endl;
-        }
+    // One read per neighbor of the halo-padded classes; tiles past the edge
+    // read as border, never as empty
+    int x = position->getX();
+    int y = position->getY();
+    Perception neighborhood = {x, y, FoodSearch::emptyNeighborMask(grid, x, y), nullptr, nullptr};
+    int validCount = neighborhood.emptyNeighborCount();
+    if (logging) {
+        std::cout << "Found " << validCount << " empty adjacent positions for spreading" << std::endl;
     }
     
-    if (!validPositions.empty()) {
+    if (validCount > 0) {
         std::random_device rd;
         std::mt19937 gen(rd());
-        std::uniform_int_distribution<> dis(0, validPositions.size() - 1);
+        std::uniform_int_distribution<> dis(0, validCount - 1);
         
-        Position spreadPos = validPositions[dis(gen)];
-        Plant* offspring = dynamic_cast<Plant*>(reproduce());
-        
-        if (offspring) {
-            worldManager.addOrganism(offspring, spreadPos);
-            std::cout << "Plant successfully spread to (" << spreadPos.getX() << ", " << spreadPos.getY() << ")" << std::endl;
-        } else {
-            std::cout << "Failed to create offspring!" << std::endl;
+        // The seedling is only created once the spawn resolves
+        Position spreadPos = neighborhood.emptyNeighbor(0);
+        if (!worldManager.claimEmptyNeighbor(neighborhood, dis(gen), spreadPos)) {
+            if (logging) {
+                std::cout << "Every empty adjacent position was claimed first" << std::endl;
+            }
+            worldManager.getMetrics().increment(MetricCounter::FAILED_SPREADS);
+            return;
+        }
+        worldManager.emitIntent(IntentKind::SPAWN, *this, spreadPos.getX(), spreadPos.getY());
+        if (logging) {
+            std::cout << "Plant spreading to (" << spreadPos.getX() << ", " << spreadPos.getY() << ")" << std::endl;
         }
     } else {
-        std::cout << "No valid positions found for spreading" << std::endl;
+        if (logging) {
+            std::cout << "No valid positions found for spreading" << std::endl;
+        }
+        worldManager.getMetrics().increment(MetricCounter::FAILED_SPREADS);
     }
 }
\ No newline at end of file
@@ -0,0 +1,131 @@
+#include "PopulationAggregates.h"
+#include "Organism.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+PopulationAggregates::PopulationAggregates() {
+    clear();
+}
+
+void PopulationAggregates::clear() {
+    for (auto& count : classCounts) {
+        count.store(0, memory_order_relaxed);
+    }
+    nutrientTotal.store(0, memory_order_relaxed);
+    ageTotal.store(0, memory_order_relaxed);
+    for (auto& bucket : nutrientHistogram) {
+        bucket.store(0, memory_order_relaxed);
+    }
+    for (auto& bucket : ageHistogram) {
+        bucket.store(0, memory_order_relaxed);
+    }
+}
+
+int PopulationAggregates::nutrientBucketOf(float nutrients) {
+    if (!(nutrients > 0.0f)) return 0;
+    return static_cast<int>(min(nutrients / NUTRIENT_BUCKET_WIDTH, static_cast<float>(NUTRIENT_BUCKETS - 1)));
+}
+
+int PopulationAggregates::ageBucketOf(int age) {
+    if (age <= 0) return 0;
+    return min(age / AGE_BUCKET_WIDTH, AGE_BUCKETS - 1);
+}
+
+PopulationAggregates::Contribution PopulationAggregates::contributionOf(const Organism& organism) {
+    Contribution contribution;
+    contribution.foodClass = organism.getFoodClass();
+    contribution.nutrientBucket = static_cast<uint8_t>(nutrientBucketOf(organism.getNutrients()));
+    contribution.ageBucket = static_cast<uint8_t>(ageBucketOf(organism.getAge()));
+    contribution.nutrients = llround(static_cast<double>(organism.getNutrients()) * NUTRIENT_SCALE);
+    contribution.age = organism.getAge();
+    return contribution;
+}
+
+void PopulationAggregates::apply(const Contribution& contribution, int64_t sign) {
+    classCounts[contribution.foodClass].fetch_add(sign, memory_order_relaxed);
+    nutrientTotal.fetch_add(sign * contribution.nutrients, memory_order_relaxed);
+    ageTotal.fetch_add(sign * contribution.age, memory_order_relaxed);
+    nutrientHistogram[contribution.nutrientBucket].fetch_add(sign, memory_order_relaxed);
+    ageHistogram[contribution.ageBucket].fetch_add(sign, memory_order_relaxed);
+}
+
+void PopulationAggregates::add(const Organism& organism) {
+    apply(contributionOf(organism), 1);
+}
+
+void PopulationAggregates::remove(const Organism& organism) {
+    apply(contributionOf(organism), -1);
+}
+
+// Only the fields that changed are touched, so an organism that merely aged
+// within its bucket costs two atomic adds.
+void PopulationAggregates::update(const Contribution& before, const Organism& organism) {
+    Contribution after = contributionOf(organism);
+    if (after.foodClass != before.foodClass) {
+        classCounts[before.foodClass].fetch_sub(1, memory_order_relaxed);
+        classCounts[after.foodClass].fetch_add(1, memory_order_relaxed);
+    }
+    if (after.nutrients != before.nutrients) {
+        nutrientTotal.fetch_add(after.nutrients - before.nutrients, memory_order_relaxed);
+    }
+    if (after.age != before.age) {
+        ageTotal.fetch_add(after.age - before.age, memory_order_relaxed);
+    }
+    if (after.nutrientBucket != before.nutrientBucket) {
+        nutrientHistogram[before.nutrientBucket].fetch_sub(1, memory_order_relaxed);
+        nutrientHistogram[after.nutrientBucket].fetch_add(1, memory_order_relaxed);
+    }
+    if (after.ageBucket != before.ageBucket) {
+        ageHistogram[before.ageBucket].fetch_sub(1, memory_order_relaxed);
+        ageHistogram[after.ageBucket].fetch_add(1, memory_order_relaxed);
+    }
+}
+
+int64_t PopulationAggregates::getTotalCount() const {
+    int64_t total = 0;
+    for (FoodClass foodClass = FOOD_CLASS_PLANT; foodClass < FOOD_CLASS_COUNT; ++foodClass) {
+        total += classCounts[foodClass].load(memory_order_relaxed);
+    }
+    return total;
+}
+
+int64_t PopulationAggregates::getCount(OrganismType type) const {
+    if (type == OrganismType::PLANT) {
+        return classCounts[FOOD_CLASS_PLANT].load(memory_order_relaxed);
+    }
+    int64_t animals = 0;
+    for (FoodClass foodClass = FOOD_CLASS_FIRST_ANIMAL; foodClass < FOOD_CLASS_COUNT; ++foodClass) {
+        animals += classCounts[foodClass].load(memory_order_relaxed);
+    }
+    return animals;
+}
+
+int64_t PopulationAggregates::getCount(AnimalType type) const {
+    return classCounts[animalFoodClass(type)].load(memory_order_relaxed);
+}
+
+double PopulationAggregates::getTotalNutrients() const {
+    return static_cast<double>(nutrientTotal.load(memory_order_relaxed)) / NUTRIENT_SCALE;
+}
+
+double PopulationAggregates::getMeanNutrients() const {
+    int64_t count = getTotalCount();
+    return count > 0 ? getTotalNutrients() / static_cast<double>(count) : 0.0;
+}
+
+double PopulationAggregates::getMeanAge() const {
+    int64_t count = getTotalCount();
+    return count > 0 ? static_cast<double>(ageTotal.load(memory_order_relaxed)) / static_cast<double>(count) : 0.0;
+}
+
+int64_t PopulationAggregates::getNutrientBucket(int bucket) const {
+    if (bucket < 0 || bucket >= NUTRIENT_BUCKETS) return 0;
+    return nutrientHistogram[bucket].load(memory_order_relaxed);
+}
+
+int64_t PopulationAggregates::getAgeBucket(int bucket) const {
+    if (bucket < 0 || bucket >= AGE_BUCKETS) return 0;
+    return ageHistogram[bucket].load(memory_order_relaxed);
+}
@@ -0,0 +1,475 @@
+#include "ShardedRunner.h"
+#include "CompactOrganism.h"
+#include "Species.h"
+#include "TaskPool.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <stdexcept>
+
+#if defined(__linux__)
+#define SHARDING_SUPPORTED 1
+#include <cerrno>
+#include <pthread.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#else
+#define SHARDING_SUPPORTED 0
+#endif
+
+using namespace std;
+
+ShardedRunner::ShardedRunner(int width, int height, int shardCount, int haloRows, float baseNutrients)
+    : width(width), height(height), shardCount(shardCount), haloRows(haloRows), baseNutrients(baseNutrients) {
+    if (width <= 0 || height <= 0) {
+        throw invalid_argument("Sharded worlds need a positive size");
+    }
+    if (shardCount <= 0) {
+        throw invalid_argument("Sharded worlds need at least one shard");
+    }
+    if (haloRows <= 0) {
+        throw invalid_argument("Halos need at least one row");
+    }
+    if (height / shardCount < haloRows) {
+        throw invalid_argument("Every band must be at least as tall as the halo");
+    }
+}
+
+ShardBand ShardedRunner::bandFor(int shard) const {
+    if (shard < 0 || shard >= shardCount) {
+        throw invalid_argument("Shard index out of range");
+    }
+    int rows = height / shardCount;
+    int taller = height % shardCount;
+    ShardBand band;
+    band.shard = shard;
+    band.firstRow = shard * rows + min(shard, taller);
+    band.lastRow = band.firstRow + rows + (shard < taller ? 1 : 0);
+    band.haloAbove = shard > 0 ? haloRows : 0;
+    band.haloBelow = shard < shardCount - 1 ? haloRows : 0;
+    band.originRow = band.firstRow - band.haloAbove;
+    return band;
+}
+
+#if SHARDING_SUPPORTED
+namespace {
+const size_t ALIGNMENT = 64;
+
+size_t alignUp(size_t bytes) {
+    return (bytes + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+}
+
+enum Direction { UP = 0, DOWN = 1 };
+
+// An organism on its way to another shard. The tile index is global, and the
+// descriptor travels along since species ids are process-local.
+struct Migrant {
+    CompactOrganism organism;
+    Species species;
+};
+
+struct alignas(64) SlotHeader {
+    uint32_t migrants;
+};
+
+// The region every shard maps: the barrier, one summary per shard, the
+// per-tick organism totals and one slot per shard, direction and tick
+// parity. A slot holds room for one migrant per halo tile (nothing else can
+// end a tick there) and the haloRows rows of food classes the neighbor
+// mirrors.
+class ShardExchange {
+private:
+    unsigned char* base;
+    size_t bytes;
+    int haloRows;
+    size_t migrantCapacity;
+    size_t summariesOffset;
+    size_t totalsOffset;
+    size_t slotsOffset;
+    size_t slotBytes;
+    size_t migrantsOffset;
+    size_t classesOffset;
+
+public:
+    ShardExchange(int width, int haloRows, int shardCount, uint64_t ticks)
+        : base(nullptr), haloRows(haloRows),
+          migrantCapacity(static_cast<size_t>(width) * haloRows) {
+        summariesOffset = alignUp(sizeof(pthread_barrier_t));
+        totalsOffset = summariesOffset + alignUp(shardCount * sizeof(ShardSummary));
+        slotsOffset = totalsOffset + alignUp((ticks + 1) * sizeof(atomic<uint64_t>));
+        migrantsOffset = alignUp(sizeof(SlotHeader));
+        classesOffset = migrantsOffset + alignUp(migrantCapacity * sizeof(Migrant));
+        slotBytes = classesOffset + alignUp(migrantCapacity * sizeof(FoodClass));
+        bytes = slotsOffset + static_cast<size_t>(shardCount) * 4 * slotBytes;
+    }
+
+    ~ShardExchange() {
+        close();
+    }
+
+    // Maps the region and sets up the barrier; the children inherit both
+    bool open(int shardCount, uint64_t ticks) {
+        void* mapped = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+        if (mapped == MAP_FAILED) return false;
+        base = static_cast<unsigned char*>(mapped);
+
+        pthread_barrierattr_t attributes;
+        pthread_barrierattr_init(&attributes);
+        pthread_barrierattr_setpshared(&attributes, PTHREAD_PROCESS_SHARED);
+        int failed = pthread_barrier_init(barrier(), &attributes, static_cast<unsigned>(shardCount));
+        pthread_barrierattr_destroy(&attributes);
+        if (failed != 0) {
+            munmap(base, bytes);
+            base = nullptr;
+            return false;
+        }
+        for (uint64_t tick = 0; tick <= ticks; ++tick) {
+            new (&total(tick)) atomic<uint64_t>(0);
+        }
+        return true;
+    }
+
+    // The barrier is not destroyed: a shard killed while waiting at it
+    // leaves it in use, and destroying it would wait for that shard forever
+    void close() {
+        if (base == nullptr) return;
+        munmap(base, bytes);
+        base = nullptr;
+    }
+
+    pthread_barrier_t* barrier() {
+        return reinterpret_cast<pthread_barrier_t*>(base);
+    }
+
+    ShardSummary& summary(int shard) {
+        return reinterpret_cast<ShardSummary*>(base + summariesOffset)[shard];
+    }
+
+    atomic<uint64_t>& total(uint64_t tick) {
+        return reinterpret_cast<atomic<uint64_t>*>(base + totalsOffset)[tick];
+    }
+
+    unsigned char* slot(int shard, Direction direction, uint64_t tick) {
+        size_t index = static_cast<size_t>(shard) * 4 + static_cast<size_t>(direction) * 2 + tick % 2;
+        return base + slotsOffset + index * slotBytes;
+    }
+
+    int getHaloRows() const { return haloRows; }
+    size_t getMigrantCapacity() const { return migrantCapacity; }
+
+    static SlotHeader& header(unsigned char* slot) {
+        return *reinterpret_cast<SlotHeader*>(slot);
+    }
+
+    Migrant* migrants(unsigned char* slot) const {
+        return reinterpret_cast<Migrant*>(slot + migrantsOffset);
+    }
+
+    FoodClass* classes(unsigned char* slot) const {
+        return reinterpret_cast<FoodClass*>(slot + classesOffset);
+    }
+};
+
+// Stand-in for an organism of another shard. Only its food class matters.
+Organism* makeGhost(FoodClass foodClass) {
+    if (foodClass == FOOD_CLASS_PLANT) {
+        return new Plant(1.0f, 1, 0.0f, 0.0f);
+    }
+    AnimalType type = static_cast<AnimalType>(foodClass - FOOD_CLASS_FIRST_ANIMAL);
+    return new Animal(1.0f, 1, 1, 1, type, 1.0f, 1.0f, 1);
+}
+
+// The shard's side of the run, inside its forked process
+class ShardProcess {
+private:
+    ShardExchange& exchange;
+    ShardBand band;
+    int shardCount;
+    int width;
+    WorldManager& world;
+    ShardSummary summary;
+    vector<Organism*> emigrants;
+
+    int getOwnedLocalFirst() const { return band.haloAbove; }
+    int getOwnedLocalLast() const { return band.haloAbove + band.getOwnedRows(); }
+
+    bool isFree(int x, int localRow) const {
+        return world.getGrid().getFoodClasses()[static_cast<size_t>(localRow) * width + x] == FOOD_CLASS_EMPTY;
+    }
+
+    void waitForNeighbors() {
+        int result = pthread_barrier_wait(exchange.barrier());
+        if (result != 0 && result != PTHREAD_BARRIER_SERIAL_THREAD) {
+            throw runtime_error("Shard barrier failed");
+        }
+    }
+
+    void publish(uint64_t tick);
+    void receive(uint64_t tick);
+    void receiveFrom(unsigned char* slot, int localRow, int rows);
+    void placeImmigrant(const Migrant& migrant);
+    bool findFreeOwnedTile(int x, int localRow, int& freeX, int& freeRow) const;
+    void countGhosts();
+
+public:
+    ShardProcess(ShardExchange& exchange, const ShardBand& band, int shardCount, WorldManager& world)
+        : exchange(exchange), band(band), shardCount(shardCount), width(world.getGrid().getWidth()),
+          world(world), summary() {}
+
+    void run(uint64_t ticks, const ShardedRunner::Populate& populate);
+};
+
+void ShardProcess::run(uint64_t ticks, const ShardedRunner::Populate& populate) {
+    world.setOwnedRows(getOwnedLocalFirst(), getOwnedLocalLast());
+    populate(world, band);
+
+    // Tick 0 only mirrors the initial populations into the halos
+    for (uint64_t tick = 0; tick <= ticks; ++tick) {
+        if (tick > 0) {
+            world.update();
+        }
+        publish(tick);
+        waitForNeighbors();
+        receive(tick);
+        exchange.total(tick).fetch_add(static_cast<uint64_t>(world.getOrganismCount()));
+    }
+
+    summary.organisms = static_cast<uint64_t>(world.getOrganismCount());
+    countGhosts();
+    summary.completed = 1;
+    exchange.summary(band.shard) = summary;
+}
+
+void ShardProcess::publish(uint64_t tick) {
+    unsigned char* up = band.shard > 0 ? exchange.slot(band.shard, UP, tick) : nullptr;
+    unsigned char* down = band.shard < shardCount - 1 ? exchange.slot(band.shard, DOWN, tick) : nullptr;
+    if (up != nullptr) ShardExchange::header(up).migrants = 0;
+    if (down != nullptr) ShardExchange::header(down).migrants = 0;
+
+    emigrants.clear();
+    world.takeEmigrants(emigrants);
+    for (Organism* organism : emigrants) {
+        Position position = organism->getPosition();
+        unsigned char* slot = position.getY() < getOwnedLocalFirst() ? up : down;
+        uint32_t& count = ShardExchange::header(slot).migrants;
+        if (count < exchange.getMigrantCapacity()) {
+            Migrant& migrant = exchange.migrants(slot)[count++];
+            migrant.organism = CompactOrganism::pack(*organism, width);
+            migrant.organism.setPosition(Position(position.getX(), band.toGlobalRow(position.getY())), width);
+            migrant.species = organism->getSpecies();
+            ++summary.emigrants;
+        } else {
+            ++summary.lost;
+        }
+        delete organism;
+    }
+
+    const FoodClass* classes = world.getGrid().getFoodClasses();
+    size_t haloBytes = exchange.getMigrantCapacity() * sizeof(FoodClass);
+    if (up != nullptr) {
+        memcpy(exchange.classes(up), classes + static_cast<size_t>(getOwnedLocalFirst()) * width, haloBytes);
+    }
+    if (down != nullptr) {
+        size_t firstRow = static_cast<size_t>(getOwnedLocalLast() - exchange.getHaloRows());
+        memcpy(exchange.classes(down), classes + firstRow * width, haloBytes);
+    }
+}
+
+void ShardProcess::receive(uint64_t tick) {
+    if (band.shard > 0) {
+        receiveFrom(exchange.slot(band.shard - 1, DOWN, tick), 0, band.haloAbove);
+    }
+    if (band.shard < shardCount - 1) {
+        receiveFrom(exchange.slot(band.shard + 1, UP, tick), getOwnedLocalLast(), band.haloBelow);
+    }
+}
+
+// Migrants land in the owned rows and ghosts in the halo rows, so neither
+// disturbs the other
+void ShardProcess::receiveFrom(unsigned char* slot, int localRow, int rows) {
+    const Migrant* migrants = exchange.migrants(slot);
+    uint32_t count = ShardExchange::header(slot).migrants;
+    for (uint32_t i = 0; i < count; ++i) {
+        placeImmigrant(migrants[i]);
+    }
+
+    const FoodClass* mirrored = exchange.classes(slot);
+    const FoodClass* current = world.getGrid().getFoodClasses();
+    for (int row = 0; row < rows; ++row) {
+        for (int x = 0; x < width; ++x) {
+            FoodClass wanted = mirrored[static_cast<size_t>(row) * width + x];
+            if (current[static_cast<size_t>(localRow + row) * width + x] == wanted) continue;
+            delete world.removeGhost(x, localRow + row);
+            if (wanted != FOOD_CLASS_EMPTY) {
+                world.placeGhost(makeGhost(wanted), x, localRow + row);
+            }
+            ++summary.haloUpdates;
+        }
+    }
+}
+
+// The neighbor only knew this shard's rows as of its halo, so the target can
+// have been taken in the meantime
+void ShardProcess::placeImmigrant(const Migrant& migrant) {
+    CompactOrganism record = migrant.organism;
+    record.setSpeciesId(SpeciesRegistry::intern(migrant.species));
+    Position position = record.getPosition(width);
+    int x = position.getX();
+    int localRow = band.toLocalRow(position.getY());
+    int freeX = x;
+    int freeRow = localRow;
+    if (!band.owns(position.getY()) || !findFreeOwnedTile(x, localRow, freeX, freeRow)) {
+        ++summary.lost;
+        return;
+    }
+    if (freeX != x || freeRow != localRow) {
+        ++summary.displaced;
+    }
+    world.addOrganism(record.unpack(width), freeX, freeRow);
+    ++summary.immigrants;
+}
+
+// Searches square rings of growing radius around the target
+bool ShardProcess::findFreeOwnedTile(int x, int localRow, int& freeX, int& freeRow) const {
+    int first = getOwnedLocalFirst();
+    int last = getOwnedLocalLast();
+    int maxRadius = max(width, last - first);
+    for (int radius = 0; radius <= maxRadius; ++radius) {
+        for (int dy = -radius; dy <= radius; ++dy) {
+            int row = localRow + dy;
+            if (row < first || row >= last) continue;
+            bool edgeRow = dy == -radius || dy == radius;
+            for (int dx = -radius; dx <= radius; dx += edgeRow ? 1 : 2 * max(radius, 1)) {
+                int column = x + dx;
+                if (column < 0 || column >= width) continue;
+                if (isFree(column, row)) {
+                    freeX = column;
+                    freeRow = row;
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+void ShardProcess::countGhosts() {
+    const FoodClass* classes = world.getGrid().getFoodClasses();
+    int localHeight = band.getLocalHeight();
+    for (int row = 0; row < localHeight; ++row) {
+        if (row >= getOwnedLocalFirst() && row < getOwnedLocalLast()) continue;
+        for (int x = 0; x < width; ++x) {
+            if (classes[static_cast<size_t>(row) * width + x] != FOOD_CLASS_EMPTY) {
+                ++summary.ghosts;
+            }
+        }
+    }
+}
+
+// The child never returns into the caller's stack, and exits without tearing
+// its world down
+[[noreturn]] void runShard(ShardExchange& exchange, const ShardBand& band, int shardCount, int width,
+                           float baseNutrients, uint64_t ticks, const ShardedRunner::Populate& populate) {
+    int status = 0;
+    try {
+        WorldManager::forgetInstanceAfterFork();
+        WorldManager& world = WorldManager::getInstance(width, band.getLocalHeight(), baseNutrients);
+        ShardProcess process(exchange, band, shardCount, world);
+        process.run(ticks, populate);
+    } catch (const exception& e) {
+        cerr << "Shard " << band.shard << " failed: " << e.what() << endl;
+        status = 1;
+    }
+    cout.flush();
+    cerr.flush();
+    _exit(status);
+}
+}
+
+bool ShardedRunner::run(uint64_t ticks, const Populate& populate) {
+    // A child gets only the forking thread, plus every lock another thread
+    // held at that moment
+    if (WorldManager::isRecordingStatistics()) {
+        throw logic_error("Close the world's statistics before a sharded run");
+    }
+    summaries.assign(shardCount, ShardSummary());
+    organismsPerTick.assign(ticks + 1, 0);
+
+    ShardExchange exchange(width, haloRows, shardCount, ticks);
+    if (!exchange.open(shardCount, ticks)) {
+        cerr << "Warning: Cannot map the shard exchange region" << endl;
+        return false;
+    }
+    // The pool's workers come back on the parent's next shared(), and each
+    // child starts its own
+    TaskPool::stopShared();
+    // Anything still buffered would be written once per child
+    cout.flush();
+    cerr.flush();
+
+    vector<pid_t> children;
+    bool failed = false;
+    for (int shard = 0; shard < shardCount; ++shard) {
+        pid_t child = fork();
+        if (child == 0) {
+            runShard(exchange, bandFor(shard), shardCount, width, baseNutrients, ticks, populate);
+        }
+        if (child < 0) {
+            cerr << "Warning: Cannot fork shard " << shard << endl;
+            failed = true;
+            break;
+        }
+        children.push_back(child);
+    }
+
+    // The others would wait at the barrier forever once one shard is gone
+    vector<bool> reaped(children.size(), false);
+    auto killRunning = [&]() {
+        for (size_t i = 0; i < children.size(); ++i) {
+            if (!reaped[i]) kill(children[i], SIGKILL);
+        }
+    };
+    if (failed) {
+        killRunning();
+    }
+    size_t running = children.size();
+    while (running > 0) {
+        int status = 0;
+        pid_t done = waitpid(-1, &status, 0);
+        if (done < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        auto found = find(children.begin(), children.end(), done);
+        if (found == children.end()) continue;
+        reaped[found - children.begin()] = true;
+        --running;
+        if (!failed && (!WIFEXITED(status) || WEXITSTATUS(status) != 0)) {
+            failed = true;
+            killRunning();
+        }
+    }
+
+    for (int shard = 0; shard < shardCount; ++shard) {
+        summaries[shard] = exchange.summary(shard);
+        failed = failed || summaries[shard].completed == 0;
+    }
+    for (uint64_t tick = 0; tick <= ticks; ++tick) {
+        organismsPerTick[tick] = exchange.total(tick).load();
+    }
+    exchange.close();
+    return !failed;
+}
+#else
+bool ShardedRunner::run(uint64_t ticks, const Populate& populate) {
+    (void)populate;
+    summaries.assign(shardCount, ShardSummary());
+    organismsPerTick.assign(ticks + 1, 0);
+    cerr << "Warning: Sharded runs need fork() and process-shared barriers" << endl;
+    return false;
+}
+#endif
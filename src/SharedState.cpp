@@ -0,0 +1,324 @@
+#include "SharedState.h"
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define SHARED_STATE_SUPPORTED 1
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#define SHARED_STATE_SUPPORTED 0
+#endif
+
+using namespace std;
+
+static const char MAGIC[8] = {'E', 'C', 'O', 'S', 'H', 'M', '0', '1'};
+static const size_t ALIGNMENT = 64;
+
+static size_t alignUp(size_t bytes) {
+    return (bytes + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+}
+
+// Offsets of the layers inside one frame and the stride between frames
+struct FrameLayout {
+    size_t occupancyOffset;
+    size_t nutrientOffset;
+    size_t stride;
+};
+
+static FrameLayout frameLayout(size_t tiles, bool withNutrients) {
+    FrameLayout layout;
+    layout.occupancyOffset = sizeof(SharedFrameHeader);
+    size_t end = alignUp(layout.occupancyOffset + tiles * sizeof(FoodClass));
+    layout.nutrientOffset = withNutrients ? end : 0;
+    if (withNutrients) {
+        end = alignUp(end + tiles * sizeof(float));
+    }
+    layout.stride = end;
+    return layout;
+}
+
+// Whether a layer of `bytes` starting at `offset` lies inside one frame,
+// after the frame header, without overflowing on the way
+static bool layerFits(uint64_t offset, uint64_t bytes, uint64_t stride) {
+    return offset >= sizeof(SharedFrameHeader) && offset <= stride && bytes <= stride - offset;
+}
+
+// What a reader checks before trusting a header it did not write: a segment
+// from another build, or a damaged one, must not send the views past a frame
+// or past the mapping
+static bool headerFits(const SharedStateHeader& header, size_t mappedBytes) {
+    if (header.width == 0 || header.height == 0 || header.frameCount == 0) return false;
+    if (header.frameStride % alignof(SharedFrameHeader) != 0) return false;
+    uint64_t tiles = static_cast<uint64_t>(header.width) * header.height;
+    if (!layerFits(header.occupancyOffset, tiles * sizeof(FoodClass), header.frameStride)) return false;
+    if (header.nutrientOffset != 0 &&
+        (header.nutrientOffset % alignof(float) != 0 ||
+         !layerFits(header.nutrientOffset, tiles * sizeof(float), header.frameStride))) {
+        return false;
+    }
+    return header.frameStride <= (mappedBytes - sizeof(SharedStateHeader)) / header.frameCount;
+}
+
+size_t SharedStateExporter::segmentBytes(int width, int height, int frameCount, bool withNutrients) {
+    size_t tiles = static_cast<size_t>(width) * static_cast<size_t>(height);
+    return sizeof(SharedStateHeader) + frameLayout(tiles, withNutrients).stride * static_cast<size_t>(frameCount);
+}
+
+SharedStateExporter::SharedStateExporter()
+    : fd(-1), base(nullptr), mappedBytes(0), header(nullptr) { }
+
+SharedStateExporter::~SharedStateExporter() {
+    close();
+}
+
+bool SharedStateExporter::open(const string& segmentName, int width, int height, int frameCount, bool withNutrients) {
+    if (width <= 0 || height <= 0) {
+        throw invalid_argument("Shared state dimensions must be positive");
+    }
+    if (frameCount < 1) {
+        throw invalid_argument("Shared state ring needs at least one frame");
+    }
+    close();
+
+#if SHARED_STATE_SUPPORTED
+    size_t bytes = segmentBytes(width, height, frameCount, withNutrients);
+    // Never truncate a segment in use: readers still mapping it would fault
+    // past the new end. One left behind by a crashed writer is replaced, and
+    // readers still attached to it keep the old one until they reopen.
+    int created = shm_open(segmentName.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (created < 0 && errno == EEXIST) {
+        cerr << "Warning: Replacing existing shared memory segment " << segmentName << endl;
+        shm_unlink(segmentName.c_str());
+        created = shm_open(segmentName.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    }
+    if (created < 0) {
+        cerr << "Warning: Cannot create shared memory segment " << segmentName << endl;
+        return false;
+    }
+    if (ftruncate(created, static_cast<off_t>(bytes)) != 0) {
+        cerr << "Warning: Cannot size shared memory segment " << segmentName << endl;
+        ::close(created);
+        shm_unlink(segmentName.c_str());
+        return false;
+    }
+    void* mapped = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, created, 0);
+    if (mapped == MAP_FAILED) {
+        cerr << "Warning: Cannot map shared memory segment " << segmentName << endl;
+        ::close(created);
+        shm_unlink(segmentName.c_str());
+        return false;
+    }
+
+    name = segmentName;
+    fd = created;
+    base = static_cast<unsigned char*>(mapped);
+    mappedBytes = bytes;
+
+    // ftruncate zero-fills, so every frame starts with an even sequence and
+    // published stays 0 until the first frame is complete
+    FrameLayout layout = frameLayout(static_cast<size_t>(width) * static_cast<size_t>(height), withNutrients);
+    header = new (base) SharedStateHeader();
+    header->version = SHARED_STATE_VERSION;
+    header->width = static_cast<uint32_t>(width);
+    header->height = static_cast<uint32_t>(height);
+    header->frameCount = static_cast<uint32_t>(frameCount);
+    header->layers = SHARED_LAYER_OCCUPANCY | (withNutrients ? SHARED_LAYER_NUTRIENTS : 0u);
+    header->reserved = 0;
+    header->frameStride = layout.stride;
+    header->occupancyOffset = layout.occupancyOffset;
+    header->nutrientOffset = layout.nutrientOffset;
+    header->published.store(0, memory_order_relaxed);
+    for (int i = 0; i < frameCount; ++i) {
+        new (base + sizeof(SharedStateHeader) + layout.stride * static_cast<size_t>(i)) SharedFrameHeader();
+    }
+    // Readers check the magic first, so it goes in once the rest is valid
+    atomic_thread_fence(memory_order_release);
+    memcpy(header->magic, MAGIC, sizeof(MAGIC));
+    return true;
+#else
+    (void)segmentName;
+    (void)withNutrients;
+    cerr << "Warning: Shared memory export is not supported on this platform" << endl;
+    return false;
+#endif
+}
+
+void SharedStateExporter::close() {
+#if SHARED_STATE_SUPPORTED
+    if (base != nullptr) {
+        munmap(base, mappedBytes);
+        ::close(fd);
+        shm_unlink(name.c_str());
+    }
+#endif
+    fd = -1;
+    base = nullptr;
+    mappedBytes = 0;
+    header = nullptr;
+    name.clear();
+}
+
+void SharedStateExporter::publish(uint64_t tick, uint64_t organisms, const FoodClass* occupancy, const float* nutrients) {
+    if (header == nullptr) return;
+
+    uint64_t published = header->published.load(memory_order_relaxed);
+    size_t index = static_cast<size_t>(published % header->frameCount);
+    unsigned char* frameBase = base + sizeof(SharedStateHeader) + header->frameStride * index;
+    SharedFrameHeader* frame = reinterpret_cast<SharedFrameHeader*>(frameBase);
+    size_t tiles = static_cast<size_t>(header->width) * header->height;
+
+    uint64_t sequence = frame->sequence.load(memory_order_relaxed);
+    frame->sequence.store(sequence + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    frame->tick = tick;
+    frame->organisms = organisms;
+    memcpy(frameBase + header->occupancyOffset, occupancy, tiles * sizeof(FoodClass));
+    if (header->nutrientOffset != 0 && nutrients != nullptr) {
+        memcpy(frameBase + header->nutrientOffset, nutrients, tiles * sizeof(float));
+    }
+
+    frame->sequence.store(sequence + 2, memory_order_release);
+    header->published.store(published + 1, memory_order_release);
+}
+
+uint64_t SharedStateExporter::getPublishedCount() const {
+    return header == nullptr ? 0 : header->published.load(memory_order_acquire);
+}
+
+SharedStateReader::SharedStateReader()
+    : fd(-1), base(nullptr), mappedBytes(0), header(nullptr) { }
+
+SharedStateReader::~SharedStateReader() {
+    close();
+}
+
+bool SharedStateReader::open(const string& segmentName) {
+    close();
+
+#if SHARED_STATE_SUPPORTED
+    int opened = shm_open(segmentName.c_str(), O_RDONLY, 0);
+    if (opened < 0) return false;
+
+    struct stat info;
+    if (fstat(opened, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(SharedStateHeader)) {
+        ::close(opened);
+        return false;
+    }
+    size_t bytes = static_cast<size_t>(info.st_size);
+    void* mapped = mmap(nullptr, bytes, PROT_READ, MAP_SHARED, opened, 0);
+    if (mapped == MAP_FAILED) {
+        ::close(opened);
+        return false;
+    }
+
+    const SharedStateHeader* candidate = static_cast<const SharedStateHeader*>(mapped);
+    bool valid = memcmp(candidate->magic, MAGIC, sizeof(MAGIC)) == 0;
+    atomic_thread_fence(memory_order_acquire);
+    valid = valid && candidate->version == SHARED_STATE_VERSION && headerFits(*candidate, bytes);
+    if (!valid) {
+        munmap(mapped, bytes);
+        ::close(opened);
+        return false;
+    }
+
+    fd = opened;
+    base = static_cast<const unsigned char*>(mapped);
+    mappedBytes = bytes;
+    header = candidate;
+    return true;
+#else
+    (void)segmentName;
+    return false;
+#endif
+}
+
+void SharedStateReader::close() {
+#if SHARED_STATE_SUPPORTED
+    if (base != nullptr) {
+        munmap(const_cast<unsigned char*>(base), mappedBytes);
+        ::close(fd);
+    }
+#endif
+    fd = -1;
+    base = nullptr;
+    mappedBytes = 0;
+    header = nullptr;
+}
+
+int SharedStateReader::getWidth() const {
+    return header == nullptr ? 0 : static_cast<int>(header->width);
+}
+
+int SharedStateReader::getHeight() const {
+    return header == nullptr ? 0 : static_cast<int>(header->height);
+}
+
+int SharedStateReader::getFrameCount() const {
+    return header == nullptr ? 0 : static_cast<int>(header->frameCount);
+}
+
+bool SharedStateReader::hasNutrients() const {
+    return header != nullptr && header->nutrientOffset != 0;
+}
+
+uint64_t SharedStateReader::getPublishedCount() const {
+    return header == nullptr ? 0 : header->published.load(memory_order_acquire);
+}
+
+bool SharedStateReader::acquireLatest(SharedFrameView& view) const {
+    if (header == nullptr) return false;
+    uint64_t published = header->published.load(memory_order_acquire);
+    if (published == 0) return false;
+
+    size_t index = static_cast<size_t>((published - 1) % header->frameCount);
+    const unsigned char* frameBase = base + sizeof(SharedStateHeader) + header->frameStride * index;
+    const SharedFrameHeader* frame = reinterpret_cast<const SharedFrameHeader*>(frameBase);
+
+    uint64_t sequence = frame->sequence.load(memory_order_acquire);
+    if (sequence & 1u) return false;
+
+    view.sequence = sequence;
+    view.tick = frame->tick;
+    view.organisms = frame->organisms;
+    view.occupancy = reinterpret_cast<const FoodClass*>(frameBase + header->occupancyOffset);
+    view.nutrients = header->nutrientOffset != 0
+        ? reinterpret_cast<const float*>(frameBase + header->nutrientOffset)
+        : nullptr;
+    view.frame = frame;
+    return true;
+}
+
+bool SharedStateReader::validate(const SharedFrameView& view) const {
+    if (view.frame == nullptr) return false;
+    // Orders the reads made through the view before the sequence re-check
+    atomic_thread_fence(memory_order_acquire);
+    return view.frame->sequence.load(memory_order_relaxed) == view.sequence;
+}
+
+bool SharedStateReader::copyLatest(SharedFrameCopy& copy, int attempts) const {
+    size_t tiles = static_cast<size_t>(getWidth()) * static_cast<size_t>(getHeight());
+    for (int attempt = 0; attempt < attempts; ++attempt) {
+        SharedFrameView view;
+        if (!acquireLatest(view)) continue;
+
+        copy.occupancy.assign(view.occupancy, view.occupancy + tiles);
+        if (view.nutrients != nullptr) {
+            copy.nutrients.assign(view.nutrients, view.nutrients + tiles);
+        } else {
+            copy.nutrients.clear();
+        }
+        if (validate(view)) {
+            copy.tick = view.tick;
+            copy.organisms = view.organisms;
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,197 @@
+#include "SimulationMetrics.h"
+#include <cstdio>
+#include <iostream>
+
+using namespace std;
+
+SimulationMetrics::SimulationMetrics() : tick(0) {
+    reset();
+}
+
+size_t SimulationMetrics::shardIndex() {
+    static atomic<size_t> nextShard(0);
+    thread_local size_t index = nextShard.fetch_add(1, memory_order_relaxed) % SHARD_COUNT;
+    return index;
+}
+
+uint64_t SimulationMetrics::getTotal(MetricCounter counter) const {
+    uint64_t total = 0;
+    for (const Shard& shard : shards) {
+        total += shard.counters[static_cast<size_t>(counter)].load(memory_order_relaxed);
+    }
+    return total;
+}
+
+int64_t SimulationMetrics::getGauge(MetricGauge gauge) const {
+    return gauges[static_cast<size_t>(gauge)].load(memory_order_relaxed);
+}
+
+void SimulationMetrics::endTick() {
+    ++tick;
+    for (size_t i = 0; i < COUNTER_COUNT; ++i) {
+        uint64_t total = getTotal(static_cast<MetricCounter>(i));
+        lastTickDeltas[i] = total - totalsAtLastTick[i];
+        totalsAtLastTick[i] = total;
+    }
+}
+
+uint64_t SimulationMetrics::getLastTickDelta(MetricCounter counter) const {
+    return lastTickDeltas[static_cast<size_t>(counter)];
+}
+
+void SimulationMetrics::reset() {
+    for (Shard& shard : shards) {
+        for (auto& counter : shard.counters) {
+            counter.store(0, memory_order_relaxed);
+        }
+    }
+    for (auto& gauge : gauges) {
+        gauge.store(0, memory_order_relaxed);
+    }
+    tick = 0;
+    totalsAtLastTick.fill(0);
+    lastTickDeltas.fill(0);
+}
+
+const char* SimulationMetrics::counterName(MetricCounter counter) {
+    switch (counter) {
+        case MetricCounter::BIRTHS: return "births";
+        case MetricCounter::DEATHS_STARVATION: return "deaths_starvation";
+        case MetricCounter::DEATHS_OLD_AGE: return "deaths_old_age";
+        case MetricCounter::DEATHS_PREDATION: return "deaths_predation";
+        case MetricCounter::MOVES: return "moves";
+        case MetricCounter::EATS: return "eats";
+        case MetricCounter::FAILED_SPREADS: return "failed_spreads";
+        case MetricCounter::DECOMPOSITION_SPAWNS: return "decomposition_spawns";
+        case MetricCounter::INTENT_CONFLICTS: return "intent_conflicts";
+        default: return "unknown";
+    }
+}
+
+const char* SimulationMetrics::gaugeName(MetricGauge gauge) {
+    switch (gauge) {
+        case MetricGauge::ORGANISMS: return "organisms";
+        case MetricGauge::PLANTS: return "plants";
+        case MetricGauge::HERBIVORES: return "herbivores";
+        case MetricGauge::CARNIVORES: return "carnivores";
+        case MetricGauge::OMNIVORES: return "omnivores";
+        default: return "unknown";
+    }
+}
+
+MetricsExporter::MetricsExporter() : intervalTicks(0) {
+    totalsAtLastRow.fill(0);
+}
+
+void MetricsExporter::configure(const string& promPath, const string& csv, int interval) {
+    prometheusPath = promPath;
+    csvPath = csv;
+    intervalTicks = interval;
+    totalsAtLastRow.fill(0);
+
+    if (csvFile.is_open()) {
+        csvFile.close();
+    }
+    if (!csvPath.empty()) {
+        csvFile.open(csvPath, ios::out | ios::trunc);
+        if (!csvFile) {
+            cerr << "Warning: Cannot open metrics CSV file " << csvPath << endl;
+            return;
+        }
+        csvFile << "tick";
+        for (size_t i = 0; i < SimulationMetrics::COUNTER_COUNT; ++i) {
+            csvFile << ',' << SimulationMetrics::counterName(static_cast<MetricCounter>(i));
+        }
+        for (size_t i = 0; i < SimulationMetrics::GAUGE_COUNT; ++i) {
+            csvFile << ',' << SimulationMetrics::gaugeName(static_cast<MetricGauge>(i));
+        }
+        csvFile << '\n';
+    }
+}
+
+void MetricsExporter::onTick(const SimulationMetrics& metrics) {
+    if (intervalTicks <= 0 || metrics.getTick() % static_cast<uint64_t>(intervalTicks) != 0) {
+        return;
+    }
+    flush(metrics);
+}
+
+void MetricsExporter::flush(const SimulationMetrics& metrics) {
+    if (!prometheusPath.empty()) {
+        writePrometheus(metrics);
+    }
+    if (csvFile.is_open()) {
+        appendCsvRow(metrics);
+    }
+}
+
+// The textfile collector may read at any moment, so the file is written next
+// to its destination and renamed into place to never expose a partial file.
+void MetricsExporter::writePrometheus(const SimulationMetrics& metrics) const {
+    string tmpPath = prometheusPath + ".tmp";
+    {
+        ofstream out(tmpPath, ios::out | ios::trunc);
+        if (!out) {
+            cerr << "Warning: Cannot write metrics file " << tmpPath << endl;
+            return;
+        }
+
+        out << "# HELP ecosystem_tick Number of completed simulation ticks.\n"
+            << "# TYPE ecosystem_tick counter\n"
+            << "ecosystem_tick " << metrics.getTick() << '\n';
+
+        out << "# HELP ecosystem_births_total Organisms born through reproduction or spreading.\n"
+            << "# TYPE ecosystem_births_total counter\n"
+            << "ecosystem_births_total " << metrics.getTotal(MetricCounter::BIRTHS) << '\n';
+
+        out << "# HELP ecosystem_deaths_total Organisms that died, by cause.\n"
+            << "# TYPE ecosystem_deaths_total counter\n"
+            << "ecosystem_deaths_total{cause=\"starvation\"} " << metrics.getTotal(MetricCounter::DEATHS_STARVATION) << '\n'
+            << "ecosystem_deaths_total{cause=\"old_age\"} " << metrics.getTotal(MetricCounter::DEATHS_OLD_AGE) << '\n'
+            << "ecosystem_deaths_total{cause=\"predation\"} " << metrics.getTotal(MetricCounter::DEATHS_PREDATION) << '\n';
+
+        out << "# HELP ecosystem_moves_total Animal moves to a different tile.\n"
+            << "# TYPE ecosystem_moves_total counter\n"
+            << "ecosystem_moves_total " << metrics.getTotal(MetricCounter::MOVES) << '\n';
+
+        out << "# HELP ecosystem_eats_total Organisms eaten by animals.\n"
+            << "# TYPE ecosystem_eats_total counter\n"
+            << "ecosystem_eats_total " << metrics.getTotal(MetricCounter::EATS) << '\n';
+
+        out << "# HELP ecosystem_failed_spreads_total Plant spread attempts without a free tile.\n"
+            << "# TYPE ecosystem_failed_spreads_total counter\n"
+            << "ecosystem_failed_spreads_total " << metrics.getTotal(MetricCounter::FAILED_SPREADS) << '\n';
+
+        out << "# HELP ecosystem_decomposition_spawns_total Plants grown from dead organisms.\n"
+            << "# TYPE ecosystem_decomposition_spawns_total counter\n"
+            << "ecosystem_decomposition_spawns_total " << metrics.getTotal(MetricCounter::DECOMPOSITION_SPAWNS) << '\n';
+
+        out << "# HELP ecosystem_organisms Living organisms by type.\n"
+            << "# TYPE ecosystem_organisms gauge\n"
+            << "ecosystem_organisms{type=\"all\"} " << metrics.getGauge(MetricGauge::ORGANISMS) << '\n'
+            << "ecosystem_organisms{type=\"plant\"} " << metrics.getGauge(MetricGauge::PLANTS) << '\n'
+            << "ecosystem_organisms{type=\"herbivore\"} " << metrics.getGauge(MetricGauge::HERBIVORES) << '\n'
+            << "ecosystem_organisms{type=\"carnivore\"} " << metrics.getGauge(MetricGauge::CARNIVORES) << '\n'
+            << "ecosystem_organisms{type=\"omnivore\"} " << metrics.getGauge(MetricGauge::OMNIVORES) << '\n';
+    }
+
+    if (rename(tmpPath.c_str(), prometheusPath.c_str()) != 0) {
+        cerr << "Warning: Cannot move metrics file into place at " << prometheusPath << endl;
+    }
+}
+
+// Counter columns hold the events since the previous row, gauges the value at
+// the time of the row.
+void MetricsExporter::appendCsvRow(const SimulationMetrics& metrics) {
+    csvFile << metrics.getTick();
+    for (size_t i = 0; i < SimulationMetrics::COUNTER_COUNT; ++i) {
+        uint64_t total = metrics.getTotal(static_cast<MetricCounter>(i));
+        csvFile << ',' << (total - totalsAtLastRow[i]);
+        totalsAtLastRow[i] = total;
+    }
+    for (size_t i = 0; i < SimulationMetrics::GAUGE_COUNT; ++i) {
+        csvFile << ',' << metrics.getGauge(static_cast<MetricGauge>(i));
+    }
+    csvFile << '\n';
+    csvFile.flush();
+}
@@ -0,0 +1,146 @@
+#include "SoilField.h"
+#include "TaskPool.h"
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+using namespace std;
+
+namespace {
+
+// Regeneration only tops a cell up to capacity; what it already holds beyond
+// that (from deposits) is kept and diffuses like the rest
+inline float stencilCell(float center, float up, float down, float left, float right,
+                         float diffusionRate, float regeneration, float capacity) {
+    float diffused = center + diffusionRate * (up + down + left + right - 4.0f * center);
+    return max(diffused + min(regeneration, max(capacity - diffused, 0.0f)), 0.0f);
+}
+
+// Columns [firstX, lastX) of one output row. Missing neighbors across the
+// border are replaced by the cell itself, which makes the border flux zero.
+void stencilRow(const float* up, const float* row, const float* down, float* out,
+                int firstX, int lastX, int width,
+                float diffusionRate, float regeneration, float capacity) {
+    int x = firstX;
+    if (x == 0 && x < lastX) {
+        float right = width > 1 ? row[1] : row[0];
+        out[0] = stencilCell(row[0], up[0], down[0], row[0], right, diffusionRate, regeneration, capacity);
+        ++x;
+    }
+
+    int interiorEnd = min(lastX, width - 1);
+#if defined(__SSE2__)
+    const __m128 rate = _mm_set1_ps(diffusionRate);
+    const __m128 four = _mm_set1_ps(4.0f);
+    const __m128 regen = _mm_set1_ps(regeneration);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 cap = _mm_set1_ps(capacity);
+    for (; x + 4 <= interiorEnd; x += 4) {
+        __m128 center = _mm_loadu_ps(row + x);
+        __m128 sum = _mm_add_ps(_mm_add_ps(_mm_loadu_ps(up + x), _mm_loadu_ps(down + x)),
+                                _mm_add_ps(_mm_loadu_ps(row + x - 1), _mm_loadu_ps(row + x + 1)));
+        __m128 laplacian = _mm_sub_ps(sum, _mm_mul_ps(four, center));
+        __m128 diffused = _mm_add_ps(center, _mm_mul_ps(rate, laplacian));
+        __m128 topUp = _mm_min_ps(regen, _mm_max_ps(_mm_sub_ps(cap, diffused), zero));
+        _mm_storeu_ps(out + x, _mm_max_ps(_mm_add_ps(diffused, topUp), zero));
+    }
+#endif
+    for (; x < interiorEnd; ++x) {
+        out[x] = stencilCell(row[x], up[x], down[x], row[x - 1], row[x + 1], diffusionRate, regeneration, capacity);
+    }
+
+    if (x < lastX && x == width - 1) {
+        out[x] = stencilCell(row[x], up[x], down[x], row[x - 1], row[x], diffusionRate, regeneration, capacity);
+    }
+}
+
+}
+
+SoilField::SoilField(int width, int height, float initialLevel, float capacity, float diffusionRate)
+    : width(width), height(height), capacity(capacity), diffusionRate(diffusionRate), threadCount(0) {
+    if (width <= 0 || height <= 0) {
+        throw invalid_argument("Soil dimensions must be positive");
+    }
+    if (diffusionRate < 0.0f || diffusionRate > 0.25f) {
+        throw invalid_argument("Soil diffusion rate must be within [0, 0.25]");
+    }
+    current.assign(static_cast<size_t>(width) * height, min(initialLevel, capacity));
+    next.assign(current.size(), 0.0f);
+    setThreadCount(0);
+}
+
+float SoilField::getNutrients(int x, int y) const {
+    return current[static_cast<size_t>(y) * width + x];
+}
+
+void SoilField::setNutrients(int x, int y, float amount) {
+    current[static_cast<size_t>(y) * width + x] = amount;
+}
+
+float SoilField::draw(int x, int y, float amount) {
+    float& cell = current[static_cast<size_t>(y) * width + x];
+    float taken = min(max(amount, 0.0f), cell);
+    cell -= taken;
+    return taken;
+}
+
+void SoilField::deposit(int x, int y, float amount) {
+    current[static_cast<size_t>(y) * width + x] += max(amount, 0.0f);
+}
+
+double SoilField::getTotal() const {
+    double total = 0.0;
+    for (float value : current) {
+        total += value;
+    }
+    return total;
+}
+
+void SoilField::setThreadCount(int threads) {
+    if (threads <= 0) {
+        threads = static_cast<int>(thread::hardware_concurrency());
+    }
+    threadCount = max(threads, 1);
+}
+
+void SoilField::stepRows(int firstRow, int lastRow, float regeneration) {
+    const float* source = current.data();
+    float* target = next.data();
+    for (int firstX = 0; firstX < width; firstX += TILE_WIDTH) {
+        int lastX = min(firstX + TILE_WIDTH, width);
+        for (int y = firstRow; y < lastRow; ++y) {
+            const float* row = source + static_cast<size_t>(y) * width;
+            const float* up = y > 0 ? row - width : row;
+            const float* down = y < height - 1 ? row + width : row;
+            stencilRow(up, row, down, target + static_cast<size_t>(y) * width,
+                       firstX, lastX, width, diffusionRate, regeneration, capacity);
+        }
+    }
+}
+
+void SoilField::step(float regeneration) {
+    size_t cells = current.size();
+    int bands = static_cast<int>(min<size_t>(static_cast<size_t>(threadCount), max<size_t>(cells / MIN_CELLS_PER_THREAD, 1)));
+    bands = min(bands, height);
+
+    if (bands <= 1) {
+        stepRows(0, height, regeneration);
+    } else {
+        TaskPool::shared().parallelFor(static_cast<size_t>(bands), 1, [&](size_t first, size_t last, int) {
+            for (size_t band = first; band < last; ++band) {
+                int firstRow = static_cast<int>(height * band / bands);
+                int lastRow = static_cast<int>(height * (band + 1) / bands);
+                stepRows(firstRow, lastRow, regeneration);
+            }
+        });
+    }
+
+    current.swap(next);
+}
+
+MemoryFootprint SoilField::getMemoryFootprint() const {
+    return {(current.capacity() + next.capacity()) * sizeof(float), 2};
+}
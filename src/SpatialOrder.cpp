@@ -0,0 +1,80 @@
+#include "SpatialOrder.h"
+#include "Organism.h"
+#include <algorithm>
+#include <utility>
+
+using namespace std;
+
+namespace {
+const size_t GATHER_PREFETCH_DISTANCE = 8;
+
+int bitsFor(size_t count) {
+    int bits = 0;
+    while (bits < 64 && (static_cast<size_t>(1) << bits) < count) {
+        ++bits;
+    }
+    return bits;
+}
+}
+
+SpatialOrder::SpatialOrder() : counts(static_cast<size_t>(1) << DIGIT_BITS), sortCount(0), sortedOrganisms(0) {}
+
+// Lists that are already in order (the common case between two passes, since
+// the timing wheel hands organisms back in the order they were rescheduled)
+// cost only the key gathering.
+void SpatialOrder::sort(vector<Organism*>& organisms, const TileLayout& layout) {
+    size_t count = organisms.size();
+    entries.resize(count);
+    bool ordered = true;
+    for (size_t i = 0; i < count; ++i) {
+#if defined(__GNUC__) || defined(__clang__)
+        if (i + GATHER_PREFETCH_DISTANCE < count) {
+            __builtin_prefetch(organisms[i + GATHER_PREFETCH_DISTANCE]);
+        }
+#endif
+        const Position& position = organisms[i]->getPosition();
+        entries[i] = {static_cast<uint32_t>(layout.index(position.getX(), position.getY())), organisms[i]};
+        ordered = ordered && (i == 0 || entries[i - 1].key <= entries[i].key);
+    }
+    ++sortCount;
+    sortedOrganisms += count;
+    if (ordered) return;
+
+    // Ping-pongs between entries and scratch one digit at a time
+    int keyBits = bitsFor(layout.getStorageSize());
+    scratch.resize(count);
+    vector<Entry>* from = &entries;
+    vector<Entry>* to = &scratch;
+    uint32_t mask = static_cast<uint32_t>(counts.size() - 1);
+    for (int shift = 0; shift < keyBits; shift += DIGIT_BITS) {
+        fill(counts.begin(), counts.end(), 0);
+        for (const Entry& entry : *from) {
+            ++counts[(entry.key >> shift) & mask];
+        }
+        uint32_t offset = 0;
+        for (uint32_t& bucket : counts) {
+            uint32_t size = bucket;
+            bucket = offset;
+            offset += size;
+        }
+        for (const Entry& entry : *from) {
+            (*to)[counts[(entry.key >> shift) & mask]++] = entry;
+        }
+        swap(from, to);
+    }
+    for (size_t i = 0; i < count; ++i) {
+        organisms[i] = (*from)[i].organism;
+    }
+}
+
+MemoryFootprint SpatialOrder::getMemoryFootprint() const {
+    MemoryFootprint footprint = {0, 0};
+    auto add = [&footprint](size_t bytes) {
+        footprint.bytes += bytes;
+        footprint.allocations += bytes > 0 ? 1 : 0;
+    };
+    add(entries.capacity() * sizeof(Entry));
+    add(scratch.capacity() * sizeof(Entry));
+    add(counts.capacity() * sizeof(uint32_t));
+    return footprint;
+}
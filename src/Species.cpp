@@ -0,0 +1,122 @@
+#include "Species.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+
+using namespace std;
+
+Species Species::animal(int maxLifespan, int movementSpeed, int visionDistance, AnimalType animalType,
+                        float nutrientRequirement, float reproductionNutrientThreshold, int mass) {
+    Species species = {};
+    species.type = OrganismType::ANIMAL;
+    species.maxLifespan = maxLifespan;
+    species.animalType = animalType;
+    species.movementSpeed = movementSpeed;
+    species.visionDistance = visionDistance;
+    species.nutrientRequirement = nutrientRequirement;
+    species.reproductionNutrientThreshold = reproductionNutrientThreshold;
+    species.mass = mass;
+    return species;
+}
+
+Species Species::plant(int maxLifespan, float growthRate, float nutrientAbsorptionRate, float spreadingThreshold) {
+    Species species = {};
+    species.type = OrganismType::PLANT;
+    species.maxLifespan = maxLifespan;
+    species.growthRate = growthRate;
+    species.nutrientAbsorptionRate = nutrientAbsorptionRate;
+    species.spreadingThreshold = spreadingThreshold;
+    return species;
+}
+
+bool Species::operator==(const Species& other) const {
+    return type == other.type
+        && maxLifespan == other.maxLifespan
+        && animalType == other.animalType
+        && movementSpeed == other.movementSpeed
+        && visionDistance == other.visionDistance
+        && nutrientRequirement == other.nutrientRequirement
+        && reproductionNutrientThreshold == other.reproductionNutrientThreshold
+        && mass == other.mass
+        && growthRate == other.growthRate
+        && nutrientAbsorptionRate == other.nutrientAbsorptionRate
+        && spreadingThreshold == other.spreadingThreshold;
+}
+
+int16_t encodeTraitDelta(float speciesValue, float value) {
+    if (speciesValue == 0.0f || value == speciesValue) {
+        return 0;
+    }
+    long steps = lround((value / speciesValue - 1.0f) * TRAIT_DELTA_STEPS);
+    steps = max(steps, -static_cast<long>(TRAIT_DELTA_STEPS) + 1);
+    steps = min(steps, static_cast<long>(INT16_MAX));
+    return static_cast<int16_t>(steps);
+}
+
+namespace {
+
+void hashCombine(size_t& seed, size_t value) {
+    seed ^= value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+}
+
+size_t floatBits(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+}
+
+Species* SpeciesRegistry::chunks[MAX_SPECIES / CHUNK_SIZE] = {};
+size_t SpeciesRegistry::count = 0;
+mutex SpeciesRegistry::mutex;
+
+// Function-local so organisms built during static initialization still work.
+unordered_map<Species, uint16_t, SpeciesRegistry::SpeciesHash>& SpeciesRegistry::index() {
+    static unordered_map<Species, uint16_t, SpeciesHash> speciesIndex;
+    return speciesIndex;
+}
+
+size_t SpeciesRegistry::SpeciesHash::operator()(const Species& species) const {
+    size_t seed = static_cast<size_t>(species.type);
+    hashCombine(seed, static_cast<size_t>(species.maxLifespan));
+    hashCombine(seed, static_cast<size_t>(species.animalType));
+    hashCombine(seed, static_cast<size_t>(species.movementSpeed));
+    hashCombine(seed, static_cast<size_t>(species.visionDistance));
+    hashCombine(seed, floatBits(species.nutrientRequirement));
+    hashCombine(seed, floatBits(species.reproductionNutrientThreshold));
+    hashCombine(seed, static_cast<size_t>(species.mass));
+    hashCombine(seed, floatBits(species.growthRate));
+    hashCombine(seed, floatBits(species.nutrientAbsorptionRate));
+    hashCombine(seed, floatBits(species.spreadingThreshold));
+    return seed;
+}
+
+uint16_t SpeciesRegistry::intern(const Species& species) {
+    lock_guard<std::mutex> lock(mutex);
+
+    auto found = index().find(species);
+    if (found != index().end()) {
+        return found->second;
+    }
+    if (count == MAX_SPECIES) {
+        throw runtime_error("Species registry is full");
+    }
+
+    size_t chunk = count >> CHUNK_BITS;
+    if (chunks[chunk] == nullptr) {
+        chunks[chunk] = new Species[CHUNK_SIZE]();
+    }
+    uint16_t id = static_cast<uint16_t>(count);
+    chunks[chunk][count & (CHUNK_SIZE - 1)] = species;
+    index().emplace(species, id);
+    ++count;
+    return id;
+}
+
+size_t SpeciesRegistry::size() {
+    lock_guard<std::mutex> lock(mutex);
+    return count;
+}
@@ -0,0 +1,435 @@
+#include "StatisticsRecorder.h"
+#include "Animal.h"
+#include "Organism.h"
+#include "SimulationMetrics.h"
+#include "TaskPool.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+
+using namespace std;
+
+static const char MAGIC[8] = {'E', 'C', 'O', 'S', 'T', 'A', 'T', 'S'};
+
+// Nearest-rank percentile; reorders values
+static float percentile(vector<float>& values, double fraction) {
+    if (values.empty()) return 0.0f;
+    size_t rank = static_cast<size_t>(ceil(fraction * values.size()));
+    size_t index = rank == 0 ? 0 : rank - 1;
+    nth_element(values.begin(), values.begin() + index, values.end());
+    return values[index];
+}
+
+// The binary format is little-endian; other hosts reverse every value's bytes
+static bool hostIsLittleEndian() {
+    const uint16_t probe = 1;
+    unsigned char first = 0;
+    memcpy(&first, &probe, 1);
+    return first == 1;
+}
+
+template <typename T>
+static void writeRaw(ostream& out, const T* data, size_t count) {
+    if (sizeof(T) == 1 || hostIsLittleEndian()) {
+        out.write(reinterpret_cast<const char*>(data), static_cast<streamsize>(count * sizeof(T)));
+        return;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        char bytes[sizeof(T)];
+        memcpy(bytes, data + i, sizeof(T));
+        reverse(bytes, bytes + sizeof(T));
+        out.write(bytes, sizeof(T));
+    }
+}
+
+template <typename T>
+static bool readRaw(istream& in, T* data, size_t count) {
+    char* bytes = reinterpret_cast<char*>(data);
+    in.read(bytes, static_cast<streamsize>(count * sizeof(T)));
+    if (static_cast<size_t>(in.gcount()) != count * sizeof(T)) return false;
+    if (sizeof(T) > 1 && !hostIsLittleEndian()) {
+        for (size_t i = 0; i < count; ++i) {
+            reverse(bytes + i * sizeof(T), bytes + (i + 1) * sizeof(T));
+        }
+    }
+    return true;
+}
+
+int StatisticsTable::find(const string& name) const {
+    for (size_t i = 0; i < names.size(); ++i) {
+        if (names[i] == name) return static_cast<int>(i);
+    }
+    return -1;
+}
+
+StatisticsRecorder::StatisticsRecorder()
+    : enabled(false),
+      birthsSinceRow(0),
+      deathsSinceRow(0),
+      ticksInWindow(0),
+      windowLastTick(0),
+      rowsRecorded(0),
+      stopping(false) {
+    resetWindow();
+}
+
+StatisticsRecorder::~StatisticsRecorder() {
+    close();
+}
+
+const char* StatisticsRecorder::columnName(StatColumn column) {
+    switch (column) {
+        case StatColumn::PLANTS: return "plants";
+        case StatColumn::HERBIVORES: return "herbivores";
+        case StatColumn::CARNIVORES: return "carnivores";
+        case StatColumn::OMNIVORES: return "omnivores";
+        case StatColumn::NUTRIENTS_MEAN: return "nutrients_mean";
+        case StatColumn::NUTRIENTS_P50: return "nutrients_p50";
+        case StatColumn::NUTRIENTS_P90: return "nutrients_p90";
+        case StatColumn::AGE_MEAN: return "age_mean";
+        case StatColumn::AGE_P50: return "age_p50";
+        case StatColumn::AGE_P90: return "age_p90";
+        case StatColumn::AGE_MAX: return "age_max";
+        case StatColumn::BIRTHS: return "births";
+        case StatColumn::DEATHS: return "deaths";
+        default: return "unknown";
+    }
+}
+
+void StatisticsRecorder::buildColumnNames() {
+    columnNames.clear();
+    for (size_t i = 0; i < COLUMN_COUNT; ++i) {
+        string name = columnName(static_cast<StatColumn>(i));
+        if (options.downsampling == StatisticsDownsampling::WINDOW) {
+            columnNames.push_back(name + "_min");
+            columnNames.push_back(name + "_max");
+            columnNames.push_back(name + "_mean");
+        } else {
+            columnNames.push_back(name);
+        }
+    }
+}
+
+void StatisticsRecorder::open(const string& filePath, const StatisticsOptions& newOptions) {
+    if (newOptions.intervalTicks < 1) {
+        throw invalid_argument("Statistics interval must be at least one tick");
+    }
+    if (newOptions.chunkRows == 0) {
+        throw invalid_argument("Statistics chunks must hold at least one row");
+    }
+    close();
+
+    options = newOptions;
+    path = filePath;
+    buildColumnNames();
+    birthsSinceRow = 0;
+    deathsSinceRow = 0;
+    rowsRecorded = 0;
+    resetWindow();
+
+    ios::openmode mode = ios::out | ios::trunc;
+    if (options.format == StatisticsFormat::BINARY) {
+        mode |= ios::binary;
+    }
+    file.open(path, mode);
+    if (!file) {
+        cerr << "Warning: Cannot open statistics file " << path << endl;
+        return;
+    }
+    writeHeader();
+
+    filling.ticks.clear();
+    filling.ticks.reserve(options.chunkRows);
+    filling.columns.assign(columnNames.size(), vector<float>());
+    for (auto& column : filling.columns) {
+        column.reserve(options.chunkRows);
+    }
+
+    stopping = false;
+    writer = thread(&StatisticsRecorder::writerLoop, this);
+    enabled = true;
+}
+
+void StatisticsRecorder::close() {
+    if (!enabled) return;
+
+    if (options.downsampling == StatisticsDownsampling::WINDOW && ticksInWindow > 0) {
+        emitWindow();
+    }
+    if (!filling.ticks.empty()) {
+        handOff();
+    }
+
+    {
+        lock_guard<mutex> lock(queueMutex);
+        stopping = true;
+    }
+    wakeWriter.notify_one();
+    writer.join();
+
+    file.close();
+    pending.clear();
+    spare.clear();
+    enabled = false;
+}
+
+void StatisticsRecorder::resetWindow() {
+    ticksInWindow = 0;
+    windowLastTick = 0;
+    for (size_t i = 0; i < COLUMN_COUNT; ++i) {
+        windowMin.values[i] = numeric_limits<float>::max();
+        windowMax.values[i] = numeric_limits<float>::lowest();
+        windowSum[i] = 0.0;
+    }
+}
+
+bool StatisticsRecorder::needsSample(uint64_t tick) const {
+    if (!enabled) return false;
+    if (options.downsampling == StatisticsDownsampling::WINDOW) return true;
+    return tick % static_cast<uint64_t>(options.intervalTicks) == 0;
+}
+
+void StatisticsRecorder::countEvents(uint64_t births, uint64_t deaths) {
+    birthsSinceRow += births;
+    deathsSinceRow += deaths;
+}
+
+void StatisticsRecorder::record(uint64_t tick, const Sample& sample) {
+    if (!enabled) return;
+    if (!needsSample(tick)) {
+        countEvents(static_cast<uint64_t>(sample.values[static_cast<size_t>(StatColumn::BIRTHS)]),
+                    static_cast<uint64_t>(sample.values[static_cast<size_t>(StatColumn::DEATHS)]));
+        return;
+    }
+
+    if (options.downsampling == StatisticsDownsampling::EVERY_NTH) {
+        float values[COLUMN_COUNT];
+        copy(begin(sample.values), end(sample.values), values);
+        values[static_cast<size_t>(StatColumn::BIRTHS)] += static_cast<float>(birthsSinceRow);
+        values[static_cast<size_t>(StatColumn::DEATHS)] += static_cast<float>(deathsSinceRow);
+        birthsSinceRow = 0;
+        deathsSinceRow = 0;
+        appendRow(tick, values);
+        return;
+    }
+
+    for (size_t i = 0; i < COLUMN_COUNT; ++i) {
+        windowMin.values[i] = min(windowMin.values[i], sample.values[i]);
+        windowMax.values[i] = max(windowMax.values[i], sample.values[i]);
+        windowSum[i] += sample.values[i];
+    }
+    windowLastTick = tick;
+    if (++ticksInWindow == static_cast<uint64_t>(options.intervalTicks)) {
+        emitWindow();
+    }
+}
+
+// A window is reported under the last tick it saw, so a partial one flushed
+// by close() is still labelled correctly
+void StatisticsRecorder::emitWindow() {
+    float values[COLUMN_COUNT * 3];
+    for (size_t i = 0; i < COLUMN_COUNT; ++i) {
+        values[3 * i] = windowMin.values[i];
+        values[3 * i + 1] = windowMax.values[i];
+        values[3 * i + 2] = static_cast<float>(windowSum[i] / ticksInWindow);
+    }
+    appendRow(windowLastTick, values);
+    resetWindow();
+}
+
+void StatisticsRecorder::collect(uint64_t tick, const vector<Organism*>& organisms, const SimulationMetrics& metrics) {
+    uint64_t births = metrics.getLastTickDelta(MetricCounter::BIRTHS);
+    uint64_t deaths = metrics.getLastTickDelta(MetricCounter::DEATHS_STARVATION) +
+                      metrics.getLastTickDelta(MetricCounter::DEATHS_OLD_AGE) +
+                      metrics.getLastTickDelta(MetricCounter::DEATHS_PREDATION);
+    if (!needsSample(tick)) {
+        if (enabled) countEvents(births, deaths);
+        return;
+    }
+
+    Sample sample;
+    buildSample(organisms, sample);
+    sample.values[static_cast<size_t>(StatColumn::BIRTHS)] = static_cast<float>(births);
+    sample.values[static_cast<size_t>(StatColumn::DEATHS)] = static_cast<float>(deaths);
+    record(tick, sample);
+}
+
+// Births and deaths are left at zero; they come from the metrics, not the
+// population. Gathering touches every organism, so it runs on the shared
+// TaskPool; the sums then walk the gathered arrays in order, so the sample
+// does not depend on how the gathering was split.
+void StatisticsRecorder::buildSample(const vector<Organism*>& organisms, Sample& sample) {
+    fill(begin(sample.values), end(sample.values), 0.0f);
+    nutrientScratch.resize(organisms.size());
+    ageScratch.resize(organisms.size());
+    columnScratch.resize(organisms.size());
+
+    TaskPool::shared().parallelFor(organisms.size(), gatherGrain, [&](size_t first, size_t last, int) {
+        for (size_t i = first; i < last; ++i) {
+            const Organism* organism = organisms[i];
+            size_t column = static_cast<size_t>(StatColumn::PLANTS);
+            if (organism->getType() != OrganismType::PLANT) {
+                AnimalType animalType = static_cast<const Animal*>(organism)->getAnimalType();
+                column = static_cast<size_t>(StatColumn::HERBIVORES) + static_cast<size_t>(animalType);
+            }
+            columnScratch[i] = static_cast<uint8_t>(column);
+            nutrientScratch[i] = organism->getNutrients();
+            ageScratch[i] = static_cast<float>(organism->getAge());
+        }
+    });
+
+    double nutrientSum = 0.0;
+    double ageSum = 0.0;
+    for (size_t i = 0; i < organisms.size(); ++i) {
+        sample.values[columnScratch[i]] += 1.0f;
+        nutrientSum += nutrientScratch[i];
+        ageSum += ageScratch[i];
+    }
+    if (organisms.empty()) return;
+
+    double count = static_cast<double>(organisms.size());
+    sample.values[static_cast<size_t>(StatColumn::NUTRIENTS_MEAN)] = static_cast<float>(nutrientSum / count);
+    sample.values[static_cast<size_t>(StatColumn::NUTRIENTS_P50)] = percentile(nutrientScratch, 0.5);
+    sample.values[static_cast<size_t>(StatColumn::NUTRIENTS_P90)] = percentile(nutrientScratch, 0.9);
+    sample.values[static_cast<size_t>(StatColumn::AGE_MEAN)] = static_cast<float>(ageSum / count);
+    sample.values[static_cast<size_t>(StatColumn::AGE_P50)] = percentile(ageScratch, 0.5);
+    sample.values[static_cast<size_t>(StatColumn::AGE_P90)] = percentile(ageScratch, 0.9);
+    sample.values[static_cast<size_t>(StatColumn::AGE_MAX)] = *max_element(ageScratch.begin(), ageScratch.end());
+}
+
+void StatisticsRecorder::appendRow(uint64_t tick, const float* values) {
+    filling.ticks.push_back(tick);
+    for (size_t i = 0; i < filling.columns.size(); ++i) {
+        filling.columns[i].push_back(values[i]);
+    }
+    ++rowsRecorded;
+    if (filling.ticks.size() >= options.chunkRows) {
+        handOff();
+    }
+}
+
+// Queues the filled chunk for the writer and continues in a recycled one.
+// Blocks only when the writer has fallen MAX_PENDING_CHUNKS behind.
+void StatisticsRecorder::handOff() {
+    unique_lock<mutex> lock(queueMutex);
+    wakeRecorder.wait(lock, [this]() { return pending.size() < MAX_PENDING_CHUNKS; });
+    pending.push_back(std::move(filling));
+    if (!spare.empty()) {
+        filling = std::move(spare.back());
+        spare.pop_back();
+    } else {
+        filling = Chunk();
+        filling.ticks.reserve(options.chunkRows);
+        filling.columns.assign(columnNames.size(), vector<float>());
+        for (auto& column : filling.columns) {
+            column.reserve(options.chunkRows);
+        }
+    }
+    lock.unlock();
+    wakeWriter.notify_one();
+}
+
+void StatisticsRecorder::writerLoop() {
+    unique_lock<mutex> lock(queueMutex);
+    while (true) {
+        wakeWriter.wait(lock, [this]() { return stopping || !pending.empty(); });
+        if (pending.empty()) break;
+
+        Chunk chunk = std::move(pending.front());
+        pending.pop_front();
+        lock.unlock();
+
+        writeChunk(chunk);
+        chunk.ticks.clear();
+        for (auto& column : chunk.columns) {
+            column.clear();
+        }
+
+        lock.lock();
+        spare.push_back(std::move(chunk));
+        wakeRecorder.notify_one();
+    }
+    file.flush();
+}
+
+void StatisticsRecorder::writeHeader() {
+    if (options.format == StatisticsFormat::CSV) {
+        file << "tick";
+        for (const string& name : columnNames) {
+            file << ',' << name;
+        }
+        file << '\n';
+        // Enough digits for a float to read back exactly
+        file.precision(numeric_limits<float>::max_digits10);
+        return;
+    }
+
+    uint32_t version = FORMAT_VERSION;
+    uint32_t columnCount = static_cast<uint32_t>(columnNames.size());
+    file.write(MAGIC, sizeof(MAGIC));
+    writeRaw(file, &version, 1);
+    writeRaw(file, &columnCount, 1);
+    for (const string& name : columnNames) {
+        uint16_t length = static_cast<uint16_t>(name.size());
+        writeRaw(file, &length, 1);
+        file.write(name.data(), length);
+    }
+}
+
+void StatisticsRecorder::writeChunk(const Chunk& chunk) {
+    size_t rows = chunk.ticks.size();
+    if (options.format == StatisticsFormat::CSV) {
+        for (size_t row = 0; row < rows; ++row) {
+            file << chunk.ticks[row];
+            for (const auto& column : chunk.columns) {
+                file << ',' << column[row];
+            }
+            file << '\n';
+        }
+        return;
+    }
+
+    uint32_t rowCount = static_cast<uint32_t>(rows);
+    writeRaw(file, &rowCount, 1);
+    writeRaw(file, chunk.ticks.data(), rows);
+    for (const auto& column : chunk.columns) {
+        writeRaw(file, column.data(), rows);
+    }
+}
+
+bool StatisticsRecorder::readBinary(const string& filePath, StatisticsTable& table) {
+    table = StatisticsTable();
+    ifstream in(filePath, ios::in | ios::binary);
+    if (!in) return false;
+
+    char magic[sizeof(MAGIC)];
+    uint32_t version = 0;
+    uint32_t columnCount = 0;
+    if (!readRaw(in, magic, sizeof(magic)) || memcmp(magic, MAGIC, sizeof(MAGIC)) != 0) return false;
+    if (!readRaw(in, &version, 1) || version != FORMAT_VERSION) return false;
+    if (!readRaw(in, &columnCount, 1)) return false;
+
+    for (uint32_t i = 0; i < columnCount; ++i) {
+        uint16_t length = 0;
+        if (!readRaw(in, &length, 1)) return false;
+        string name(length, '\0');
+        if (!readRaw(in, &name[0], length)) return false;
+        table.names.push_back(name);
+    }
+    table.columns.assign(columnCount, vector<float>());
+
+    uint32_t rows = 0;
+    while (readRaw(in, &rows, 1)) {
+        size_t offset = table.ticks.size();
+        table.ticks.resize(offset + rows);
+        if (!readRaw(in, table.ticks.data() + offset, rows)) return false;
+        for (auto& column : table.columns) {
+            column.resize(offset + rows);
+            if (!readRaw(in, column.data() + offset, rows)) return false;
+        }
+    }
+    return in.gcount() == 0;
+}
@@ -0,0 +1,275 @@
+#include "TaskPool.h"
+#include <algorithm>
+#include <chrono>
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+using namespace std;
+
+namespace {
+thread_local const TaskPool* workerPool = nullptr;
+thread_local int workerParticipant = 0;
+
+TaskPool* sharedPool = nullptr;
+mutex sharedPoolLock;
+// What configureShared asked for, so a stopped pool comes back the same
+int sharedWorkers = 0;
+bool sharedPinned = false;
+
+void cpuRelax() {
+#if defined(__SSE2__)
+    _mm_pause();
+#endif
+}
+
+uint64_t nowNanos() {
+    return static_cast<uint64_t>(chrono::duration_cast<chrono::nanoseconds>(
+        chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+bool pinToCore(int core) {
+#if defined(__linux__)
+    unsigned cores = max(thread::hardware_concurrency(), 1u);
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(static_cast<unsigned>(core) % cores, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    (void)core;
+    return false;
+#endif
+}
+}
+
+size_t GrainTuner::grainFor(size_t count, int participants) const {
+    if (count == 0) return 1;
+    size_t balanced = max<size_t>(count / (static_cast<size_t>(max(participants, 1)) * CHUNKS_PER_PARTICIPANT), 1);
+    if (nanosPerItem <= 0.0) return balanced;
+    size_t worthwhile = static_cast<size_t>(static_cast<double>(TARGET_CHUNK_NANOS) / nanosPerItem);
+    return min(max(worthwhile, balanced), count);
+}
+
+void GrainTuner::record(size_t items, uint64_t nanos) {
+    if (items == 0) return;
+    double measured = static_cast<double>(nanos) / static_cast<double>(items);
+    nanosPerItem = nanosPerItem <= 0.0 ? measured : nanosPerItem * 0.75 + measured * 0.25;
+}
+
+TaskPool::TaskPool(int workers, bool pinWorkers)
+    : workerCount(workers > 0 ? workers : max(static_cast<int>(thread::hardware_concurrency()) - 1, 1)),
+      queued(0), sleepers(0), stopping(false), pinnedWorkers(0), steals(0) {
+    for (int i = 0; i <= workerCount; ++i) {
+        queues.emplace_back(new ChunkQueue());
+    }
+    this->workers.reserve(workerCount);
+    for (int i = 1; i <= workerCount; ++i) {
+        this->workers.emplace_back(&TaskPool::workerLoop, this, i, pinWorkers);
+    }
+}
+
+TaskPool::~TaskPool() {
+    {
+        lock_guard<mutex> lock(sleepLock);
+        stopping.store(true);
+    }
+    wake.notify_all();
+    for (thread& worker : workers) {
+        worker.join();
+    }
+}
+
+TaskPool& TaskPool::shared() {
+    lock_guard<mutex> lock(sharedPoolLock);
+    if (sharedPool == nullptr) {
+        sharedPool = new TaskPool(sharedWorkers, sharedPinned);
+    }
+    return *sharedPool;
+}
+
+void TaskPool::configureShared(int workers, bool pinWorkers) {
+    lock_guard<mutex> lock(sharedPoolLock);
+    delete sharedPool;
+    sharedWorkers = workers;
+    sharedPinned = pinWorkers;
+    sharedPool = new TaskPool(workers, pinWorkers);
+}
+
+void TaskPool::stopShared() {
+    lock_guard<mutex> lock(sharedPoolLock);
+    delete sharedPool;
+    sharedPool = nullptr;
+}
+
+int TaskPool::currentParticipant() const {
+    return workerPool == this ? workerParticipant : 0;
+}
+
+void TaskPool::submit(function<void()> job) {
+    queued.fetch_add(1);
+    {
+        lock_guard<mutex> lock(detachedLock);
+        detached.push_back(std::move(job));
+    }
+    wakeSleepers();
+}
+
+// queued is raised before sleepers is read, and a sleeper raises sleepers
+// before it reads queued, so one of the two always sees the other.
+void TaskPool::wakeSleepers() {
+    if (sleepers.load() == 0) return;
+    lock_guard<mutex> lock(sleepLock);
+    wake.notify_all();
+}
+
+bool TaskPool::popChunk(int participant, Chunk& chunk) {
+    {
+        ChunkQueue& own = *queues[participant];
+        lock_guard<mutex> lock(own.lock);
+        if (!own.chunks.empty()) {
+            chunk = own.chunks.front();
+            own.chunks.pop_front();
+            queued.fetch_sub(1);
+            return true;
+        }
+    }
+    int participants = static_cast<int>(queues.size());
+    for (int i = 1; i < participants; ++i) {
+        ChunkQueue& victim = *queues[(participant + i) % participants];
+        lock_guard<mutex> lock(victim.lock);
+        if (!victim.chunks.empty()) {
+            chunk = victim.chunks.back();
+            victim.chunks.pop_back();
+            queued.fetch_sub(1);
+            steals.fetch_add(1, memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool TaskPool::popDetached(function<void()>& job) {
+    lock_guard<mutex> lock(detachedLock);
+    if (detached.empty()) return false;
+    job = std::move(detached.front());
+    detached.pop_front();
+    queued.fetch_sub(1);
+    return true;
+}
+
+// A throwing body must not escape a worker, where it would terminate the
+// process; the exception travels back to the thread that started the loop.
+void TaskPool::runChunk(const Chunk& chunk, int participant) {
+    RangeJob& job = *chunk.job;
+    if (!job.failed.load(memory_order_relaxed)) {
+        try {
+            if (job.timed) {
+                uint64_t start = nowNanos();
+                job.run(job.body, chunk.begin, chunk.end, participant);
+                job.nanos.fetch_add(nowNanos() - start, memory_order_relaxed);
+            } else {
+                job.run(job.body, chunk.begin, chunk.end, participant);
+            }
+        } catch (...) {
+            if (!job.failed.exchange(true)) {
+                job.error = current_exception();
+            }
+        }
+    }
+    job.unfinished.fetch_sub(1, memory_order_release);
+}
+
+void TaskPool::workerLoop(int participant, bool pin) {
+    workerPool = this;
+    workerParticipant = participant;
+    if (pin && pinToCore(participant)) {
+        pinnedWorkers.fetch_add(1, memory_order_relaxed);
+    }
+
+    int idleRounds = 0;
+    while (true) {
+        Chunk chunk;
+        if (popChunk(participant, chunk)) {
+            runChunk(chunk, participant);
+            idleRounds = 0;
+            continue;
+        }
+        function<void()> job;
+        if (popDetached(job)) {
+            job();
+            idleRounds = 0;
+            continue;
+        }
+        if (stopping.load()) break;
+
+        ++idleRounds;
+        if (idleRounds < SPIN_ROUNDS) {
+            cpuRelax();
+        } else if (idleRounds < SPIN_ROUNDS + YIELD_ROUNDS) {
+            this_thread::yield();
+        } else {
+            unique_lock<mutex> lock(sleepLock);
+            sleepers.fetch_add(1);
+            wake.wait(lock, [this]() { return stopping.load() || queued.load() > 0; });
+            sleepers.fetch_sub(1);
+            idleRounds = 0;
+        }
+    }
+}
+
+// Loops too small to split, and pools without workers, run inline. The
+// chunks live on the caller's stack: it does not return before the last one
+// has finished.
+void TaskPool::runRange(size_t count, size_t grain, RangeFunction run, void* body, GrainTuner* tuner) {
+    if (count == 0) return;
+    grain = max<size_t>(grain, 1);
+    size_t chunkCount = (count + grain - 1) / grain;
+    int self = currentParticipant();
+    if (chunkCount == 1 || workers.empty()) {
+        uint64_t start = tuner != nullptr ? nowNanos() : 0;
+        run(body, 0, count, self);
+        if (tuner != nullptr) tuner->record(count, nowNanos() - start);
+        return;
+    }
+
+    RangeJob job;
+    job.run = run;
+    job.body = body;
+    job.timed = tuner != nullptr;
+    job.unfinished.store(chunkCount, memory_order_relaxed);
+    job.nanos.store(0, memory_order_relaxed);
+    job.failed.store(false, memory_order_relaxed);
+
+    // Counted before they are visible, so takers never drive it below zero
+    queued.fetch_add(chunkCount);
+    // Dealt round-robin, starting with the caller's own deque
+    int participants = static_cast<int>(queues.size());
+    for (int offset = 0; offset < participants && static_cast<size_t>(offset) < chunkCount; ++offset) {
+        ChunkQueue& queue = *queues[(self + offset) % participants];
+        lock_guard<mutex> lock(queue.lock);
+        for (size_t index = offset; index < chunkCount; index += participants) {
+            size_t begin = index * grain;
+            queue.chunks.push_back({&job, begin, min(begin + grain, count)});
+        }
+    }
+    wakeSleepers();
+
+    while (job.unfinished.load(memory_order_acquire) > 0) {
+        Chunk chunk;
+        if (popChunk(self, chunk)) {
+            runChunk(chunk, self);
+        } else {
+            cpuRelax();
+        }
+    }
+    if (job.error) {
+        rethrow_exception(job.error);
+    }
+    if (tuner != nullptr) {
+        tuner->record(count, job.nanos.load(memory_order_relaxed));
+    }
+}
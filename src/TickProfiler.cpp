@@ -0,0 +1,147 @@
+#include "TickProfiler.h"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <limits>
+
+using namespace std;
+
+LatencyHistogram::LatencyHistogram()
+    : buckets((MAX_MAGNITUDE + 2) * SUB_BUCKET_HALF, 0),
+      totalCount(0),
+      minValue(numeric_limits<uint64_t>::max()),
+      maxValue(0),
+      sum(0) {}
+
+size_t LatencyHistogram::bucketIndex(uint64_t value) {
+    int bitLength = 0;
+    for (uint64_t v = value; v != 0; v >>= 1) {
+        ++bitLength;
+    }
+    int magnitude = max(0, bitLength - SUB_BUCKET_BITS);
+    if (magnitude > MAX_MAGNITUDE) {
+        return static_cast<size_t>((MAX_MAGNITUDE + 2) * SUB_BUCKET_HALF - 1);
+    }
+    return static_cast<size_t>(magnitude) * SUB_BUCKET_HALF + static_cast<size_t>(value >> magnitude);
+}
+
+uint64_t LatencyHistogram::bucketMidpoint(size_t index) {
+    if (index < static_cast<size_t>(2 * SUB_BUCKET_HALF)) {
+        return index;
+    }
+    int magnitude = static_cast<int>(index / SUB_BUCKET_HALF) - 1;
+    uint64_t subBucket = index - static_cast<size_t>(magnitude) * SUB_BUCKET_HALF;
+    return (subBucket << magnitude) + ((uint64_t(1) << magnitude) >> 1);
+}
+
+void LatencyHistogram::record(uint64_t nanoseconds) {
+    ++buckets[bucketIndex(nanoseconds)];
+    ++totalCount;
+    sum += nanoseconds;
+    minValue = min(minValue, nanoseconds);
+    maxValue = max(maxValue, nanoseconds);
+}
+
+void LatencyHistogram::reset() {
+    fill(buckets.begin(), buckets.end(), 0);
+    totalCount = 0;
+    minValue = numeric_limits<uint64_t>::max();
+    maxValue = 0;
+    sum = 0;
+}
+
+double LatencyHistogram::getMean() const {
+    return totalCount ? static_cast<double>(sum / totalCount) : 0.0;
+}
+
+uint64_t LatencyHistogram::getPercentile(double percentile) const {
+    if (totalCount == 0) return 0;
+
+    percentile = min(max(percentile, 0.0), 100.0);
+    uint64_t target = static_cast<uint64_t>(ceil(percentile / 100.0 * totalCount));
+    if (target == 0) target = 1;
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < buckets.size(); ++i) {
+        seen += buckets[i];
+        if (seen >= target) {
+            return min(max(bucketMidpoint(i), getMin()), maxValue);
+        }
+    }
+    return maxValue;
+}
+
+TickProfiler::TickProfiler() : enabled(false) {}
+
+void TickProfiler::record(TickPhase phase, uint64_t nanoseconds) {
+    histograms[static_cast<size_t>(phase)].record(nanoseconds);
+}
+
+const LatencyHistogram& TickProfiler::getHistogram(TickPhase phase) const {
+    return histograms[static_cast<size_t>(phase)];
+}
+
+void TickProfiler::reset() {
+    for (auto& histogram : histograms) {
+        histogram.reset();
+    }
+}
+
+const char* TickProfiler::phaseName(TickPhase phase) {
+    switch (phase) {
+        case TickPhase::TICK_TOTAL: return "tick_total";
+        case TickPhase::ORGANISM_UPDATE: return "organism_update";
+        case TickPhase::RESOLVE_INTENTS: return "resolve_intents";
+        case TickPhase::REMOVE_DEAD: return "remove_dead";
+        case TickPhase::DECOMPOSITION_SPAWN: return "decomposition_spawn";
+        case TickPhase::SOIL_UPDATE: return "soil_update";
+        case TickPhase::STATISTICS: return "statistics";
+        case TickPhase::SHARED_EXPORT: return "shared_export";
+        case TickPhase::FRAME_DUMP: return "frame_dump";
+        case TickPhase::NEIGHBORHOOD: return "neighborhood";
+        case TickPhase::SPATIAL_SORT: return "spatial_sort";
+        case TickPhase::PLANT_UPDATE: return "plant_update";
+        case TickPhase::HERBIVORE_UPDATE: return "herbivore_update";
+        case TickPhase::CARNIVORE_UPDATE: return "carnivore_update";
+        case TickPhase::OMNIVORE_UPDATE: return "omnivore_update";
+        default: return "unknown";
+    }
+}
+
+void TickProfiler::writeTable(ostream& out) const {
+    out << left << setw(22) << "phase" << right
+        << setw(10) << "count"
+        << setw(14) << "mean_ns"
+        << setw(12) << "p50_ns"
+        << setw(12) << "p90_ns"
+        << setw(12) << "p99_ns"
+        << setw(14) << "max_ns" << '\n';
+
+    for (size_t i = 0; i < histograms.size(); ++i) {
+        const LatencyHistogram& h = histograms[i];
+        out << left << setw(22) << phaseName(static_cast<TickPhase>(i)) << right
+            << setw(10) << h.getCount()
+            << setw(14) << fixed << setprecision(1) << h.getMean()
+            << setw(12) << h.getPercentile(50.0)
+            << setw(12) << h.getPercentile(90.0)
+            << setw(12) << h.getPercentile(99.0)
+            << setw(14) << h.getMax() << '\n';
+    }
+}
+
+void TickProfiler::writeJson(ostream& out) const {
+    out << "{\"phases\":[";
+    for (size_t i = 0; i < histograms.size(); ++i) {
+        const LatencyHistogram& h = histograms[i];
+        if (i > 0) out << ',';
+        out << "{\"name\":\"" << phaseName(static_cast<TickPhase>(i)) << "\""
+            << ",\"count\":" << h.getCount()
+            << ",\"mean_ns\":" << fixed << setprecision(1) << h.getMean()
+            << ",\"min_ns\":" << h.getMin()
+            << ",\"p50_ns\":" << h.getPercentile(50.0)
+            << ",\"p90_ns\":" << h.getPercentile(90.0)
+            << ",\"p99_ns\":" << h.getPercentile(99.0)
+            << ",\"max_ns\":" << h.getMax() << '}';
+    }
+    out << "]}";
+}
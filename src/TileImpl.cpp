@@ -1,10 +1,11 @@
 #include "TileImpl.h"
+#include "GridImpl.h"
 #include <stdexcept>
 #include <iostream>
 
 using namespace std;
 
-TileImpl::TileImpl(const Position& pos) : position(pos), organism(nullptr) {
+TileImpl::TileImpl(const Position& pos) : position(pos), organism(nullptr), grid(nullptr), gridIndex(0) {
     //cout << "Creating Tile at position (" << pos.getX() << ", " << pos.getY() << ")" << endl;
 }  
 
@@ -25,13 +26,27 @@ void TileImpl::setOccupant(const Organism& org) {
         return;
     }
     organism = const_cast<Organism*>(&org);
+    if (grid != nullptr) {
+        grid->setFoodClass(gridIndex, org.getFoodClass());
+    }
     cout << "Organism placed at (" << position.getX() << ", " << position.getY() << ")" << endl;
 }
 
 void TileImpl::clearOccupant() {
     organism = nullptr;
+    if (grid != nullptr) {
+        grid->setFoodClass(gridIndex, FOOD_CLASS_EMPTY);
+    }
 }
 
 Position& TileImpl::getPosition() {
     return position;
+}
+
+void TileImpl::bindGrid(GridImpl* owner, size_t index) {
+    grid = owner;
+    gridIndex = index;
+    if (grid != nullptr) {
+        grid->setFoodClass(gridIndex, organism != nullptr ? organism->getFoodClass() : FOOD_CLASS_EMPTY);
+    }
 }
\ No newline at end of file
@@ -0,0 +1,83 @@
+#include "TileLayout.h"
+#include <algorithm>
+#include <stdexcept>
+
+using namespace std;
+
+namespace {
+
+int bitsFor(int count) {
+    int bits = 0;
+    while ((1 << bits) < count) {
+        ++bits;
+    }
+    return bits;
+}
+
+// Moves bit i of value to position positions[i]
+size_t spread(int value, const vector<int>& positions) {
+    size_t result = 0;
+    for (size_t bit = 0; bit < positions.size(); ++bit) {
+        if (value & (1 << bit)) {
+            result |= static_cast<size_t>(1) << positions[bit];
+        }
+    }
+    return result;
+}
+
+}
+
+TileLayout::TileLayout(GridLayout kind, int width, int height)
+    : kind(kind), width(width), height(height) {
+    if (width <= 0 || height <= 0) {
+        throw invalid_argument("Layout dimensions must be positive");
+    }
+    columnOffsets.resize(width);
+    rowOffsets.resize(height);
+
+    if (kind == GridLayout::ROW_MAJOR) {
+        for (int x = 0; x < width; ++x) {
+            columnOffsets[x] = static_cast<size_t>(x);
+        }
+        for (int y = 0; y < height; ++y) {
+            rowOffsets[y] = static_cast<size_t>(y) * width;
+        }
+        storageSize = static_cast<size_t>(width) * height;
+        return;
+    }
+
+    int blocksX = (width + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    int blocksY = (height + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    int bitsX = bitsFor(blocksX);
+    int bitsY = bitsFor(blocksY);
+
+    // Alternate x and y bits from the bottom until one axis runs out
+    vector<int> xPositions;
+    vector<int> yPositions;
+    int position = 0;
+    for (int bit = 0; bit < max(bitsX, bitsY); ++bit) {
+        if (bit < bitsX) {
+            xPositions.push_back(position++);
+            splitIsY.push_back(false);
+            splitBit.push_back(bit);
+        }
+        if (bit < bitsY) {
+            yPositions.push_back(position++);
+            splitIsY.push_back(true);
+            splitBit.push_back(bit);
+        }
+    }
+
+    for (int x = 0; x < width; ++x) {
+        columnOffsets[x] = spread(x >> BLOCK_SHIFT, xPositions) * BLOCK_TILES + (x & (BLOCK_SIZE - 1));
+    }
+    for (int y = 0; y < height; ++y) {
+        rowOffsets[y] = spread(y >> BLOCK_SHIFT, yPositions) * BLOCK_TILES +
+                        static_cast<size_t>(y & (BLOCK_SIZE - 1)) * BLOCK_SIZE;
+    }
+    storageSize = (static_cast<size_t>(1) << (bitsX + bitsY)) * BLOCK_TILES;
+}
+
+MemoryFootprint TileLayout::getMemoryFootprint() const {
+    return {(columnOffsets.capacity() + rowOffsets.capacity()) * sizeof(size_t), 2};
+}
@@ -0,0 +1,123 @@
+#include "TimeWarpController.h"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+using namespace std;
+
+// Weight of the newest sample in the moving averages
+static const double SMOOTHING = 0.2;
+
+TimeWarpController::TimeWarpController(double framesPerSecond)
+    : multiplier(1.0),
+      maxSpeed(false),
+      tickSeconds(0.0),
+      renderSeconds(0.0),
+      tickDebt(0.0),
+      sinceRender(0.0),
+      renderDue(true),
+      skippedFrames(0),
+      windowSeconds(0.0),
+      windowTicks(0),
+      achievedTicksPerSecond(0.0),
+      totalTicks(0),
+      droppedTicks(0) {
+    if (framesPerSecond <= 0.0) {
+        throw invalid_argument("Frames per second must be positive");
+    }
+    frameSeconds = 1.0 / framesPerSecond;
+}
+
+double TimeWarpController::smooth(double average, double sample) {
+    return average == 0.0 ? sample : average + SMOOTHING * (sample - average);
+}
+
+void TimeWarpController::setMultiplier(double value) {
+    multiplier = min(max(value, MIN_MULTIPLIER), MAX_MULTIPLIER);
+}
+
+void TimeWarpController::setMaxSpeed(bool enabled) {
+    maxSpeed = enabled;
+    tickDebt = 0.0;
+}
+
+double TimeWarpController::getTickBudgetSeconds() const {
+    return max(frameSeconds - renderSeconds, frameSeconds * MIN_TICK_SHARE);
+}
+
+double TimeWarpController::getRequestedTicksPerSecond() const {
+    return maxSpeed ? 0.0 : BASE_TICKS_PER_SECOND * multiplier;
+}
+
+int TimeWarpController::planTicks(double elapsedSeconds) {
+    elapsedSeconds = max(elapsedSeconds, 0.0);
+
+    windowSeconds += elapsedSeconds;
+    if (windowSeconds >= RATE_WINDOW_SECONDS) {
+        achievedTicksPerSecond = static_cast<double>(windowTicks) / windowSeconds;
+        windowSeconds = 0.0;
+        windowTicks = 0;
+    }
+
+    // Before the first measurement assume one tick fits
+    auto ticksFitting = [this](double seconds) {
+        double fitting = tickSeconds > 0.0 ? floor(seconds / tickSeconds) : 1.0;
+        return min(max(fitting, 1.0), static_cast<double>(INT32_MAX));
+    };
+    double renderingBudget = ticksFitting(getTickBudgetSeconds());
+
+    if (maxSpeed) {
+        renderDue = true;
+        return static_cast<int>(renderingBudget);
+    }
+
+    double rate = BASE_TICKS_PER_SECOND * multiplier;
+    tickDebt += elapsedSeconds * rate;
+    double backlog = max(rate * MAX_BACKLOG_SECONDS, 1.0);
+    if (tickDebt > backlog) {
+        droppedTicks += static_cast<uint64_t>(tickDebt - backlog);
+        tickDebt = backlog;
+    }
+
+    double owed = floor(tickDebt);
+    sinceRender += elapsedSeconds;
+    renderDue = owed <= renderingBudget || sinceRender >= 1.0 / MIN_FRAMES_PER_SECOND;
+    double budget = renderDue ? renderingBudget : ticksFitting(frameSeconds);
+    if (renderDue) {
+        sinceRender = 0.0;
+    } else {
+        ++skippedFrames;
+    }
+
+    int ticks = static_cast<int>(min(owed, budget));
+    tickDebt -= ticks;
+    return ticks;
+}
+
+void TimeWarpController::recordTicks(int ticks, double seconds) {
+    if (ticks <= 0) return;
+    tickSeconds = smooth(tickSeconds, max(seconds, 0.0) / ticks);
+    windowTicks += static_cast<uint64_t>(ticks);
+    totalTicks += static_cast<uint64_t>(ticks);
+}
+
+void TimeWarpController::recordRender(double seconds) {
+    renderSeconds = smooth(renderSeconds, max(seconds, 0.0));
+}
+
+string TimeWarpController::describe() const {
+    ostringstream line;
+    if (maxSpeed) {
+        line << "max";
+    } else {
+        line << 'x' << multiplier;
+    }
+    line << "  " << fixed << setprecision(1) << achievedTicksPerSecond;
+    if (!maxSpeed) {
+        line << '/' << getRequestedTicksPerSecond();
+    }
+    line << " ticks/s";
+    return line.str();
+}
@@ -0,0 +1,164 @@
+#include "TimingWheel.h"
+#include <algorithm>
+
+using namespace std;
+
+namespace {
+const uint64_t SLOT_MASK = TimingWheel::SLOTS - 1;
+const uint64_t NOT_SCHEDULED = UINT64_MAX;
+
+int highestBit(uint64_t value) {
+    int bit = -1;
+    while (value != 0) {
+        value >>= 1;
+        ++bit;
+    }
+    return bit;
+}
+}
+
+TimingWheel::TimingWheel() : now(0), scheduledCount(0) {}
+
+// An organism due at `due` lives on the level of the highest slot group in
+// which `due` and `now` differ; cascading keeps that true as `now` advances.
+vector<Organism*>* TimingWheel::slotFor(uint64_t due) {
+    int level = max(highestBit(due ^ now), 0) / SLOT_BITS;
+    if (level >= LEVELS) {
+        return &overflow;
+    }
+    return &slots[level][(due >> (level * SLOT_BITS)) & SLOT_MASK];
+}
+
+void TimingWheel::place(Organism* organism, Entry& entry) {
+    vector<Organism*>& slot = *slotFor(entry.due);
+    entry.index = slot.size();
+    slot.push_back(organism);
+}
+
+void TimingWheel::vacate(const Entry& entry) {
+    (*slotFor(entry.due))[entry.index] = nullptr;
+}
+
+bool TimingWheel::isScheduled(const Organism* organism) const {
+    auto it = dueTicks.find(organism);
+    return it != dueTicks.end() && it->second.due != NOT_SCHEDULED;
+}
+
+void TimingWheel::schedule(Organism* organism, uint64_t delay) {
+    Entry& entry = dueTicks.try_emplace(organism, Entry{NOT_SCHEDULED, 0}).first->second;
+    if (entry.due != NOT_SCHEDULED) {
+        vacate(entry);
+    } else {
+        ++scheduledCount;
+    }
+    entry.due = now + delay;
+    place(organism, entry);
+}
+
+bool TimingWheel::cancel(const Organism* organism) {
+    auto it = dueTicks.find(organism);
+    if (it == dueTicks.end()) {
+        return false;
+    }
+    bool wasScheduled = it->second.due != NOT_SCHEDULED;
+    if (wasScheduled) {
+        vacate(it->second);
+        --scheduledCount;
+    }
+    dueTicks.erase(it);
+    return wasScheduled;
+}
+
+void TimingWheel::clear() {
+    for (auto& level : slots) {
+        for (auto& slot : level) {
+            slot.clear();
+        }
+    }
+    overflow.clear();
+    dueTicks.clear();
+    scheduledCount = 0;
+}
+
+void TimingWheel::cascade(int level) {
+    vector<Organism*>& slot = level < LEVELS ? slots[level][(now >> (level * SLOT_BITS)) & SLOT_MASK] : overflow;
+    cascading.assign(slot.begin(), slot.end());
+    slot.clear();
+    for (Organism* organism : cascading) {
+        if (organism != nullptr) place(organism, dueTicks[organism]);
+    }
+}
+
+void TimingWheel::advance(vector<Organism*>& due) {
+    vector<Organism*>& current = slots[0][now & SLOT_MASK];
+    for (Organism* organism : current) {
+        if (organism == nullptr) continue;
+        dueTicks[organism].due = NOT_SCHEDULED;
+        due.push_back(organism);
+        --scheduledCount;
+    }
+    current.clear();
+    ++now;
+
+    if ((now & SLOT_MASK) != 0) return;
+
+    // Every level whose slot index just wrapped to zero, plus the first one
+    // that did not, hands one slot down
+    int level = 1;
+    while (level < LEVELS && ((now >> (level * SLOT_BITS)) & SLOT_MASK) == 0) {
+        ++level;
+    }
+    for (; level >= 1; --level) {
+        cascade(level);
+    }
+}
+
+// The new index is filled before the old one is freed, so its nodes come
+// from fresh memory in delivery order: the current level 0 slot onwards,
+// then the higher levels. Delivered organisms awaiting their reschedule keep
+// their entries at the end.
+void TimingWheel::reindex() {
+    unordered_map<const Organism*, Entry> rebuilt;
+    rebuilt.reserve(dueTicks.size());
+    auto copy = [this, &rebuilt](const vector<Organism*>& slot) {
+        for (size_t i = 0; i < slot.size(); ++i) {
+            if (slot[i] != nullptr) rebuilt.emplace(slot[i], Entry{dueTicks[slot[i]].due, i});
+        }
+    };
+    for (int level = 0; level < LEVELS; ++level) {
+        uint64_t first = (now >> (level * SLOT_BITS)) & SLOT_MASK;
+        for (uint64_t i = 0; i < SLOTS; ++i) {
+            copy(slots[level][(first + i) & SLOT_MASK]);
+        }
+    }
+    copy(overflow);
+    for (const auto& entry : dueTicks) {
+        if (entry.second.due == NOT_SCHEDULED) {
+            rebuilt.emplace(entry.first, entry.second);
+        }
+    }
+    dueTicks.swap(rebuilt);
+}
+
+MemoryFootprint TimingWheel::getMemoryFootprint() const {
+    MemoryFootprint footprint = {0, 0};
+    auto addSlot = [&footprint](const vector<Organism*>& slot) {
+        if (slot.capacity() > 0) {
+            footprint.bytes += slot.capacity() * sizeof(Organism*);
+            footprint.allocations += 1;
+        }
+    };
+    for (const auto& level : slots) {
+        for (const auto& slot : level) {
+            addSlot(slot);
+        }
+    }
+    addSlot(overflow);
+    addSlot(cascading);
+    // One node per entry plus the bucket array
+    footprint.bytes += dueTicks.size() * (sizeof(void*) + sizeof(pair<const Organism* const, Entry>) + sizeof(size_t));
+    footprint.allocations += dueTicks.size();
+    footprint.bytes += dueTicks.bucket_count() * sizeof(void*);
+    footprint.allocations += dueTicks.bucket_count() > 0 ? 1 : 0;
+    return footprint;
+}
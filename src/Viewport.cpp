@@ -0,0 +1,164 @@
+#include "Viewport.h"
+#include "TilePalette.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+using namespace std;
+
+Viewport::Viewport(int worldWidth, int worldHeight, int windowWidth, int windowHeight, double pixelsPerTile)
+    : worldWidth(worldWidth), worldHeight(worldHeight),
+      windowWidth(windowWidth), windowHeight(windowHeight),
+      centerX(worldWidth / 2.0), centerY(worldHeight / 2.0),
+      pixelsPerTile(pixelsPerTile) {
+    if (worldWidth <= 0 || worldHeight <= 0 || windowWidth <= 0 || windowHeight <= 0) {
+        throw invalid_argument("Viewport dimensions must be positive");
+    }
+    if (!(pixelsPerTile > 0.0)) {
+        throw invalid_argument("Viewport zoom must be positive");
+    }
+    clamp();
+}
+
+// Zooming out stops at half the size that fits the whole world
+double Viewport::minPixelsPerTile() const {
+    double fit = min(static_cast<double>(windowWidth) / worldWidth,
+                     static_cast<double>(windowHeight) / worldHeight);
+    return min(fit, MAX_PIXELS_PER_TILE) / 2.0;
+}
+
+// Keeps the zoom in range and some of the world under the window centre
+void Viewport::clamp() {
+    pixelsPerTile = max(minPixelsPerTile(), min(MAX_PIXELS_PER_TILE, pixelsPerTile));
+    centerX = max(0.0, min(static_cast<double>(worldWidth), centerX));
+    centerY = max(0.0, min(static_cast<double>(worldHeight), centerY));
+}
+
+void Viewport::resize(int newWindowWidth, int newWindowHeight) {
+    if (newWindowWidth <= 0 || newWindowHeight <= 0) return;
+    windowWidth = newWindowWidth;
+    windowHeight = newWindowHeight;
+    clamp();
+}
+
+void Viewport::fitWorld() {
+    centerX = worldWidth / 2.0;
+    centerY = worldHeight / 2.0;
+    pixelsPerTile = minPixelsPerTile() * 2.0;
+    clamp();
+}
+
+void Viewport::pan(double dx, double dy) {
+    centerX -= dx / pixelsPerTile;
+    centerY -= dy / pixelsPerTile;
+    clamp();
+}
+
+void Viewport::zoom(double factor, double px, double py) {
+    if (!(factor > 0.0)) return;
+    double anchorX = screenToWorldX(px);
+    double anchorY = screenToWorldY(py);
+    pixelsPerTile *= factor;
+    clamp();
+    // Shift the centre so the anchor maps back onto the same pixel
+    centerX = anchorX - (px - windowWidth / 2.0) / pixelsPerTile;
+    centerY = anchorY - (py - windowHeight / 2.0) / pixelsPerTile;
+    clamp();
+}
+
+double Viewport::worldToScreenX(double x) const {
+    return (x - centerX) * pixelsPerTile + windowWidth / 2.0;
+}
+
+double Viewport::worldToScreenY(double y) const {
+    return (y - centerY) * pixelsPerTile + windowHeight / 2.0;
+}
+
+double Viewport::screenToWorldX(double px) const {
+    return (px - windowWidth / 2.0) / pixelsPerTile + centerX;
+}
+
+double Viewport::screenToWorldY(double py) const {
+    return (py - windowHeight / 2.0) / pixelsPerTile + centerY;
+}
+
+int Viewport::selectLevel(int levelCount) const {
+    int level = 0;
+    double cellPixels = pixelsPerTile;
+    while (cellPixels < 1.0 && level + 1 < levelCount) {
+        cellPixels *= 2.0;
+        ++level;
+    }
+    return level;
+}
+
+void Viewport::rasterize(const OccupancyPyramid& pyramid, ViewportRaster& raster) const {
+    int level = selectLevel(pyramid.getLevelCount());
+    double cellTiles = static_cast<double>(1 << level);
+    int levelWidth = pyramid.getLevelWidth(level);
+    int levelHeight = pyramid.getLevelHeight(level);
+
+    int firstX = max(0, static_cast<int>(floor(screenToWorldX(0.0) / cellTiles)));
+    int firstY = max(0, static_cast<int>(floor(screenToWorldY(0.0) / cellTiles)));
+    int lastX = min(levelWidth - 1, static_cast<int>(floor(screenToWorldX(windowWidth) / cellTiles)));
+    int lastY = min(levelHeight - 1, static_cast<int>(floor(screenToWorldY(windowHeight) / cellTiles)));
+
+    raster.level = level;
+    raster.firstCellX = firstX;
+    raster.firstCellY = firstY;
+    raster.columns = max(0, lastX - firstX + 1);
+    raster.rows = max(0, lastY - firstY + 1);
+    raster.screenX = worldToScreenX(firstX * cellTiles);
+    raster.screenY = worldToScreenY(firstY * cellTiles);
+    raster.cellPixels = cellTiles * pixelsPerTile;
+    raster.rgba.resize(static_cast<size_t>(raster.columns) * raster.rows * 4);
+
+    uint8_t* out = raster.rgba.data();
+    if (level == 0) {
+        const FoodClass* tiles = pyramid.getTiles();
+        for (int y = firstY; y < firstY + raster.rows; ++y) {
+            const FoodClass* row = tiles + static_cast<size_t>(y) * levelWidth;
+            for (int x = firstX; x < firstX + raster.columns; ++x) {
+                const uint8_t* colour = tileColour(row[x]);
+                out[0] = colour[0];
+                out[1] = colour[1];
+                out[2] = colour[2];
+                out[3] = 255;
+                out += 4;
+            }
+        }
+        return;
+    }
+
+    // Blending in fixed point; only the last row and column of cells can be
+    // cut short by the world's edge, so the area is looked up just there
+    const uint8_t* empty = tileColour(FOOD_CLASS_EMPTY);
+    const uint32_t fullArea = 1u << (2 * level);
+    for (int y = firstY; y < firstY + raster.rows; ++y) {
+        const uint32_t* counts = pyramid.cellCounts(level, firstX, y);
+        bool edgeRow = y == levelHeight - 1;
+        for (int x = firstX; x < firstX + raster.columns; ++x) {
+            uint32_t occupied = 0;
+            uint32_t best = 0;
+            int majority = FOOD_CLASS_EMPTY;
+            for (int slot = 0; slot < OccupancyPyramid::CLASS_SLOTS; ++slot) {
+                occupied += counts[slot];
+                if (counts[slot] > best) {
+                    best = counts[slot];
+                    majority = slot + 1;
+                }
+            }
+            counts += OccupancyPyramid::CLASS_SLOTS;
+
+            const uint8_t* colour = TILE_PALETTE[majority];
+            uint32_t area = edgeRow || x == levelWidth - 1 ? pyramid.getCellArea(level, x, y) : fullArea;
+            uint32_t weight = static_cast<uint32_t>((static_cast<uint64_t>(occupied) << 8) / area);
+            for (int c = 0; c < 3; ++c) {
+                int blended = empty[c] * 256 + (colour[c] - empty[c]) * static_cast<int>(weight);
+                out[c] = static_cast<uint8_t>((blended + 128) >> 8);
+            }
+            out[3] = 255;
+            out += 4;
+        }
+    }
+}
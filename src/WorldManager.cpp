@@ -20,6 +20,19 @@ WorldManager& WorldManager::getInstance(int width, int height, float baseNutrien
     return *instance;
 }
 
+void WorldManager::resetInstance() {
+    delete instance;
+    instance = nullptr;
+}
+
+void WorldManager::forgetInstanceAfterFork() {
+    instance = nullptr;
+}
+
+bool WorldManager::isRecordingStatistics() {
+    return instance != nullptr && instance->pImpl->isRecordingStatistics();
+}
+
 void WorldManager::update() {
     pImpl->update(*this);
 }
@@ -44,9 +57,125 @@ void WorldManager::spawnPlantFromDeadOrganism(Position position, float nutrients
     pImpl->spawnPlantFromDeadOrganism(position.getX(), position.getY(), nutrients);
 }
 
+void WorldManager::emitIntent(IntentKind kind, Organism& actor, int x, int y) {
+    pImpl->emitIntent(kind, actor, x, y);
+}
+
+bool WorldManager::claimTile(int x, int y) {
+    return pImpl->claimTile(x, y);
+}
+
+bool WorldManager::claimEmptyNeighbor(const Perception& neighborhood, int nth, Position& claimed) {
+    return pImpl->claimEmptyNeighbor(neighborhood, nth, claimed);
+}
+
 const Grid& WorldManager::getGrid() const {
     return pImpl->getGrid();
 }
 int WorldManager::getOrganismCount() const {
     return pImpl->getOrganismCount();
+}
+
+uint64_t WorldManager::getCurrentTick() const {
+    return pImpl->getCurrentTick();
+}
+
+TickProfiler& WorldManager::getProfiler() {
+    return pImpl->getProfiler();
+}
+
+SimulationMetrics& WorldManager::getMetrics() {
+    return pImpl->getMetrics();
+}
+
+const PopulationAggregates& WorldManager::getAggregates() const {
+    return pImpl->getAggregates();
+}
+
+void WorldManager::configureMetricsExport(const std::string& prometheusPath, const std::string& csvPath, int intervalTicks) {
+    pImpl->configureMetricsExport(prometheusPath, csvPath, intervalTicks);
+}
+
+void WorldManager::configureStatistics(const std::string& path, const StatisticsOptions& options) {
+    pImpl->configureStatistics(path, options);
+}
+
+void WorldManager::closeStatistics() {
+    pImpl->closeStatistics();
+}
+
+bool WorldManager::configureSharedExport(const std::string& name, int frameCount, bool withNutrients) {
+    return pImpl->configureSharedExport(name, frameCount, withNutrients);
+}
+
+bool WorldManager::configureFrameDump(const FrameDumpOptions& options) {
+    return pImpl->configureFrameDump(options);
+}
+
+void WorldManager::closeFrameDump() {
+    pImpl->closeFrameDump();
+}
+
+const FrameDumper& WorldManager::getFrameDumper() const {
+    return pImpl->getFrameDumper();
+}
+
+const OccupancyPyramid& WorldManager::enableOccupancyPyramid() {
+    return pImpl->enableOccupancyPyramid();
+}
+
+void WorldManager::setGridLayout(GridLayout kind) {
+    pImpl->setGridLayout(kind);
+}
+
+void WorldManager::setSpatialSortInterval(int ticks) {
+    pImpl->setSpatialSortInterval(ticks);
+}
+
+const SpatialOrder& WorldManager::getSpatialOrder() const {
+    return pImpl->getSpatialOrder();
+}
+
+void WorldManager::setParallelUpdates(bool enabled) {
+    pImpl->setParallelUpdates(enabled);
+}
+
+bool WorldManager::hasParallelUpdates() const {
+    return pImpl->hasParallelUpdates();
+}
+
+bool WorldManager::logsOrganismUpdates() const {
+    return !pImpl->hasParallelUpdates();
+}
+
+void WorldManager::setOwnedRows(int firstRow, int lastRow) {
+    pImpl->setOwnedRows(firstRow, lastRow);
+}
+
+void WorldManager::placeGhost(Organism* ghost, int x, int y) {
+    pImpl->placeGhost(ghost, x, y);
+}
+
+Organism* WorldManager::removeGhost(int x, int y) {
+    return pImpl->removeGhost(x, y);
+}
+
+void WorldManager::takeEmigrants(std::vector<Organism*>& emigrants) {
+    pImpl->takeEmigrants(emigrants);
+}
+
+const MemoryAccounting& WorldManager::getMemoryAccounting() const {
+    return pImpl->getMemoryAccounting();
+}
+
+void WorldManager::packOrganisms(CompactOrganismStore& store) const {
+    pImpl->packOrganisms(store);
+}
+
+const SoilField& WorldManager::getSoil() const {
+    return pImpl->getSoil();
+}
+
+float WorldManager::drawSoilNutrients(int x, int y, float amount) {
+    return pImpl->drawSoilNutrients(x, y, amount);
 }
\ No newline at end of file
@@ -1,11 +1,45 @@
 #include "WorldManagerImpl.h"
 #include "WorldManager.h"
+#include "OccupancyPyramid.h"
 #include <algorithm>
+#include <array>
+#include <chrono>
 #include <iostream>
+#include <stdexcept>
+
+// Soil starts full, and regeneration refills it to SOIL_CAPACITY_TICKS ticks'
+// worth at most; decomposition enriches it beyond that
+static const float SOIL_CAPACITY_TICKS = 10.0f;
+// Share of a dead organism's nutrients returned to the soil; the rest feeds
+// the decomposition plant
+static const float DECOMPOSITION_SOIL_SHARE = 0.2f;
+// How far ahead of the organism updating its successors are prefetched
+static const size_t UPDATE_PREFETCH_DISTANCE = 8;
+
+static inline void prefetchRead(const void* address) {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(address);
+#else
+    (void)address;
+#endif
+}
 
 WorldManagerImpl::WorldManagerImpl(int width, int height, float nutrients)
-    : baseNutrientGenerationRate(nutrients) {
+    : baseNutrientGenerationRate(nutrients),
+      soil(width, height, nutrients * SOIL_CAPACITY_TICKS, nutrients * SOIL_CAPACITY_TICKS),
+      accountedStoreCapacity(0),
+      accountedSchedulerFootprint({0, 0}),
+      spatialSortInterval(0),
+      parallelUpdates(false),
+      ownedFirstRow(0),
+      ownedLastRow(height) {
     grid = new Grid(width, height);
+    
+    MemoryFootprint gridFootprint = grid->getMemoryFootprint();
+    gridFootprint.bytes += sizeof(Grid);
+    gridFootprint.allocations += 1;
+    memory.getAccount(MemorySubsystem::GRID).charge(gridFootprint);
+    memory.getAccount(MemorySubsystem::SOIL).charge(soil.getMemoryFootprint());
 }
 
 WorldManagerImpl::~WorldManagerImpl() {
@@ -19,20 +53,176 @@ WorldManagerImpl::~WorldManagerImpl() {
 }
 
 void WorldManagerImpl::update(WorldManager& worldManager) {
-    std::cout << "Updating " << organisms.size() << " organisms" << std::endl;
+    PROFILE_TICK_PHASE(profiler, TickPhase::TICK_TOTAL);
+    if (spatialSortInterval > 0) {
+        PROFILE_TICK_PHASE(profiler, TickPhase::SPATIAL_SORT);
+        orderSpatially();
+    }
+    dueOrganisms.clear();
+    schedule.advance(dueOrganisms);
+    std::cout << "Updating " << dueOrganisms.size() << " of " << organisms.size() << " organisms" << std::endl;
     
-    std::vector<bool> shouldUpdate(organisms.size(), true);
+    // The grid holds still until the intents resolve, so one whole-grid pass
+    // answers every organism's neighborhood questions for this tick
+    {
+        PROFILE_TICK_PHASE(profiler, TickPhase::NEIGHBORHOOD);
+        grid->getBitboards().refreshNeighborhood();
+    }
     
-    for (size_t i = 0; i < organisms.size() && i < shouldUpdate.size(); ++i) {
-        if (shouldUpdate[i] && organisms[i] != nullptr && !organisms[i]->isDead()) {
-            // Check if organism is still at the same index (not moved due to removals)
-            if (i < organisms.size() && organisms[i] != nullptr) {
-                organisms[i]->update(*grid, worldManager);
-            }
+    {
+        PROFILE_TICK_PHASE(profiler, TickPhase::ORGANISM_UPDATE);
+        if (PROFILING_COMPILED_IN && profiler.isEnabled()) {
+            updateOrganismsProfiled(worldManager);
+        } else if (parallelUpdates) {
+            updateOrganismsParallel(worldManager);
+        } else {
+            updateOrganisms(worldManager);
         }
     }
     
-    removeDeadOrganisms();
+    {
+        PROFILE_TICK_PHASE(profiler, TickPhase::RESOLVE_INTENTS);
+        resolveIntents();
+    }
+    
+    {
+        PROFILE_TICK_PHASE(profiler, TickPhase::SOIL_UPDATE);
+        soil.step(baseNutrientGenerationRate);
+    }
+    
+    updatePopulationGauges();
+    accountScheduler();
+    metrics.endTick();
+    metricsExporter.onTick(metrics);
+    
+    if (statistics.isEnabled()) {
+        PROFILE_TICK_PHASE(profiler, TickPhase::STATISTICS);
+        statistics.collect(metrics.getTick(), organisms, metrics);
+    }
+    
+    if (sharedState.isOpen()) {
+        PROFILE_TICK_PHASE(profiler, TickPhase::SHARED_EXPORT);
+        sharedState.publish(metrics.getTick(), organisms.size(), grid->getFoodClasses(), soil.data());
+    }
+    
+    if (frameDumper.wantsTick(metrics.getTick())) {
+        PROFILE_TICK_PHASE(profiler, TickPhase::FRAME_DUMP);
+        frameDumper.capture(metrics.getTick(), grid->getWidth(), grid->getHeight(), grid->getFoodClasses());
+    }
+}
+
+// One bounded pass every spatialSortInterval ticks puts the organism list and
+// every list waiting in the wheel in tile order. It runs between ticks, when
+// every living organism is in the wheel. Between passes the order mostly
+// holds by itself: organisms are rescheduled in the order they update, so
+// only movers and newcomers drift.
+void WorldManagerImpl::orderSpatially() {
+    if (metrics.getTick() % static_cast<uint64_t>(spatialSortInterval) != 0) return;
+    const TileLayout& layout = grid->getLayout();
+    spatialOrder.sort(organisms, layout);
+    schedule.reorderSlots([this, &layout](std::vector<Organism*>& slot) {
+        spatialOrder.sort(slot, layout);
+    });
+}
+
+// Two stages, so the organism has arrived by the time its position pointer
+// is read for the second prefetch.
+void WorldManagerImpl::prefetchDue(size_t index) const {
+    if (index + UPDATE_PREFETCH_DISTANCE < dueOrganisms.size()) {
+        prefetchRead(dueOrganisms[index + UPDATE_PREFETCH_DISTANCE]);
+    }
+    if (index + UPDATE_PREFETCH_DISTANCE / 2 < dueOrganisms.size()) {
+        prefetchRead(dueOrganisms[index + UPDATE_PREFETCH_DISTANCE / 2]->position);
+    }
+}
+
+// Only the organisms due this tick update. They only emit intents, so neither
+// the grid nor the organism list changes during this walk, and each one is
+// booked for its next action straight away; the resolve phase cancels the
+// bookings of those that die.
+void WorldManagerImpl::updateOrganisms(WorldManager& worldManager) {
+    IntentBuffer& buffer = intents.local();
+    for (size_t i = 0; i < dueOrganisms.size(); ++i) {
+        Organism* organism = dueOrganisms[i];
+        prefetchDue(i);
+        buffer.setSequence(static_cast<uint32_t>(i));
+        PopulationAggregates::Contribution before = PopulationAggregates::contributionOf(*organism);
+        organism->update(*grid, worldManager);
+        aggregates.update(before, *organism);
+        reschedule(organism);
+    }
+}
+
+// Same walk as updateOrganisms, but every organism update is timed and the
+// per-type totals are recorded once at the end of the tick.
+void WorldManagerImpl::updateOrganismsProfiled(WorldManager& worldManager) {
+    using Clock = std::chrono::steady_clock;
+    std::array<uint64_t, 4> typeNanos = {0, 0, 0, 0};
+    std::array<bool, 4> typeSeen = {false, false, false, false};
+    
+    IntentBuffer& buffer = intents.local();
+    for (size_t i = 0; i < dueOrganisms.size(); ++i) {
+        Organism* organism = dueOrganisms[i];
+        prefetchDue(i);
+        size_t slot = 0;
+        if (organism->getType() == OrganismType::ANIMAL) {
+            slot = 1 + static_cast<size_t>(static_cast<Animal*>(organism)->getAnimalType());
+        }
+        
+        buffer.setSequence(static_cast<uint32_t>(i));
+        PopulationAggregates::Contribution before = PopulationAggregates::contributionOf(*organism);
+        Clock::time_point start = Clock::now();
+        organism->update(*grid, worldManager);
+        typeNanos[slot] += static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+        typeSeen[slot] = true;
+        aggregates.update(before, *organism);
+        reschedule(organism);
+    }
+    
+    const TickPhase typePhases[4] = {
+        TickPhase::PLANT_UPDATE,
+        TickPhase::HERBIVORE_UPDATE,
+        TickPhase::CARNIVORE_UPDATE,
+        TickPhase::OMNIVORE_UPDATE
+    };
+    for (size_t slot = 0; slot < typeNanos.size(); ++slot) {
+        if (typeSeen[slot]) {
+            profiler.record(typePhases[slot], typeNanos[slot]);
+        }
+    }
+}
+
+// Organisms only read the grid and emit intents, so they can update on any
+// participant: each one emits into its participant's intent buffer with its
+// serial sequence, target tiles go to whichever claims first, and metrics
+// are sharded. Aggregates and the wheel are not thread-safe, so they are
+// brought up to date afterwards, in update order.
+void WorldManagerImpl::updateOrganismsParallel(WorldManager& worldManager) {
+    TaskPool& pool = TaskPool::shared();
+    if (intents.getWorkerCount() != pool.getParticipantCount()) {
+        // The shared pool was replaced since parallel updates were enabled
+        if (intents.pending() > 0) {
+            updateOrganisms(worldManager);
+            return;
+        }
+        intents.setWorkerCount(pool.getParticipantCount());
+    }
+    dueContributions.resize(dueOrganisms.size());
+    pool.parallelFor(dueOrganisms.size(), updateGrain, [&](size_t begin, size_t end, int participant) {
+        IntentQueue::bindWorker(participant);
+        IntentBuffer& buffer = intents.local();
+        for (size_t i = begin; i < end; ++i) {
+            Organism* organism = dueOrganisms[i];
+            buffer.setSequence(static_cast<uint32_t>(i));
+            dueContributions[i] = PopulationAggregates::contributionOf(*organism);
+            organism->update(*grid, worldManager);
+        }
+    });
+    for (size_t i = 0; i < dueOrganisms.size(); ++i) {
+        aggregates.update(dueContributions[i], *dueOrganisms[i]);
+        reschedule(dueOrganisms[i]);
+    }
 }
 
 void WorldManagerImpl::addOrganism(Organism* organism, int x, int y) {
@@ -47,7 +237,7 @@ void WorldManagerImpl::addOrganism(Organism* organism, int x, int y) {
         return;
     }
     
-    Tile& tile = grid->getTile(x, y);
+    Tile& tile = grid->tileAt(x, y);
     if (!tile.isEmpty()) {
         std::cout << "Cannot add organism - tile occupied at (" << x << ", " << y << ")" << std::endl;
         delete organism; // Clean up the organism since we can't place it
@@ -61,6 +251,10 @@ void WorldManagerImpl::addOrganism(Organism* organism, int x, int y) {
     try {
         tile.setOccupant(*organism);
         organisms.push_back(organism); // Only add to vector if tile placement succeeds
+        schedule.schedule(organism, 0);
+        aggregates.add(*organism);
+        memory.getAccount(MemorySubsystem::ORGANISMS).charge(organism->getMemoryFootprint());
+        accountOrganismStore();
         std::cout << "Added organism to (" << x << ", " << y << ")" << std::endl;
     } catch (const std::runtime_error& e) {
         std::cout << "Failed to place organism: " << e.what() << std::endl;
@@ -75,23 +269,26 @@ void WorldManagerImpl::removeOrganism(Organism* organism) {
     auto it = std::find(organisms.begin(), organisms.end(), organism);
     if (it != organisms.end()) {
         organisms.erase(it);
+        schedule.cancel(organism);
+        aggregates.remove(*organism);
         
         // Clear from grid
         Position pos = organism->getPosition();
         if (grid->isInBounds(pos.getX(), pos.getY())) {
-            Tile& tile = grid->getTile(pos.getX(), pos.getY());
+            Tile& tile = grid->tileAt(pos.getX(), pos.getY());
             if (!tile.isEmpty() && tile.getOccupant() == organism) {
                 tile.clearOccupant();
             }
         }
         
+        memory.getAccount(MemorySubsystem::ORGANISMS).release(organism->getMemoryFootprint());
         delete organism;
     }
 }
 
 void WorldManagerImpl::removeOrganism(int x, int y) {
     if (grid->isInBounds(x, y)) {
-        Tile& tile = grid->getTile(x, y);
+        Tile& tile = grid->tileAt(x, y);
         if (!tile.isEmpty()) {
             Organism* organism = tile.getOccupant();
             removeOrganism(organism);
@@ -101,16 +298,62 @@ void WorldManagerImpl::removeOrganism(int x, int y) {
 
 void WorldManagerImpl::spawnPlantFromDeadOrganism(int x, int y, float nutrients) {
     if (grid->isInBounds(x, y)) {
-        Tile& tile = grid->getTile(x, y);
+        Tile& tile = grid->tileAt(x, y);
         if (tile.isEmpty()) {
             float plantNutrients = std::max(nutrients / 2, 4.0f); 
             Plant* newPlant = new Plant(plantNutrients, 100, 0.8f, 0.6f);
             addOrganism(newPlant, x, y);
+            metrics.increment(MetricCounter::DECOMPOSITION_SPAWNS);
             std::cout << "Plant spawned from dead organism with " << plantNutrients << " nutrients" << std::endl;
         }
     }
 }
 
+void WorldManagerImpl::emitIntent(IntentKind kind, Organism& actor, int x, int y) {
+    if (!grid->isInBounds(x, y)) {
+        std::cout << "Warning: Ignoring intent out of bounds at (" << x << ", " << y << ")" << std::endl;
+        return;
+    }
+    intents.local().push(kind, actor, static_cast<uint32_t>(y * grid->getWidth() + x));
+}
+
+// The handle is the caller's place in the update order, which the thread
+// driving it has already set on its intent buffer.
+bool WorldManagerImpl::tryClaimTile(int x, int y, bool& lost) {
+    if (!grid->isInBounds(x, y)) return false;
+    size_t index = static_cast<size_t>(y) * grid->getWidth() + x;
+    if (grid->tryClaim(index, intents.local().getSequence())) return true;
+    lost = lost || grid->getFoodClasses()[index] == FOOD_CLASS_EMPTY;
+    return false;
+}
+
+bool WorldManagerImpl::claimTile(int x, int y) {
+    bool lost = false;
+    if (tryClaimTile(x, y, lost)) return true;
+    if (lost) {
+        metrics.increment(MetricCounter::INTENT_CONFLICTS);
+    }
+    return false;
+}
+
+// A conflict is counted once for the whole search, and only if it comes up
+// empty; losing a candidate to a neighbor and taking the next is no conflict
+bool WorldManagerImpl::claimEmptyNeighbor(const Perception& neighborhood, int nth, Position& claimed) {
+    int count = neighborhood.emptyNeighborCount();
+    bool lost = false;
+    for (int i = 0; i < count; ++i) {
+        Position candidate = neighborhood.emptyNeighbor((nth + i) % count);
+        if (tryClaimTile(candidate.getX(), candidate.getY(), lost)) {
+            claimed = candidate;
+            return true;
+        }
+    }
+    if (lost) {
+        metrics.increment(MetricCounter::INTENT_CONFLICTS);
+    }
+    return false;
+}
+
 const Grid& WorldManagerImpl::getGrid() const {
     return *grid;
 }
@@ -119,60 +362,375 @@ int WorldManagerImpl::getOrganismCount() const {
     return organisms.size();
 }
 
+uint64_t WorldManagerImpl::getCurrentTick() const {
+    return schedule.getCurrentTick();
+}
+
+const MemoryAccounting& WorldManagerImpl::getMemoryAccounting() const {
+    return memory;
+}
+
+const SoilField& WorldManagerImpl::getSoil() const {
+    return soil;
+}
+
+float WorldManagerImpl::drawSoilNutrients(int x, int y, float amount) {
+    if (!grid->isInBounds(x, y)) return 0.0f;
+    return soil.draw(x, y, amount);
+}
+
+void WorldManagerImpl::packOrganisms(CompactOrganismStore& store) const {
+    store.clear();
+    store.reserve(organisms.size());
+    for (const Organism* organism : organisms) {
+        store.add(*organism, grid->getWidth());
+    }
+}
+
+// The organism vector only changes its heap block when it grows or shrinks
+// its capacity, so the account is adjusted only then.
+void WorldManagerImpl::accountOrganismStore() {
+    size_t capacity = organisms.capacity();
+    if (capacity == accountedStoreCapacity) return;
+    
+    MemoryAccount& account = memory.getAccount(MemorySubsystem::ORGANISM_STORE);
+    if (accountedStoreCapacity > 0) {
+        account.release({accountedStoreCapacity * sizeof(Organism*), 1});
+    }
+    if (capacity > 0) {
+        account.charge({capacity * sizeof(Organism*), 1});
+    }
+    accountedStoreCapacity = capacity;
+}
+
+// advance() has already moved the wheel past the tick being updated, so an
+// interval of 1 means the wheel's current tick.
+void WorldManagerImpl::reschedule(Organism* organism) {
+    schedule.schedule(organism, static_cast<uint64_t>(std::max(organism->getActionInterval(), 1) - 1));
+}
+
+// The wheel's slot vectors and index change every tick, so the account is
+// settled once per tick rather than on every schedule call.
+void WorldManagerImpl::accountScheduler() {
+    MemoryFootprint footprint = schedule.getMemoryFootprint();
+    footprint.bytes += dueOrganisms.capacity() * sizeof(Organism*);
+    footprint.allocations += dueOrganisms.capacity() > 0 ? 1 : 0;
+    footprint.bytes += dueContributions.capacity() * sizeof(PopulationAggregates::Contribution);
+    footprint.allocations += dueContributions.capacity() > 0 ? 1 : 0;
+    MemoryFootprint orderFootprint = spatialOrder.getMemoryFootprint();
+    footprint.bytes += orderFootprint.bytes;
+    footprint.allocations += orderFootprint.allocations;
+    if (footprint.bytes == accountedSchedulerFootprint.bytes &&
+        footprint.allocations == accountedSchedulerFootprint.allocations) return;
+    
+    MemoryAccount& account = memory.getAccount(MemorySubsystem::SCHEDULER);
+    account.release(accountedSchedulerFootprint);
+    account.charge(footprint);
+    accountedSchedulerFootprint = footprint;
+}
+
+TickProfiler& WorldManagerImpl::getProfiler() {
+    return profiler;
+}
+
+SimulationMetrics& WorldManagerImpl::getMetrics() {
+    return metrics;
+}
+
+const PopulationAggregates& WorldManagerImpl::getAggregates() const {
+    return aggregates;
+}
+
+void WorldManagerImpl::configureMetricsExport(const std::string& prometheusPath, const std::string& csvPath, int intervalTicks) {
+    metricsExporter.configure(prometheusPath, csvPath, intervalTicks);
+}
+
+void WorldManagerImpl::configureStatistics(const std::string& path, const StatisticsOptions& options) {
+    statistics.open(path, options);
+}
+
+void WorldManagerImpl::closeStatistics() {
+    statistics.close();
+}
+
+bool WorldManagerImpl::isRecordingStatistics() const {
+    return statistics.isEnabled();
+}
+
+bool WorldManagerImpl::configureFrameDump(const FrameDumpOptions& options) {
+    return frameDumper.open(options);
+}
+
+void WorldManagerImpl::closeFrameDump() {
+    frameDumper.close();
+}
+
+const FrameDumper& WorldManagerImpl::getFrameDumper() const {
+    return frameDumper;
+}
+
+void WorldManagerImpl::setGridLayout(GridLayout kind) {
+    MemoryAccount& account = memory.getAccount(MemorySubsystem::GRID);
+    account.release(grid->getMemoryFootprint());
+    grid->setLayout(kind);
+    account.charge(grid->getMemoryFootprint());
+}
+
+void WorldManagerImpl::setSpatialSortInterval(int ticks) {
+    if (ticks < 0) {
+        throw std::invalid_argument("Spatial sort interval must not be negative");
+    }
+    spatialSortInterval = ticks;
+}
+
+const SpatialOrder& WorldManagerImpl::getSpatialOrder() const {
+    return spatialOrder;
+}
+
+// One intent buffer per participant. Resizing the queue drops pending
+// intents, which is why this is only called between ticks.
+void WorldManagerImpl::setParallelUpdates(bool enabled) {
+    parallelUpdates = enabled;
+    intents.setWorkerCount(enabled ? TaskPool::shared().getParticipantCount() : 1);
+}
+
+bool WorldManagerImpl::hasParallelUpdates() const {
+    return parallelUpdates;
+}
+
+void WorldManagerImpl::setOwnedRows(int firstRow, int lastRow) {
+    if (firstRow < 0 || lastRow > grid->getHeight() || firstRow >= lastRow) {
+        throw std::invalid_argument("Owned rows must be a non-empty range inside the grid");
+    }
+    ownedFirstRow = firstRow;
+    ownedLastRow = lastRow;
+    // Ghosts block their tiles but are never food, so nobody hunts them
+    grid->setFoodRows(firstRow, lastRow);
+}
+
+void WorldManagerImpl::placeGhost(Organism* ghost, int x, int y) {
+    if (!grid->isInBounds(x, y) || ownsRow(y)) {
+        throw std::invalid_argument("Ghosts go on tiles outside the owned rows");
+    }
+    Tile& tile = grid->tileAt(x, y);
+    if (!tile.isEmpty()) {
+        throw std::invalid_argument("Ghosts go on empty tiles");
+    }
+    ghost->setPosition(Position(x, y));
+    tile.setOccupant(*ghost);
+}
+
+Organism* WorldManagerImpl::removeGhost(int x, int y) {
+    if (!grid->isInBounds(x, y) || ownsRow(y)) return nullptr;
+    Tile& tile = grid->tileAt(x, y);
+    if (tile.isEmpty()) return nullptr;
+    Organism* ghost = tile.getOccupant();
+    tile.clearOccupant();
+    return ghost;
+}
+
+// Runs between ticks. Movers and offspring that landed in a halo row during
+// the tick are the only organisms found there.
+void WorldManagerImpl::takeEmigrants(std::vector<Organism*>& emigrants) {
+    MemoryAccount& account = memory.getAccount(MemorySubsystem::ORGANISMS);
+    auto kept = std::remove_if(organisms.begin(), organisms.end(), [&](Organism* organism) {
+        const Position& pos = organism->getPosition();
+        if (ownsRow(pos.getY())) return false;
+        schedule.cancel(organism);
+        aggregates.remove(*organism);
+        grid->tileAt(pos.getX(), pos.getY()).clearOccupant();
+        account.release(organism->getMemoryFootprint());
+        emigrants.push_back(organism);
+        return true;
+    });
+    organisms.erase(kept, organisms.end());
+}
+
+const OccupancyPyramid& WorldManagerImpl::enableOccupancyPyramid() {
+    if (grid->getOccupancyPyramid() == nullptr) {
+        const OccupancyPyramid& pyramid = grid->enableOccupancyPyramid();
+        MemoryFootprint footprint = pyramid.getMemoryFootprint();
+        footprint.bytes += sizeof(OccupancyPyramid);
+        footprint.allocations += 1;
+        memory.getAccount(MemorySubsystem::GRID).charge(footprint);
+    }
+    return *grid->getOccupancyPyramid();
+}
+
+// Frame 0 is published right away so readers can attach before the first tick
+bool WorldManagerImpl::configureSharedExport(const std::string& name, int frameCount, bool withNutrients) {
+    if (!sharedState.open(name, grid->getWidth(), grid->getHeight(), frameCount, withNutrients)) {
+        return false;
+    }
+    sharedState.publish(metrics.getTick(), organisms.size(), grid->getFoodClasses(), soil.data());
+    return true;
+}
+
+void WorldManagerImpl::updatePopulationGauges() {
+    metrics.setGauge(MetricGauge::ORGANISMS, aggregates.getTotalCount());
+    metrics.setGauge(MetricGauge::PLANTS, aggregates.getCount(OrganismType::PLANT));
+    metrics.setGauge(MetricGauge::HERBIVORES, aggregates.getCount(AnimalType::HERBIVORE));
+    metrics.setGauge(MetricGauge::CARNIVORES, aggregates.getCount(AnimalType::CARNIVORE));
+    metrics.setGauge(MetricGauge::OMNIVORES, aggregates.getCount(AnimalType::OMNIVORE));
+}
+
 void WorldManagerImpl::removeDeadOrganisms() {
-    std::vector<std::pair<Position, float>> plantsToSpawn;
-    
-    auto it = organisms.begin();
-    while (it != organisms.end()) {
-        Organism* organism = *it;
-        if (!organism || organism->isDead()) {
-            if (organism) {
-                Position pos = organism->getPosition();
-                float nutrients = organism->getNutrients();
-                
-                std::cout << "Organism died at (" << pos.getX() << ", " << pos.getY() 
+    IntentBuffer& buffer = intents.local();
+    for (size_t i = 0; i < organisms.size(); ++i) {
+        Organism* organism = organisms[i];
+        if (organism->isDead()) {
+            const Position& pos = organism->getPosition();
+            buffer.setSequence(static_cast<uint32_t>(i));
+            emitIntent(IntentKind::DIE, *organism, pos.getX(), pos.getY());
+        }
+    }
+    resolveIntents();
+}
+
+// Applies every queued intent in one sorted sweep. Eats go first, so prey is
+// gone before anything else happens to it; then deaths; then moves and spawns,
+// where the lowest sequence claiming a tile gets it and the rest are dropped.
+// Organisms claim their targets while they update, so only intents emitted
+// without a claim can still collide here.
+// Retired organisms stay in the list until the single compaction at the end.
+void WorldManagerImpl::resolveIntents() {
+    std::vector<Intent> resolved;
+    intents.drain(resolved);
+    // Every claim made so far guards one of these intents
+    grid->beginClaimRound();
+    bool anyRetired = false;
+    
+    std::vector<std::pair<uint32_t, float>> decompositions;
+    int width = grid->getWidth();
+    
+    for (const Intent& intent : resolved) {
+        Organism* actor = intent.actor;
+        if (actor->isRemoved()) continue;
+        
+        int x = static_cast<int>(intent.tile) % width;
+        int y = static_cast<int>(intent.tile) / width;
+        Tile& tile = grid->tileAt(x, y);
+        
+        switch (intent.kind) {
+            case IntentKind::EAT: {
+                Organism* food = tile.isEmpty() ? nullptr : tile.getOccupant();
+                // Ghosts belong to another shard's world
+                if (food == nullptr || food == actor || !ownsRow(y)) {
+                    metrics.increment(MetricCounter::INTENT_CONFLICTS);
+                    break;
+                }
+                PopulationAggregates::Contribution before = PopulationAggregates::contributionOf(*actor);
+                static_cast<Animal*>(actor)->eat(food);
+                aggregates.update(before, *actor);
+                retireOrganism(food);
+                anyRetired = true;
+                metrics.increment(MetricCounter::EATS);
+                metrics.increment(MetricCounter::DEATHS_PREDATION);
+                break;
+            }
+            case IntentKind::DIE: {
+                float nutrients = actor->getNutrients();
+                std::cout << "Organism died at (" << x << ", " << y
                          << ") with " << nutrients << " nutrients" << std::endl;
+                metrics.increment(actor->getAge() >= actor->getMaxLifespan()
+                                      ? MetricCounter::DEATHS_OLD_AGE
+                                      : MetricCounter::DEATHS_STARVATION);
                 
                 // Give more nutrients to spawned plants and ensure minimum threshold
-                float plantNutrients = std::max(nutrients * 0.8f, 12.0f); // 80% of nutrients, minimum 12
-                plantsToSpawn.emplace_back(pos, plantNutrients);
-                
-                // Clear from grid
-                if (grid->isInBounds(pos.getX(), pos.getY())) {
-                    Tile& tile = grid->getTile(pos.getX(), pos.getY());
-                    if (!tile.isEmpty() && tile.getOccupant() == organism) {
-                        tile.clearOccupant();
+                decompositions.emplace_back(intent.tile, std::max(nutrients * 0.8f, 12.0f));
+                soil.deposit(x, y, nutrients * DECOMPOSITION_SOIL_SHARE);
+                retireOrganism(actor);
+                anyRetired = true;
+                break;
+            }
+            case IntentKind::MOVE: {
+                if (!tile.isEmpty()) {
+                    metrics.increment(MetricCounter::INTENT_CONFLICTS);
+                    break;
+                }
+                const Position& from = actor->getPosition();
+                grid->tileAt(from.getX(), from.getY()).clearOccupant();
+                actor->setPosition(Position(x, y));
+                tile.setOccupant(*actor);
+                metrics.increment(MetricCounter::MOVES);
+                break;
+            }
+            case IntentKind::SPAWN: {
+                PopulationAggregates::Contribution before = PopulationAggregates::contributionOf(*actor);
+                Organism* offspring = tile.isEmpty() ? actor->reproduce() : nullptr;
+                aggregates.update(before, *actor);
+                if (offspring == nullptr) {
+                    metrics.increment(MetricCounter::INTENT_CONFLICTS);
+                    if (actor->getType() == OrganismType::PLANT) {
+                        metrics.increment(MetricCounter::FAILED_SPREADS);
                     }
+                    break;
                 }
-                
-                delete organism;
+                addOrganism(offspring, x, y);
+                metrics.increment(MetricCounter::BIRTHS);
+                break;
             }
-            
-            it = organisms.erase(it);
-        } else {
-            ++it;
+        }
+    }
+    
+    ScopedMemoryCharge scratchCharge(memory.getAccount(MemorySubsystem::SCRATCH), {
+        resolved.capacity() * sizeof(Intent) + decompositions.capacity() * sizeof(decompositions[0]),
+        1u + (decompositions.capacity() > 0 ? 1u : 0u)});
+    
+    {
+        PROFILE_TICK_PHASE(profiler, TickPhase::REMOVE_DEAD);
+        if (anyRetired) {
+            compactOrganisms();
         }
     }
     
     // Spawn plants from dead organisms
-    for (const auto& plantData : plantsToSpawn) {
-        const Position& pos = plantData.first;
-        float nutrients = plantData.second;
+    PROFILE_TICK_PHASE(profiler, TickPhase::DECOMPOSITION_SPAWN);
+    for (const auto& decomposition : decompositions) {
+        int x = static_cast<int>(decomposition.first) % width;
+        int y = static_cast<int>(decomposition.first) / width;
+        float nutrients = decomposition.second;
         
-        if (grid->isInBounds(pos.getX(), pos.getY())) {
-            Tile& tile = grid->getTile(pos.getX(), pos.getY());
-            if (tile.isEmpty()) {
-                // Create plants with better stats specifically for decomposition plants
-                Plant* newPlant = new Plant(
-                    nutrients,           // Use the calculated nutrients (minimum 12)
-                    120,                // Longer lifespan 
-                    1.0f,               // Higher growth rate
-                    0.8f                // Higher absorption rate
-                );
-                addOrganism(newPlant, pos.getX(), pos.getY());
-                std::cout << "Decomposition plant spawned at (" << pos.getX() << ", " << pos.getY() 
-                         << ") with " << nutrients << " nutrients" << std::endl;
-            }
+        if (grid->tileAt(x, y).isEmpty()) {
+            // Create plants with better stats specifically for decomposition plants
+            Plant* newPlant = new Plant(
+                nutrients,           // Use the calculated nutrients (minimum 12)
+                120,                // Longer lifespan 
+                1.0f,               // Higher growth rate
+                0.8f                // Higher absorption rate
+            );
+            addOrganism(newPlant, x, y);
+            metrics.increment(MetricCounter::DECOMPOSITION_SPAWNS);
+            std::cout << "Decomposition plant spawned at (" << x << ", " << y 
+                     << ") with " << nutrients << " nutrients" << std::endl;
+        }
+    }
+}
+
+// Takes the organism off the grid and the schedule; it is deleted by the
+// next compaction.
+void WorldManagerImpl::retireOrganism(Organism* organism) {
+    schedule.cancel(organism);
+    aggregates.remove(*organism);
+    const Position& pos = organism->getPosition();
+    if (grid->isInBounds(pos.getX(), pos.getY())) {
+        Tile& tile = grid->tileAt(pos.getX(), pos.getY());
+        if (!tile.isEmpty() && tile.getOccupant() == organism) {
+            tile.clearOccupant();
         }
     }
-}
\ No newline at end of file
+    organism->removed = true;
+}
+
+// One stable pass instead of an erase per removal, so survivors keep their
+// relative update order.
+void WorldManagerImpl::compactOrganisms() {
+    MemoryAccount& account = memory.getAccount(MemorySubsystem::ORGANISMS);
+    auto kept = std::remove_if(organisms.begin(), organisms.end(), [&account](Organism* organism) {
+        if (!organism->isRemoved()) return false;
+        account.release(organism->getMemoryFootprint());
+        delete organism;
+        return true;
+    });
+    organisms.erase(kept, organisms.end());
+}
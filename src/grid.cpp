@@ -25,6 +25,9 @@ Organism& Grid::findClosestOrganism(const Position& pos, OrganismType targetType
     return pImpl->findClosestOrganism(pos, targetType);
 }
 
-bool Grid::isInBounds(int x, int y) const {
-    return pImpl->isInBounds(x, y);
+MemoryFootprint Grid::getMemoryFootprint() const {
+    MemoryFootprint footprint = pImpl->getMemoryFootprint();
+    footprint.bytes += sizeof(GridImpl);
+    footprint.allocations += 1;
+    return footprint;
 }
\ No newline at end of file
@@ -1,10 +1,13 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
 #include <iostream>
 #include <string>
 #include <cstdlib> // For rand()
-#include <thread>  // For sleep
-#include <chrono>  // For chrono literals
 #include <random>  // For better random number generation
 #include "WorldManager.h"
+#include "TimeWarpController.h"
+#include "Viewport.h"
 #include "Animal.h"
 #include "Plant.h"
 #include "Position.h"
@@ -13,12 +16,259 @@
 
 using namespace std;
 
-int main() {
+// Largest window the viewer opens; bigger worlds start zoomed out
+static const unsigned int MAX_WINDOW_WIDTH = 1280;
+static const unsigned int MAX_WINDOW_HEIGHT = 800;
+
+// Runs the ticks the time-warp controller plans and draws the world when it
+// says to, until the window is closed.
+static void runViewer(WorldManager& world, int tileSize, double warpMultiplier, bool warpMax) {
+    const int worldWidth = world.getGrid().getWidth();
+    const int worldHeight = world.getGrid().getHeight();
+    const unsigned int windowWidth = min(MAX_WINDOW_WIDTH, static_cast<unsigned int>(worldWidth * tileSize));
+    const unsigned int windowHeight = min(MAX_WINDOW_HEIGHT, static_cast<unsigned int>(worldHeight * tileSize));
+    sf::RenderWindow window(sf::VideoMode({windowWidth, windowHeight}), "SFML window");
+    
+    const sf::Font font("fonts/arial.ttf");
+    sf::Text hud(font, "", 14);
+    hud.setFillColor(sf::Color::Black);
+    hud.setPosition(sf::Vector2f(4.0f, 2.0f));
+
+    // WASD or dragging with the left button pans, the wheel or +/- zooms and
+    // F fits the whole world. Each frame draws the visible cells of one
+    // pyramid level as a single texture, one texel per cell.
+    const OccupancyPyramid& pyramid = world.enableOccupancyPyramid();
+    Viewport viewport(worldWidth, worldHeight, static_cast<int>(windowWidth), static_cast<int>(windowHeight), tileSize);
+    if (windowWidth < static_cast<unsigned int>(worldWidth * tileSize) ||
+        windowHeight < static_cast<unsigned int>(worldHeight * tileSize)) {
+        viewport.fitWorld();
+    }
+    ViewportRaster raster;
+    sf::Texture cellTexture;
+    bool dragging = false;
+    sf::Vector2i dragFrom;
+    const double ZOOM_STEP = 1.25;
+    const double PAN_STEP = 0.1;
+
+    // Up/Down double or halve the warp multiplier, M toggles max speed.
+    // Every loop runs the ticks the controller plans and then, unless the
+    // simulation is behind, draws only the latest state. Loops that skip
+    // drawing also skip display(), so the frame limit does not hold them up.
+    const double RENDER_FPS = 60.0;
+    TimeWarpController warp(RENDER_FPS);
+    warp.setMultiplier(warpMultiplier);
+    warp.setMaxSpeed(warpMax);
+    window.setFramerateLimit(static_cast<unsigned int>(RENDER_FPS));
+    sf::Clock frameClock;
+
+    while (window.isOpen())
+    {
+        while (const std::optional event = window.pollEvent())
+        {
+            if (event->is<sf::Event::Closed>()) {
+                window.close();
+            } else if (const auto* resized = event->getIf<sf::Event::Resized>()) {
+                sf::Vector2f size(static_cast<float>(resized->size.x), static_cast<float>(resized->size.y));
+                window.setView(sf::View(sf::FloatRect({0.0f, 0.0f}, size)));
+                viewport.resize(static_cast<int>(resized->size.x), static_cast<int>(resized->size.y));
+            } else if (const auto* key = event->getIf<sf::Event::KeyPressed>()) {
+                double panX = viewport.getWindowWidth() * PAN_STEP;
+                double panY = viewport.getWindowHeight() * PAN_STEP;
+                double midX = viewport.getWindowWidth() / 2.0;
+                double midY = viewport.getWindowHeight() / 2.0;
+                if (key->code == sf::Keyboard::Key::Up) {
+                    warp.faster();
+                } else if (key->code == sf::Keyboard::Key::Down) {
+                    warp.slower();
+                } else if (key->code == sf::Keyboard::Key::M) {
+                    warp.toggleMaxSpeed();
+                } else if (key->code == sf::Keyboard::Key::W) {
+                    viewport.pan(0.0, panY);
+                } else if (key->code == sf::Keyboard::Key::S) {
+                    viewport.pan(0.0, -panY);
+                } else if (key->code == sf::Keyboard::Key::A) {
+                    viewport.pan(panX, 0.0);
+                } else if (key->code == sf::Keyboard::Key::D) {
+                    viewport.pan(-panX, 0.0);
+                } else if (key->code == sf::Keyboard::Key::Equal || key->code == sf::Keyboard::Key::Add) {
+                    viewport.zoom(ZOOM_STEP, midX, midY);
+                } else if (key->code == sf::Keyboard::Key::Hyphen || key->code == sf::Keyboard::Key::Subtract) {
+                    viewport.zoom(1.0 / ZOOM_STEP, midX, midY);
+                } else if (key->code == sf::Keyboard::Key::F) {
+                    viewport.fitWorld();
+                }
+            } else if (const auto* wheel = event->getIf<sf::Event::MouseWheelScrolled>()) {
+                viewport.zoom(pow(ZOOM_STEP, wheel->delta), wheel->position.x, wheel->position.y);
+            } else if (const auto* pressed = event->getIf<sf::Event::MouseButtonPressed>()) {
+                if (pressed->button == sf::Mouse::Button::Left) {
+                    dragging = true;
+                    dragFrom = pressed->position;
+                }
+            } else if (const auto* released = event->getIf<sf::Event::MouseButtonReleased>()) {
+                if (released->button == sf::Mouse::Button::Left) {
+                    dragging = false;
+                }
+            } else if (const auto* moved = event->getIf<sf::Event::MouseMoved>()) {
+                if (dragging) {
+                    viewport.pan(moved->position.x - dragFrom.x, moved->position.y - dragFrom.y);
+                    dragFrom = moved->position;
+                }
+            }
+        }
+
+        int ticks = warp.planTicks(frameClock.restart().asSeconds());
+        if (ticks > 0) {
+            sf::Clock tickClock;
+            for (int i = 0; i < ticks; ++i) {
+                world.update();
+            }
+            warp.recordTicks(ticks, tickClock.getElapsedTime().asSeconds());
+        }
+        if (!warp.shouldRender()) {
+            continue;
+        }
+
+        sf::Clock renderClock;
+        // Outside the world stays lighter than the empty tiles
+        window.clear(sf::Color(240, 240, 240));
+
+        // The texture only grows, so panning by a cell does not reallocate it
+        viewport.rasterize(pyramid, raster);
+        if (raster.columns > 0 && raster.rows > 0) {
+            sf::Vector2u cells(static_cast<unsigned int>(raster.columns), static_cast<unsigned int>(raster.rows));
+            bool textureReady = true;
+            if (cellTexture.getSize().x < cells.x || cellTexture.getSize().y < cells.y) {
+                sf::Vector2u grown(max(cells.x, cellTexture.getSize().x), max(cells.y, cellTexture.getSize().y));
+                textureReady = cellTexture.resize(grown);
+                if (!textureReady) {
+                    cerr << "Warning: could not allocate a " << grown.x << "x" << grown.y << " cell texture" << endl;
+                }
+            }
+            if (textureReady) {
+                cellTexture.update(raster.rgba.data(), cells, {0, 0});
+                sf::Sprite cellSprite(cellTexture, sf::IntRect({0, 0}, {raster.columns, raster.rows}));
+                cellSprite.setPosition(sf::Vector2f(static_cast<float>(raster.screenX), static_cast<float>(raster.screenY)));
+                cellSprite.setScale(sf::Vector2f(static_cast<float>(raster.cellPixels), static_cast<float>(raster.cellPixels)));
+                window.draw(cellSprite);
+            }
+        }
+
+        char zoomText[64];
+        snprintf(zoomText, sizeof(zoomText), "  zoom %.2f px/tile lod %d", viewport.getPixelsPerTile(), raster.level);
+        hud.setString(warp.describe() + "  tick " + to_string(world.getCurrentTick()) +
+                      "  organisms " + to_string(world.getOrganismCount()) + zoomText);
+        window.draw(hud);
+        warp.recordRender(renderClock.getElapsedTime().asSeconds());
+
+        window.display();
+    }
+}
+
+int main(int argc, char* argv[]) {
     int tileSize = 20;
+    bool profileTable = false;
+    bool profileJson = false;
+    string metricsPromPath;
+    string metricsCsvPath;
+    int metricsInterval = 10;
+    double warpMultiplier = 1.0;
+    bool warpMax = false;
+    string statsPath;
+    StatisticsOptions statsOptions;
+    string shmName;
+    int shmFrames = 8;
+    bool shmNutrients = false;
+    int worldSize = 20;
+    bool headless = false;
+    long long headlessTicks = 1000;
+    FrameDumpOptions dumpOptions;
+    GridLayout gridLayout = GridLayout::ROW_MAJOR;
+    int spatialSortInterval = 0;
+    // 0 keeps the serial update; the pool gets threads - 1 workers
+    int updateThreads = 0;
+    bool pinThreads = false;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--profile") {
+            profileTable = true;
+        } else if (arg == "--profile-json") {
+            profileJson = true;
+        } else if (arg == "--metrics-prom" && i + 1 < argc) {
+            metricsPromPath = argv[++i];
+        } else if (arg == "--metrics-csv" && i + 1 < argc) {
+            metricsCsvPath = argv[++i];
+        } else if (arg == "--metrics-interval" && i + 1 < argc) {
+            metricsInterval = stoi(argv[++i]);
+        } else if (arg == "--warp" && i + 1 < argc) {
+            warpMultiplier = stod(argv[++i]);
+        } else if (arg == "--warp-max") {
+            warpMax = true;
+        } else if (arg == "--stats" && i + 1 < argc) {
+            // A .csv path selects the CSV fallback, anything else the binary format
+            statsPath = argv[++i];
+            bool csv = statsPath.size() >= 4 && statsPath.compare(statsPath.size() - 4, 4, ".csv") == 0;
+            statsOptions.format = csv ? StatisticsFormat::CSV : StatisticsFormat::BINARY;
+        } else if (arg == "--stats-every" && i + 1 < argc) {
+            statsOptions.downsampling = StatisticsDownsampling::EVERY_NTH;
+            statsOptions.intervalTicks = stoi(argv[++i]);
+        } else if (arg == "--stats-window" && i + 1 < argc) {
+            statsOptions.downsampling = StatisticsDownsampling::WINDOW;
+            statsOptions.intervalTicks = stoi(argv[++i]);
+        } else if (arg == "--shm" && i + 1 < argc) {
+            shmName = argv[++i];
+        } else if (arg == "--shm-frames" && i + 1 < argc) {
+            shmFrames = stoi(argv[++i]);
+        } else if (arg == "--shm-nutrients") {
+            shmNutrients = true;
+        } else if (arg == "--size" && i + 1 < argc) {
+            worldSize = stoi(argv[++i]);
+        } else if (arg == "--headless") {
+            headless = true;
+        } else if (arg == "--ticks" && i + 1 < argc) {
+            headlessTicks = stoll(argv[++i]);
+        } else if (arg == "--dump-frames" && i + 1 < argc) {
+            dumpOptions.directory = argv[++i];
+        } else if (arg == "--dump-every" && i + 1 < argc) {
+            dumpOptions.intervalTicks = stoi(argv[++i]);
+        } else if (arg == "--dump-scale" && i + 1 < argc) {
+            dumpOptions.scale = stoi(argv[++i]);
+        } else if (arg == "--dump-format" && i + 1 < argc) {
+            dumpOptions.format = string(argv[++i]) == "png" ? FrameFormat::PNG : FrameFormat::PPM;
+        } else if (arg == "--dump-workers" && i + 1 < argc) {
+            dumpOptions.workers = stoi(argv[++i]);
+        } else if (arg == "--grid-layout" && i + 1 < argc) {
+            gridLayout = string(argv[++i]) == "blocked" ? GridLayout::BLOCKED : GridLayout::ROW_MAJOR;
+        } else if (arg == "--spatial-sort" && i + 1 < argc) {
+            spatialSortInterval = stoi(argv[++i]);
+        } else if (arg == "--threads" && i + 1 < argc) {
+            updateThreads = stoi(argv[++i]);
+        } else if (arg == "--pin-threads") {
+            pinThreads = true;
+        }
+    }
+    if (updateThreads > 1 || pinThreads) {
+        TaskPool::configureShared(updateThreads > 1 ? updateThreads - 1 : 0, pinThreads);
+    }
     cout << "Starting debug program" << endl;
     
-    cout << "Creating world (20x20)" << endl;
-    WorldManager& world = WorldManager::getInstance(20, 20, 1.0f);
+    cout << "Creating world (" << worldSize << "x" << worldSize << ")" << endl;
+    WorldManager& world = WorldManager::getInstance(worldSize, worldSize, 1.0f);
+    world.setGridLayout(gridLayout);
+    world.setSpatialSortInterval(spatialSortInterval);
+    world.setParallelUpdates(updateThreads > 1);
+    world.getProfiler().setEnabled(profileTable || profileJson);
+    if (!metricsPromPath.empty() || !metricsCsvPath.empty()) {
+        world.configureMetricsExport(metricsPromPath, metricsCsvPath, metricsInterval);
+    }
+    if (!statsPath.empty()) {
+        world.configureStatistics(statsPath, statsOptions);
+    }
+    if (!shmName.empty() && world.configureSharedExport(shmName, shmFrames, shmNutrients)) {
+        cout << "Publishing world state to shared memory " << shmName << endl;
+    }
+    if (!dumpOptions.directory.empty()) {
+        world.configureFrameDump(dumpOptions);
+    }
     cout << "World created successfully" << endl;
     
     cout << "Testing grid access" << endl;
@@ -26,10 +276,11 @@ int main() {
     // Create multiple plants randomly distributed across the grid
     std::random_device rd;
     std::mt19937 gen(rd());
-    std::uniform_int_distribution<> xDist(0, 19);
-    std::uniform_int_distribution<> yDist(0, 19);
+    std::uniform_int_distribution<> xDist(0, worldSize - 1);
+    std::uniform_int_distribution<> yDist(0, worldSize - 1);
     
-    const int NUM_INITIAL_PLANTS = 15; // Spawn 15 plants initially
+    // 15 plants on the default 20x20 world, the same density on larger ones
+    const int NUM_INITIAL_PLANTS = max(15, worldSize * worldSize * 15 / 400);
     
     cout << "Creating " << NUM_INITIAL_PLANTS << " Plant objects\n";
     for (int i = 0; i < NUM_INITIAL_PLANTS; ++i) {
@@ -75,91 +326,36 @@ int main() {
 
     cout << "Total organism count: " << world.getOrganismCount() << endl;
     
-    sf::RenderWindow window(
-            sf::VideoMode(
-                    {static_cast<unsigned int>(world.getGrid().getWidth() * tileSize),
-                    static_cast<unsigned int>(world.getGrid().getHeight() * tileSize)}
-            ),
-            "SFML window"
-    );
-    
-    const sf::Font font("fonts/arial.ttf");
-    sf::Text text(font, "Hello SFML", 50);
-
-    sf::Color plantColor = sf::Color::Green;
-    sf::Color herbivoreColor = sf::Color::Blue;
-    sf::Color carnivoreColor = sf::Color::Red;
-    sf::Color emptyColor = sf::Color(200, 200, 200);
-
-    // Add frame rate control variables
-    sf::Clock clock;
-    const float TARGET_FPS = 2.0f; // 2 updates per second for slow simulation
-    const sf::Time frameTime = sf::seconds(1.0f / TARGET_FPS);
-
-    while (window.isOpen())
-    {
-        while (const std::optional event = window.pollEvent())
-        {
-            if (event->is<sf::Event::Closed>())
-                window.close();
-        }
-
-        // Only update simulation at target frame rate
-        if (clock.getElapsedTime() >= frameTime) {
+    if (headless) {
+        // No window and no pacing: tick as fast as possible
+        for (long long tick = 0; tick < headlessTicks; ++tick) {
             world.update();
-            clock.restart();
-            
-            // Optional: Print organism count every update
-            cout << "Organisms alive: " << world.getOrganismCount() << endl;
         }
-
-        window.clear();
-
-        // Draw the grid
-        for (int y = 0; y < world.getGrid().getHeight(); ++y) {
-            for (int x = 0; x < world.getGrid().getWidth(); ++x) {
-                const Tile& tile = world.getGrid().getTile(x, y);
-
-                sf::RectangleShape rect(sf::Vector2f(tileSize, tileSize));
-                rect.setPosition(sf::Vector2f(static_cast<float>(x * tileSize), static_cast<float>(y * tileSize)));
-
-                if (tile.isEmpty()) {
-                    rect.setFillColor(emptyColor);
-                } else {
-                    Organism* occupant = tile.getOccupant();
-                    switch (occupant->getType()) {
-                        case OrganismType::PLANT:
-                            rect.setFillColor(plantColor);
-                            break;
-                        case OrganismType::ANIMAL: {
-                            Animal* animal = dynamic_cast<Animal*>(occupant);
-                            if (animal != nullptr) {
-                                if (animal->getAnimalType() == AnimalType::HERBIVORE) {
-                                    rect.setFillColor(herbivoreColor);
-                                } else if (animal->getAnimalType() == AnimalType::CARNIVORE) {
-                                    rect.setFillColor(carnivoreColor);
-                                }
-                            }
-                            break;
-                        }
-                        default:
-                            rect.setFillColor(sf::Color::Magenta); // fallback
-                            break;
-                    }
-                }
-
-                window.draw(rect);
-            }
-        }
-        
-        window.display();
-        
-        // Small sleep to prevent excessive CPU usage
-        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    } else {
+        runViewer(world, tileSize, warpMultiplier, warpMax);
+    }
+    
+    world.closeStatistics();
+    if (world.getFrameDumper().isEnabled()) {
+        world.closeFrameDump();
+        cout << "Frames written: " << world.getFrameDumper().getFramesWritten()
+             << ", dropped: " << world.getFrameDumper().getFramesDropped() << endl;
     }
     
-    cout << "Press Enter to exit...";
-    cin.get();
+    if (profileTable) {
+        world.getProfiler().writeTable(cout);
+    }
+    if (profileJson) {
+        world.getProfiler().writeJson(cout);
+        cout << endl;
+    }
+    
+    if (!headless) {
+        cout << "Press Enter to exit...";
+        cin.get();
+    }
     
+    // Also unlinks the shared-memory segment, if any
+    WorldManager::resetInstance();
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,114 @@
+#include "catch2/catch_test_macros.hpp"
+#include "CompactOrganism.h"
+#include "Animal.h"
+#include "Plant.h"
+#include "WorldManager.h"
+#include <cmath>
+#include <memory>
+
+TEST_CASE("Compact organisms pack and unpack", "[Compact]") {
+    const int gridWidth = 50;
+
+    SECTION("Animal round trip") {
+        Animal animal(23.7f, 80, 3, 6, AnimalType::CARNIVORE, 1.25f, 30.0f, 9);
+        animal.setPosition(Position(17, 42));
+        animal.incrementAge();
+        animal.incrementAge();
+
+        CompactOrganism compact = CompactOrganism::pack(animal, gridWidth);
+        REQUIRE(compact.getType() == OrganismType::ANIMAL);
+        REQUIRE(compact.getTileIndex() == 42u * gridWidth + 17u);
+        REQUIRE(compact.getAge() == 2);
+        REQUIRE(compact.getMaxLifespan() == 80);
+        REQUIRE(compact.getMovementSpeed() == 3);
+        REQUIRE(compact.getNutrientRequirement() == 1.25f);
+        REQUIRE(compact.getFoodClass() == animal.getFoodClass());
+        REQUIRE(std::fabs(compact.getNutrients() - 23.7f) <= 1.0f / 8192);
+
+        std::unique_ptr<Organism> restored(compact.unpack(gridWidth));
+        Animal* restoredAnimal = dynamic_cast<Animal*>(restored.get());
+        REQUIRE(restoredAnimal != nullptr);
+        REQUIRE(restoredAnimal->getSpeciesId() == animal.getSpeciesId());
+        REQUIRE(restoredAnimal->getAge() == 2);
+        REQUIRE(restoredAnimal->getPosition().getX() == 17);
+        REQUIRE(restoredAnimal->getPosition().getY() == 42);
+        REQUIRE(restoredAnimal->getNutrientRequirement() == 1.25f);
+    }
+
+    SECTION("Plant round trip keeps its rates") {
+        Plant plant(9.0f, 100, 0.5f, 0.3f);
+        plant.setPosition(Position(0, 3));
+
+        CompactOrganism compact = CompactOrganism::pack(plant, gridWidth);
+        REQUIRE(compact.getType() == OrganismType::PLANT);
+        REQUIRE(compact.getGrowthRate() == 0.5f);
+        REQUIRE(compact.getNutrientAbsorptionRate() == 0.3f);
+        REQUIRE(compact.getNutrients() == 9.0f);
+
+        std::unique_ptr<Organism> restored(compact.unpack(gridWidth));
+        REQUIRE(restored->getType() == OrganismType::PLANT);
+        REQUIRE(restored->getPosition().getY() == 3);
+    }
+}
+
+TEST_CASE("Compact nutrient arithmetic honours its accuracy contract", "[Compact]") {
+    Plant plant(10.0f, 100, 0.5f, 0.3f);
+    CompactOrganism compact = CompactOrganism::pack(plant, 0);
+
+    float reference = 10.0f;
+    int operations = 0;
+    for (int i = 0; i < 500; ++i) {
+        float amount = 0.1f + 0.013f * (i % 7);
+        if (i % 3 == 0) {
+            compact.consumeNutrients(amount);
+            reference -= amount;
+        } else {
+            compact.addNutrients(amount);
+            reference += amount;
+        }
+        ++operations;
+    }
+    REQUIRE(std::fabs(compact.getNutrients() - reference) <= (operations + 1) / 8192.0f + 1e-3f);
+
+    SECTION("Consumption clamps at zero and kills") {
+        compact.consumeNutrients(1.0e6f);
+        REQUIRE(compact.getFixedNutrients() == 0);
+        REQUIRE(compact.isDead());
+    }
+
+    SECTION("Large values saturate") {
+        compact.addNutrients(1.0e9f);
+        REQUIRE(compact.getFixedNutrients() == CompactOrganism::NUTRIENT_MAX);
+    }
+}
+
+TEST_CASE("Compact organism store", "[Compact]") {
+    CompactOrganismStore store;
+    Plant young(10.0f, 100, 0.5f, 0.3f);
+    Plant old(10.0f, 1, 0.5f, 0.3f);
+
+    store.add(CompactOrganism::pack(young, 0));
+    store.add(CompactOrganism::pack(old, 0));
+    store.add(CompactOrganism::pack(young, 0));
+    store[1].incrementAge();
+    store[2].markRemoved();
+
+    REQUIRE(store.removeDead() == 2);
+    REQUIRE(store.size() == 1);
+    REQUIRE(store.getMemoryFootprint().bytes >= sizeof(CompactOrganism));
+
+    SECTION("World packs every organism") {
+        WorldManager::resetInstance();
+        WorldManager& manager = WorldManager::getInstance(10, 10, 2.0f);
+        manager.addOrganism(new Plant(10.0f, 100, 0.5f, 0.3f), 1, 2);
+        manager.addOrganism(new Animal(20.0f, 80, 2, 5, AnimalType::HERBIVORE, 1.0f, 30.0f, 5), 3, 4);
+
+        manager.packOrganisms(store);
+        REQUIRE(store.size() == 2);
+        REQUIRE(store[0].getPosition(10).getX() == 1);
+        REQUIRE(store[1].getTileIndex() == 4u * 10u + 3u);
+        REQUIRE(store[1].getType() == OrganismType::ANIMAL);
+
+        WorldManager::resetInstance();
+    }
+}
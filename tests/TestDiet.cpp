@@ -0,0 +1,132 @@
+#include "catch2/catch_test_macros.hpp"
+#include "Diet.h"
+#include "FoodSearch.h"
+#include "Grid.h"
+#include "Plant.h"
+#include "Animal.h"
+#include <cmath>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace {
+
+// The if/else rules the diet table replaced.
+bool legacyCanEat(AnimalType eater, const Organism& food) {
+    if (eater == AnimalType::HERBIVORE) return food.getType() == OrganismType::PLANT;
+    if (eater == AnimalType::CARNIVORE) return food.getType() == OrganismType::ANIMAL;
+    return true;
+}
+
+// Straightforward vision-square scan over the tiles themselves.
+int referenceNearestFood(const Grid& grid, const Animal& animal, int x, int y, int vision) {
+    int nearest = -1;
+    int shortest = vision + 1;
+    for (int dy = -vision; dy <= vision; ++dy) {
+        for (int dx = -vision; dx <= vision; ++dx) {
+            int cx = x + dx;
+            int cy = y + dy;
+            if (!grid.isInBounds(cx, cy) || (dx == 0 && dy == 0)) continue;
+            Organism* occupant = grid.getTile(cx, cy).getOccupant();
+            if (occupant != nullptr && animal.canEat(occupant)) {
+                int distance = static_cast<int>(std::sqrt(dx * dx + dy * dy));
+                if (distance < shortest) {
+                    shortest = distance;
+                    nearest = cy * grid.getWidth() + cx;
+                }
+            }
+        }
+    }
+    return nearest;
+}
+
+}
+
+TEST_CASE("Diet table matches the animal feeding rules", "[Diet]") {
+    Plant plant(10.0f, 100, 0.5f, 0.3f);
+    std::vector<std::unique_ptr<Animal>> animals;
+    for (int type = 0; type < ANIMAL_TYPE_COUNT; ++type) {
+        animals.emplace_back(new Animal(20.0f, 80, 2, 5, static_cast<AnimalType>(type), 1.0f, 30.0f, 5));
+    }
+
+    for (const auto& eater : animals) {
+        REQUIRE(eater->canEat(&plant) == legacyCanEat(eater->getAnimalType(), plant));
+        for (const auto& food : animals) {
+            REQUIRE(eater->canEat(food.get()) == legacyCanEat(eater->getAnimalType(), *food));
+        }
+        REQUIRE_FALSE(dietAllows(dietMask(eater->getAnimalType()), FOOD_CLASS_EMPTY));
+    }
+}
+
+TEST_CASE("Grid tracks the food class of every tile", "[Diet]") {
+    Grid grid(4, 3);
+    Plant plant(10.0f, 100, 0.5f, 0.3f);
+    Animal wolf(20.0f, 80, 2, 5, AnimalType::CARNIVORE, 1.0f, 30.0f, 5);
+
+    grid.getTile(1, 2).setOccupant(plant);
+    grid.getTile(3, 0).setOccupant(wolf);
+
+    const FoodClass* classes = grid.getFoodClasses();
+    REQUIRE(classes[2 * 4 + 1] == FOOD_CLASS_PLANT);
+    REQUIRE(classes[0 * 4 + 3] == animalFoodClass(AnimalType::CARNIVORE));
+    REQUIRE(classes[0] == FOOD_CLASS_EMPTY);
+
+    grid.getTile(1, 2).clearOccupant();
+    REQUIRE(classes[2 * 4 + 1] == FOOD_CLASS_EMPTY);
+}
+
+TEST_CASE("Specialized food searches agree with a plain scan", "[Diet]") {
+    const int width = 24;
+    const int height = 17;
+    Grid grid(width, height);
+    std::vector<std::unique_ptr<Organism>> occupants;
+
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> pick(0, 9);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            int roll = pick(rng);
+            Organism* organism = nullptr;
+            if (roll < 2) {
+                organism = new Plant(10.0f, 100, 0.5f, 0.3f);
+            } else if (roll < 2 + ANIMAL_TYPE_COUNT) {
+                organism = new Animal(20.0f, 80, 2, 5, static_cast<AnimalType>(roll - 2), 1.0f, 30.0f, 5);
+            }
+            if (organism != nullptr) {
+                organism->setPosition(Position(x, y));
+                grid.getTile(x, y).setOccupant(*organism);
+                occupants.emplace_back(organism);
+            }
+        }
+    }
+
+    for (int type = 0; type < ANIMAL_TYPE_COUNT; ++type) {
+        AnimalType animalType = static_cast<AnimalType>(type);
+        Animal searcher(20.0f, 80, 2, 5, animalType, 1.0f, 30.0f, 5);
+        for (int vision : {0, 1, 3, 8}) {
+            for (int y = 0; y < height; ++y) {
+                for (int x = 0; x < width; ++x) {
+                    REQUIRE(FoodSearch::nearestFood(animalType, grid, x, y, vision)
+                            == referenceNearestFood(grid, searcher, x, y, vision));
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("An animal is never its own food", "[Diet]") {
+    Grid grid(5, 5);
+    Animal omnivore(20.0f, 80, 2, 3, AnimalType::OMNIVORE, 1.0f, 30.0f, 5);
+    omnivore.setPosition(Position(2, 2));
+    grid.getTile(2, 2).setOccupant(omnivore);
+
+    REQUIRE(omnivore.findNearestFood(grid) == nullptr);
+    REQUIRE(omnivore.findAdjacentFood(grid) == nullptr);
+
+    Plant plant(10.0f, 100, 0.5f, 0.3f);
+    plant.setPosition(Position(4, 4));
+    grid.getTile(4, 4).setOccupant(plant);
+
+    REQUIRE(omnivore.findNearestFood(grid) == &plant);
+    REQUIRE(omnivore.findAdjacentFood(grid) == nullptr);
+}
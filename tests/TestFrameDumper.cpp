@@ -0,0 +1,113 @@
+#include "catch2/catch_test_macros.hpp"
+#include "FrameDumper.h"
+#include "WorldManager.h"
+#include "Plant.h"
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+std::vector<uint8_t> readBytes(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::vector<uint8_t>(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+uint32_t bigEndian(const std::vector<uint8_t>& bytes, size_t offset) {
+    return (uint32_t(bytes[offset]) << 24) | (uint32_t(bytes[offset + 1]) << 16) |
+           (uint32_t(bytes[offset + 2]) << 8) | uint32_t(bytes[offset + 3]);
+}
+}
+
+TEST_CASE("Frames encode tiles as scaled pixel blocks", "[FrameDump]") {
+    const FoodClass occupancy[] = {
+        FOOD_CLASS_EMPTY, FOOD_CLASS_PLANT,
+        animalFoodClass(AnimalType::HERBIVORE), animalFoodClass(AnimalType::CARNIVORE)
+    };
+    std::vector<uint8_t> out;
+
+    SECTION("PPM") {
+        FrameDumper::encode(FrameFormat::PPM, 2, 2, 2, occupancy, out);
+        const std::string header = "P6\n4 4\n255\n";
+        REQUIRE(out.size() == header.size() + 4 * 4 * 3);
+        REQUIRE(std::string(out.begin(), out.begin() + header.size()) == header);
+
+        auto pixel = [&](int x, int y) {
+            size_t at = header.size() + (static_cast<size_t>(y) * 4 + x) * 3;
+            return std::vector<uint8_t>{out[at], out[at + 1], out[at + 2]};
+        };
+        REQUIRE(pixel(0, 0) == std::vector<uint8_t>{200, 200, 200});
+        REQUIRE(pixel(1, 1) == std::vector<uint8_t>{200, 200, 200});
+        REQUIRE(pixel(2, 0) == std::vector<uint8_t>{0, 255, 0});
+        REQUIRE(pixel(3, 1) == std::vector<uint8_t>{0, 255, 0});
+        REQUIRE(pixel(0, 3) == std::vector<uint8_t>{0, 0, 255});
+        REQUIRE(pixel(3, 3) == std::vector<uint8_t>{255, 0, 0});
+    }
+
+    SECTION("PNG") {
+        FrameDumper::encode(FrameFormat::PNG, 2, 2, 3, occupancy, out);
+        const uint8_t signature[] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+        REQUIRE(std::equal(signature, signature + 8, out.begin()));
+        REQUIRE(std::string(out.begin() + 12, out.begin() + 16) == "IHDR");
+        REQUIRE(bigEndian(out, 16) == 6);
+        REQUIRE(bigEndian(out, 20) == 6);
+        REQUIRE(std::string(out.begin() + 37, out.begin() + 41) == "IDAT");
+        // Six rows of a filter byte and 18 RGB bytes fit one stored block
+        REQUIRE(bigEndian(out, 33) == 2 + 5 + 6 * 19 + 4);
+        REQUIRE(std::string(out.end() - 8, out.end() - 4) == "IEND");
+    }
+}
+
+TEST_CASE("Frame dumper writes numbered files", "[FrameDump]") {
+    std::filesystem::path dir = std::filesystem::temp_directory_path() / "ecosystem_frames_test";
+    std::filesystem::remove_all(dir);
+
+    FrameDumpOptions options;
+    options.directory = dir.string();
+    options.intervalTicks = 2;
+    options.scale = 2;
+
+    SECTION("Every Nth tick is written") {
+        FrameDumper dumper;
+        REQUIRE(dumper.open(options));
+        std::vector<FoodClass> occupancy(3 * 2, FOOD_CLASS_PLANT);
+        for (uint64_t tick = 1; tick <= 6; ++tick) {
+            REQUIRE(dumper.capture(tick, 3, 2, occupancy.data()) == (tick % 2 == 0));
+        }
+        dumper.close();
+
+        REQUIRE(dumper.getFramesWritten() == 3);
+        REQUIRE(dumper.getFramesDropped() == 0);
+        std::vector<uint8_t> frame = readBytes(dumper.framePath(4));
+        REQUIRE(frame.size() == std::string("P6\n6 4\n255\n").size() + 6 * 4 * 3);
+        REQUIRE_FALSE(std::filesystem::exists(dumper.framePath(3)));
+    }
+
+    SECTION("The world dumps its grid") {
+        WorldManager::resetInstance();
+        WorldManager& manager = WorldManager::getInstance(4, 4, 1.0f);
+        manager.addOrganism(new Plant(5.0f, 100, 0.5f, 0.3f), 1, 1);
+        options.format = FrameFormat::PNG;
+        REQUIRE(manager.configureFrameDump(options));
+        for (int i = 0; i < 4; ++i) {
+            manager.update();
+        }
+        manager.closeFrameDump();
+
+        REQUIRE(manager.getFrameDumper().getFramesWritten() == 2);
+        REQUIRE(std::filesystem::exists(dir / "frame_00000002.png"));
+        REQUIRE(std::filesystem::exists(dir / "frame_00000004.png"));
+        WorldManager::resetInstance();
+    }
+
+    SECTION("Invalid options are rejected") {
+        FrameDumper dumper;
+        options.scale = 0;
+        REQUIRE_THROWS_AS(dumper.open(options), std::invalid_argument);
+        REQUIRE_FALSE(dumper.isEnabled());
+    }
+
+    std::filesystem::remove_all(dir);
+}
@@ -0,0 +1,195 @@
+#include "catch2/catch_test_macros.hpp"
+#include "Intent.h"
+#include "WorldManager.h"
+#include "Animal.h"
+#include "Plant.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+TEST_CASE("Intent queue drains every worker in resolve order", "[Intent]") {
+    IntentQueue queue(2);
+    Plant a(10.0f, 100, 0.5f, 0.3f);
+    Plant b(10.0f, 100, 0.5f, 0.3f);
+
+    std::thread worker([&]() {
+        IntentQueue::bindWorker(1);
+        IntentBuffer& buffer = queue.local();
+        buffer.setSequence(7);
+        buffer.push(IntentKind::MOVE, b, 4);
+        buffer.push(IntentKind::EAT, b, 9);
+    });
+    worker.join();
+
+    IntentBuffer& buffer = queue.buffer(0);
+    buffer.setSequence(3);
+    buffer.push(IntentKind::SPAWN, a, 4);
+    buffer.push(IntentKind::DIE, a, 2);
+    REQUIRE(queue.buffer(1).size() == 2);
+    REQUIRE(queue.pending() == 4);
+
+    std::vector<Intent> drained;
+    queue.drain(drained);
+    REQUIRE(queue.pending() == 0);
+    REQUIRE(drained.size() == 4);
+    REQUIRE(drained[0].kind == IntentKind::EAT);
+    REQUIRE(drained[1].kind == IntentKind::DIE);
+    // Moves and spawns share a pass; the same tile goes to the lower sequence
+    REQUIRE(drained[2].kind == IntentKind::SPAWN);
+    REQUIRE(drained[2].sequence == 3);
+    REQUIRE(drained[3].kind == IntentKind::MOVE);
+    REQUIRE(drained[3].actor == &b);
+}
+
+TEST_CASE("Intent conflicts go to the earliest actor", "[Intent]") {
+    SECTION("Two predators, one prey") {
+        WorldManager::resetInstance();
+        WorldManager& manager = WorldManager::getInstance(5, 5, 1.0f);
+        Animal* first = new Animal(20.0f, 80, 1, 3, AnimalType::CARNIVORE, 1.0f, 100.0f, 5);
+        Animal* prey = new Animal(10.0f, 80, 1, 3, AnimalType::HERBIVORE, 2.0f, 100.0f, 5);
+        Animal* second = new Animal(20.0f, 80, 1, 3, AnimalType::CARNIVORE, 1.0f, 100.0f, 5);
+        manager.addOrganism(first, 0, 0);
+        manager.addOrganism(prey, 1, 0);
+        manager.addOrganism(second, 2, 0);
+        uint64_t conflicts = manager.getMetrics().getTotal(MetricCounter::INTENT_CONFLICTS);
+
+        manager.update();
+
+        // Speed 1 animals act every other tick and pay two ticks of upkeep;
+        // the prey paid its own before it was eaten
+        REQUIRE(manager.getOrganismCount() == 2);
+        REQUIRE(first->getNutrients() == 24.0f);
+        REQUIRE(second->getNutrients() == 18.0f);
+        REQUIRE(manager.getGrid().getTile(1, 0).isEmpty());
+        REQUIRE(manager.getMetrics().getLastTickDelta(MetricCounter::EATS) == 1);
+        REQUIRE(manager.getMetrics().getTotal(MetricCounter::INTENT_CONFLICTS) == conflicts + 1);
+    }
+
+    SECTION("Two movers, one free tile") {
+        WorldManager::resetInstance();
+        WorldManager& manager = WorldManager::getInstance(3, 1, 1.0f);
+        Animal* left = new Animal(20.0f, 80, 1, 3, AnimalType::HERBIVORE, 1.0f, 100.0f, 5);
+        Animal* right = new Animal(20.0f, 80, 1, 3, AnimalType::HERBIVORE, 1.0f, 100.0f, 5);
+        manager.addOrganism(left, 0, 0);
+        manager.addOrganism(right, 2, 0);
+
+        manager.update();
+
+        REQUIRE(manager.getGrid().getTile(1, 0).getOccupant() == left);
+        REQUIRE(manager.getGrid().getTile(2, 0).getOccupant() == right);
+        REQUIRE(right->getPosition().getX() == 2);
+        REQUIRE(manager.getMetrics().getLastTickDelta(MetricCounter::MOVES) == 1);
+        REQUIRE(manager.getMetrics().getLastTickDelta(MetricCounter::INTENT_CONFLICTS) == 1);
+    }
+
+    SECTION("Two seeds, one free tile") {
+        WorldManager::resetInstance();
+        WorldManager& manager = WorldManager::getInstance(3, 1, 1.0f);
+        Plant* left = new Plant(10.0f, 100, 0.5f, 0.3f);
+        Plant* right = new Plant(10.0f, 100, 0.5f, 0.3f);
+        manager.addOrganism(left, 0, 0);
+        manager.addOrganism(right, 2, 0);
+
+        manager.update();
+
+        // Only the winner pays for its seedling
+        REQUIRE(manager.getOrganismCount() == 3);
+        REQUIRE(left->getNutrients() == 6.0f);
+        REQUIRE(right->getNutrients() == 10.0f);
+        REQUIRE(manager.getMetrics().getLastTickDelta(MetricCounter::BIRTHS) == 1);
+        REQUIRE(manager.getMetrics().getLastTickDelta(MetricCounter::FAILED_SPREADS) == 1);
+    }
+
+    SECTION("Four seeds, two free tiles") {
+        WorldManager::resetInstance();
+        WorldManager& manager = WorldManager::getInstance(3, 2, 1.0f);
+        // The corners each see one of the free tiles; the middle two see both
+        // and lose both
+        manager.addOrganism(new Plant(10.0f, 100, 0.5f, 0.3f), 0, 0);
+        manager.addOrganism(new Plant(10.0f, 100, 0.5f, 0.3f), 2, 0);
+        manager.addOrganism(new Plant(10.0f, 100, 0.5f, 0.3f), 1, 0);
+        manager.addOrganism(new Plant(10.0f, 100, 0.5f, 0.3f), 1, 1);
+
+        manager.update();
+
+        REQUIRE(manager.getOrganismCount() == 6);
+        REQUIRE(manager.getMetrics().getLastTickDelta(MetricCounter::BIRTHS) == 2);
+        REQUIRE(manager.getMetrics().getLastTickDelta(MetricCounter::FAILED_SPREADS) == 2);
+        // One per seed left without a tile, not one per tile it lost
+        REQUIRE(manager.getMetrics().getLastTickDelta(MetricCounter::INTENT_CONFLICTS) == 2);
+    }
+    WorldManager::resetInstance();
+}
+
+TEST_CASE("Tile claims go to one handle per round", "[Intent]") {
+    Grid grid(4, 3);
+    Plant plant(10.0f, 100, 0.5f, 0.3f);
+    grid.getTile(1, 0).setOccupant(plant);
+
+    REQUIRE(grid.tryClaim(5, 2));
+    REQUIRE(grid.tryClaim(5, 2));
+    REQUIRE_FALSE(grid.tryClaim(5, 3));
+    REQUIRE(grid.isClaimed(5));
+    // Occupied tiles can't be claimed at all
+    REQUIRE_FALSE(grid.tryClaim(1, 2));
+
+    REQUIRE_FALSE(grid.release(5, 3));
+    REQUIRE(grid.release(5, 2));
+    REQUIRE_FALSE(grid.isClaimed(5));
+    REQUIRE(grid.tryClaim(5, 3));
+
+    grid.beginClaimRound();
+    REQUIRE_FALSE(grid.isClaimed(5));
+    REQUIRE(grid.tryClaim(5, 2));
+}
+
+TEST_CASE("Racing claims leave exactly one winner per tile", "[Intent]") {
+    const int width = 64;
+    const int height = 32;
+    const int threadCount = 4;
+    Grid grid(width, height);
+    std::vector<std::atomic<int>> wins(static_cast<size_t>(width) * height);
+    std::atomic<int> totalWins(0);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&, t]() {
+            // Each thread sweeps the grid from a different starting tile
+            size_t tiles = wins.size();
+            for (size_t i = 0; i < tiles; ++i) {
+                size_t tile = (i + static_cast<size_t>(t) * tiles / threadCount) % tiles;
+                if (grid.tryClaim(tile, static_cast<uint32_t>(t))) {
+                    ++wins[tile];
+                    ++totalWins;
+                }
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    REQUIRE(totalWins == width * height);
+    for (const std::atomic<int>& tileWins : wins) {
+        REQUIRE(tileWins == 1);
+    }
+}
+
+TEST_CASE("Movers that lose a claim take another empty tile", "[Intent]") {
+    WorldManager::resetInstance();
+    WorldManager& manager = WorldManager::getInstance(3, 2, 1.0f);
+    Animal* left = new Animal(20.0f, 80, 1, 3, AnimalType::HERBIVORE, 1.0f, 100.0f, 5);
+    Animal* right = new Animal(20.0f, 80, 1, 3, AnimalType::HERBIVORE, 1.0f, 100.0f, 5);
+    manager.addOrganism(left, 0, 0);
+    manager.addOrganism(right, 2, 0);
+
+    // Both may pick the middle column at random; the later one falls back
+    manager.update();
+
+    REQUIRE(manager.getMetrics().getLastTickDelta(MetricCounter::MOVES) == 2);
+    REQUIRE(left->getPosition().getY() + left->getPosition().getX() > 0);
+    REQUIRE((right->getPosition().getX() != 2 || right->getPosition().getY() != 0));
+    REQUIRE(manager.getGrid().getTile(left->getPosition().getX(), left->getPosition().getY()).getOccupant() == left);
+    REQUIRE(manager.getGrid().getTile(right->getPosition().getX(), right->getPosition().getY()).getOccupant() == right);
+    WorldManager::resetInstance();
+}
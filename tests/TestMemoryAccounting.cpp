@@ -0,0 +1,83 @@
+#include "catch2/catch_test_macros.hpp"
+#include "MemoryAccounting.h"
+#include "WorldManager.h"
+#include "Grid.h"
+#include "Plant.h"
+#include "Animal.h"
+#include <sstream>
+#include <string>
+
+TEST_CASE("Memory account tracks live and peak bytes", "[Memory]") {
+    MemoryAccount account;
+
+    account.charge({100, 2});
+    account.charge({50, 1});
+    account.release({100, 2});
+
+    MemoryUsage usage = account.getUsage();
+    REQUIRE(usage.liveBytes == 50);
+    REQUIRE(usage.peakBytes == 150);
+    REQUIRE(usage.allocations == 3);
+    REQUIRE(usage.deallocations == 2);
+
+    {
+        ScopedMemoryCharge scratch(account, {1000, 1});
+        REQUIRE(account.getUsage().liveBytes == 1050);
+    }
+    REQUIRE(account.getUsage().liveBytes == 50);
+    REQUIRE(account.getUsage().peakBytes == 1050);
+}
+
+TEST_CASE("Footprints cover owned heap blocks", "[Memory]") {
+    SECTION("Organism footprint grows once it has a position") {
+        Animal animal(20.0f, 80, 2, 5, AnimalType::HERBIVORE, 1.0f, 30.0f, 5);
+        MemoryFootprint unplaced = animal.getMemoryFootprint();
+        REQUIRE(unplaced.bytes == sizeof(Animal));
+        REQUIRE(unplaced.allocations == 1);
+
+        animal.setPosition(Position(1, 2));
+        MemoryFootprint placed = animal.getMemoryFootprint();
+        REQUIRE(placed.bytes > unplaced.bytes);
+        REQUIRE(placed.allocations == 3);
+    }
+
+    SECTION("Grid footprint scales with tile count") {
+        Grid small(10, 10);
+        Grid large(20, 20);
+        MemoryFootprint smallFootprint = small.getMemoryFootprint();
+        MemoryFootprint largeFootprint = large.getMemoryFootprint();
+
+        REQUIRE(smallFootprint.allocations >= 200);
+        REQUIRE(largeFootprint.bytes > 3 * smallFootprint.bytes);
+    }
+}
+
+TEST_CASE("World reports memory per subsystem", "[Memory]") {
+    WorldManager::resetInstance();
+    WorldManager& manager = WorldManager::getInstance(10, 10, 2.0f);
+    const MemoryAccounting& accounting = manager.getMemoryAccounting();
+
+    REQUIRE(accounting.getUsage(MemorySubsystem::GRID).liveBytes > 0);
+    REQUIRE(accounting.getUsage(MemorySubsystem::ORGANISMS).liveBytes == 0);
+
+    Plant* plant = new Plant(10.0f, 100, 0.5f, 0.3f);
+    manager.addOrganism(plant, 3, 3);
+    uint64_t plantBytes = plant->getMemoryFootprint().bytes;
+    REQUIRE(accounting.getUsage(MemorySubsystem::ORGANISMS).liveBytes == plantBytes);
+    REQUIRE(accounting.getUsage(MemorySubsystem::ORGANISM_STORE).liveBytes >= sizeof(Organism*));
+
+    manager.removeOrganism(plant);
+    REQUIRE(accounting.getUsage(MemorySubsystem::ORGANISMS).liveBytes == 0);
+    REQUIRE(accounting.getUsage(MemorySubsystem::ORGANISMS).peakBytes == plantBytes);
+
+    manager.addOrganism(new Plant(10.0f, 100, 0.5f, 0.3f), 4, 4);
+    manager.update();
+    REQUIRE(accounting.getUsage(MemorySubsystem::SCRATCH).liveBytes == 0);
+    REQUIRE(accounting.getUsage(MemorySubsystem::SCRATCH).peakBytes > 0);
+
+    std::ostringstream json;
+    accounting.writeJson(json);
+    REQUIRE(json.str().find("\"organism_store\":{\"live_bytes\":") != std::string::npos);
+
+    WorldManager::resetInstance();
+}
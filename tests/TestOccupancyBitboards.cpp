@@ -0,0 +1,167 @@
+#include "catch2/catch_test_macros.hpp"
+#include "OccupancyBitboards.h"
+#include "FoodSearch.h"
+#include "Grid.h"
+#include "Plant.h"
+#include "Animal.h"
+#include <random>
+#include <vector>
+
+namespace {
+struct Board {
+    int width;
+    int height;
+    std::vector<FoodClass> tiles;
+    OccupancyBitboards bits;
+
+    Board(int width, int height) : width(width), height(height), tiles(width * height, FOOD_CLASS_EMPTY), bits(width, height) {}
+
+    void set(int x, int y, FoodClass foodClass) {
+        FoodClass& tile = tiles[static_cast<size_t>(y) * width + x];
+        bits.set(x, y, tile, foodClass);
+        tile = foodClass;
+    }
+
+    int neighborsWith(int x, int y, DietMask classes) const {
+        int count = 0;
+        for (int i = 0; i < FoodSearch::NEIGHBOR_COUNT; ++i) {
+            int cx = x + FoodSearch::NEIGHBOR_OFFSET_X[i];
+            int cy = y + FoodSearch::NEIGHBOR_OFFSET_Y[i];
+            if (cx < 0 || cy < 0 || cx >= width || cy >= height) continue;
+            count += dietAllows(classes, tiles[static_cast<size_t>(cy) * width + cx]) ? 1 : 0;
+        }
+        return count;
+    }
+};
+
+bool testBit(const std::vector<uint64_t>& board, size_t wordsPerRow, int x, int y) {
+    return (board[static_cast<size_t>(y) * wordsPerRow + x / 64] >> (x % 64)) & 1u;
+}
+}
+
+TEST_CASE("Bitboard neighborhoods match per-tile scans", "[Bitboards]") {
+    // Widths around word boundaries, plus one wide enough for the paired loop
+    const int widths[] = {1, 5, 63, 64, 65, 129, 300};
+    std::mt19937 rng(11);
+
+    for (int width : widths) {
+        const int height = 7;
+        Board board(width, height);
+        for (int i = 0; i < width * height; ++i) {
+            board.set(i % width, i / width, static_cast<FoodClass>(rng() % FOOD_CLASS_COUNT));
+        }
+        const OccupancyBitboards& bits = board.bits;
+        const DietMask plantOnly = foodClassBit(FOOD_CLASS_PLANT);
+        const DietMask occupiedClasses = plantOnly | anyAnimalMask();
+        // foodClassBit() leaves empty out, so its bit is spelled directly
+        const DietMask emptyOnly = 1u << FOOD_CLASS_EMPTY;
+
+        std::vector<uint64_t> plants;
+        bits.unionOf(plantOnly, plants);
+        std::vector<uint64_t> nearPlants;
+        bits.neighborsOf(plants.data(), nearPlants);
+        NeighborCounts counts;
+        bits.countNeighbors(bits.layer(OccupancyBitboards::LAYER_ANY), counts);
+
+        uint64_t occupied = 0;
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                FoodClass foodClass = board.tiles[static_cast<size_t>(y) * width + x];
+                occupied += foodClass != FOOD_CLASS_EMPTY ? 1 : 0;
+                REQUIRE(bits.test(foodClass, x, y));
+                REQUIRE(bits.test(OccupancyBitboards::LAYER_ANY, x, y) == (foodClass != FOOD_CLASS_EMPTY));
+                REQUIRE(testBit(nearPlants, bits.getWordsPerRow(), x, y) == (board.neighborsWith(x, y, plantOnly) > 0));
+                REQUIRE(counts.at(x, y) == board.neighborsWith(x, y, occupiedClasses));
+                REQUIRE(bits.hasEmptyNeighbor(x, y) == (board.neighborsWith(x, y, emptyOnly) > 0));
+                for (int type = 0; type < ANIMAL_TYPE_COUNT; ++type) {
+                    AnimalType animalType = static_cast<AnimalType>(type);
+                    REQUIRE(bits.hasAdjacentFood(animalType, x, y) == (board.neighborsWith(x, y, dietMask(animalType)) > 0));
+                }
+            }
+        }
+        REQUIRE(bits.population(bits.layer(OccupancyBitboards::LAYER_ANY)) == occupied);
+
+        // Padding bits past the last column stay clear
+        size_t last = bits.getWordsPerRow() - 1;
+        if (width % 64 != 0) {
+            REQUIRE((nearPlants[last] >> (width % 64)) == 0);
+            REQUIRE((bits.layer(FOOD_CLASS_EMPTY)[last] >> (width % 64)) == 0);
+        }
+    }
+}
+
+TEST_CASE("Derived boards follow grid changes", "[Bitboards]") {
+    Board board(4, 4);
+    for (int y = 0; y < 4; ++y) {
+        for (int x = 0; x < 4; ++x) {
+            if (x != 0 || y != 0) board.set(x, y, FOOD_CLASS_PLANT);
+        }
+    }
+    REQUIRE(board.bits.hasEmptyNeighbor(1, 1));
+    REQUIRE_FALSE(board.bits.hasEmptyNeighbor(2, 2));
+    REQUIRE_FALSE(board.bits.hasEmptyNeighbor(0, 0));
+
+    uint64_t version = board.bits.getVersion();
+    board.set(0, 0, animalFoodClass(AnimalType::HERBIVORE));
+    REQUIRE(board.bits.getVersion() != version);
+    REQUIRE_FALSE(board.bits.hasEmptyNeighbor(1, 1));
+    REQUIRE(board.bits.hasAdjacentFood(AnimalType::CARNIVORE, 1, 0));
+    REQUIRE_FALSE(board.bits.hasAdjacentFood(AnimalType::CARNIVORE, 2, 2));
+}
+
+TEST_CASE("Grid keeps its bitboards in sync with the tiles", "[Bitboards]") {
+    Grid grid(6, 4);
+    Plant plant(5.0f, 100, 0.5f, 0.3f);
+    grid.getTile(2, 1).setOccupant(plant);
+    const OccupancyBitboards& bits = grid.getBitboards();
+
+    REQUIRE(bits.test(FOOD_CLASS_PLANT, 2, 1));
+    REQUIRE(bits.hasAdjacentFood(AnimalType::HERBIVORE, 3, 2));
+    REQUIRE_FALSE(bits.hasAdjacentFood(AnimalType::HERBIVORE, 5, 3));
+
+    grid.getTile(2, 1).clearOccupant();
+    REQUIRE(bits.test(FOOD_CLASS_EMPTY, 2, 1));
+    REQUIRE_FALSE(bits.test(OccupancyBitboards::LAYER_ANY, 2, 1));
+    REQUIRE_FALSE(bits.hasAdjacentFood(AnimalType::HERBIVORE, 3, 2));
+}
+
+TEST_CASE("Derived boards only rebuild the rows around changes", "[Bitboards]") {
+    const int width = 130;
+    const int height = 40;
+    Board board(width, height);
+    board.bits.refreshNeighborhood();
+    REQUIRE(board.bits.getRefreshedRows() == height);
+    board.bits.refreshNeighborhood();
+    REQUIRE(board.bits.getRefreshedRows() == height);
+
+    // One change touches its own row and the two next to it, fewer at the
+    // edges; neighboring changes share the rows in between
+    board.set(70, 10, FOOD_CLASS_PLANT);
+    board.set(3, 10, FOOD_CLASS_PLANT);
+    board.bits.refreshNeighborhood();
+    REQUIRE(board.bits.getRefreshedRows() == height + 3);
+    board.set(5, 0, FOOD_CLASS_PLANT);
+    board.set(5, 20, FOOD_CLASS_PLANT);
+    board.set(5, 21, FOOD_CLASS_PLANT);
+    board.bits.refreshNeighborhood();
+    REQUIRE(board.bits.getRefreshedRows() == height + 3 + 2 + 4);
+
+    // Scattered edits over several refreshes still match a full scan
+    std::mt19937 rng(5);
+    for (int round = 0; round < 6; ++round) {
+        for (int i = 0; i < 25; ++i) {
+            board.set(rng() % width, rng() % height, static_cast<FoodClass>(rng() % FOOD_CLASS_COUNT));
+        }
+        board.bits.refreshNeighborhood();
+    }
+    const DietMask emptyOnly = 1u << FOOD_CLASS_EMPTY;
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            REQUIRE(board.bits.hasEmptyNeighbor(x, y) == (board.neighborsWith(x, y, emptyOnly) > 0));
+            for (int type = 0; type < ANIMAL_TYPE_COUNT; ++type) {
+                AnimalType animalType = static_cast<AnimalType>(type);
+                REQUIRE(board.bits.hasAdjacentFood(animalType, x, y) == (board.neighborsWith(x, y, dietMask(animalType)) > 0));
+            }
+        }
+    }
+}
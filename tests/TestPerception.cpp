@@ -0,0 +1,94 @@
+#include "catch2/catch_test_macros.hpp"
+#include "Perception.h"
+#include "Animal.h"
+#include "Plant.h"
+#include "Grid.h"
+#include <memory>
+#include <random>
+#include <vector>
+
+TEST_CASE("Perception matches the individual grid queries", "[Perception]") {
+    const int width = 12;
+    const int height = 9;
+    Grid grid(width, height);
+    std::vector<std::unique_ptr<Organism>> occupants;
+
+    std::mt19937 rng(11);
+    std::uniform_int_distribution<int> pick(0, 5);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            int roll = pick(rng);
+            Organism* organism = nullptr;
+            if (roll == 0) {
+                organism = new Plant(10.0f, 100, 0.5f, 0.3f);
+            } else if (roll == 1) {
+                organism = new Animal(20.0f, 80, 2, 4, AnimalType::CARNIVORE, 1.0f, 30.0f, 5);
+            }
+            if (organism != nullptr) {
+                organism->setPosition(Position(x, y));
+                grid.getTile(x, y).setOccupant(*organism);
+                occupants.emplace_back(organism);
+            }
+        }
+    }
+
+    for (const auto& occupant : occupants) {
+        if (occupant->getType() != OrganismType::ANIMAL) continue;
+        Animal& animal = static_cast<Animal&>(*occupant);
+        Perception perception = animal.perceive(grid);
+
+        REQUIRE(perception.adjacentFood == animal.findAdjacentFood(grid));
+        REQUIRE(perception.nearestFood == animal.findNearestFood(grid));
+
+        std::vector<Position> expected;
+        for (const Position& pos : animal.getPosition().getAdjacentPositions()) {
+            if (grid.isInBounds(pos.getX(), pos.getY()) && grid.getTile(pos.getX(), pos.getY()).isEmpty()) {
+                expected.push_back(pos);
+            }
+        }
+        REQUIRE(perception.emptyNeighborCount() == static_cast<int>(expected.size()));
+        for (size_t i = 0; i < expected.size(); ++i) {
+            Position seen = perception.emptyNeighbor(static_cast<int>(i));
+            REQUIRE(seen.getX() == expected[i].getX());
+            REQUIRE(seen.getY() == expected[i].getY());
+        }
+    }
+}
+
+TEST_CASE("Moves follow the perceived food", "[Perception]") {
+    Grid grid(7, 7);
+    Animal herbivore(20.0f, 80, 2, 5, AnimalType::HERBIVORE, 1.0f, 30.0f, 5);
+    herbivore.setPosition(Position(1, 1));
+    grid.getTile(1, 1).setOccupant(herbivore);
+
+    Plant plant(10.0f, 100, 0.5f, 0.3f);
+    plant.setPosition(Position(5, 5));
+    grid.getTile(5, 5).setOccupant(plant);
+
+    Perception perception = herbivore.perceive(grid);
+    REQUIRE(perception.nearestFood == &plant);
+    REQUIRE(perception.adjacentFood == nullptr);
+    REQUIRE(perception.emptyNeighborCount() == 8);
+
+    Position next = herbivore.findBestMovePosition(grid);
+    REQUIRE(next.getX() == 2);
+    REQUIRE(next.getY() == 2);
+
+    SECTION("Boxed in animals stay put") {
+        Grid corner(2, 2);
+        Animal boxed(20.0f, 80, 2, 5, AnimalType::HERBIVORE, 1.0f, 30.0f, 5);
+        Animal a(20.0f, 80, 2, 5, AnimalType::HERBIVORE, 1.0f, 30.0f, 5);
+        Animal b(20.0f, 80, 2, 5, AnimalType::HERBIVORE, 1.0f, 30.0f, 5);
+        Animal c(20.0f, 80, 2, 5, AnimalType::HERBIVORE, 1.0f, 30.0f, 5);
+        boxed.setPosition(Position(0, 0));
+        corner.getTile(0, 0).setOccupant(boxed);
+        corner.getTile(1, 0).setOccupant(a);
+        corner.getTile(0, 1).setOccupant(b);
+        corner.getTile(1, 1).setOccupant(c);
+
+        REQUIRE_FALSE(boxed.perceive(corner).hasEmptyNeighbor());
+        Position stay = boxed.findBestMovePosition(corner);
+        REQUIRE(stay.getX() == 0);
+        REQUIRE(stay.getY() == 0);
+    }
+}
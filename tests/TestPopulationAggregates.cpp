@@ -0,0 +1,109 @@
+#include "catch2/catch_test_macros.hpp"
+#include "PopulationAggregates.h"
+#include "WorldManager.h"
+#include "Animal.h"
+#include "Plant.h"
+#include <atomic>
+#include <cmath>
+#include <thread>
+
+TEST_CASE("Population aggregates follow adds, removes and changes", "[Aggregates]") {
+    PopulationAggregates aggregates;
+    Plant plant(5.0f, 100, 0.5f, 0.3f);
+    Animal wolf(11.0f, 80, 2, 5, AnimalType::CARNIVORE, 1.0f, 20.0f, 5);
+    Animal deer(3.0f, 80, 2, 5, AnimalType::HERBIVORE, 1.0f, 20.0f, 5);
+
+    aggregates.add(plant);
+    aggregates.add(wolf);
+    aggregates.add(deer);
+    REQUIRE(aggregates.getTotalCount() == 3);
+    REQUIRE(aggregates.getCount(OrganismType::PLANT) == 1);
+    REQUIRE(aggregates.getCount(OrganismType::ANIMAL) == 2);
+    REQUIRE(aggregates.getCount(AnimalType::CARNIVORE) == 1);
+    REQUIRE(aggregates.getCount(AnimalType::OMNIVORE) == 0);
+    REQUIRE(aggregates.getTotalNutrients() == 19.0);
+    REQUIRE(aggregates.getNutrientBucket(PopulationAggregates::nutrientBucketOf(11.0f)) == 1);
+    REQUIRE(aggregates.getAgeBucket(0) == 3);
+
+    SECTION("Changes move the organism between buckets") {
+        PopulationAggregates::Contribution before = PopulationAggregates::contributionOf(wolf);
+        wolf.addNutrients(100.0f);
+        wolf.incrementAge(25);
+        aggregates.update(before, wolf);
+
+        REQUIRE(aggregates.getTotalNutrients() == 119.0);
+        REQUIRE(aggregates.getNutrientBucket(PopulationAggregates::NUTRIENT_BUCKETS - 1) == 1);
+        REQUIRE(aggregates.getAgeBucket(2) == 1);
+        REQUIRE(aggregates.getAgeBucket(0) == 2);
+        REQUIRE(std::fabs(aggregates.getMeanAge() - 25.0 / 3.0) < 1e-9);
+    }
+
+    SECTION("Removing everything returns to exactly zero") {
+        PopulationAggregates::Contribution before = PopulationAggregates::contributionOf(deer);
+        deer.consumeNutrients(0.1f);
+        aggregates.update(before, deer);
+
+        aggregates.remove(plant);
+        aggregates.remove(wolf);
+        aggregates.remove(deer);
+        REQUIRE(aggregates.getTotalCount() == 0);
+        REQUIRE(aggregates.getTotalNutrients() == 0.0);
+        REQUIRE(aggregates.getMeanNutrients() == 0.0);
+        for (int bucket = 0; bucket < PopulationAggregates::NUTRIENT_BUCKETS; ++bucket) {
+            REQUIRE(aggregates.getNutrientBucket(bucket) == 0);
+        }
+    }
+}
+
+TEST_CASE("World aggregates match a walk of the grid", "[Aggregates]") {
+    WorldManager::resetInstance();
+    WorldManager& manager = WorldManager::getInstance(12, 12, 1.0f);
+    for (int i = 0; i < 10; ++i) {
+        manager.addOrganism(new Plant(5.0f, 30, 0.5f, 0.3f), i, i);
+    }
+    manager.addOrganism(new Animal(15.0f, 40, 2, 5, AnimalType::HERBIVORE, 1.0f, 20.0f, 5), 0, 5);
+    manager.addOrganism(new Animal(25.0f, 40, 2, 5, AnimalType::CARNIVORE, 1.0f, 20.0f, 5), 11, 3);
+
+    const PopulationAggregates& aggregates = manager.getAggregates();
+    std::atomic<bool> done(false);
+    std::atomic<int64_t> reads(0);
+    // Reads race with the ticks on purpose; they must never see nonsense
+    std::thread reader([&]() {
+        while (!done.load()) {
+            if (aggregates.getTotalCount() < 0 || aggregates.getTotalNutrients() < 0.0) break;
+            reads.fetch_add(1);
+        }
+    });
+
+    for (int tick = 0; tick < 60; ++tick) {
+        manager.update();
+
+        int64_t counts[2] = {0, 0};
+        double nutrients = 0.0;
+        int64_t ageBuckets[PopulationAggregates::AGE_BUCKETS] = {};
+        const Grid& grid = manager.getGrid();
+        for (int y = 0; y < grid.getHeight(); ++y) {
+            for (int x = 0; x < grid.getWidth(); ++x) {
+                const Tile& tile = grid.getTile(x, y);
+                if (tile.isEmpty()) continue;
+                const Organism* organism = tile.getOccupant();
+                ++counts[organism->getType() == OrganismType::PLANT ? 0 : 1];
+                nutrients += organism->getNutrients();
+                ++ageBuckets[PopulationAggregates::ageBucketOf(organism->getAge())];
+            }
+        }
+
+        REQUIRE(aggregates.getTotalCount() == manager.getOrganismCount());
+        REQUIRE(aggregates.getCount(OrganismType::PLANT) == counts[0]);
+        REQUIRE(aggregates.getCount(OrganismType::ANIMAL) == counts[1]);
+        REQUIRE(std::fabs(aggregates.getTotalNutrients() - nutrients) < 0.01 * (1.0 + counts[0] + counts[1]));
+        for (int bucket = 0; bucket < PopulationAggregates::AGE_BUCKETS; ++bucket) {
+            REQUIRE(aggregates.getAgeBucket(bucket) == ageBuckets[bucket]);
+        }
+    }
+
+    done.store(true);
+    reader.join();
+    REQUIRE(reads.load() > 0);
+    WorldManager::resetInstance();
+}
@@ -0,0 +1,211 @@
+#include "catch2/catch_test_macros.hpp"
+#include "ShardedRunner.h"
+#include "WorldManager.h"
+#include "Plant.h"
+#include "Animal.h"
+#include "TaskPool.h"
+#include "FoodSearch.h"
+#include <atomic>
+#include <filesystem>
+#include <stdexcept>
+#include <vector>
+
+TEST_CASE("Bands split the rows evenly", "[ShardedRunner]") {
+    ShardedRunner runner(10, 38, 3, 4);
+    ShardBand top = runner.bandFor(0);
+    ShardBand middle = runner.bandFor(1);
+    ShardBand bottom = runner.bandFor(2);
+
+    REQUIRE(top.firstRow == 0);
+    REQUIRE(top.lastRow == 13);
+    REQUIRE(middle.firstRow == 13);
+    REQUIRE(middle.lastRow == 26);
+    REQUIRE(bottom.firstRow == 26);
+    REQUIRE(bottom.lastRow == 38);
+
+    // Halos only face a neighbor
+    REQUIRE(top.haloAbove == 0);
+    REQUIRE(top.haloBelow == 4);
+    REQUIRE(top.getLocalHeight() == 17);
+    REQUIRE(middle.originRow == 9);
+    REQUIRE(middle.getLocalHeight() == 21);
+    REQUIRE(middle.toLocalRow(13) == 4);
+    REQUIRE(middle.toGlobalRow(0) == 9);
+    REQUIRE(bottom.haloBelow == 0);
+    REQUIRE(bottom.owns(37));
+    REQUIRE_FALSE(bottom.owns(25));
+
+    REQUIRE_THROWS_AS(runner.bandFor(3), std::invalid_argument);
+    REQUIRE_THROWS_AS(ShardedRunner(10, 10, 3, 4), std::invalid_argument);
+}
+
+TEST_CASE("Owned rows keep ghosts out of the world", "[ShardedRunner]") {
+    WorldManager::resetInstance();
+    WorldManager& manager = WorldManager::getInstance(5, 6, 1.0f);
+    manager.setOwnedRows(0, 4);
+    REQUIRE_THROWS_AS(manager.setOwnedRows(2, 7), std::invalid_argument);
+
+    // A hungry herbivore with nothing but ghost plants within reach
+    manager.addOrganism(new Animal(10.0f, 100, 1, 3, AnimalType::HERBIVORE, 1.0f, 1000.0f, 1), 2, 3);
+    std::vector<Plant*> ghosts;
+    for (int x = 0; x < 5; ++x) {
+        ghosts.push_back(new Plant(5.0f, 100, 0.5f, 0.3f));
+        manager.placeGhost(ghosts.back(), x, 4);
+    }
+    REQUIRE_THROWS_AS(manager.placeGhost(ghosts[0], 0, 2), std::invalid_argument);
+    REQUIRE(manager.getOrganismCount() == 1);
+
+    for (int tick = 0; tick < 4; ++tick) {
+        manager.update();
+    }
+    REQUIRE(manager.getMetrics().getTotal(MetricCounter::EATS) == 0);
+    for (int x = 0; x < 5; ++x) {
+        REQUIRE(manager.getGrid().getFoodClasses()[4 * 5 + x] == FOOD_CLASS_PLANT);
+        REQUIRE(manager.removeGhost(x, 4) == ghosts[x]);
+        delete ghosts[x];
+    }
+    REQUIRE(manager.removeGhost(0, 4) == nullptr);
+
+    // Organisms that end up outside the owned rows are handed over
+    manager.addOrganism(new Plant(5.0f, 100, 0.5f, 0.3f), 1, 5);
+    int before = manager.getOrganismCount();
+    std::vector<Organism*> emigrants;
+    manager.takeEmigrants(emigrants);
+    REQUIRE(emigrants.size() == 1);
+    REQUIRE(manager.getOrganismCount() == before - 1);
+    REQUIRE(manager.getGrid().getFoodClasses()[5 * 5 + 1] == FOOD_CLASS_EMPTY);
+    REQUIRE(manager.getAggregates().getTotalCount() == static_cast<int64_t>(before - 1));
+    delete emigrants[0];
+    WorldManager::resetInstance();
+}
+
+TEST_CASE("Animals next to a ghost hunt what they can reach", "[ShardedRunner]") {
+    const GridLayout layouts[] = {GridLayout::ROW_MAJOR, GridLayout::BLOCKED};
+    for (GridLayout layout : layouts) {
+        WorldManager::resetInstance();
+        WorldManager& manager = WorldManager::getInstance(7, 5, 1.0f);
+        manager.setGridLayout(layout);
+        manager.setOwnedRows(0, 3);
+        Plant ghost(5.0f, 100, 0.5f, 0.3f);
+        manager.placeGhost(&ghost, 3, 3);
+        manager.addOrganism(new Animal(10.0f, 100, 1, 3, AnimalType::HERBIVORE, 1.0f, 1000.0f, 1), 3, 2);
+        manager.addOrganism(new Plant(5.0f, 100, 0.5f, 0.3f), 1, 1);
+
+        // The ghost fills its tile but is nobody's food
+        const Grid& grid = manager.getGrid();
+        REQUIRE(grid.getFoodClasses()[3 * 7 + 3] == FOOD_CLASS_PLANT);
+        REQUIRE(FoodSearch::adjacentFood(AnimalType::HERBIVORE, grid, 3, 2) == -1);
+        REQUIRE_FALSE(grid.getBitboards().hasAdjacentFood(AnimalType::HERBIVORE, 3, 2));
+        REQUIRE(FoodSearch::nearestFood(AnimalType::HERBIVORE, grid, 3, 2, 3) == 1 * 7 + 1);
+        REQUIRE((FoodSearch::emptyNeighborMask(grid, 3, 2) & (1u << 4)) == 0);
+
+        for (int tick = 0; tick < 12; ++tick) {
+            manager.update();
+        }
+        REQUIRE(manager.getMetrics().getTotal(MetricCounter::MOVES) > 0);
+        REQUIRE(manager.getMetrics().getTotal(MetricCounter::EATS) > 0);
+        REQUIRE(manager.removeGhost(3, 3) == &ghost);
+    }
+    WorldManager::resetInstance();
+}
+
+#if defined(__linux__)
+TEST_CASE("Sharded processes hand organisms across bands", "[ShardedRunner]") {
+    const int width = 16;
+    const int height = 36;
+    ShardedRunner runner(width, height, 3, 3);
+
+    // Long-lived herbivores that never reproduce and find nothing to eat, so
+    // only migration changes where they are
+    size_t expected = 0;
+    for (int row = 0; row < height; row += 2) {
+        expected += (width + 2) / 3;
+    }
+    bool finished = runner.run(30, [](WorldManager& world, const ShardBand& band) {
+        for (int row = band.firstRow; row < band.lastRow; ++row) {
+            if (row % 2 != 0) continue;
+            for (int x = 0; x < world.getGrid().getWidth(); x += 3) {
+                world.addOrganism(new Animal(500.0f, 10000, 2, 3, AnimalType::HERBIVORE, 0.1f, 100000.0f, 1),
+                                  x, band.toLocalRow(row));
+            }
+        }
+    });
+    REQUIRE(finished);
+
+    const std::vector<uint64_t>& totals = runner.getOrganismsPerTick();
+    REQUIRE(totals.size() == 31);
+    for (uint64_t total : totals) {
+        REQUIRE(total == expected);
+    }
+
+    uint64_t emigrants = 0;
+    uint64_t immigrants = 0;
+    uint64_t organisms = 0;
+    for (int shard = 0; shard < runner.getShardCount(); ++shard) {
+        const ShardSummary& summary = runner.getSummary(shard);
+        REQUIRE(summary.completed == 1);
+        REQUIRE(summary.lost == 0);
+        // Every shard faces at least one neighbor with animals near the edge
+        REQUIRE(summary.ghosts > 0);
+        REQUIRE(summary.haloUpdates > 0);
+        emigrants += summary.emigrants;
+        immigrants += summary.immigrants;
+        organisms += summary.organisms;
+    }
+    REQUIRE(emigrants > 0);
+    REQUIRE(immigrants == emigrants);
+    REQUIRE(organisms == expected);
+}
+
+TEST_CASE("A failing shard stops the whole run", "[ShardedRunner]") {
+    ShardedRunner runner(8, 16, 2, 2);
+    bool finished = runner.run(5, [](WorldManager&, const ShardBand& band) {
+        if (band.shard == 1) {
+            throw std::runtime_error("populate failed");
+        }
+    });
+    REQUIRE_FALSE(finished);
+    REQUIRE(runner.getSummary(1).completed == 0);
+}
+
+TEST_CASE("Shards fork safely while the shared pool is running", "[ShardedRunner]") {
+    // Leaves the pool's workers started and idle, as a parallel tick would
+    std::atomic<size_t> visited(0);
+    TaskPool::shared().parallelFor(4096, 16, [&](size_t begin, size_t end, int) {
+        visited.fetch_add(end - begin);
+    });
+    REQUIRE(visited.load() == 4096);
+
+    ShardedRunner runner(8, 16, 2, 2);
+    bool finished = runner.run(10, [](WorldManager& world, const ShardBand& band) {
+        world.setParallelUpdates(true);
+        world.addOrganism(new Plant(5.0f, 100, 0.5f, 0.3f), 3, band.toLocalRow(band.firstRow));
+    });
+    REQUIRE(finished);
+    REQUIRE(runner.getSummary(0).completed == 1);
+    REQUIRE(runner.getSummary(1).completed == 1);
+
+    // The parent's pool comes back on its next use
+    visited.store(0);
+    TaskPool::shared().parallelFor(4096, 16, [&](size_t begin, size_t end, int) {
+        visited.fetch_add(end - begin);
+    });
+    REQUIRE(visited.load() == 4096);
+}
+
+TEST_CASE("Shards are not forked while statistics are being written", "[ShardedRunner]") {
+    WorldManager::resetInstance();
+    WorldManager& manager = WorldManager::getInstance(8, 16, 1.0f);
+    std::string path = (std::filesystem::temp_directory_path() / "sharded_statistics.bin").string();
+    manager.configureStatistics(path, StatisticsOptions());
+
+    ShardedRunner runner(8, 16, 2, 2);
+    auto populate = [](WorldManager&, const ShardBand&) {};
+    REQUIRE_THROWS_AS(runner.run(1, populate), std::logic_error);
+    manager.closeStatistics();
+    REQUIRE(runner.run(1, populate));
+
+    WorldManager::resetInstance();
+    std::filesystem::remove(path);
+}
+#endif
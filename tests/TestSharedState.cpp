@@ -0,0 +1,184 @@
+#include "catch2/catch_test_macros.hpp"
+#include "SharedState.h"
+#include "WorldManager.h"
+#include "Plant.h"
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace {
+std::string segmentName(const std::string& suffix) {
+    return "/ecosystem_test_" + std::to_string(getpid()) + "_" + suffix;
+}
+}
+
+TEST_CASE("Shared state ring publishes consistent frames", "[SharedState]") {
+    const int width = 5;
+    const int height = 3;
+    std::string name = segmentName("ring");
+
+    SharedStateExporter exporter;
+    REQUIRE(exporter.open(name, width, height, 2, true));
+
+    SharedStateReader reader;
+    REQUIRE(reader.open(name));
+    REQUIRE(reader.getWidth() == width);
+    REQUIRE(reader.getHeight() == height);
+    REQUIRE(reader.getFrameCount() == 2);
+    REQUIRE(reader.hasNutrients());
+
+    SharedFrameView view;
+    REQUIRE_FALSE(reader.acquireLatest(view));
+
+    std::vector<FoodClass> occupancy(width * height, FOOD_CLASS_EMPTY);
+    std::vector<float> nutrients(width * height, 1.5f);
+    occupancy[7] = FOOD_CLASS_PLANT;
+    exporter.publish(10, 1, occupancy.data(), nutrients.data());
+
+    SECTION("Views read in place and validate") {
+        REQUIRE(reader.acquireLatest(view));
+        REQUIRE(view.tick == 10);
+        REQUIRE(view.organisms == 1);
+        REQUIRE(view.occupancy[7] == FOOD_CLASS_PLANT);
+        REQUIRE(view.nutrients[3] == 1.5f);
+        REQUIRE(reader.validate(view));
+    }
+
+    SECTION("A view is invalidated once the ring wraps onto its frame") {
+        REQUIRE(reader.acquireLatest(view));
+        exporter.publish(11, 1, occupancy.data(), nutrients.data());
+        REQUIRE(reader.validate(view));
+        exporter.publish(12, 1, occupancy.data(), nutrients.data());
+        REQUIRE_FALSE(reader.validate(view));
+    }
+
+    SECTION("Copies follow the latest frame") {
+        occupancy[7] = FOOD_CLASS_EMPTY;
+        occupancy[0] = animalFoodClass(AnimalType::CARNIVORE);
+        exporter.publish(11, 2, occupancy.data(), nutrients.data());
+
+        SharedFrameCopy copy;
+        REQUIRE(reader.copyLatest(copy));
+        REQUIRE(copy.tick == 11);
+        REQUIRE(copy.organisms == 2);
+        REQUIRE(copy.occupancy == occupancy);
+        REQUIRE(copy.nutrients == nutrients);
+        REQUIRE(reader.getPublishedCount() == 2);
+    }
+
+    reader.close();
+    exporter.close();
+    REQUIRE_FALSE(reader.open(name));
+}
+
+TEST_CASE("Shared state rejects bad rings", "[SharedState]") {
+    SharedStateExporter exporter;
+    REQUIRE_THROWS_AS(exporter.open(segmentName("bad"), 4, 4, 0, false), std::invalid_argument);
+    REQUIRE_THROWS_AS(exporter.open(segmentName("bad"), 0, 4, 1, false), std::invalid_argument);
+    REQUIRE_FALSE(exporter.isOpen());
+
+    SharedStateReader reader;
+    REQUIRE_FALSE(reader.open(segmentName("missing")));
+}
+
+TEST_CASE("A leftover segment is replaced, not truncated", "[SharedState]") {
+    std::string name = segmentName("stale");
+    // What a writer that crashed before close() leaves behind
+    int stale = shm_open(name.c_str(), O_CREAT | O_RDWR, 0644);
+    REQUIRE(stale >= 0);
+    REQUIRE(ftruncate(stale, 16) == 0);
+    REQUIRE(write(stale, "not a ring", 10) == 10);
+    close(stale);
+
+    SharedStateExporter exporter;
+    REQUIRE(exporter.open(name, 4, 2, 2, false));
+    SharedStateReader reader;
+    REQUIRE(reader.open(name));
+    REQUIRE(reader.getWidth() == 4);
+    REQUIRE(reader.getFrameCount() == 2);
+
+    reader.close();
+    exporter.close();
+    REQUIRE_FALSE(reader.open(name));
+}
+
+TEST_CASE("Readers reject headers whose layers do not fit", "[SharedState]") {
+    std::string name = segmentName("inconsistent");
+    SharedStateExporter exporter;
+    REQUIRE(exporter.open(name, 8, 4, 2, true));
+
+    // Damages the header through a mapping of our own, as another build or a
+    // stray writer could
+    int opened = shm_open(name.c_str(), O_RDWR, 0);
+    REQUIRE(opened >= 0);
+    void* mapped = mmap(nullptr, sizeof(SharedStateHeader), PROT_READ | PROT_WRITE, MAP_SHARED, opened, 0);
+    close(opened);
+    REQUIRE(mapped != MAP_FAILED);
+    SharedStateHeader* header = static_cast<SharedStateHeader*>(mapped);
+    const uint64_t frameStride = header->frameStride;
+    const uint32_t height = header->height;
+    const uint32_t frameCount = header->frameCount;
+
+    SharedStateReader reader;
+    REQUIRE(reader.open(name));
+    reader.close();
+
+    SECTION("Occupancy running past the frame") {
+        header->occupancyOffset = frameStride - 8;
+    }
+    SECTION("Nutrients running past the frame") {
+        header->nutrientOffset = frameStride - 4 * 8;
+    }
+    SECTION("Layers overlapping the frame header") {
+        header->occupancyOffset = 0;
+    }
+    SECTION("More tiles than the layers were sized for") {
+        header->height = height * 64;
+    }
+    SECTION("No tiles") {
+        header->width = 0;
+    }
+    SECTION("Frames past the end of the segment") {
+        header->frameCount = frameCount + 1;
+    }
+    REQUIRE_FALSE(reader.open(name));
+
+    munmap(mapped, sizeof(SharedStateHeader));
+    exporter.close();
+}
+
+TEST_CASE("World publishes its grid every tick", "[SharedState]") {
+    WorldManager::resetInstance();
+    WorldManager& manager = WorldManager::getInstance(6, 4, 1.0f);
+    manager.addOrganism(new Plant(5.0f, 100, 0.5f, 0.3f), 2, 1);
+
+    std::string name = segmentName("world");
+    REQUIRE(manager.configureSharedExport(name, 4, false));
+
+    SharedStateReader reader;
+    REQUIRE(reader.open(name));
+    REQUIRE_FALSE(reader.hasNutrients());
+
+    SharedFrameCopy copy;
+    REQUIRE(reader.copyLatest(copy));
+    REQUIRE(copy.tick == 0);
+    REQUIRE(copy.occupancy[1 * 6 + 2] == FOOD_CLASS_PLANT);
+
+    manager.update();
+    manager.update();
+    REQUIRE(reader.copyLatest(copy));
+    REQUIRE(copy.tick == 2);
+    REQUIRE(copy.organisms == static_cast<uint64_t>(manager.getOrganismCount()));
+    const Grid& grid = manager.getGrid();
+    for (int y = 0; y < grid.getHeight(); ++y) {
+        for (int x = 0; x < grid.getWidth(); ++x) {
+            REQUIRE(copy.occupancy[y * 6 + x] == grid.getFoodClasses()[y * 6 + x]);
+        }
+    }
+
+    reader.close();
+    WorldManager::resetInstance();
+}
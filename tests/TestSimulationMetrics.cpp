@@ -0,0 +1,115 @@
+#include "catch2/catch_test_macros.hpp"
+#include "SimulationMetrics.h"
+#include "WorldManager.h"
+#include "Plant.h"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+std::string readFile(const std::string& path) {
+    std::ifstream in(path);
+    std::stringstream buffer;
+    buffer << in.rdbuf();
+    return buffer.str();
+}
+}
+
+TEST_CASE("Simulation metrics counters", "[Metrics]") {
+    SECTION("Counters sum across threads") {
+        SimulationMetrics metrics;
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([&metrics]() {
+                for (int i = 0; i < 1000; ++i) {
+                    metrics.increment(MetricCounter::MOVES);
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        REQUIRE(metrics.getTotal(MetricCounter::MOVES) == 4000);
+        REQUIRE(metrics.getTotal(MetricCounter::EATS) == 0);
+    }
+
+    SECTION("Tick deltas only count events since the previous tick") {
+        SimulationMetrics metrics;
+        metrics.increment(MetricCounter::BIRTHS, 3);
+        metrics.endTick();
+        REQUIRE(metrics.getTick() == 1);
+        REQUIRE(metrics.getLastTickDelta(MetricCounter::BIRTHS) == 3);
+
+        metrics.increment(MetricCounter::BIRTHS);
+        metrics.endTick();
+        REQUIRE(metrics.getLastTickDelta(MetricCounter::BIRTHS) == 1);
+        REQUIRE(metrics.getTotal(MetricCounter::BIRTHS) == 4);
+    }
+
+    SECTION("Gauges hold the last value") {
+        SimulationMetrics metrics;
+        metrics.setGauge(MetricGauge::PLANTS, 12);
+        metrics.setGauge(MetricGauge::PLANTS, 7);
+        REQUIRE(metrics.getGauge(MetricGauge::PLANTS) == 7);
+    }
+}
+
+TEST_CASE("Metrics exporter writes textfile and CSV", "[Metrics]") {
+    std::filesystem::path dir = std::filesystem::temp_directory_path();
+    std::string promPath = (dir / "ecosystem_metrics_test.prom").string();
+    std::string csvPath = (dir / "ecosystem_metrics_test.csv").string();
+
+    {
+        SimulationMetrics metrics;
+        MetricsExporter exporter;
+        exporter.configure(promPath, csvPath, 2);
+
+        metrics.increment(MetricCounter::DEATHS_OLD_AGE, 2);
+        metrics.setGauge(MetricGauge::HERBIVORES, 5);
+        metrics.endTick();
+        exporter.onTick(metrics);
+        REQUIRE_FALSE(std::filesystem::exists(promPath));
+
+        metrics.increment(MetricCounter::DEATHS_OLD_AGE);
+        metrics.endTick();
+        exporter.onTick(metrics);
+    }
+
+    std::string prom = readFile(promPath);
+    REQUIRE(prom.find("ecosystem_deaths_total{cause=\"old_age\"} 3") != std::string::npos);
+    REQUIRE(prom.find("ecosystem_organisms{type=\"herbivore\"} 5") != std::string::npos);
+    REQUIRE(prom.find("ecosystem_tick 2") != std::string::npos);
+
+    std::string csv = readFile(csvPath);
+    REQUIRE(csv.find("tick,births,deaths_starvation,deaths_old_age") == 0);
+    REQUIRE(csv.find("\n2,0,0,3,") != std::string::npos);
+
+    std::remove(promPath.c_str());
+    std::remove(csvPath.c_str());
+}
+
+TEST_CASE("World update records deaths and gauges", "[Metrics]") {
+    WorldManager& manager = WorldManager::getInstance(10, 10, 2.0f);
+    SimulationMetrics& metrics = manager.getMetrics();
+
+    if (!manager.getGrid().getTile(9, 9).isEmpty()) {
+        manager.removeOrganism(Position(9, 9));
+    }
+    uint64_t oldAgeBefore = metrics.getTotal(MetricCounter::DEATHS_OLD_AGE);
+    uint64_t spawnsBefore = metrics.getTotal(MetricCounter::DECOMPOSITION_SPAWNS);
+
+    manager.addOrganism(new Plant(1.0f, 1, 0.1f, 0.1f), 9, 9);
+    manager.update();
+
+    REQUIRE(metrics.getTotal(MetricCounter::DEATHS_OLD_AGE) >= oldAgeBefore + 1);
+    REQUIRE(metrics.getTotal(MetricCounter::DECOMPOSITION_SPAWNS) >= spawnsBefore + 1);
+    REQUIRE(metrics.getGauge(MetricGauge::ORGANISMS) == manager.getOrganismCount());
+    REQUIRE(metrics.getGauge(MetricGauge::PLANTS) >= 1);
+
+    WorldManager::resetInstance();
+}
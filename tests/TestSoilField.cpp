@@ -0,0 +1,173 @@
+#include "catch2/catch_test_macros.hpp"
+#include "SoilField.h"
+#include "WorldManager.h"
+#include "Plant.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+// Straightforward scalar stencil the blocked/SIMD step must reproduce
+std::vector<float> referenceStep(const SoilField& soil, float regeneration) {
+    int width = soil.getWidth();
+    int height = soil.getHeight();
+    std::vector<float> out(static_cast<size_t>(width) * height);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            float center = soil.getNutrients(x, y);
+            float up = y > 0 ? soil.getNutrients(x, y - 1) : center;
+            float down = y < height - 1 ? soil.getNutrients(x, y + 1) : center;
+            float left = x > 0 ? soil.getNutrients(x - 1, y) : center;
+            float right = x < width - 1 ? soil.getNutrients(x + 1, y) : center;
+            float diffused = center + soil.getDiffusionRate() * (up + down + left + right - 4.0f * center);
+            float topUp = std::min(regeneration, std::max(soil.getCapacity() - diffused, 0.0f));
+            out[static_cast<size_t>(y) * width + x] = std::max(diffused + topUp, 0.0f);
+        }
+    }
+    return out;
+}
+
+void randomize(SoilField& soil, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> level(0.0f, soil.getCapacity());
+    for (int y = 0; y < soil.getHeight(); ++y) {
+        for (int x = 0; x < soil.getWidth(); ++x) {
+            soil.setNutrients(x, y, level(rng));
+        }
+    }
+}
+
+}
+
+TEST_CASE("Soil field validates its parameters", "[Soil]") {
+    REQUIRE_THROWS_AS(SoilField(0, 4, 1.0f, 2.0f), std::invalid_argument);
+    REQUIRE_THROWS_AS(SoilField(4, 4, 1.0f, 2.0f, 0.3f), std::invalid_argument);
+    REQUIRE_THROWS_AS(SoilField(4, 4, 1.0f, 2.0f, -0.1f), std::invalid_argument);
+
+    SoilField soil(4, 3, 5.0f, 2.0f);
+    REQUIRE(soil.getNutrients(3, 2) == 2.0f);
+    REQUIRE(soil.getMemoryFootprint().bytes >= 2 * 12 * sizeof(float));
+}
+
+TEST_CASE("Soil draw and deposit", "[Soil]") {
+    SoilField soil(3, 3, 1.0f, 4.0f);
+
+    REQUIRE(soil.draw(1, 1, 0.25f) == 0.25f);
+    REQUIRE(std::fabs(soil.getNutrients(1, 1) - 0.75f) <= 1e-5f);
+    REQUIRE(std::fabs(soil.draw(1, 1, 5.0f) - 0.75f) <= 1e-5f);
+    REQUIRE(soil.getNutrients(1, 1) == 0.0f);
+    REQUIRE(soil.draw(0, 0, -1.0f) == 0.0f);
+
+    soil.deposit(2, 2, 10.0f);
+    REQUIRE(std::fabs(soil.getNutrients(2, 2) - 11.0f) <= 1e-5f);
+
+    // Regeneration adds nothing to full cells, and a deposit's surplus
+    // spreads out instead of being cut off at capacity
+    SoilField full(3, 3, 4.0f, 4.0f);
+    full.deposit(2, 2, 10.0f);
+    for (int tick = 0; tick < 40; ++tick) {
+        full.step(1.0f);
+    }
+    REQUIRE(std::fabs(full.getTotal() - (9 * 4.0 + 10.0)) <= 1e-3);
+    REQUIRE(full.getNutrients(0, 0) > 4.0f);
+    REQUIRE(full.getNutrients(2, 2) < 14.0f);
+}
+
+TEST_CASE("Soil diffusion conserves nutrients without regeneration", "[Soil]") {
+    SoilField soil(37, 21, 0.0f, 100.0f, 0.2f);
+    soil.deposit(18, 10, 50.0f);
+    soil.deposit(0, 0, 30.0f);
+
+    for (int tick = 0; tick < 50; ++tick) {
+        soil.step(0.0f);
+    }
+    REQUIRE(std::fabs(soil.getTotal() - 80.0) <= 1e-3);
+    REQUIRE(soil.getNutrients(18, 10) < 50.0f);
+    REQUIRE(soil.getNutrients(19, 10) > 0.0f);
+
+    SECTION("Regeneration fills to capacity and no further") {
+        for (int tick = 0; tick < 200; ++tick) {
+            soil.step(1.0f);
+        }
+        REQUIRE(soil.getNutrients(36, 20) == 100.0f);
+        REQUIRE(std::fabs(soil.getTotal() - 100.0 * 37 * 21) <= 1e-2);
+    }
+}
+
+TEST_CASE("Soil step matches the scalar reference", "[Soil]") {
+    // Odd widths exercise the SIMD tail and width one has no interior at all
+    const int widths[] = {1, 2, 5, 13, 67};
+    for (int width : widths) {
+        SoilField soil(width, 9, 0.0f, 10.0f, 0.15f);
+        randomize(soil, static_cast<unsigned>(width));
+        soil.setThreadCount(1);
+
+        std::vector<float> expected = referenceStep(soil, 0.05f);
+        soil.step(0.05f);
+        for (int y = 0; y < soil.getHeight(); ++y) {
+            for (int x = 0; x < width; ++x) {
+                REQUIRE(std::fabs(soil.getNutrients(x, y) - expected[static_cast<size_t>(y) * width + x]) <= 1e-5f);
+            }
+        }
+    }
+}
+
+TEST_CASE("Threaded soil steps match single threaded ones", "[Soil]") {
+    const int width = 300;
+    const int height = 700;
+    SoilField single(width, height, 0.0f, 10.0f);
+    SoilField banded(width, height, 0.0f, 10.0f);
+    randomize(single, 5);
+    randomize(banded, 5);
+    single.setThreadCount(1);
+    banded.setThreadCount(3);
+
+    for (int tick = 0; tick < 3; ++tick) {
+        single.step(0.1f);
+        banded.step(0.1f);
+    }
+    REQUIRE(std::equal(single.data(), single.data() + width * height, banded.data()));
+}
+
+TEST_CASE("Plants draw their nutrients from the soil", "[Soil]") {
+    WorldManager::resetInstance();
+    WorldManager& manager = WorldManager::getInstance(10, 10, 0.1f);
+    const SoilField& soil = manager.getSoil();
+    double fullTotal = soil.getTotal();
+    REQUIRE(std::fabs(fullTotal - 100.0) <= 1e-4);
+
+    REQUIRE(std::fabs(manager.drawSoilNutrients(5, 5, 0.4f) - 0.4f) <= 1e-5f);
+    REQUIRE(std::fabs(soil.getNutrients(5, 5) - 0.6f) <= 1e-5f);
+
+    // Demand (0.3 per tick) outpaces regeneration (0.1), so the tile drains
+    manager.addOrganism(new Plant(2.0f, 100, 0.5f, 0.3f), 1, 1);
+    for (int tick = 0; tick < 5; ++tick) {
+        manager.update();
+    }
+    REQUIRE(soil.getNutrients(1, 1) < soil.getCapacity());
+    REQUIRE(soil.getTotal() < fullTotal);
+    WorldManager::resetInstance();
+}
+
+TEST_CASE("Decomposition enriches the soil around a death", "[Soil]") {
+    WorldManager::resetInstance();
+    WorldManager& manager = WorldManager::getInstance(9, 9, 1.0f);
+    const SoilField& soil = manager.getSoil();
+    double fullTotal = soil.getTotal();
+    float capacity = soil.getCapacity();
+
+    // Dies of old age on its first update, leaving 20% of 200 in the soil
+    manager.addOrganism(new Plant(200.0f, 1, 0.5f, 0.3f), 4, 4);
+    uint64_t deaths = manager.getMetrics().getTotal(MetricCounter::DEATHS_OLD_AGE);
+    manager.update();
+    REQUIRE(manager.getMetrics().getTotal(MetricCounter::DEATHS_OLD_AGE) == deaths + 1);
+
+    REQUIRE(soil.getTotal() > fullTotal + 30.0);
+    REQUIRE(soil.getNutrients(4, 4) > capacity);
+    REQUIRE(soil.getNutrients(4, 3) > capacity);
+    REQUIRE(soil.getNutrients(0, 0) == capacity);
+    WorldManager::resetInstance();
+}
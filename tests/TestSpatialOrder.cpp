@@ -0,0 +1,118 @@
+#include "catch2/catch_test_macros.hpp"
+#include "SpatialOrder.h"
+#include "TileLayout.h"
+#include "TimingWheel.h"
+#include "WorldManager.h"
+#include "Plant.h"
+#include "Animal.h"
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+// Plants on distinct random tiles, in random order
+std::vector<std::unique_ptr<Plant>> scatteredPlants(int width, int height, size_t count, unsigned seed) {
+    std::vector<int> tiles(static_cast<size_t>(width) * height);
+    for (size_t i = 0; i < tiles.size(); ++i) {
+        tiles[i] = static_cast<int>(i);
+    }
+    std::mt19937 rng(seed);
+    std::shuffle(tiles.begin(), tiles.end(), rng);
+
+    std::vector<std::unique_ptr<Plant>> plants;
+    for (size_t i = 0; i < count; ++i) {
+        plants.emplace_back(new Plant(5.0f, 100, 0.5f, 0.3f));
+        plants.back()->setPosition(Position(tiles[i] % width, tiles[i] / width));
+    }
+    return plants;
+}
+
+size_t keyOf(const Organism* organism, const TileLayout& layout) {
+    return layout.index(organism->getPosition().getX(), organism->getPosition().getY());
+}
+}
+
+TEST_CASE("Spatial order sorts organisms by tile key", "[SpatialOrder]") {
+    const GridLayout kinds[] = {GridLayout::ROW_MAJOR, GridLayout::BLOCKED};
+    for (GridLayout kind : kinds) {
+        // Tall enough that keys need more than one radix digit
+        TileLayout layout(kind, 90, 70);
+        auto plants = scatteredPlants(90, 70, 3000, 7);
+        std::vector<Organism*> organisms;
+        for (auto& plant : plants) {
+            organisms.push_back(plant.get());
+        }
+
+        SpatialOrder order;
+        order.sort(organisms, layout);
+        REQUIRE(organisms.size() == plants.size());
+        for (size_t i = 1; i < organisms.size(); ++i) {
+            REQUIRE(keyOf(organisms[i - 1], layout) < keyOf(organisms[i], layout));
+        }
+        REQUIRE(order.getSortCount() == 1);
+        REQUIRE(order.getSortedOrganisms() == plants.size());
+    }
+}
+
+TEST_CASE("Timing wheel slots can be put in tile order", "[SpatialOrder]") {
+    TileLayout layout(GridLayout::BLOCKED, 40, 40);
+    auto plants = scatteredPlants(40, 40, 500, 9);
+    TimingWheel wheel;
+    for (size_t i = 0; i < plants.size(); ++i) {
+        // Spread over both wheel levels and the current tick
+        wheel.schedule(plants[i].get(), static_cast<uint64_t>(i % 3) * 50);
+    }
+
+    SpatialOrder order;
+    wheel.reorderSlots([&](std::vector<Organism*>& slot) {
+        order.sort(slot, layout);
+    });
+    REQUIRE(order.getSortCount() == 3);
+    REQUIRE(wheel.size() == plants.size());
+
+    size_t delivered = 0;
+    while (wheel.size() > 0) {
+        std::vector<Organism*> due;
+        wheel.advance(due);
+        for (size_t i = 1; i < due.size(); ++i) {
+            REQUIRE(keyOf(due[i - 1], layout) < keyOf(due[i], layout));
+        }
+        delivered += due.size();
+    }
+    REQUIRE(delivered == plants.size());
+}
+
+TEST_CASE("World updates organisms in tile order", "[SpatialOrder]") {
+    WorldManager::resetInstance();
+    WorldManager& manager = WorldManager::getInstance(24, 24, 1.0f);
+    manager.setSpatialSortInterval(8);
+    // Added bottom-up so insertion order is the reverse of tile order
+    size_t added = 0;
+    for (int y = 23; y >= 0; y -= 3) {
+        for (int x = 23; x >= 0; x -= 2) {
+            manager.addOrganism(new Plant(20.0f, 100, 0.5f, 0.3f), x, y);
+            ++added;
+        }
+    }
+    manager.update();
+    REQUIRE(manager.getSpatialOrder().getSortCount() >= 2);
+
+    CompactOrganismStore store;
+    manager.packOrganisms(store);
+    // The list was sorted at the start of the tick and spawned plants are
+    // appended, so the original plants lead in tile order
+    REQUIRE(store.size() >= added);
+    REQUIRE(store[0].getTileIndex() == static_cast<uint32_t>(2 * 24 + 1));
+    for (size_t i = 1; i < added; ++i) {
+        REQUIRE(store[i - 1].getTileIndex() < store[i].getTileIndex());
+    }
+
+    manager.setSpatialSortInterval(0);
+    size_t sorts = manager.getSpatialOrder().getSortCount();
+    manager.update();
+    REQUIRE(manager.getSpatialOrder().getSortCount() == sorts);
+    REQUIRE_THROWS_AS(manager.setSpatialSortInterval(-1), std::invalid_argument);
+    WorldManager::resetInstance();
+}
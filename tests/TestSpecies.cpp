@@ -0,0 +1,81 @@
+#include "catch2/catch_test_macros.hpp"
+#include "Species.h"
+#include "Animal.h"
+#include "Plant.h"
+#include <cmath>
+#include <memory>
+
+TEST_CASE("Species registry interns identical descriptors", "[Species]") {
+    Species wolf = Species::animal(90, 3, 6, AnimalType::CARNIVORE, 1.7f, 28.0f, 14);
+    uint16_t first = SpeciesRegistry::intern(wolf);
+    uint16_t second = SpeciesRegistry::intern(wolf);
+    REQUIRE(first == second);
+
+    Species heavierWolf = wolf;
+    heavierWolf.mass = 15;
+    REQUIRE(SpeciesRegistry::intern(heavierWolf) != first);
+
+    const Species& stored = SpeciesRegistry::get(first);
+    REQUIRE(stored == wolf);
+    REQUIRE(stored.type == OrganismType::ANIMAL);
+}
+
+TEST_CASE("Organisms share their species descriptor", "[Species]") {
+    Animal a(20.0f, 80, 2, 5, AnimalType::HERBIVORE, 1.5f, 25.0f, 10);
+    Animal b(35.0f, 80, 2, 5, AnimalType::HERBIVORE, 1.5f, 25.0f, 10);
+    Plant p(10.0f, 100, 0.5f, 0.3f);
+    Plant q(12.0f, 100, 0.5f, 0.3f);
+
+    REQUIRE(a.getSpeciesId() == b.getSpeciesId());
+    REQUIRE(&a.getSpecies() == &b.getSpecies());
+    REQUIRE(p.getSpeciesId() == q.getSpeciesId());
+    REQUIRE(p.getSpeciesId() != a.getSpeciesId());
+
+    SECTION("Setters move only the changed organism to another species") {
+        a.setVisionDistance(7);
+        REQUIRE(a.getVisionDistance() == 7);
+        REQUIRE(b.getVisionDistance() == 5);
+        REQUIRE(a.getSpeciesId() != b.getSpeciesId());
+        REQUIRE(a.getNutrientRequirement() == 1.5f);
+    }
+
+    SECTION("Offspring keep the parent species and vary inline") {
+        Animal parent(60.0f, 80, 4, 5, AnimalType::HERBIVORE, 1.5f, 25.0f, 10);
+        std::unique_ptr<Organism> child(parent.reproduce());
+        REQUIRE(child != nullptr);
+        REQUIRE(child->getSpeciesId() == parent.getSpeciesId());
+
+        Plant seedParent(20.0f, 100, 0.5f, 0.3f);
+        std::unique_ptr<Organism> seedling(seedParent.reproduce());
+        REQUIRE(seedling != nullptr);
+        REQUIRE(seedling->getSpeciesId() == seedParent.getSpeciesId());
+        REQUIRE(seedling->getMaxLifespan() == 100);
+    }
+}
+
+TEST_CASE("Quantized trait deltas", "[Species]") {
+    SECTION("Species value round-trips exactly") {
+        REQUIRE(encodeTraitDelta(1.5f, 1.5f) == 0);
+        REQUIRE(decodeTraitDelta(1.5f, 0) == 1.5f);
+    }
+
+    SECTION("Variations stay within one quantization step") {
+        for (float factor : {0.8f, 0.93f, 1.0f, 1.07f, 1.2f, 3.5f}) {
+            float value = 2.0f * factor;
+            float decoded = decodeTraitDelta(2.0f, encodeTraitDelta(2.0f, value));
+            REQUIRE(std::fabs(decoded - value) <= 2.0f / TRAIT_DELTA_STEPS);
+        }
+    }
+
+    SECTION("Out of range values saturate") {
+        REQUIRE(decodeTraitDelta(1.0f, encodeTraitDelta(1.0f, -5.0f)) > 0.0f);
+        REQUIRE(decodeTraitDelta(1.0f, encodeTraitDelta(1.0f, 100.0f)) < 34.0f);
+    }
+}
+
+TEST_CASE("Flyweight organisms stay compact", "[Species]") {
+    if (sizeof(void*) == 8) {
+        REQUIRE(sizeof(Animal) <= 32);
+        REQUIRE(sizeof(Plant) <= 32);
+    }
+}
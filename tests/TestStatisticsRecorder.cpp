@@ -0,0 +1,196 @@
+#include "catch2/catch_test_macros.hpp"
+#include "StatisticsRecorder.h"
+#include "WorldManager.h"
+#include "Animal.h"
+#include "Plant.h"
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+StatisticsRecorder::Sample sampleWith(float plants, float births) {
+    StatisticsRecorder::Sample sample;
+    for (float& value : sample.values) {
+        value = 0.0f;
+    }
+    sample.values[static_cast<size_t>(StatColumn::PLANTS)] = plants;
+    sample.values[static_cast<size_t>(StatColumn::BIRTHS)] = births;
+    return sample;
+}
+
+std::string tempPath(const std::string& name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+}
+
+TEST_CASE("Statistics samples describe the population", "[Statistics]") {
+    std::vector<Organism*> organisms;
+    for (int i = 1; i <= 10; ++i) {
+        Plant* plant = new Plant(static_cast<float>(i), 100, 0.5f, 0.3f);
+        plant->incrementAge(i * 2);
+        organisms.push_back(plant);
+    }
+    organisms.push_back(new Animal(5.5f, 80, 2, 5, AnimalType::CARNIVORE, 1.0f, 20.0f, 5));
+
+    StatisticsRecorder recorder;
+    StatisticsRecorder::Sample sample;
+    recorder.buildSample(organisms, sample);
+
+    auto value = [&sample](StatColumn column) { return sample.values[static_cast<size_t>(column)]; };
+    REQUIRE(value(StatColumn::PLANTS) == 10.0f);
+    REQUIRE(value(StatColumn::CARNIVORES) == 1.0f);
+    REQUIRE(value(StatColumn::HERBIVORES) == 0.0f);
+    REQUIRE(std::fabs(value(StatColumn::NUTRIENTS_MEAN) - 5.5f) < 1e-5f);
+    // Nearest rank over 1..10 and 5.5
+    REQUIRE(value(StatColumn::NUTRIENTS_P50) == 5.5f);
+    REQUIRE(value(StatColumn::NUTRIENTS_P90) == 9.0f);
+    REQUIRE(value(StatColumn::AGE_MAX) == 20.0f);
+    REQUIRE(value(StatColumn::AGE_P50) == 10.0f);
+
+    for (Organism* organism : organisms) {
+        delete organism;
+    }
+}
+
+TEST_CASE("Statistics recorder downsamples", "[Statistics]") {
+    SECTION("Every Nth tick keeps the events in between") {
+        std::string path = tempPath("ecosystem_stats_nth.bin");
+        StatisticsOptions options;
+        options.intervalTicks = 3;
+        options.chunkRows = 2;
+
+        StatisticsRecorder recorder;
+        recorder.open(path, options);
+        for (uint64_t tick = 1; tick <= 10; ++tick) {
+            recorder.record(tick, sampleWith(static_cast<float>(tick), 1.0f));
+        }
+        recorder.close();
+
+        StatisticsTable table;
+        REQUIRE(StatisticsRecorder::readBinary(path, table));
+        REQUIRE(table.ticks == std::vector<uint64_t>{3, 6, 9});
+        int plants = table.find("plants");
+        int births = table.find("births");
+        REQUIRE(plants >= 0);
+        REQUIRE(table.columns[plants] == std::vector<float>{3.0f, 6.0f, 9.0f});
+        REQUIRE(table.columns[births] == std::vector<float>{3.0f, 3.0f, 3.0f});
+        std::remove(path.c_str());
+    }
+
+    SECTION("Windows report min, max and mean, including a partial last window") {
+        std::string path = tempPath("ecosystem_stats_window.bin");
+        StatisticsOptions options;
+        options.downsampling = StatisticsDownsampling::WINDOW;
+        options.intervalTicks = 4;
+
+        StatisticsRecorder recorder;
+        recorder.open(path, options);
+        REQUIRE(recorder.getColumnNames().size() == 3 * StatisticsRecorder::COLUMN_COUNT);
+        for (uint64_t tick = 1; tick <= 6; ++tick) {
+            recorder.record(tick, sampleWith(static_cast<float>(tick), 0.0f));
+        }
+        recorder.close();
+
+        StatisticsTable table;
+        REQUIRE(StatisticsRecorder::readBinary(path, table));
+        REQUIRE(table.ticks == std::vector<uint64_t>{4, 6});
+        REQUIRE(table.columns[table.find("plants_min")] == std::vector<float>{1.0f, 5.0f});
+        REQUIRE(table.columns[table.find("plants_max")] == std::vector<float>{4.0f, 6.0f});
+        REQUIRE(table.columns[table.find("plants_mean")] == std::vector<float>{2.5f, 5.5f});
+        std::remove(path.c_str());
+    }
+
+    SECTION("CSV fallback writes one row per kept tick") {
+        std::string path = tempPath("ecosystem_stats.csv");
+        StatisticsOptions options;
+        options.format = StatisticsFormat::CSV;
+        options.intervalTicks = 2;
+
+        StatisticsRecorder recorder;
+        recorder.open(path, options);
+        for (uint64_t tick = 1; tick <= 4; ++tick) {
+            recorder.record(tick, sampleWith(7.0f, 0.0f));
+        }
+        recorder.close();
+
+        std::ifstream in(path);
+        std::stringstream buffer;
+        buffer << in.rdbuf();
+        std::string csv = buffer.str();
+        REQUIRE(csv.find("tick,plants,herbivores") == 0);
+        REQUIRE(csv.find("\n2,7,") != std::string::npos);
+        REQUIRE(csv.find("\n4,7,") != std::string::npos);
+        REQUIRE(csv.find("\n3,") == std::string::npos);
+        std::remove(path.c_str());
+    }
+
+    SECTION("Binary files are little-endian") {
+        std::string path = tempPath("ecosystem_stats_layout.bin");
+        StatisticsOptions options;
+        StatisticsRecorder recorder;
+        recorder.open(path, options);
+        recorder.record(258, sampleWith(1.0f, 0.0f));
+        recorder.close();
+
+        std::ifstream in(path, std::ios::binary);
+        std::stringstream buffer;
+        buffer << in.rdbuf();
+        std::string bytes = buffer.str();
+        auto byteAt = [&bytes](size_t offset) { return static_cast<unsigned char>(bytes[offset]); };
+        const size_t columns = StatisticsRecorder::COLUMN_COUNT;
+        REQUIRE(bytes.compare(0, 8, "ECOSTATS") == 0);
+        // Version 1, then the column count
+        REQUIRE(byteAt(8) == 1);
+        REQUIRE(byteAt(11) == 0);
+        REQUIRE(byteAt(12) == columns);
+
+        size_t offset = 16;
+        for (size_t i = 0; i < columns; ++i) {
+            offset += 2 + byteAt(offset);
+        }
+        // One row, tick 258, then 1.0f (0x3f800000) for the plants column
+        REQUIRE(byteAt(offset) == 1);
+        REQUIRE(byteAt(offset + 4) == 2);
+        REQUIRE(byteAt(offset + 5) == 1);
+        REQUIRE(byteAt(offset + 12 + 2) == 0x80);
+        REQUIRE(byteAt(offset + 12 + 3) == 0x3f);
+        std::remove(path.c_str());
+    }
+
+    SECTION("Invalid options are rejected") {
+        StatisticsRecorder recorder;
+        StatisticsOptions options;
+        options.intervalTicks = 0;
+        REQUIRE_THROWS_AS(recorder.open(tempPath("ecosystem_stats_bad.bin"), options), std::invalid_argument);
+        REQUIRE_FALSE(recorder.isEnabled());
+    }
+}
+
+TEST_CASE("World records statistics every tick", "[Statistics]") {
+    WorldManager::resetInstance();
+    WorldManager& manager = WorldManager::getInstance(8, 8, 1.0f);
+    manager.addOrganism(new Plant(5.0f, 100, 0.5f, 0.3f), 2, 2);
+    manager.addOrganism(new Plant(5.0f, 100, 0.5f, 0.3f), 5, 5);
+
+    std::string path = tempPath("ecosystem_stats_world.bin");
+    manager.configureStatistics(path, StatisticsOptions());
+    for (int i = 0; i < 5; ++i) {
+        manager.update();
+    }
+    manager.closeStatistics();
+
+    StatisticsTable table;
+    REQUIRE(StatisticsRecorder::readBinary(path, table));
+    REQUIRE(table.ticks.size() == 5);
+    REQUIRE(table.ticks.back() == 5);
+    REQUIRE(table.columns[table.find("plants")].back() ==
+            static_cast<float>(manager.getMetrics().getGauge(MetricGauge::PLANTS)));
+
+    std::remove(path.c_str());
+    WorldManager::resetInstance();
+}
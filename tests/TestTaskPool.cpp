@@ -0,0 +1,158 @@
+#include "catch2/catch_test_macros.hpp"
+#include "TaskPool.h"
+#include "WorldManager.h"
+#include "Plant.h"
+#include "Animal.h"
+#include <atomic>
+#include <chrono>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+TEST_CASE("Parallel loops visit every index once", "[TaskPool]") {
+    TaskPool pool(3);
+    REQUIRE(pool.getWorkerCount() == 3);
+    REQUIRE(pool.getParticipantCount() == 4);
+
+    for (size_t grain : {size_t(1), size_t(7), size_t(64), size_t(5000)}) {
+        std::vector<std::atomic<int>> visits(1000);
+        std::atomic<bool> participantsInRange(true);
+        pool.parallelFor(visits.size(), grain, [&](size_t begin, size_t end, int participant) {
+            if (participant < 0 || participant >= pool.getParticipantCount()) {
+                participantsInRange = false;
+            }
+            for (size_t i = begin; i < end; ++i) {
+                ++visits[i];
+            }
+        });
+        REQUIRE(participantsInRange);
+        for (const std::atomic<int>& count : visits) {
+            REQUIRE(count == 1);
+        }
+    }
+    REQUIRE(pool.currentParticipant() == 0);
+}
+
+TEST_CASE("Parallel loops nest and run detached jobs", "[TaskPool]") {
+    TaskPool pool(2, true);
+    std::atomic<size_t> inner(0);
+    pool.parallelFor(8, 1, [&](size_t begin, size_t end, int) {
+        for (size_t i = begin; i < end; ++i) {
+            pool.parallelFor(100, 10, [&](size_t first, size_t last, int) {
+                inner += last - first;
+            });
+        }
+    });
+    REQUIRE(inner == 800);
+
+    std::atomic<int> jobs(0);
+    for (int i = 0; i < 20; ++i) {
+        pool.submit([&jobs]() { ++jobs; });
+    }
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (jobs < 20 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::yield();
+    }
+    REQUIRE(jobs == 20);
+}
+
+TEST_CASE("Idle workers go to sleep", "[TaskPool]") {
+    TaskPool pool(2);
+    pool.parallelFor(64, 1, [](size_t, size_t, int) {});
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (pool.getSleepingWorkers() < pool.getWorkerCount() && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    REQUIRE(pool.getSleepingWorkers() == pool.getWorkerCount());
+
+    // And wake up for the next loop
+    std::atomic<size_t> items(0);
+    pool.parallelFor(64, 1, [&](size_t begin, size_t end, int) { items += end - begin; });
+    REQUIRE(items == 64);
+}
+
+TEST_CASE("Exceptions from loop bodies reach the caller", "[TaskPool]") {
+    TaskPool pool(3);
+    std::atomic<size_t> visited(0);
+    auto throwing = [&](size_t begin, size_t end, int) {
+        for (size_t i = begin; i < end; ++i) {
+            if (i == 537) throw std::runtime_error("item 537");
+            ++visited;
+        }
+    };
+    REQUIRE_THROWS_AS(pool.parallelFor(1000, 10, throwing), std::runtime_error);
+    // Everything before the throw in its chunk ran; later chunks may be skipped
+    REQUIRE(visited >= 7);
+    REQUIRE(visited < 1000);
+
+    // Also from a nested loop, and the pool keeps working afterwards
+    REQUIRE_THROWS_AS(pool.parallelFor(4, 1, [&](size_t, size_t, int) {
+        pool.parallelFor(100, 10, [](size_t begin, size_t, int) {
+            if (begin == 50) throw std::logic_error("inner");
+        });
+    }), std::logic_error);
+    std::atomic<size_t> items(0);
+    pool.parallelFor(500, 7, [&](size_t begin, size_t end, int) { items += end - begin; });
+    REQUIRE(items == 500);
+}
+
+TEST_CASE("Grain sizes follow the measured item cost", "[TaskPool]") {
+    GrainTuner tuner;
+    // Unmeasured loops get a few chunks per participant
+    REQUIRE(tuner.grainFor(1600, 4) == 100);
+
+    // Cheap items are not worth splitting at all
+    tuner.record(1000, 1000);
+    REQUIRE(tuner.grainFor(10000, 4) == 10000);
+
+    // Expensive ones are split down to the balancing limit
+    GrainTuner slow;
+    slow.record(10, 10 * 1000000);
+    REQUIRE(slow.grainFor(10000, 4) == 625);
+
+    TaskPool pool(2);
+    GrainTuner measured;
+    std::atomic<size_t> items(0);
+    pool.parallelFor(5000, measured, [&](size_t begin, size_t end, int) { items += end - begin; });
+    REQUIRE(items == 5000);
+    REQUIRE(measured.getNanosPerItem() > 0.0);
+}
+
+TEST_CASE("Parallel organism updates keep the grid consistent", "[TaskPool]") {
+    TaskPool::configureShared(3, false);
+    WorldManager::resetInstance();
+    WorldManager& manager = WorldManager::getInstance(30, 30, 1.0f);
+    for (int y = 0; y < 30; y += 2) {
+        for (int x = 0; x < 30; x += 3) {
+            if ((x + y) % 4 == 0) {
+                manager.addOrganism(new Animal(30.0f, 80, 2, 4, static_cast<AnimalType>((x + y) % 3), 1.0f, 40.0f, 5), x, y);
+            } else {
+                manager.addOrganism(new Plant(12.0f, 100, 0.5f, 0.3f), x, y);
+            }
+        }
+    }
+    REQUIRE(manager.logsOrganismUpdates());
+    manager.setParallelUpdates(true);
+    REQUIRE(manager.hasParallelUpdates());
+    REQUIRE_FALSE(manager.logsOrganismUpdates());
+
+    for (int tick = 0; tick < 20; ++tick) {
+        manager.update();
+    }
+
+    CompactOrganismStore store;
+    manager.packOrganisms(store);
+    REQUIRE(static_cast<int>(store.size()) == manager.getOrganismCount());
+    std::set<uint32_t> tiles;
+    for (size_t i = 0; i < store.size(); ++i) {
+        // No two organisms ever end up on one tile
+        REQUIRE(tiles.insert(store[i].getTileIndex()).second);
+    }
+    const PopulationAggregates& aggregates = manager.getAggregates();
+    REQUIRE(aggregates.getTotalCount() == static_cast<int64_t>(manager.getOrganismCount()));
+
+    manager.setParallelUpdates(false);
+    WorldManager::resetInstance();
+}
@@ -0,0 +1,113 @@
+#include "catch2/catch_test_macros.hpp"
+#include "TickProfiler.h"
+#include "WorldManager.h"
+#include "Plant.h"
+#include "Animal.h"
+#include <sstream>
+#include <string>
+
+TEST_CASE("Latency histogram statistics", "[Profiler]") {
+    SECTION("Empty histogram reports zeros") {
+        LatencyHistogram histogram;
+        REQUIRE(histogram.getCount() == 0);
+        REQUIRE(histogram.getMin() == 0);
+        REQUIRE(histogram.getMax() == 0);
+        REQUIRE(histogram.getPercentile(50.0) == 0);
+    }
+
+    SECTION("Small values are recorded exactly") {
+        LatencyHistogram histogram;
+        for (uint64_t v = 1; v <= 20; ++v) {
+            histogram.record(v);
+        }
+
+        REQUIRE(histogram.getCount() == 20);
+        REQUIRE(histogram.getMin() == 1);
+        REQUIRE(histogram.getMax() == 20);
+        REQUIRE(histogram.getPercentile(50.0) == 10);
+        REQUIRE(histogram.getPercentile(100.0) == 20);
+    }
+
+    SECTION("Large values stay within relative error bound") {
+        LatencyHistogram histogram;
+        for (uint64_t v = 1; v <= 1000; ++v) {
+            histogram.record(v * 1000);
+        }
+
+        uint64_t p90 = histogram.getPercentile(90.0);
+        REQUIRE(p90 >= 900000 * 97 / 100);
+        REQUIRE(p90 <= 900000 * 103 / 100);
+        REQUIRE(histogram.getMax() == 1000000);
+    }
+
+    SECTION("Reset clears samples") {
+        LatencyHistogram histogram;
+        histogram.record(500);
+        histogram.reset();
+        REQUIRE(histogram.getCount() == 0);
+        REQUIRE(histogram.getMax() == 0);
+    }
+}
+
+TEST_CASE("Tick profiler records phases", "[Profiler]") {
+    SECTION("Disabled scoped timer records nothing") {
+        TickProfiler profiler;
+        {
+            ScopedPhaseTimer timer(profiler, TickPhase::REMOVE_DEAD);
+        }
+        REQUIRE(profiler.getHistogram(TickPhase::REMOVE_DEAD).getCount() == 0);
+    }
+
+    SECTION("Enabled scoped timer records one sample") {
+        TickProfiler profiler;
+        profiler.setEnabled(true);
+        {
+            ScopedPhaseTimer timer(profiler, TickPhase::REMOVE_DEAD);
+        }
+        REQUIRE(profiler.getHistogram(TickPhase::REMOVE_DEAD).getCount() == 1);
+    }
+
+    SECTION("Table and JSON output name every phase") {
+        TickProfiler profiler;
+        profiler.record(TickPhase::ORGANISM_UPDATE, 1200);
+
+        std::ostringstream table;
+        profiler.writeTable(table);
+        REQUIRE(table.str().find("organism_update") != std::string::npos);
+        REQUIRE(table.str().find("omnivore_update") != std::string::npos);
+
+        std::ostringstream json;
+        profiler.writeJson(json);
+        REQUIRE(json.str().find("\"name\":\"organism_update\",\"count\":1") != std::string::npos);
+    }
+}
+
+TEST_CASE("World update feeds the tick profiler", "[Profiler]") {
+    WorldManager& manager = WorldManager::getInstance(10, 10, 2.0f);
+    TickProfiler& profiler = manager.getProfiler();
+    profiler.reset();
+    profiler.setEnabled(true);
+
+    if (manager.getGrid().getTile(0, 9).isEmpty()) {
+        manager.addOrganism(new Plant(5.0f, 100, 0.5f, 0.3f), 0, 9);
+    }
+    if (manager.getGrid().getTile(9, 0).isEmpty()) {
+        manager.addOrganism(new Animal(20.0f, 80, 2, 3, AnimalType::HERBIVORE, 1.0f, 30.0f, 5), 9, 0);
+    }
+
+    manager.update();
+    profiler.setEnabled(false);
+
+    if (PROFILING_COMPILED_IN) {
+        REQUIRE(profiler.getHistogram(TickPhase::TICK_TOTAL).getCount() == 1);
+        REQUIRE(profiler.getHistogram(TickPhase::ORGANISM_UPDATE).getCount() == 1);
+        REQUIRE(profiler.getHistogram(TickPhase::REMOVE_DEAD).getCount() == 1);
+        REQUIRE(profiler.getHistogram(TickPhase::DECOMPOSITION_SPAWN).getCount() == 1);
+        REQUIRE(profiler.getHistogram(TickPhase::PLANT_UPDATE).getCount() == 1);
+    }
+
+    manager.update();
+    REQUIRE(profiler.getHistogram(TickPhase::TICK_TOTAL).getCount() <= 1);
+
+    WorldManager::resetInstance();
+}
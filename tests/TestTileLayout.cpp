@@ -0,0 +1,147 @@
+#include "catch2/catch_test_macros.hpp"
+#include "TileLayout.h"
+#include "FoodSearch.h"
+#include "Grid.h"
+#include "Plant.h"
+#include "Animal.h"
+#include "WorldManager.h"
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+TEST_CASE("Tile layouts map every tile to its own slot", "[TileLayout]") {
+    const int sizes[][2] = {{1, 1}, {20, 20}, {64, 8}, {8, 64}, {37, 91}, {130, 17}};
+
+    for (const auto& size : sizes) {
+        int width = size[0];
+        int height = size[1];
+        TileLayout rowMajor(GridLayout::ROW_MAJOR, width, height);
+        TileLayout blocked(GridLayout::BLOCKED, width, height);
+        REQUIRE(rowMajor.getStorageSize() == static_cast<size_t>(width) * height);
+        REQUIRE(blocked.getStorageSize() >= static_cast<size_t>(width) * height);
+        // Under 2x padding per axis on top of whole blocks
+        size_t paddedWidth = (width + 7) / 8 * 8;
+        size_t paddedHeight = (height + 7) / 8 * 8;
+        REQUIRE(blocked.getStorageSize() < paddedWidth * paddedHeight * 4);
+
+        std::vector<int> seen(blocked.getStorageSize(), 0);
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                REQUIRE(rowMajor.index(x, y) == static_cast<size_t>(y) * width + x);
+                size_t index = blocked.index(x, y);
+                REQUIRE(index < blocked.getStorageSize());
+                REQUIRE(++seen[index] == 1);
+                // Each 8x8 block is one contiguous run
+                REQUIRE(index - blocked.blockBase(x, y) == static_cast<size_t>((y % 8) * 8 + x % 8));
+            }
+        }
+    }
+
+    REQUIRE_THROWS_AS(TileLayout(GridLayout::BLOCKED, 0, 4), std::invalid_argument);
+}
+
+TEST_CASE("Blocks follow the Z curve", "[TileLayout]") {
+    TileLayout layout(GridLayout::BLOCKED, 32, 32);
+    REQUIRE(layout.blockBase(0, 0) == 0);
+    REQUIRE(layout.blockBase(8, 0) == 64);
+    REQUIRE(layout.blockBase(0, 8) == 128);
+    REQUIRE(layout.blockBase(8, 8) == 192);
+    REQUIRE(layout.blockBase(16, 0) == 256);
+
+    // A 4x1 block strip has no y bits, so its blocks are simply consecutive
+    TileLayout strip(GridLayout::BLOCKED, 32, 8);
+    REQUIRE(strip.blockBase(24, 0) == 192);
+}
+
+TEST_CASE("Window blocks are visited in storage order", "[TileLayout]") {
+    TileLayout layout(GridLayout::BLOCKED, 100, 43);
+    std::mt19937 rng(5);
+    for (int trial = 0; trial < 200; ++trial) {
+        int x0 = static_cast<int>(rng() % 100);
+        int y0 = static_cast<int>(rng() % 43);
+        int x1 = x0 + static_cast<int>(rng() % (100 - x0));
+        int y1 = y0 + static_cast<int>(rng() % (43 - y0));
+
+        std::vector<size_t> bases;
+        layout.forEachBlock(x0, y0, x1, y1, [&](int blockX, int blockY) {
+            REQUIRE(blockX % 8 == 0);
+            REQUIRE(blockY % 8 == 0);
+            bases.push_back(layout.blockBase(blockX, blockY));
+        });
+
+        size_t expected = static_cast<size_t>(x1 / 8 - x0 / 8 + 1) * (y1 / 8 - y0 / 8 + 1);
+        REQUIRE(bases.size() == expected);
+        for (size_t i = 1; i < bases.size(); ++i) {
+            REQUIRE(bases[i - 1] < bases[i]);
+        }
+    }
+}
+
+TEST_CASE("Blocked searches match row-major searches", "[TileLayout]") {
+    const int width = 53;
+    const int height = 41;
+    std::mt19937 rng(3);
+    std::vector<FoodClass> rowMajor(width * height);
+    for (FoodClass& tile : rowMajor) {
+        // Sparse food so the wide windows are scanned to the end
+        int roll = static_cast<int>(rng() % 40);
+        tile = roll < FOOD_CLASS_COUNT ? static_cast<FoodClass>(roll) : FOOD_CLASS_EMPTY;
+    }
+    TileLayout layout(GridLayout::BLOCKED, width, height);
+    std::vector<FoodClass> blocked(layout.getStorageSize(), FOOD_CLASS_EMPTY);
+    layout.scatter(rowMajor.data(), blocked.data());
+
+    const DietMask herbivore = DIET_TABLE[0];
+    const DietMask carnivore = DIET_TABLE[1];
+    for (int trial = 0; trial < 400; ++trial) {
+        int x = static_cast<int>(rng() % width);
+        int y = static_cast<int>(rng() % height);
+        int vision = 1 + static_cast<int>(rng() % 40);
+        REQUIRE(FoodSearch::nearestFoodBlocked<herbivore>(blocked.data(), layout, x, y, vision) ==
+                FoodSearch::nearestFood<herbivore>(rowMajor.data(), width, height, x, y, vision));
+        REQUIRE(FoodSearch::nearestFoodBlocked<carnivore>(blocked.data(), layout, x, y, vision) ==
+                FoodSearch::nearestFood<carnivore>(rowMajor.data(), width, height, x, y, vision));
+        REQUIRE(FoodSearch::adjacentFoodBlocked<carnivore>(blocked.data(), layout, x, y) ==
+                FoodSearch::adjacentFood<carnivore>(rowMajor.data(), width, height, x, y));
+        REQUIRE(FoodSearch::emptyNeighborMaskBlocked(blocked.data(), layout, x, y) ==
+                FoodSearch::emptyNeighborMask(rowMajor.data(), width, height, x, y));
+    }
+}
+
+TEST_CASE("Grid keeps its blocked copy current", "[TileLayout]") {
+    Grid grid(20, 12);
+    Plant early(5.0f, 100, 0.5f, 0.3f);
+    grid.getTile(3, 4).setOccupant(early);
+
+    grid.setLayout(GridLayout::BLOCKED);
+    const TileLayout& layout = grid.getLayout();
+    REQUIRE(layout.getKind() == GridLayout::BLOCKED);
+    REQUIRE(grid.getLayoutFoodClasses()[layout.index(3, 4)] == FOOD_CLASS_PLANT);
+
+    Plant late(5.0f, 100, 0.5f, 0.3f);
+    grid.getTile(17, 9).setOccupant(late);
+    grid.getTile(3, 4).clearOccupant();
+    for (int y = 0; y < 12; ++y) {
+        for (int x = 0; x < 20; ++x) {
+            REQUIRE(grid.getLayoutFoodClasses()[layout.index(x, y)] == grid.getFoodClasses()[y * 20 + x]);
+        }
+    }
+    REQUIRE(FoodSearch::nearestFood(AnimalType::HERBIVORE, grid, 15, 8, 5) == 9 * 20 + 17);
+
+    grid.setLayout(GridLayout::ROW_MAJOR);
+    REQUIRE(grid.getLayoutFoodClasses() == grid.getFoodClasses());
+}
+
+TEST_CASE("Switching the world's layout keeps the memory account exact", "[TileLayout]") {
+    WorldManager::resetInstance();
+    WorldManager& manager = WorldManager::getInstance(30, 30, 1.0f);
+    const MemoryAccounting& memory = manager.getMemoryAccounting();
+    uint64_t before = memory.getUsage(MemorySubsystem::GRID).liveBytes;
+
+    manager.setGridLayout(GridLayout::BLOCKED);
+    REQUIRE(memory.getUsage(MemorySubsystem::GRID).liveBytes >= before + 30 * 30);
+
+    manager.setGridLayout(GridLayout::ROW_MAJOR);
+    REQUIRE(memory.getUsage(MemorySubsystem::GRID).liveBytes == before);
+    WorldManager::resetInstance();
+}
@@ -3,7 +3,11 @@
 #include "Grid.h"
 #include "Plant.h"
 #include "Animal.h"
+#include "FoodSearch.h"
+#include <memory>
+#include <random>
 #include <stdexcept>
+#include <vector>
 
 TEST_CASE("Tile basic functionality", "[Tile]") {
     Position pos(5, 10);
@@ -201,4 +205,75 @@ TEST_CASE("Grid finding closest organism", "[Grid]") {
         delete plant1;
         delete plant2;
     }
-}
\ No newline at end of file
+}
+
+TEST_CASE("Halo class bytes mirror the grid inside a border", "[Grid]") {
+    const int width = 13;
+    const int height = 9;
+    Grid grid(width, height);
+    const FoodClass* halo = grid.getHaloFoodClasses();
+    const size_t stride = grid.getHaloStride();
+    REQUIRE(stride == static_cast<size_t>(width) + 2);
+
+    // Every tile's 8 neighbors can be read, including those past the edge
+    for (int y = -1; y <= height; ++y) {
+        for (int x = -1; x <= width; ++x) {
+            FoodClass expected = grid.isInBounds(x, y) ? FOOD_CLASS_EMPTY : FOOD_CLASS_BORDER;
+            REQUIRE(halo[static_cast<ptrdiff_t>(y) * static_cast<ptrdiff_t>(stride) + x] == expected);
+        }
+    }
+
+    Plant plant(10.0f, 100, 0.5f, 0.3f);
+    grid.getTile(0, 8).setOccupant(plant);
+    REQUIRE(halo[8 * stride + 0] == FOOD_CLASS_PLANT);
+    grid.getTile(0, 8).clearOccupant();
+    REQUIRE(halo[8 * stride + 0] == FOOD_CLASS_EMPTY);
+}
+
+TEST_CASE("Halo neighbor kernels match the bounds-tested ones", "[Grid]") {
+    const int width = 19;
+    const int height = 11;
+    Grid grid(width, height);
+    std::vector<std::unique_ptr<Organism>> occupants;
+    std::mt19937 rng(13);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            int roll = static_cast<int>(rng() % 8);
+            Organism* organism = nullptr;
+            if (roll == 0) {
+                organism = new Plant(10.0f, 100, 0.5f, 0.3f);
+            } else if (roll <= ANIMAL_TYPE_COUNT) {
+                organism = new Animal(20.0f, 80, 2, 5, static_cast<AnimalType>(roll - 1), 1.0f, 30.0f, 5);
+            }
+            if (organism != nullptr) {
+                grid.getTile(x, y).setOccupant(*organism);
+                occupants.emplace_back(organism);
+            }
+        }
+    }
+
+    const FoodClass* classes = grid.getFoodClasses();
+    const FoodClass* halo = grid.getHaloFoodClasses();
+    const size_t stride = grid.getHaloStride();
+    const DietMask herbivore = DIET_TABLE[0];
+    const DietMask omnivore = DIET_TABLE[2];
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            REQUIRE(FoodSearch::adjacentFoodHalo<herbivore>(halo, stride, width, x, y) ==
+                    FoodSearch::adjacentFood<herbivore>(classes, width, height, x, y));
+            REQUIRE(FoodSearch::adjacentFoodHalo<omnivore>(halo, stride, width, x, y) ==
+                    FoodSearch::adjacentFood<omnivore>(classes, width, height, x, y));
+            REQUIRE(FoodSearch::emptyNeighborMaskHalo(halo, stride, x, y) ==
+                    FoodSearch::emptyNeighborMask(classes, width, height, x, y));
+        }
+    }
+}
+
+#ifndef NDEBUG
+TEST_CASE("Unchecked tile access is still checked in debug builds", "[Grid]") {
+    Grid grid(5, 5);
+    REQUIRE(&grid.tileAt(4, 2) == &grid.getTile(4, 2));
+    REQUIRE_THROWS_AS(grid.tileAt(5, 0), std::out_of_range);
+    REQUIRE_THROWS_AS(grid.tileAt(0, -1), std::out_of_range);
+}
+#endif
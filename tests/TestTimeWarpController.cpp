@@ -0,0 +1,104 @@
+#include "catch2/catch_test_macros.hpp"
+#include "TimeWarpController.h"
+#include <cmath>
+#include <stdexcept>
+
+TEST_CASE("Time warp paces ticks by the multiplier", "[TimeWarp]") {
+    TimeWarpController warp(10.0);
+    REQUIRE_THROWS_AS(TimeWarpController(0.0), std::invalid_argument);
+
+    // Cheap ticks: the budget never limits a fixed multiplier
+    warp.recordTicks(1, 1e-6);
+    warp.setMultiplier(4.0);
+    int total = 0;
+    for (int frame = 0; frame < 10; ++frame) {
+        total += warp.planTicks(0.1);
+    }
+    // One second at 4x the base pace
+    REQUIRE(total == static_cast<int>(4.0 * TimeWarpController::BASE_TICKS_PER_SECOND));
+    REQUIRE(warp.getDroppedTicks() == 0);
+
+    SECTION("Fractional ticks carry over between frames") {
+        warp.setMultiplier(0.25);
+        int slow = 0;
+        for (int frame = 0; frame < 20; ++frame) {
+            slow += warp.planTicks(0.1);
+        }
+        REQUIRE(slow == 1);
+    }
+
+    SECTION("Multiplier stays within its limits") {
+        warp.setMultiplier(1.0);
+        warp.slower();
+        REQUIRE(warp.getMultiplier() == 0.5);
+        for (int i = 0; i < 40; ++i) {
+            warp.faster();
+        }
+        REQUIRE(warp.getMultiplier() == TimeWarpController::MAX_MULTIPLIER);
+        warp.setMultiplier(0.0);
+        REQUIRE(warp.getMultiplier() == TimeWarpController::MIN_MULTIPLIER);
+    }
+}
+
+TEST_CASE("Time warp fills the frame budget from measured costs", "[TimeWarp]") {
+    TimeWarpController warp(10.0);
+    warp.setMaxSpeed(true);
+
+    // Nothing measured yet: a single probe tick
+    REQUIRE(warp.planTicks(0.1) == 1);
+
+    warp.recordTicks(10, 0.01);
+    warp.recordRender(0.02);
+    REQUIRE(std::fabs(warp.getTickBudgetSeconds() - 0.08) < 1e-9);
+    REQUIRE(warp.planTicks(0.1) == 80);
+
+    SECTION("Rendering cannot starve the simulation") {
+        warp.recordRender(10.0);
+        warp.recordRender(10.0);
+        REQUIRE(warp.getTickBudgetSeconds() == 0.1 * TimeWarpController::MIN_TICK_SHARE);
+        REQUIRE(warp.planTicks(0.1) == 25);
+    }
+
+    SECTION("A fixed multiplier the world cannot keep up with drops frames") {
+        warp.setMaxSpeed(false);
+        warp.setMultiplier(1024.0);
+        // 204 ticks owed, more than fit beside a render: the loop skips
+        // drawing and spends the whole frame on ticks
+        int ran = warp.planTicks(0.1);
+        REQUIRE(ran > 80);
+        REQUIRE_FALSE(warp.shouldRender());
+        REQUIRE(warp.getSkippedFrames() == 1);
+
+        // The rest is carried forward, not dropped
+        int total = ran;
+        int loops = 0;
+        do {
+            total += warp.planTicks(0.0);
+            ++loops;
+        } while (!warp.shouldRender() && loops < 10);
+        REQUIRE(warp.shouldRender());
+        REQUIRE(total == 204);
+        REQUIRE(warp.getDroppedTicks() == 0);
+
+        // A long stall still renders, and gives up only what exceeds the cap
+        warp.planTicks(5.0);
+        REQUIRE(warp.shouldRender());
+        REQUIRE(warp.getDroppedTicks() == static_cast<uint64_t>(5.0 * 2.0 * 1024.0 * (1.0 - 0.2)));
+        REQUIRE(warp.getTickDebt() <= 2.0 * 1024.0 * TimeWarpController::MAX_BACKLOG_SECONDS);
+        REQUIRE(warp.describe().find("/2048.0 ticks/s") != std::string::npos);
+    }
+
+    SECTION("Achieved rate is measured over wall time") {
+        TimeWarpController paced(10.0);
+        paced.recordTicks(1, 1e-6);
+        paced.setMultiplier(8.0);
+        for (int frame = 0; frame < 11; ++frame) {
+            int ticks = paced.planTicks(0.1);
+            paced.recordTicks(ticks, ticks * 1e-6);
+        }
+        REQUIRE(std::fabs(paced.getAchievedTicksPerSecond() - 16.0) < 2.5);
+        REQUIRE(paced.describe().find("x8") == 0);
+        REQUIRE(warp.describe().find("max") == 0);
+        REQUIRE(warp.describe().find("ticks/s") != std::string::npos);
+    }
+}
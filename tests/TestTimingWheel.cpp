@@ -0,0 +1,136 @@
+#include "catch2/catch_test_macros.hpp"
+#include "TimingWheel.h"
+#include "WorldManager.h"
+#include "Plant.h"
+#include "Animal.h"
+#include <memory>
+#include <vector>
+
+TEST_CASE("Timing wheel delivers each organism on its due tick", "[Scheduler]") {
+    // Delays straddle every level boundary and reach the overflow list
+    const uint64_t delays[] = {0, 1, 5, 63, 64, 65, 200, 4095, 4096, 5000, 262143, 262144, 300000,
+                               (uint64_t(1) << 24) + 3};
+    const size_t count = sizeof(delays) / sizeof(delays[0]);
+
+    TimingWheel wheel;
+    std::vector<std::unique_ptr<Plant>> plants;
+    for (size_t i = 0; i < count; ++i) {
+        plants.emplace_back(new Plant(5.0f, 100, 0.5f, 0.3f));
+        wheel.schedule(plants.back().get(), delays[i]);
+    }
+    REQUIRE(wheel.size() == count);
+
+    std::vector<Organism*> due;
+    size_t delivered = 0;
+    while (wheel.size() > 0) {
+        uint64_t tick = wheel.getCurrentTick();
+        due.clear();
+        wheel.advance(due);
+        for (Organism* organism : due) {
+            size_t index = 0;
+            while (plants[index].get() != organism) ++index;
+            REQUIRE(delays[index] == tick);
+            ++delivered;
+        }
+    }
+    REQUIRE(delivered == count);
+}
+
+TEST_CASE("Timing wheel cancels and reschedules", "[Scheduler]") {
+    TimingWheel wheel;
+    Plant a(5.0f, 100, 0.5f, 0.3f);
+    Plant b(5.0f, 100, 0.5f, 0.3f);
+
+    wheel.schedule(&a, 3);
+    wheel.schedule(&b, 70);
+    REQUIRE(wheel.isScheduled(&a));
+    REQUIRE(wheel.cancel(&b));
+    REQUIRE_FALSE(wheel.cancel(&b));
+    REQUIRE_FALSE(wheel.isScheduled(&b));
+
+    // Scheduling again moves the entry instead of adding a second one
+    wheel.schedule(&a, 1);
+    REQUIRE(wheel.size() == 1);
+
+    std::vector<Organism*> due;
+    wheel.advance(due);
+    REQUIRE(due.empty());
+    wheel.advance(due);
+    REQUIRE(due.size() == 1);
+    REQUIRE(due[0] == &a);
+    for (int tick = 0; tick < 100; ++tick) {
+        wheel.advance(due);
+    }
+    REQUIRE(due.size() == 1);
+    REQUIRE(wheel.getMemoryFootprint().bytes > 0);
+}
+
+TEST_CASE("Timing wheel cancels from a crowded slot", "[Scheduler]") {
+    // The whole population due on the same tick, as with interval-1 plants
+    const size_t count = 20000;
+    TimingWheel wheel;
+    std::vector<std::unique_ptr<Plant>> plants;
+    for (size_t i = 0; i < count; ++i) {
+        plants.emplace_back(new Plant(5.0f, 100, 0.5f, 0.3f));
+        wheel.schedule(plants.back().get(), 1);
+    }
+
+    // Cancels and moves leave holes; the survivors keep their order
+    for (size_t i = 0; i < count; i += 2) {
+        REQUIRE(wheel.cancel(plants[i].get()));
+    }
+    wheel.schedule(plants[1].get(), 100);
+    REQUIRE(wheel.size() == count / 2);
+
+    std::vector<Organism*> due;
+    wheel.advance(due);
+    wheel.advance(due);
+    REQUIRE(due.size() == count / 2 - 1);
+    for (size_t i = 0; i < due.size(); ++i) {
+        REQUIRE(due[i] == plants[2 * i + 3].get());
+    }
+    REQUIRE(wheel.size() == 1);
+
+    // Cancelled organisms may be scheduled again, and holes survive a cascade
+    wheel.schedule(plants[0].get(), 70);
+    REQUIRE(wheel.cancel(plants[1].get()));
+    for (int tick = 0; tick < 70; ++tick) {
+        due.clear();
+        wheel.advance(due);
+        REQUIRE(due.empty());
+    }
+    due.clear();
+    wheel.advance(due);
+    REQUIRE(due.size() == 1);
+    REQUIRE(due[0] == plants[0].get());
+    REQUIRE(wheel.size() == 0);
+}
+
+TEST_CASE("Organisms act at their own cadence", "[Scheduler]") {
+    REQUIRE(Plant(5.0f, 100, 0.5f, 0.3f).getActionInterval() == 1);
+    REQUIRE(Plant(5.0f, 100, 0.1f, 0.3f).getActionInterval() == 5);
+    REQUIRE(Animal(20.0f, 80, 2, 3, AnimalType::HERBIVORE, 1.0f, 30.0f, 5).getActionInterval() == 1);
+    REQUIRE(Animal(20.0f, 80, 1, 3, AnimalType::HERBIVORE, 1.0f, 30.0f, 5).getActionInterval() == 2);
+    REQUIRE(Animal(20.0f, 80, 0, 3, AnimalType::HERBIVORE, 1.0f, 30.0f, 5).getActionInterval() == 8);
+
+    WorldManager::resetInstance();
+    WorldManager& manager = WorldManager::getInstance(8, 8, 1.0f);
+    Plant* slow = new Plant(5.0f, 100, 0.1f, 0.3f);
+    Plant* fast = new Plant(5.0f, 100, 0.5f, 0.3f);
+    manager.addOrganism(slow, 1, 1);
+    manager.addOrganism(fast, 6, 6);
+
+    // Each action ages the plant by the ticks it covers
+    manager.update();
+    REQUIRE(slow->getAge() == 5);
+    REQUIRE(fast->getAge() == 1);
+    for (int tick = 1; tick < 5; ++tick) {
+        manager.update();
+    }
+    REQUIRE(slow->getAge() == 5);
+    REQUIRE(fast->getAge() == 5);
+    manager.update();
+    REQUIRE(slow->getAge() == 10);
+    REQUIRE(manager.getCurrentTick() == 6);
+    WorldManager::resetInstance();
+}
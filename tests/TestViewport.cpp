@@ -0,0 +1,180 @@
+#include "catch2/catch_test_macros.hpp"
+#include "OccupancyPyramid.h"
+#include "Viewport.h"
+#include "WorldManager.h"
+#include "Plant.h"
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+// Counts a class over the tiles a cell covers, straight from the grid
+uint32_t bruteCount(const std::vector<FoodClass>& tiles, int width, int height,
+                    int level, int cellX, int cellY, FoodClass foodClass) {
+    uint32_t count = 0;
+    for (int y = cellY << level; y < std::min(height, (cellY + 1) << level); ++y) {
+        for (int x = cellX << level; x < std::min(width, (cellX + 1) << level); ++x) {
+            count += tiles[static_cast<size_t>(y) * width + x] == foodClass ? 1 : 0;
+        }
+    }
+    return count;
+}
+
+void requireMatches(const OccupancyPyramid& pyramid, const std::vector<FoodClass>& tiles, int width, int height) {
+    for (int level = 0; level < pyramid.getLevelCount(); ++level) {
+        for (int y = 0; y < pyramid.getLevelHeight(level); ++y) {
+            for (int x = 0; x < pyramid.getLevelWidth(level); ++x) {
+                for (int c = FOOD_CLASS_PLANT; c < FOOD_CLASS_COUNT; ++c) {
+                    FoodClass foodClass = static_cast<FoodClass>(c);
+                    REQUIRE(pyramid.getCount(level, x, y, foodClass) ==
+                            bruteCount(tiles, width, height, level, x, y, foodClass));
+                }
+            }
+        }
+    }
+}
+}
+
+TEST_CASE("Occupancy pyramid counts classes per cell", "[Viewport]") {
+    const int width = 13;
+    const int height = 6;
+    std::vector<FoodClass> tiles(width * height, FOOD_CLASS_EMPTY);
+    std::mt19937 rng(7);
+    for (FoodClass& tile : tiles) {
+        tile = static_cast<FoodClass>(rng() % FOOD_CLASS_COUNT);
+    }
+
+    OccupancyPyramid pyramid(width, height, tiles.data());
+
+    SECTION("Levels halve until a single cell") {
+        REQUIRE(pyramid.getLevelCount() == 5);
+        REQUIRE(pyramid.getLevelWidth(1) == 7);
+        REQUIRE(pyramid.getLevelHeight(1) == 3);
+        REQUIRE(pyramid.getLevelWidth(4) == 1);
+        REQUIRE(pyramid.getLevelHeight(4) == 1);
+        REQUIRE(pyramid.getCellArea(4, 0, 0) == width * height);
+        REQUIRE(pyramid.getCellArea(1, 6, 2) == 2);
+        requireMatches(pyramid, tiles, width, height);
+    }
+
+    SECTION("Updates keep every level in step with the tiles") {
+        for (int i = 0; i < 500; ++i) {
+            size_t index = rng() % tiles.size();
+            FoodClass before = tiles[index];
+            tiles[index] = static_cast<FoodClass>(rng() % FOOD_CLASS_COUNT);
+            pyramid.update(static_cast<int>(index % width), static_cast<int>(index / width), before, tiles[index]);
+        }
+        requireMatches(pyramid, tiles, width, height);
+    }
+
+    SECTION("Majority and occupancy") {
+        std::vector<FoodClass> block = {
+            FOOD_CLASS_PLANT, FOOD_CLASS_EMPTY,
+            animalFoodClass(AnimalType::HERBIVORE), FOOD_CLASS_PLANT
+        };
+        OccupancyPyramid small(2, 2, block.data());
+        REQUIRE(small.getMajority(1, 0, 0) == FOOD_CLASS_PLANT);
+        REQUIRE(small.getOccupied(1, 0, 0) == 3);
+        REQUIRE(small.getMajority(0, 1, 0) == FOOD_CLASS_EMPTY);
+    }
+}
+
+TEST_CASE("The grid keeps its pyramid current", "[Viewport]") {
+    WorldManager::resetInstance();
+    WorldManager& manager = WorldManager::getInstance(9, 9, 1.0f);
+    manager.addOrganism(new Plant(5.0f, 100, 0.5f, 0.3f), 1, 1);
+    const OccupancyPyramid& pyramid = manager.enableOccupancyPyramid();
+    REQUIRE(&pyramid == manager.getGrid().getOccupancyPyramid());
+
+    manager.addOrganism(new Plant(5.0f, 100, 0.5f, 0.3f), 8, 8);
+    for (int i = 0; i < 20; ++i) {
+        manager.update();
+    }
+
+    const Grid& grid = manager.getGrid();
+    std::vector<FoodClass> tiles(grid.getFoodClasses(), grid.getFoodClasses() + 81);
+    requireMatches(pyramid, tiles, 9, 9);
+    int top = pyramid.getLevelCount() - 1;
+    REQUIRE(pyramid.getOccupied(top, 0, 0) == static_cast<uint32_t>(manager.getOrganismCount()));
+    WorldManager::resetInstance();
+}
+
+TEST_CASE("Viewport pans, zooms and picks a level", "[Viewport]") {
+    Viewport viewport(1000, 500, 200, 100, 1.0);
+
+    SECTION("Zoom keeps the anchor pixel on the same world point") {
+        double worldX = viewport.screenToWorldX(30.0);
+        double worldY = viewport.screenToWorldY(70.0);
+        viewport.zoom(4.0, 30.0, 70.0);
+        REQUIRE(viewport.getPixelsPerTile() == 4.0);
+        REQUIRE(std::fabs(viewport.worldToScreenX(worldX) - 30.0) < 1e-9);
+        REQUIRE(std::fabs(viewport.worldToScreenY(worldY) - 70.0) < 1e-9);
+    }
+
+    SECTION("Zoom is clamped") {
+        viewport.zoom(1000.0, 100.0, 50.0);
+        REQUIRE(viewport.getPixelsPerTile() == Viewport::MAX_PIXELS_PER_TILE);
+        viewport.fitWorld();
+        REQUIRE(viewport.getPixelsPerTile() == 0.2);
+        viewport.zoom(0.001, 100.0, 50.0);
+        REQUIRE(viewport.getPixelsPerTile() == 0.1);
+    }
+
+    SECTION("Panning moves the view by window pixels") {
+        double before = viewport.getCenterX();
+        viewport.pan(-50.0, 0.0);
+        REQUIRE(viewport.getCenterX() == before + 50.0);
+    }
+
+    SECTION("Each cell of the chosen level covers at least a pixel") {
+        REQUIRE(viewport.selectLevel(11) == 0);
+        viewport.fitWorld();
+        REQUIRE(viewport.selectLevel(11) == 3);
+        REQUIRE(viewport.selectLevel(2) == 1);
+    }
+
+    SECTION("Bad sizes are rejected") {
+        REQUIRE_THROWS_AS(Viewport(0, 10, 10, 10, 1.0), std::invalid_argument);
+        REQUIRE_THROWS_AS(Viewport(10, 10, 10, 10, 0.0), std::invalid_argument);
+    }
+}
+
+TEST_CASE("Viewport raster follows the window, not the world", "[Viewport]") {
+    const int width = 1024;
+    const int height = 1024;
+    std::vector<FoodClass> tiles(width * height, FOOD_CLASS_EMPTY);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width / 2; ++x) {
+            tiles[static_cast<size_t>(y) * width + x] = FOOD_CLASS_PLANT;
+        }
+    }
+    OccupancyPyramid pyramid(width, height, tiles.data());
+    Viewport viewport(width, height, 64, 32, 1.0);
+    ViewportRaster raster;
+
+    SECTION("Zoomed in, only visible tiles are drawn") {
+        viewport.zoom(8.0, 32.0, 16.0);
+        viewport.rasterize(pyramid, raster);
+        REQUIRE(raster.level == 0);
+        REQUIRE(raster.columns <= 64 / 8 + 1);
+        REQUIRE(raster.rows <= 32 / 8 + 1);
+        REQUIRE(raster.rgba.size() == static_cast<size_t>(raster.columns) * raster.rows * 4);
+    }
+
+    SECTION("Zoomed out, one texel per pyramid cell") {
+        viewport.fitWorld();
+        viewport.rasterize(pyramid, raster);
+        REQUIRE(raster.level == 5);
+        REQUIRE(raster.columns == 32);
+        REQUIRE(raster.rows == 32);
+        REQUIRE(raster.cellPixels == 1.0);
+        REQUIRE(std::fabs(raster.screenX - 16.0) < 1e-9);
+        // Left half is all plants, right half empty
+        REQUIRE(raster.rgba[0] == 0);
+        REQUIRE(raster.rgba[1] == 255);
+        size_t right = static_cast<size_t>(31) * 4;
+        REQUIRE(raster.rgba[right] == 200);
+        REQUIRE(raster.rgba[right + 3] == 255);
+    }
+}
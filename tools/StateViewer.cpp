@@ -0,0 +1,119 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include "SharedState.h"
+
+using namespace std;
+
+// Sample consumer of the shared-memory export: attaches to a running
+// simulation, prints per-class counts and mean soil nutrients of the latest
+// frame at a fixed interval and, for small worlds, an ASCII map.
+
+namespace {
+
+struct Options {
+    string name;
+    int intervalMs = 500;
+    long long frames = 0;
+    bool map = true;
+};
+
+void usage() {
+    cerr << "Usage: stateviewer NAME [--interval-ms N] [--frames N] [--no-map]\n"
+         << "  NAME is the segment given to the simulation's --shm flag, e.g. /ecosystem\n";
+}
+
+Options parseOptions(int argc, char* argv[]) {
+    if (argc < 2) {
+        usage();
+        exit(1);
+    }
+    Options options;
+    options.name = argv[1];
+    for (int i = 2; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--interval-ms" && i + 1 < argc) {
+            options.intervalMs = atoi(argv[++i]);
+        } else if (arg == "--frames" && i + 1 < argc) {
+            options.frames = atoll(argv[++i]);
+        } else if (arg == "--no-map") {
+            options.map = false;
+        } else {
+            usage();
+            exit(1);
+        }
+    }
+    return options;
+}
+
+char tileSymbol(FoodClass foodClass) {
+    switch (foodClass) {
+        case FOOD_CLASS_EMPTY: return '.';
+        case FOOD_CLASS_PLANT: return '*';
+        default: break;
+    }
+    switch (static_cast<AnimalType>(foodClass - FOOD_CLASS_FIRST_ANIMAL)) {
+        case AnimalType::HERBIVORE: return 'h';
+        case AnimalType::CARNIVORE: return 'c';
+        case AnimalType::OMNIVORE: return 'o';
+    }
+    return '?';
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    Options options = parseOptions(argc, argv);
+
+    SharedStateReader reader;
+    while (!reader.open(options.name)) {
+        cerr << "Waiting for " << options.name << "..." << endl;
+        this_thread::sleep_for(chrono::seconds(1));
+    }
+    int width = reader.getWidth();
+    int height = reader.getHeight();
+    cout << "Attached to " << options.name << ": " << width << "x" << height
+         << ", " << reader.getFrameCount() << " frames"
+         << (reader.hasNutrients() ? ", nutrients" : "") << endl;
+
+    SharedFrameCopy frame;
+    uint64_t lastTick = UINT64_MAX;
+    for (long long shown = 0; options.frames == 0 || shown < options.frames;) {
+        if (reader.copyLatest(frame) && frame.tick != lastTick) {
+            lastTick = frame.tick;
+            ++shown;
+
+            uint64_t classCounts[FOOD_CLASS_COUNT] = {};
+            for (FoodClass foodClass : frame.occupancy) {
+                if (foodClass < FOOD_CLASS_COUNT) ++classCounts[foodClass];
+            }
+            cout << "tick " << frame.tick << "  organisms " << frame.organisms
+                 << "  plants " << classCounts[FOOD_CLASS_PLANT]
+                 << "  herbivores " << classCounts[animalFoodClass(AnimalType::HERBIVORE)]
+                 << "  carnivores " << classCounts[animalFoodClass(AnimalType::CARNIVORE)]
+                 << "  omnivores " << classCounts[animalFoodClass(AnimalType::OMNIVORE)];
+            if (!frame.nutrients.empty()) {
+                double total = 0.0;
+                for (float nutrients : frame.nutrients) {
+                    total += nutrients;
+                }
+                cout << "  soil_mean " << total / static_cast<double>(frame.nutrients.size());
+            }
+            cout << '\n';
+
+            if (options.map && width <= 80 && height <= 40) {
+                for (int y = 0; y < height; ++y) {
+                    for (int x = 0; x < width; ++x) {
+                        cout << tileSymbol(frame.occupancy[static_cast<size_t>(y) * width + x]);
+                    }
+                    cout << '\n';
+                }
+            }
+            cout << flush;
+        }
+        this_thread::sleep_for(chrono::milliseconds(options.intervalMs));
+    }
+    return 0;
+}